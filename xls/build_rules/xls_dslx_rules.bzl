@@ -108,6 +108,13 @@ def _get_dslx_test_cmdline(ctx, src, all_srcs, append_cmd_line_args = True):
         "enable_warnings",
         "max_ticks",
         "format_preference",
+        "test_threads",
+        "quickcheck_threads",
+        "typecheck_imports_lazily",
+        "compare_sample_rate",
+        "compare_function_sample_rates",
+        "compare_max_per_function",
+        "compare_async_threads",
     )
 
     dslx_test_args = dict(_dslx_test_args)
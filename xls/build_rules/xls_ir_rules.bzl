@@ -140,6 +140,8 @@ def _convert_to_ir(ctx, src):
         "disable_warnings",
         "convert_tests",
         "default_fifo_config",
+        "conversion_threads",
+        "typecheck_imports_lazily",
     )
 
     # With runs outside a monorepo, the execution root for the workspace of
@@ -20,8 +20,11 @@
 #include <deque>
 #include <initializer_list>
 #include <optional>
+#include <ostream>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <variant>
 #include <vector>
@@ -997,8 +1000,9 @@ absl::StatusOr<std::vector<Block*>> GatherInstantiatedBlocks(Block* top) {
 
 }  // namespace
 
-absl::StatusOr<std::string> GenerateVerilog(
-    Block* top, const CodegenOptions& options, VerilogLineMap* verilog_line_map,
+absl::Status GenerateVerilog(
+    Block* top, const CodegenOptions& options, std::ostream& os,
+    VerilogLineMap* verilog_line_map,
     const absl::flat_hash_map<InputPort*, std::string>& input_port_sv_types,
     const absl::flat_hash_map<OutputPort*, std::string>& output_port_sv_types) {
   VLOG(2) << absl::StreamFormat(
@@ -1019,8 +1023,12 @@ absl::StatusOr<std::string> GenerateVerilog(
     }
   }
 
+  // Emit the modules of the blocks concurrently.
+  int64_t emit_threads =
+      std::min(static_cast<int64_t>(blocks.size()),
+               static_cast<int64_t>(std::thread::hardware_concurrency()));
   LineInfo line_info;
-  std::string text = file.Emit(&line_info);
+  file.EmitTo(os, &line_info, emit_threads);
   if (verilog_line_map != nullptr) {
     for (const VastNode* vast_node : line_info.nodes()) {
       std::optional<std::vector<LineSpan>> spans =
@@ -1046,6 +1054,19 @@ absl::StatusOr<std::string> GenerateVerilog(
     }
   }
 
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> GenerateVerilog(
+    Block* top, const CodegenOptions& options, VerilogLineMap* verilog_line_map,
+    const absl::flat_hash_map<InputPort*, std::string>& input_port_sv_types,
+    const absl::flat_hash_map<OutputPort*, std::string>& output_port_sv_types) {
+  std::ostringstream os;
+  XLS_RETURN_IF_ERROR(GenerateVerilog(top, options, os, verilog_line_map,
+                                      input_port_sv_types,
+                                      output_port_sv_types));
+  std::string text = std::move(os).str();
+
   VLOG(2) << "Verilog output:";
   XLS_VLOG_LINES(2, text);
 
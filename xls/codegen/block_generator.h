@@ -15,9 +15,11 @@
 #ifndef XLS_CODEGEN_BLOCK_GENERATOR_H_
 #define XLS_CODEGEN_BLOCK_GENERATOR_H_
 
+#include <ostream>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/codegen/codegen_options.h"
 #include "xls/codegen/verilog_line_map.pb.h"
@@ -27,6 +29,18 @@
 namespace xls {
 namespace verilog {
 
+// Generates (System)Verilog text implementing the given top-level block and
+// writes it to `os` (e.g. a `std::ofstream`) as it is emitted, so the text of
+// the whole package is never held in memory. The text is the same as that
+// returned by the overload below.
+absl::Status GenerateVerilog(
+    Block* top, const CodegenOptions& options, std::ostream& os,
+    VerilogLineMap* verilog_line_map = nullptr,
+    const absl::flat_hash_map<InputPort*, std::string>& input_port_sv_types =
+        {},
+    const absl::flat_hash_map<OutputPort*, std::string>& output_port_sv_types =
+        {});
+
 // Generates and returns (System)Verilog text implementing the given top-level
 // block. The text will include a Verilog module corresponding to the given
 // block as well as module definitions for any instantiated blocks.
@@ -19,6 +19,7 @@
 #include <initializer_list>
 #include <memory>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -43,6 +44,7 @@
 #include "xls/codegen/module_signature.h"
 #include "xls/codegen/op_override_impls.h"
 #include "xls/codegen/signature_generator.h"
+#include "xls/codegen/verilog_line_map.pb.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/status/matchers.h"
 #include "xls/common/status/ret_check.h"
@@ -1508,6 +1510,29 @@ TEST_P(BlockGeneratorTest, DiamondDependencyInstantiations) {
   XLS_ASSERT_OK(tb->Run());
 }
 
+TEST_P(BlockGeneratorTest, StreamedVerilogMatchesReturnedVerilog) {
+  Package package(TestBaseName());
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub_block,
+                           MakeSubtractBlock("subtractor", &package));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Block * delegator0,
+      MakeDelegatingBlock("delegator0", sub_block, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Block * delegator1,
+      MakeDelegatingBlock("delegator1", delegator0, &package));
+
+  VerilogLineMap expected_line_map;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string expected,
+      GenerateVerilog(delegator1, codegen_options(), &expected_line_map));
+
+  std::ostringstream os;
+  VerilogLineMap line_map;
+  XLS_ASSERT_OK(GenerateVerilog(delegator1, codegen_options(), os, &line_map));
+  EXPECT_EQ(os.str(), expected);
+  EXPECT_EQ(line_map.DebugString(), expected_line_map.DebugString());
+}
+
 TEST_P(BlockGeneratorTest, LoopbackFifoInstantiation) {
   constexpr std::string_view ir_text = R"(package test
 
@@ -14,6 +14,7 @@
 
 #include "xls/codegen/combinational_generator.h"
 
+#include <ostream>
 #include <string>
 
 #include "absl/status/statusor.h"
@@ -35,7 +36,7 @@ namespace verilog {
 
 absl::StatusOr<ModuleGeneratorResult> GenerateCombinationalModule(
     FunctionBase* module, const CodegenOptions& options,
-    const DelayEstimator* delay_estimator) {
+    const DelayEstimator* delay_estimator, std::ostream* verilog_output) {
   XLS_ASSIGN_OR_RETURN(CodegenPassUnit unit,
                        FunctionBaseToCombinationalBlock(module, options));
 
@@ -51,9 +52,14 @@ absl::StatusOr<ModuleGeneratorResult> GenerateCombinationalModule(
   XLS_RET_CHECK(unit.metadata.contains(unit.top_block));
   XLS_RET_CHECK(unit.metadata.at(unit.top_block).signature.has_value());
   VerilogLineMap verilog_line_map;
-  XLS_ASSIGN_OR_RETURN(
-      std::string verilog,
-      GenerateVerilog(unit.top_block, options, &verilog_line_map));
+  std::string verilog;
+  if (verilog_output != nullptr) {
+    XLS_RETURN_IF_ERROR(GenerateVerilog(unit.top_block, options,
+                                        *verilog_output, &verilog_line_map));
+  } else {
+    XLS_ASSIGN_OR_RETURN(
+        verilog, GenerateVerilog(unit.top_block, options, &verilog_line_map));
+  }
 
   // TODO: google/xls#1323 - add all block signatures to ModuleGeneratorResult,
   // not just top.
@@ -15,6 +15,8 @@
 #ifndef XLS_CODEGEN_COMBINATIONAL_GENERATOR_H_
 #define XLS_CODEGEN_COMBINATIONAL_GENERATOR_H_
 
+#include <ostream>
+
 #include "absl/status/statusor.h"
 #include "xls/codegen/codegen_options.h"
 #include "xls/codegen/module_signature.h"
@@ -28,9 +30,12 @@ namespace verilog {
 // use_system_verilog is true the generated module will be SystemVerilog
 // otherwise it will be Verilog. This adds a proc to the package which
 // represents the combinational module. This proc is used for code generation.
+// If `verilog_output` is non-null the Verilog text is streamed to it and the
+// `verilog_text` field of the result is left empty.
 absl::StatusOr<ModuleGeneratorResult> GenerateCombinationalModule(
     FunctionBase* module, const CodegenOptions& options,
-    const DelayEstimator* delay_estimator = nullptr);
+    const DelayEstimator* delay_estimator = nullptr,
+    std::ostream* verilog_output = nullptr);
 
 }  // namespace verilog
 }  // namespace xls
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <ostream>
 #include <string>
 #include <utility>
 
@@ -44,14 +45,16 @@ namespace verilog {
 
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, Function* func,
-    const CodegenOptions& options, const DelayEstimator* delay_estimator) {
+    const CodegenOptions& options, const DelayEstimator* delay_estimator,
+    std::ostream* verilog_output) {
   return ToPipelineModuleText(schedule, static_cast<FunctionBase*>(func),
-                              options, delay_estimator);
+                              options, delay_estimator, verilog_output);
 }
 
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, FunctionBase* module,
-    const CodegenOptions& options, const DelayEstimator* delay_estimator) {
+    const CodegenOptions& options, const DelayEstimator* delay_estimator,
+    std::ostream* verilog_output) {
   VLOG(2) << "Generating pipelined module for module:";
   XLS_VLOG_LINES(2, module->DumpIr());
   XLS_VLOG_LINES(2, schedule.ToString());
@@ -80,11 +83,19 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
   VerilogLineMap verilog_line_map;
   const auto& pipeline =
       unit.metadata.at(unit.top_block).streaming_io_and_pipeline;
-  XLS_ASSIGN_OR_RETURN(
-      std::string verilog,
-      GenerateVerilog(unit.top_block, pass_options.codegen_options,
-                      &verilog_line_map, pipeline.input_port_sv_type,
-                      pipeline.output_port_sv_type));
+  std::string verilog;
+  if (verilog_output != nullptr) {
+    XLS_RETURN_IF_ERROR(GenerateVerilog(
+        unit.top_block, pass_options.codegen_options, *verilog_output,
+        &verilog_line_map, pipeline.input_port_sv_type,
+        pipeline.output_port_sv_type));
+  } else {
+    XLS_ASSIGN_OR_RETURN(
+        verilog,
+        GenerateVerilog(unit.top_block, pass_options.codegen_options,
+                        &verilog_line_map, pipeline.input_port_sv_type,
+                        pipeline.output_port_sv_type));
+  }
 
   // TODO: google/xls#1323 - add all block signatures to ModuleGeneratorResult,
   // not just top.
@@ -95,7 +106,8 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
 
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PackagePipelineSchedules& schedules, Package* package,
-    const CodegenOptions& options, const DelayEstimator* delay_estimator) {
+    const CodegenOptions& options, const DelayEstimator* delay_estimator,
+    std::ostream* verilog_output) {
   VLOG(2) << "Generating pipelined module for module:";
   XLS_VLOG_LINES(2, package->DumpIr());
   if (VLOG_IS_ON(2)) {
@@ -132,11 +144,17 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
   VerilogLineMap verilog_line_map;
   const auto& pipeline =
       unit.metadata[unit.top_block].streaming_io_and_pipeline;
-  XLS_ASSIGN_OR_RETURN(
-      std::string verilog,
-      GenerateVerilog(unit.top_block, options, &verilog_line_map,
-                      pipeline.input_port_sv_type,
-                      pipeline.output_port_sv_type));
+  std::string verilog;
+  if (verilog_output != nullptr) {
+    XLS_RETURN_IF_ERROR(GenerateVerilog(
+        unit.top_block, options, *verilog_output, &verilog_line_map,
+        pipeline.input_port_sv_type, pipeline.output_port_sv_type));
+  } else {
+    XLS_ASSIGN_OR_RETURN(
+        verilog, GenerateVerilog(unit.top_block, options, &verilog_line_map,
+                                 pipeline.input_port_sv_type,
+                                 pipeline.output_port_sv_type));
+  }
 
   // TODO: google/xls#1323 - add all block signatures to ModuleGeneratorResult,
   // not just top.
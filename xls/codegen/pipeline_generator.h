@@ -15,6 +15,7 @@
 #ifndef XLS_CODEGEN_PIPELINE_GENERATOR_H_
 #define XLS_CODEGEN_PIPELINE_GENERATOR_H_
 
+#include <ostream>
 
 #include "absl/status/statusor.h"
 #include "xls/codegen/codegen_options.h"
@@ -45,7 +46,8 @@ inline CodegenOptions BuildPipelineOptions() {
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, Function* func,
     const CodegenOptions& options = BuildPipelineOptions(),
-    const DelayEstimator* delay_estimator = nullptr);
+    const DelayEstimator* delay_estimator = nullptr,
+    std::ostream* verilog_output = nullptr);
 
 // Emits the given function or proc as a verilog module which follows the given
 // schedule. The module is pipelined with a latency and initiation interval
@@ -55,16 +57,21 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, FunctionBase* module,
     const CodegenOptions& options = BuildPipelineOptions(),
-    const DelayEstimator* delay_estimator = nullptr);
+    const DelayEstimator* delay_estimator = nullptr,
+    std::ostream* verilog_output = nullptr);
 
 // Emits the given package as a verilog module which follows the given
 // schedules. Modules are pipelined with a latency and initiation interval
 // given in the signature. If a delay estimator is provided, the signature also
 // includes delay information about the pipeline stages.
+//
+// For all overloads, if `verilog_output` is non-null the Verilog text is
+// streamed to it and the `verilog_text` field of the result is left empty.
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PackagePipelineSchedules& schedules, Package* package,
     const CodegenOptions& options = BuildPipelineOptions(),
-    const DelayEstimator* delay_estimator = nullptr);
+    const DelayEstimator* delay_estimator = nullptr,
+    std::ostream* verilog_output = nullptr);
 
 }  // namespace verilog
 }  // namespace xls
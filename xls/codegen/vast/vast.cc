@@ -17,6 +17,8 @@
 #include <algorithm>
 #include <cstdint>
 #include <optional>
+#include <ostream>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -37,6 +39,7 @@
 #include "absl/types/variant.h"
 #include "xls/codegen/module_signature.pb.h"
 #include "xls/common/indent.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/visitor.h"
 #include "xls/ir/bits_ops.h"
@@ -260,6 +263,30 @@ void LineInfo::End(const VastNode* node) {
   spans_.at(node).hanging_start_line = std::nullopt;
 }
 
+void LineInfo::Append(const LineInfo& other) {
+  for (const VastNode* node : other.nodes_) {
+    const PartialLineSpans& other_spans = other.spans_.at(node);
+    auto [it, inserted] = spans_.try_emplace(node);
+    if (inserted) {
+      nodes_.push_back(node);
+    } else {
+      CHECK(!it->second.hanging_start_line.has_value() &&
+            !other_spans.hanging_start_line.has_value())
+          << "LineInfo::Append can't merge hanging spans!";
+    }
+    for (const LineSpan& span : other_spans.completed_spans) {
+      it->second.completed_spans.push_back(
+          LineSpan(span.StartLine() + current_line_number_,
+                   span.EndLine() + current_line_number_));
+    }
+    if (other_spans.hanging_start_line.has_value()) {
+      it->second.hanging_start_line =
+          *other_spans.hanging_start_line + current_line_number_;
+    }
+  }
+  current_line_number_ += other.current_line_number_;
+}
+
 void LineInfo::Increase(int64_t delta) { current_line_number_ += delta; }
 
 std::optional<std::vector<LineSpan>> LineInfo::LookupNode(
@@ -388,16 +415,67 @@ UnpackedArrayType* VerilogFile::UnpackedArrayType(
 }
 
 std::string VerilogFile::Emit(LineInfo* line_info) const {
-  auto file_member_str = [=](const FileMember& member) -> std::string {
-    return absl::visit([=](auto* m) { return m->Emit(line_info); }, member);
+  std::ostringstream os;
+  EmitTo(os, line_info);
+  return os.str();
+}
+
+void VerilogFile::EmitTo(std::ostream& os, LineInfo* line_info,
+                         int64_t threads) const {
+  // Text and line info of modules emitted ahead of time, indexed by position in
+  // `members_`. At most `threads` modules are buffered at once and each buffer
+  // is released as soon as it has been written out.
+  struct EmittedModule {
+    std::string text;
+    LineInfo line_info;
   };
-
-  std::string out;
-  for (const FileMember& member : members_) {
-    absl::StrAppend(&out, file_member_str(member), "\n");
+  std::vector<std::optional<EmittedModule>> emitted(members_.size());
+  std::vector<int64_t> module_indices;
+  if (threads > 1) {
+    for (int64_t i = 0; i < members_.size(); ++i) {
+      if (std::holds_alternative<Module*>(members_[i])) {
+        module_indices.push_back(i);
+      }
+    }
+  }
+  // Position in `module_indices` of the first module not yet emitted.
+  int64_t next_module = 0;
+
+  for (int64_t i = 0; i < members_.size(); ++i) {
+    if (threads > 1 && std::holds_alternative<Module*>(members_[i]) &&
+        !emitted[i].has_value()) {
+      int64_t window =
+          std::min(threads, static_cast<int64_t>(module_indices.size()) -
+                                next_module);
+      for (int64_t j = 0; j < window; ++j) {
+        emitted[module_indices[next_module + j]].emplace();
+      }
+      ParallelFor(window, threads, [&](int64_t j) {
+        int64_t index = module_indices[next_module + j];
+        EmittedModule& module = *emitted[index];
+        std::ostringstream module_os;
+        std::get<Module*>(members_[index])
+            ->EmitTo(module_os,
+                     line_info == nullptr ? nullptr : &module.line_info);
+        module.text = std::move(module_os).str();
+      });
+      next_module += window;
+    }
+    if (emitted[i].has_value()) {
+      os << emitted[i]->text;
+      if (line_info != nullptr) {
+        line_info->Append(emitted[i]->line_info);
+      }
+      emitted[i].reset();
+    } else if (std::holds_alternative<Module*>(members_[i])) {
+      std::get<Module*>(members_[i])->EmitTo(os, line_info);
+    } else {
+      os << absl::visit([=](auto* m) { return m->Emit(line_info); },
+                        members_[i]);
+    }
+    os << "\n";
     LineInfoIncrease(line_info, 1);
   }
-  return out;
 }
 
 LocalParamItemRef* LocalParam::AddItem(std::string_view name, Expression* value,
@@ -1094,30 +1172,108 @@ std::string SystemFunctionCall::Emit(LineInfo* line_info) const {
   return absl::StrFormat("$%s", name_);
 }
 
+namespace {
+
+// Writes text to a stream, indenting it as `Indent` would. Text may be written
+// in arbitrary pieces; lines are indented as they are completed.
+class IndentingWriter {
+ public:
+  explicit IndentingWriter(std::ostream& os) : os_(os) {}
+
+  void Write(std::string_view text) {
+    size_t newline;
+    while ((newline = text.find('\n')) != std::string_view::npos) {
+      absl::StrAppend(&line_, text.substr(0, newline));
+      WriteLine();
+      text.remove_prefix(newline + 1);
+    }
+    absl::StrAppend(&line_, text);
+  }
+
+  void Finish() { WriteLine(); }
+
+ private:
+  // Mirrors `Indent`: empty lines are not indented and leading empty lines are
+  // dropped.
+  void WriteLine() {
+    if (wrote_text_) {
+      os_ << '\n';
+    }
+    if (!line_.empty()) {
+      os_ << "  " << line_;
+      wrote_text_ = true;
+    }
+    line_.clear();
+  }
+
+  std::ostream& os_;
+  std::string line_;
+  bool wrote_text_ = false;
+};
+
+// Streaming equivalent of `ModuleSection::Emit` which emits one member at a
+// time, recursing into nested sections.
+void EmitModuleSectionTo(const ModuleSection* section, IndentingWriter& writer,
+                         LineInfo* line_info) {
+  LineInfoStart(line_info, section);
+  bool first = true;
+  for (const ModuleMember& member : section->members()) {
+    if (std::holds_alternative<ModuleSection*>(member) &&
+        std::get<ModuleSection*>(member)->members().empty()) {
+      continue;
+    }
+    if (!first) {
+      writer.Write("\n");
+    }
+    first = false;
+    if (std::holds_alternative<ModuleSection*>(member)) {
+      EmitModuleSectionTo(std::get<ModuleSection*>(member), writer, line_info);
+    } else {
+      writer.Write(EmitModuleMember(line_info, member));
+    }
+    LineInfoIncrease(line_info, 1);
+  }
+  if (!first) {
+    LineInfoIncrease(line_info, -1);
+  }
+  LineInfoEnd(line_info, section);
+}
+
+}  // namespace
+
 std::string Module::Emit(LineInfo* line_info) const {
+  std::ostringstream os;
+  EmitTo(os, line_info);
+  return os.str();
+}
+
+void Module::EmitTo(std::ostream& os, LineInfo* line_info) const {
   LineInfoStart(line_info, this);
-  std::string result = absl::StrCat("module ", name_);
+  os << "module " << name_;
   if (ports_.empty()) {
-    absl::StrAppend(&result, ";\n");
+    os << ";\n";
     LineInfoIncrease(line_info, 1);
   } else {
-    absl::StrAppend(&result, "(\n  ");
+    os << "(\n  ";
     LineInfoIncrease(line_info, 1);
-    absl::StrAppend(
-        &result,
-        absl::StrJoin(ports_, ",\n  ", [=](std::string* out, const Port& port) {
-          absl::StrAppendFormat(out, "%s %s", ToString(port.direction),
-                                port.wire->EmitNoSemi(line_info));
-          LineInfoIncrease(line_info, 1);
-        }));
-    absl::StrAppend(&result, "\n);\n");
+    for (int64_t i = 0; i < ports_.size(); ++i) {
+      if (i != 0) {
+        os << ",\n  ";
+      }
+      os << ToString(ports_[i].direction) << " "
+         << ports_[i].wire->EmitNoSemi(line_info);
+      LineInfoIncrease(line_info, 1);
+    }
+    os << "\n);\n";
     LineInfoIncrease(line_info, 1);
   }
-  absl::StrAppend(&result, Indent(top_.Emit(line_info)), "\n");
+  IndentingWriter body(os);
+  EmitModuleSectionTo(&top_, body, line_info);
+  body.Finish();
+  os << "\n";
   LineInfoIncrease(line_info, 1);
-  absl::StrAppend(&result, "endmodule");
+  os << "endmodule";
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 std::string VerilogPackage::Emit(LineInfo* line_info) const {
@@ -121,6 +121,12 @@ class LineInfo {
   // CHECK fails if called multiple times with no intervening `Start` calls.
   void End(const VastNode* node);
 
+  // Appends the spans recorded in `other`, which must describe text following
+  // the text described by this object, shifting them by the current line
+  // number. CHECK fails if either object has a hanging span on a node recorded
+  // in both.
+  void Append(const LineInfo& other);
+
   // Increase the current line number by the given value.
   // You may pass in a negative number, but only if that sequence of calls
   // could equivalently be achieved through only nonnegative numbers.
@@ -2225,6 +2231,11 @@ class Module final : public VastNode {
 
   std::string Emit(LineInfo* line_info) const final;
 
+  // Writes the same text as `Emit` to `os`. Each top-level member of the module
+  // is emitted and written separately so the text of the whole module is never
+  // held in memory at once.
+  void EmitTo(std::ostream& os, LineInfo* line_info) const;
+
  private:
   // Add the given Def as a port on the module.
   LogicRef* AddPortDef(Direction direction, Def* def, const SourceInfo& loc);
@@ -2377,6 +2388,13 @@ class VerilogFile {
 
   std::string Emit(LineInfo* line_info = nullptr) const;
 
+  // Writes the same text as `Emit` to `os` (e.g. a `std::ofstream`) without
+  // first building the text of the whole file. If `threads` is greater than one
+  // up to `threads` modules at a time are emitted concurrently, each into its
+  // own buffer, and written out in order.
+  void EmitTo(std::ostream& os, LineInfo* line_info = nullptr,
+              int64_t threads = 1) const;
+
   verilog::Slice* Slice(IndexableExpression* subject, Expression* hi,
                         Expression* lo, const SourceInfo& loc) {
     return Make<verilog::Slice>(loc, subject, hi, lo);
@@ -14,7 +14,9 @@
 
 #include "xls/codegen/vast/vast.h"
 
+#include <cstdint>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -2104,6 +2106,53 @@ endpackage)");
             std::vector<LineSpan>{LineSpan(3, 3)});
 }
 
+TEST_P(VastTest, EmitToMatchesEmit) {
+  VerilogFile f(GetFileType());
+  std::vector<Module*> modules;
+  std::vector<const VastNode*> defs;
+  for (int64_t i = 0; i < 5; ++i) {
+    Module* m = f.AddModule(absl::StrCat("m", i), SourceInfo());
+    LogicRef* a = m->AddInput("a", f.BitVectorType(8, SourceInfo()),
+                              SourceInfo());
+    LogicRef* b = m->AddOutput("b", f.BitVectorType(8, SourceInfo()),
+                               SourceInfo());
+    ModuleSection* section = m->Add<ModuleSection>(SourceInfo());
+    section->Add<ModuleSection>(SourceInfo());
+    section->Add<Comment>(SourceInfo(), "first\nsecond");
+    LogicRef* w = m->AddWire("w", f.BitVectorType(8, SourceInfo()),
+                             SourceInfo(), section);
+    m->Add<BlankLine>(SourceInfo());
+    m->Add<ContinuousAssignment>(SourceInfo(), w, a);
+    m->Add<ContinuousAssignment>(SourceInfo(), b, w);
+    modules.push_back(m);
+    defs.push_back(w->def());
+    if (i % 2 == 0) {
+      f.Add(f.Make<BlankLine>(SourceInfo()));
+      f.Add(f.Make<Comment>(SourceInfo(), "between modules"));
+    }
+  }
+
+  LineInfo expected_line_info;
+  std::string expected = f.Emit(&expected_line_info);
+  for (int64_t threads : {1, 4}) {
+    LineInfo line_info;
+    std::ostringstream os;
+    f.EmitTo(os, &line_info, threads);
+    EXPECT_EQ(os.str(), expected);
+    for (Module* m : modules) {
+      EXPECT_EQ(line_info.LookupNode(m), expected_line_info.LookupNode(m));
+    }
+    for (const VastNode* def : defs) {
+      EXPECT_EQ(line_info.LookupNode(def),
+                expected_line_info.LookupNode(def));
+    }
+  }
+  EXPECT_EQ(expected_line_info.LookupNode(modules[1]).value(),
+            std::vector<LineSpan>{LineSpan(13, 23)});
+  EXPECT_EQ(expected_line_info.LookupNode(defs[1]).value(),
+            std::vector<LineSpan>{LineSpan(19, 19)});
+}
+
 INSTANTIATE_TEST_SUITE_P(VastTestInstantiation, VastTest,
                          testing::Values(false, true),
                          [](const testing::TestParamInfo<bool>& info) {
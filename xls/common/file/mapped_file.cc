@@ -0,0 +1,78 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/file/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "xls/common/file/file_descriptor.h"
+#include "xls/common/status/error_code_to_status.h"
+
+namespace xls {
+
+/* static */ absl::StatusOr<MappedFile> MappedFile::Open(
+    const std::filesystem::path& path) {
+  FileDescriptor fd(open(path.c_str(), O_RDONLY));
+  if (fd.get() == -1) {
+    return ErrnoToStatus(errno) << "Unable to open " << path;
+  }
+  struct stat file_stat;
+  if (fstat(fd.get(), &file_stat) != 0) {
+    return ErrnoToStatus(errno) << "Unable to stat " << path;
+  }
+  int64_t size = file_stat.st_size;
+  if (size == 0) {
+    return MappedFile(nullptr, 0);
+  }
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+  if (mapping == MAP_FAILED) {
+    return ErrnoToStatus(errno) << "Unable to map " << path;
+  }
+  return MappedFile(static_cast<const uint8_t*>(mapping), size);
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+    : data_(other.data_), size_(other.size_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+  if (this != &other) {
+    Unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { Unmap(); }
+
+void MappedFile::Unmap() {
+  if (data_ != nullptr) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+
+}  // namespace xls
@@ -0,0 +1,58 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_FILE_MAPPED_FILE_H_
+#define XLS_COMMON_FILE_MAPPED_FILE_H_
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <string_view>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+
+namespace xls {
+
+// A read-only memory mapping of a file, for reading (large) files without
+// first copying their contents into memory. Views of the contents remain valid
+// for the lifetime of the mapping.
+class MappedFile {
+ public:
+  static absl::StatusOr<MappedFile> Open(const std::filesystem::path& path);
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other);
+  MappedFile& operator=(MappedFile&& other);
+  ~MappedFile();
+
+  absl::Span<const uint8_t> data() const {
+    return absl::MakeConstSpan(data_, size_);
+  }
+  std::string_view contents() const {
+    return std::string_view(reinterpret_cast<const char*>(data_), size_);
+  }
+
+ private:
+  MappedFile(const uint8_t* data, int64_t size) : data_(data), size_(size) {}
+
+  void Unmap();
+
+  const uint8_t* data_ = nullptr;
+  int64_t size_ = 0;
+};
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_FILE_MAPPED_FILE_H_
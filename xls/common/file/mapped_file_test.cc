@@ -0,0 +1,62 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/file/mapped_file.h"
+
+#include <filesystem>  // NOLINT
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace {
+
+using ::absl_testing::StatusIs;
+
+TEST(MappedFileTest, MapsContents) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  const std::filesystem::path path = temp_dir.path() / "my_file";
+  XLS_ASSERT_OK(SetFileContents(path, "hello!"));
+
+  XLS_ASSERT_OK_AND_ASSIGN(MappedFile file, MappedFile::Open(path));
+  EXPECT_EQ(file.contents(), "hello!");
+  EXPECT_EQ(file.data().size(), 6);
+
+  MappedFile moved = std::move(file);
+  EXPECT_EQ(moved.contents(), "hello!");
+  EXPECT_TRUE(file.contents().empty());
+}
+
+TEST(MappedFileTest, EmptyFile) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  const std::filesystem::path path = temp_dir.path() / "empty";
+  XLS_ASSERT_OK(SetFileContents(path, ""));
+
+  XLS_ASSERT_OK_AND_ASSIGN(MappedFile file, MappedFile::Open(path));
+  EXPECT_TRUE(file.contents().empty());
+}
+
+TEST(MappedFileTest, MissingFile) {
+  EXPECT_THAT(MappedFile::Open("/not/a/file"),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+}  // namespace
+}  // namespace xls
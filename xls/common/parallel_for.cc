@@ -0,0 +1,54 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "xls/common/thread.h"
+
+namespace xls {
+
+void ParallelFor(int64_t count, int64_t threads,
+                 absl::FunctionRef<void(int64_t)> fn) {
+  threads = std::min(threads, count);
+  if (threads <= 1) {
+    for (int64_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+    return;
+  }
+  std::atomic<int64_t> next = 0;
+  auto run = [&]() {
+    for (int64_t i = next++; i < count; i = next++) {
+      fn(i);
+    }
+  };
+  std::vector<std::unique_ptr<Thread>> workers;
+  workers.reserve(threads - 1);
+  for (int64_t t = 1; t < threads; ++t) {
+    workers.push_back(std::make_unique<Thread>(run));
+  }
+  run();
+  for (std::unique_ptr<Thread>& worker : workers) {
+    worker->Join();
+  }
+}
+
+}  // namespace xls
@@ -0,0 +1,36 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_PARALLEL_FOR_H_
+#define XLS_COMMON_PARALLEL_FOR_H_
+
+#include <cstdint>
+
+#include "absl/functional/function_ref.h"
+
+namespace xls {
+
+// Calls `fn(i)` for every `i` in [0, count) using up to `threads` threads, the
+// calling thread included. Indices are handed out one at a time in increasing
+// order so that work of uneven cost is balanced across the threads. Returns
+// once every call has returned.
+//
+// If `threads` is at most one (or `count` is at most one) the calls are made
+// serially, in order, on the calling thread.
+void ParallelFor(int64_t count, int64_t threads,
+                 absl::FunctionRef<void(int64_t)> fn);
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_PARALLEL_FOR_H_
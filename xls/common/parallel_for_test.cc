@@ -0,0 +1,55 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/parallel_for.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace xls {
+namespace {
+
+using ::testing::Each;
+using ::testing::ElementsAre;
+
+TEST(ParallelForTest, SerialCallsAreInOrder) {
+  std::vector<int64_t> order;
+  ParallelFor(4, /*threads=*/1, [&](int64_t i) { order.push_back(i); });
+  EXPECT_THAT(order, ElementsAre(0, 1, 2, 3));
+}
+
+TEST(ParallelForTest, EveryIndexIsVisitedOnce) {
+  for (int64_t threads : {0, 2, 7, 100}) {
+    std::vector<std::atomic<int64_t>> visits(1000);
+    ParallelFor(visits.size(), threads, [&](int64_t i) { ++visits[i]; });
+    std::vector<int64_t> counts;
+    for (const std::atomic<int64_t>& v : visits) {
+      counts.push_back(v.load());
+    }
+    EXPECT_THAT(counts, Each(1)) << threads << " threads";
+  }
+}
+
+TEST(ParallelForTest, EmptyRange) {
+  int64_t calls = 0;
+  ParallelFor(0, /*threads=*/4, [&](int64_t i) { ++calls; });
+  EXPECT_EQ(calls, 0);
+}
+
+}  // namespace
+}  // namespace xls
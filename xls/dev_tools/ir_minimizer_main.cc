@@ -27,6 +27,7 @@
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/btree_set.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
@@ -42,12 +43,15 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
+#include "openssl/sha.h"
 #include "xls/common/exit_status.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/temp_file.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/log_lines.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/subprocess.h"
@@ -118,6 +122,16 @@ from the interpreter results. Example invocation:
   ir_minimizer_main --test_llvm_jit --use_optimization_pipeline \
     --input='bits[32]:42; bits[1]:0' IR_FILE
 
+The third mode reduces a test case where an optimization pass (or pipeline)
+returns an error, running the pass in-process. Example invocation:
+
+  ir_minimizer_main --test_pass_error=bdd_cse IR_FILE
+
+Test results are memoized by a hash of the IR. With --parallelism=N, each round
+derives N simplification candidates from the last failing IR and tests them
+concurrently, keeping the first which still fails; this is much faster when
+the test is slow and many candidates are rejected.
+
 )";
 
 ABSL_FLAG(bool, can_remove_params, false,
@@ -171,6 +185,13 @@ ABSL_FLAG(bool, test_optimizer, false,
           "Tests for differences between results from the unoptimized and "
           "optimized IR as the reduction test case. Must specify --input with "
           "this flag. Cannot be used with --test_llvm_jit.");
+ABSL_FLAG(std::string, test_pass_error, "",
+          "Tests for an error returned by the optimization pass (or compound "
+          "pass, or pass pipeline in the syntax of opt_main's --passes) of "
+          "this name as the reduction test case. The pass is run in-process, "
+          "so this cannot be used to reduce a test case which crashes the "
+          "pass; use --test_executable with --test_executable_crash_is_bug "
+          "for that.");
 ABSL_FLAG(std::string, input, "",
           "Input to use when invoking the JIT and the interpreter. Must be "
           "used with --test_llvm_jit or --test_optimizer.");
@@ -211,6 +232,12 @@ ABSL_FLAG(int64_t, simplifications_between_tests, 1,
 ABSL_FLAG(int64_t, failed_attempts_between_tests_limit, 16,
           "Failed simplification attempts between tests before we conclude we "
           "need to check our changes so far.");
+ABSL_FLAG(int64_t, parallelism, 1,
+          "Number of simplification candidates to test concurrently. If "
+          "greater than one, each round derives this many candidates from the "
+          "last known failing IR, tests them in parallel and keeps the first "
+          "(in generation order) which still fails. "
+          "--simplifications_between_tests is ignored in this mode.");
 ABSL_FLAG(
     bool, verify_ir, true,
     "Verify IR whenever parsing. In most cases, this is a good check that the "
@@ -251,6 +278,39 @@ absl::StatusOr<std::unique_ptr<Package>> ParsePackage(
   return package;
 }
 
+// Thread-safe memo of test results. Results are keyed by the SHA-256 digest of
+// the IR text so the (possibly large) texts of all tested candidates need not
+// be retained.
+class TestCache {
+ public:
+  std::optional<bool> Get(std::string_view ir_text) const {
+    std::string key = Key(ir_text);
+    absl::MutexLock lock(&mutex_);
+    auto it = results_.find(key);
+    if (it == results_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  void Put(std::string_view ir_text, bool still_fails) {
+    std::string key = Key(ir_text);
+    absl::MutexLock lock(&mutex_);
+    results_[key] = still_fails;
+  }
+
+ private:
+  static std::string Key(std::string_view ir_text) {
+    std::string digest(SHA256_DIGEST_LENGTH, '\0');
+    SHA256(reinterpret_cast<const uint8_t*>(ir_text.data()), ir_text.size(),
+           reinterpret_cast<uint8_t*>(digest.data()));
+    return digest;
+  }
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, bool> results_ ABSL_GUARDED_BY(mutex_);
+};
+
 // Checks whether we still fail when attempting to run function "f". Optional
 // 'inputs' is required if --test_llvm_jit is used.
 absl::StatusOr<bool> StillFailsHelper(
@@ -304,6 +364,23 @@ absl::StatusOr<bool> StillFailsHelper(
     return subproc_result.exit_status == 0;
   }
 
+  if (!absl::GetFlag(FLAGS_test_pass_error).empty()) {
+    // Test for bugs by running the pass in-process.
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                         ParsePackage(ir_text));
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<OptimizationCompoundPass> pipeline,
+                         GetOptimizationPipelineGenerator(kMaxOptLevel)
+                             .GeneratePipeline(
+                                 absl::GetFlag(FLAGS_test_pass_error)));
+    PassResults results;
+    absl::StatusOr<bool> changed =
+        pipeline->Run(package.get(), OptimizationPassOptions(), &results);
+    if (!changed.ok()) {
+      VLOG(2) << "pass error: " << changed.status();
+    }
+    return !changed.ok();
+  }
+
   if (absl::GetFlag(FLAGS_test_optimizer)) {
     // Test for bugs by comparing the results of the unoptimized & optimized IR.
     XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
@@ -364,24 +441,24 @@ absl::StatusOr<bool> StillFailsHelper(
 
 // Wrapper around StillFails which memoizes the result. Optional test_cache is
 // used to memoize the results of testing the given IR.
-absl::StatusOr<bool> StillFails(
-    std::string_view ir_text, std::optional<std::vector<Value>> inputs,
-    absl::flat_hash_map<std::string, bool>* test_cache) {
+absl::StatusOr<bool> StillFails(std::string_view ir_text,
+                                std::optional<std::vector<Value>> inputs,
+                                TestCache* test_cache) {
   VLOG(1) << "=== Verifying contents still fails";
   XLS_VLOG_LINES(2, ir_text);
 
   if (test_cache != nullptr) {
-    auto it = test_cache->find(ir_text);
-    if (it != test_cache->end()) {
+    if (std::optional<bool> cached = test_cache->Get(ir_text);
+        cached.has_value()) {
       LOG(INFO) << absl::StreamFormat("Found result in cache (failed = %d)",
-                                      it->second);
-      return it->second;
+                                      *cached);
+      return *cached;
     }
   }
 
   XLS_ASSIGN_OR_RETURN(bool result, StillFailsHelper(ir_text, inputs));
   if (test_cache != nullptr) {
-    (*test_cache)[ir_text] = result;
+    test_cache->Put(ir_text, result);
   }
   return result;
 }
@@ -389,10 +466,10 @@ absl::StatusOr<bool> StillFails(
 // Writes the IR out to a temporary file, runs the test executable on it, and
 // returns 'true' if the test (still) fails on that IR text.  Optional test
 // cache is used to memoize the results of testing the given IR.
-absl::Status VerifyStillFails(
-    std::string_view ir_text, std::optional<std::vector<Value>> inputs,
-    std::string_view description,
-    absl::flat_hash_map<std::string, bool>* test_cache) {
+absl::Status VerifyStillFails(std::string_view ir_text,
+                              std::optional<std::vector<Value>> inputs,
+                              std::string_view description,
+                              TestCache* test_cache) {
   XLS_ASSIGN_OR_RETURN(bool still_fails,
                        StillFails(ir_text, inputs, test_cache));
 
@@ -1217,14 +1294,158 @@ absl::Status CleanUp(FunctionBase* f, bool can_remove_params) {
   return absl::OkStatus();
 }
 
+// Chooses the function base to simplify next: the top if --simplify_top_only
+// is given, otherwise a random one weighted by node count. Returns
+// std::nullopt if there is nothing left to simplify.
+std::optional<FunctionBase*> ChooseFunctionBase(Package* package,
+                                                absl::BitGenRef rng) {
+  if (absl::GetFlag(FLAGS_simplify_top_only)) {
+    return package->GetTop().value();
+  }
+  std::vector<FunctionBase*> bases = package->GetFunctionBases();
+  std::vector<int64_t> node_counts;
+  node_counts.reserve(bases.size());
+  for (auto it = bases.begin(); it != bases.end();) {
+    FunctionBase* f = *it;
+    int64_t node_count = f->node_count();
+    if (node_count == 0) {
+      // This is an empty function.
+      it = bases.erase(it);
+      continue;
+    }
+    node_counts.push_back(node_count);
+    it++;
+  }
+  if (bases.empty()) {
+    return std::nullopt;
+  }
+  absl::discrete_distribution<size_t> distribution(node_counts.cbegin(),
+                                                   node_counts.cend());
+  return bases[distribution(rng)];
+}
+
+// Prints the minimized IR and checks (without the cache) that it still fails.
+absl::Status OutputMinimizedIr(
+    std::string_view knownf_ir_text,
+    const std::optional<std::vector<Value>>& inputs) {
+  std::cout << knownf_ir_text;
+
+  // Run the last test verification without the cache.
+  return VerifyStillFails(knownf_ir_text, inputs,
+                          "Minimized function does not fail!",
+                          /*test_cache=*/nullptr);
+}
+
+// Minimizes `knownf_ir_text` by speculatively testing `parallelism`
+// simplification candidates at a time (see --parallelism) and returns the
+// minimized IR.
+//
+// Each candidate is a single simplification of the last known failing IR.
+// Candidates are generated serially, so the result is deterministic; only the
+// (typically much slower) tests run concurrently.
+absl::StatusOr<std::string> MinimizeInParallel(
+    std::string knownf_ir_text, const std::optional<std::vector<Value>>& inputs,
+    bool can_remove_params, int64_t failed_attempt_limit,
+    int64_t total_attempt_limit, int64_t parallelism, TestCache* test_cache) {
+  struct Candidate {
+    std::string which_transform;
+    std::string ir_text;
+    int64_t node_count;
+  };
+
+  std::mt19937 rng;  // Default constructor uses deterministic seed.
+  int64_t failed_simplification_attempts = 0;
+  int64_t total_attempts = 0;
+  bool cannot_change = false;
+  while (!cannot_change &&
+         failed_simplification_attempts < failed_attempt_limit &&
+         total_attempts < total_attempt_limit) {
+    std::vector<Candidate> candidates;
+    absl::flat_hash_set<std::string> candidate_texts;
+    while (static_cast<int64_t>(candidates.size()) < parallelism &&
+           failed_simplification_attempts < failed_attempt_limit &&
+           total_attempts < total_attempt_limit) {
+      total_attempts++;
+      XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                           ParsePackage(knownf_ir_text));
+      std::optional<FunctionBase*> f = ChooseFunctionBase(package.get(), rng);
+      if (!f.has_value()) {
+        LOG(INFO) << "Nothing left to simplify";
+        cannot_change = true;
+        break;
+      }
+      std::string which_transform;
+      XLS_ASSIGN_OR_RETURN(SimplifiedIr simplification,
+                           Simplify(*f, inputs, rng, &which_transform));
+      if (simplification.result == SimplificationResult::kCannotChange) {
+        LOG(INFO) << "Cannot simplify any further, done!";
+        cannot_change = true;
+        break;
+      }
+      if (simplification.result == SimplificationResult::kDidNotChange) {
+        failed_simplification_attempts++;
+        continue;
+      }
+      if (simplification.in_place()) {
+        XLS_RETURN_IF_ERROR(CleanUp(*f, can_remove_params));
+      }
+      std::string ir_text = simplification.ir();
+      if (!candidate_texts.insert(ir_text).second) {
+        // Same as an earlier candidate of this round.
+        failed_simplification_attempts++;
+        continue;
+      }
+      candidates.push_back({.which_transform = which_transform,
+                            .ir_text = std::move(ir_text),
+                            .node_count = simplification.node_count});
+    }
+    if (candidates.empty()) {
+      continue;
+    }
+
+    LOG(INFO) << "Testing " << candidates.size() << " candidates; total "
+              << "attempts " << total_attempts << "/" << total_attempt_limit;
+    std::vector<absl::StatusOr<bool>> results(
+        candidates.size(), absl::InternalError("Candidate was not tested"));
+    ParallelFor(candidates.size(), parallelism, [&](int64_t i) {
+      results[i] = StillFails(candidates[i].ir_text, inputs, test_cache);
+    });
+
+    std::optional<int64_t> first_failing;
+    for (int64_t i = 0; i < candidates.size(); ++i) {
+      XLS_ASSIGN_OR_RETURN(bool still_fails, results[i]);
+      if (still_fails) {
+        first_failing = i;
+        break;
+      }
+    }
+    if (!first_failing.has_value()) {
+      failed_simplification_attempts += candidates.size();
+      LOG(INFO) << "No candidate still fails; failed simplification attempts "
+                << "now: " << failed_simplification_attempts << "/"
+                << failed_attempt_limit;
+      continue;
+    }
+
+    const Candidate& known_failure = candidates[*first_failing];
+    knownf_ir_text = known_failure.ir_text;
+    failed_simplification_attempts = 0;
+    std::cerr << "---\ntransform: " << known_failure.which_transform << "\n"
+              << (known_failure.node_count > 50 ? "" : known_failure.ir_text)
+              << "(" << known_failure.node_count << " nodes)\n";
+  }
+  return knownf_ir_text;
+}
+
 absl::Status RealMain(std::string_view path, const int64_t failed_attempt_limit,
                       const int64_t total_attempt_limit,
                       const int64_t simplifications_between_tests,
-                      const int64_t failed_attempts_between_tests_limit) {
+                      const int64_t failed_attempts_between_tests_limit,
+                      const int64_t parallelism) {
   XLS_ASSIGN_OR_RETURN(std::string knownf_ir_text, GetFileContents(path));
   // Cache of test results to avoid duplicate invocations of the
   // test_executable.
-  absl::flat_hash_map<std::string, bool> test_cache;
+  TestCache test_cache;
 
   // Parse inputs, if specified.
   std::optional<std::vector<xls::Value>> inputs;
@@ -1268,6 +1489,15 @@ absl::Status RealMain(std::string_view path, const int64_t failed_attempt_limit,
     LOG(INFO) << "=== Done cleaning up initial garbage";
   }
 
+  if (parallelism > 1) {
+    XLS_ASSIGN_OR_RETURN(
+        knownf_ir_text,
+        MinimizeInParallel(knownf_ir_text, inputs, can_remove_params,
+                           failed_attempt_limit, total_attempt_limit,
+                           parallelism, &test_cache));
+    return OutputMinimizedIr(knownf_ir_text, inputs);
+  }
+
   // If so, we start simplifying via this seeded RNG.
   std::mt19937 rng;  // Default constructor uses deterministic seed.
 
@@ -1307,32 +1537,13 @@ absl::Status RealMain(std::string_view path, const int64_t failed_attempt_limit,
 
     VLOG(1) << "=== Simplification attempt " << total_attempts;
 
-    FunctionBase* candidate;
-    if (absl::GetFlag(FLAGS_simplify_top_only)) {
-      candidate = package->GetTop().value();
-    } else {
-      std::vector<FunctionBase*> bases = package->GetFunctionBases();
-      std::vector<int64_t> node_counts;
-      node_counts.reserve(bases.size());
-      for (auto it = bases.begin(); it != bases.end();) {
-        FunctionBase* f = *it;
-        int64_t node_count = f->node_count();
-        if (node_count == 0) {
-          // This is an empty function.
-          it = bases.erase(it);
-          continue;
-        }
-        node_counts.push_back(node_count);
-        it++;
-      }
-      if (bases.empty()) {
-        LOG(INFO) << "Nothing left to simplify";
-        break;
-      }
-      absl::discrete_distribution<size_t> distribution(node_counts.cbegin(),
-                                                       node_counts.cend());
-      candidate = bases[distribution(rng)];
+    std::optional<FunctionBase*> chosen =
+        ChooseFunctionBase(package.get(), rng);
+    if (!chosen.has_value()) {
+      LOG(INFO) << "Nothing left to simplify";
+      break;
     }
+    FunctionBase* candidate = *chosen;
     std::string candidate_name = candidate->name();
     XLS_VLOG_LINES(2,
                    "=== Candidate for simplification:\n" + candidate->DumpIr());
@@ -1463,14 +1674,7 @@ absl::Status RealMain(std::string_view path, const int64_t failed_attempt_limit,
     candidate_changes.clear();
   }
 
-  std::cout << knownf_ir_text;
-
-  // Run the last test verification without the cache.
-  XLS_RETURN_IF_ERROR(VerifyStillFails(knownf_ir_text, inputs,
-                                       "Minimized function does not fail!",
-                                       /*test_cache=*/nullptr));
-
-  return absl::OkStatus();
+  return OutputMinimizedIr(knownf_ir_text, inputs);
 }
 
 }  // namespace
@@ -1495,9 +1699,14 @@ int main(int argc, char** argv) {
   if (absl::GetFlag(FLAGS_test_optimizer)) {
     test_flags++;
   }
+  if (!absl::GetFlag(FLAGS_test_pass_error).empty()) {
+    test_flags++;
+  }
   QCHECK_EQ(test_flags, 1)
-      << "Must specify exactly one of --test_executable, --test_llvm_jit, or "
-         "--test_optimizer";
+      << "Must specify exactly one of --test_executable, --test_llvm_jit, "
+         "--test_optimizer, or --test_pass_error";
+  QCHECK_GE(absl::GetFlag(FLAGS_parallelism), 1)
+      << "--parallelism must be positive";
 
   if (absl::GetFlag(FLAGS_can_extract_segments)) {
     std::vector<std::string> failures;
@@ -1528,5 +1737,6 @@ int main(int argc, char** argv) {
       positional_arguments[0], absl::GetFlag(FLAGS_failed_attempt_limit),
       absl::GetFlag(FLAGS_total_attempt_limit),
       absl::GetFlag(FLAGS_simplifications_between_tests),
-      absl::GetFlag(FLAGS_failed_attempts_between_tests_limit)));
+      absl::GetFlag(FLAGS_failed_attempts_between_tests_limit),
+      absl::GetFlag(FLAGS_parallelism)));
 }
@@ -347,6 +347,29 @@ class IrMinimizerMainTest(absltest.TestCase):
     self.assertIn('y: bits', minimized_ir)
     self.assertIn('ret myadd', minimized_ir)
 
+  def test_minimize_add_no_remove_params_in_parallel(self):
+    ir_file = self.create_tempfile(content=ADD_IR)
+    test_sh_file = self.create_tempfile()
+    self._write_sh_script(
+        test_sh_file.full_path, ['/usr/bin/env grep myadd $1']
+    )
+    minimized_ir = subprocess.check_output(
+        [
+            IR_MINIMIZER_MAIN_PATH,
+            '--test_executable=' + test_sh_file.full_path,
+            '--can_remove_params=false',
+            '--parallelism=4',
+            ir_file.full_path,
+        ],
+        encoding='utf-8',
+    )
+    self._maybe_record_property('output', minimized_ir)
+    self.assertEqual(function_count(minimized_ir), 1)
+    self.assertEqual(node_count(minimized_ir), 1)
+    self.assertIn('x: bits', minimized_ir)
+    self.assertIn('y: bits', minimized_ir)
+    self.assertIn('ret myadd', minimized_ir)
+
   def test_minimize_add_remove_params(self):
     ir_file = self.create_tempfile(content=ADD_IR)
     test_sh_file = self.create_tempfile()
@@ -703,6 +726,51 @@ top proc foo<input: bits[32] in kind=streaming, output:bits[32] out kind=streami
     self.assertNotEqual(comp.returncode, 0)
     self.assertIn('main function provided does not fail', comp.stderr)
 
+  def test_minimize_pass_error(self):
+    # Channel legalization rejects sends on a totally-ordered channel which are
+    # not ordered by tokens.
+    input_ir = '''package foo
+
+chan out(bits[32], id=0, kind=streaming, ops=send_only, flow_control=ready_valid, strictness=total_order, metadata="""""")
+
+top proc foo(__state: bits[32], init={0}) {
+  __token: token = literal(value=token, id=1)
+  literal.2: bits[32] = literal(value=1, id=2)
+  add.3: bits[32] = add(__state, literal.2, id=3)
+  umul.4: bits[32] = umul(__state, add.3, id=4)
+  send.5: token = send(__token, __state, channel=out, id=5)
+  send.6: token = send(__token, umul.4, channel=out, id=6)
+  next (add.3)
+}
+'''
+    ir_file = self.create_tempfile(content=input_ir)
+    minimized_ir = subprocess.check_output(
+        [
+            IR_MINIMIZER_MAIN_PATH,
+            '--test_pass_error=channel_legalization',
+            ir_file.full_path,
+        ],
+        encoding='utf-8',
+    )
+    self._maybe_record_property('output', minimized_ir)
+    self.assertEqual(node_count(minimized_ir, 'send'), 2)
+    self.assertLess(node_count(minimized_ir), node_count(input_ir))
+
+  def test_minimize_pass_error_bad_pipeline(self):
+    ir_file = self.create_tempfile(content=ADD_IR)
+    comp = subprocess.run(
+        [
+            IR_MINIMIZER_MAIN_PATH,
+            '--test_pass_error=dce not_a_real_pass',
+            ir_file.full_path,
+        ],
+        encoding='utf-8',
+        stderr=subprocess.PIPE,
+        check=False,
+    )
+    self.assertNotEqual(comp.returncode, 0)
+    self.assertIn("Unable to add pass 'not_a_real_pass'", comp.stderr)
+
   def test_remove_userless_sideeffecting_op(self):
     input_ir = """package foo
 
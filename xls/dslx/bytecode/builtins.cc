@@ -93,12 +93,15 @@ absl::Status RunBuiltinSlice(const Bytecode& bytecode,
 
 absl::Status RunBuiltinUpdate(const Bytecode& bytecode,
                               InterpreterStack& stack) {
-  return RunTernaryBuiltin(
-      [](const InterpValue& array, const InterpValue& index,
-         const InterpValue& new_value) {
-        return array.Update(index, new_value);
-      },
-      stack);
+  // The array is owned by the stack, so it can be updated in place rather than
+  // copied.
+  XLS_RET_CHECK_GE(stack.size(), 3);
+  XLS_ASSIGN_OR_RETURN(InterpValue new_value, stack.Pop());
+  XLS_ASSIGN_OR_RETURN(InterpValue index, stack.Pop());
+  XLS_ASSIGN_OR_RETURN(InterpValue array, stack.Pop());
+  XLS_RETURN_IF_ERROR(array.UpdateInPlace(index, std::move(new_value)));
+  stack.Push(std::move(array));
+  return absl::OkStatus();
 }
 
 absl::Status RunBuiltinBitSlice(const Bytecode& bytecode,
@@ -24,6 +24,8 @@
 #include <variant>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
@@ -747,6 +749,140 @@ absl::StatusOr<std::vector<Bytecode>> BytecodesFromString(
   return result;
 }
 
+namespace {
+
+// Appends the slots read by the given match arm item (and its sub-items) to
+// `slots`.
+void CollectMatchArmLoads(const Bytecode::MatchArmItem& item,
+                          std::vector<int64_t>& slots) {
+  if (item.kind() == Bytecode::MatchArmItem::Kind::kLoad) {
+    absl::StatusOr<Bytecode::SlotIndex> slot = item.slot_index();
+    if (slot.ok()) {
+      slots.push_back(slot->value());
+    }
+  } else if (item.kind() == Bytecode::MatchArmItem::Kind::kTuple) {
+    absl::StatusOr<std::vector<Bytecode::MatchArmItem>> elements =
+        item.tuple_elements();
+    if (elements.ok()) {
+      for (const Bytecode::MatchArmItem& element : *elements) {
+        CollectMatchArmLoads(element, slots);
+      }
+    }
+  }
+}
+
+// Returns the PCs of the kLoad bytecodes after which the loaded slot is dead,
+// i.e., not read again before being overwritten (or the function ending) on
+// any path. This is a per-slot backwards liveness analysis over the control
+// flow graph induced by the relative jumps; the work done is proportional to
+// the live ranges of the slots rather than to #bytecodes * #slots.
+//
+// The analysis is conservative: stores performed by match arms are not
+// treated as killing a slot, and bytecodes which end execution (e.g. kFail)
+// are treated as falling through.
+absl::flat_hash_set<int64_t> FindFinalLoads(
+    absl::Span<const Bytecode> bytecodes) {
+  const int64_t size = bytecodes.size();
+  std::vector<std::vector<int64_t>> predecessors(size);
+  // Reads and writes of each slot, keyed by slot index.
+  absl::flat_hash_map<int64_t, std::vector<int64_t>> uses;
+  absl::flat_hash_map<int64_t, std::vector<int64_t>> loads;
+  std::vector<std::optional<int64_t>> stored_slot(size);
+  auto add_edge = [&](int64_t from, int64_t to) {
+    if (to >= 0 && to < size) {
+      predecessors[to].push_back(from);
+    }
+  };
+  for (int64_t pc = 0; pc < size; ++pc) {
+    const Bytecode& bytecode = bytecodes[pc];
+    switch (bytecode.op()) {
+      case Bytecode::Op::kJumpRel:
+      case Bytecode::Op::kJumpRelIf: {
+        absl::StatusOr<Bytecode::JumpTarget> target = bytecode.jump_target();
+        if (target.ok()) {
+          add_edge(pc, pc + target->value());
+        }
+        if (bytecode.op() == Bytecode::Op::kJumpRelIf || !target.ok()) {
+          add_edge(pc, pc + 1);
+        }
+        continue;
+      }
+      case Bytecode::Op::kLoad: {
+        absl::StatusOr<Bytecode::SlotIndex> slot = bytecode.slot_index();
+        if (slot.ok()) {
+          uses[slot->value()].push_back(pc);
+          loads[slot->value()].push_back(pc);
+        }
+        break;
+      }
+      case Bytecode::Op::kStore: {
+        absl::StatusOr<Bytecode::SlotIndex> slot = bytecode.slot_index();
+        if (slot.ok()) {
+          stored_slot[pc] = slot->value();
+        }
+        break;
+      }
+      case Bytecode::Op::kMatchArm: {
+        absl::StatusOr<const Bytecode::MatchArmItem*> item =
+            bytecode.match_arm_item();
+        if (item.ok()) {
+          std::vector<int64_t> slots;
+          CollectMatchArmLoads(**item, slots);
+          for (int64_t slot : slots) {
+            uses[slot].push_back(pc);
+          }
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    add_edge(pc, pc + 1);
+  }
+
+  // `live_in[pc] == slot` indicates that `slot` is live on entry to `pc`, and
+  // likewise for `live_out`. Tagging with the slot index lets the vectors be
+  // reused across slots without clearing.
+  std::vector<int64_t> live_in(size, -1);
+  std::vector<int64_t> live_out(size, -1);
+  absl::flat_hash_set<int64_t> final_loads;
+  for (const auto& [slot, slot_uses] : uses) {
+    std::vector<int64_t> worklist;
+    for (int64_t pc : slot_uses) {
+      if (live_in[pc] != slot) {
+        live_in[pc] = slot;
+        worklist.push_back(pc);
+      }
+    }
+    while (!worklist.empty()) {
+      int64_t pc = worklist.back();
+      worklist.pop_back();
+      for (int64_t pred : predecessors[pc]) {
+        if (live_out[pred] == slot) {
+          continue;
+        }
+        live_out[pred] = slot;
+        if (stored_slot[pred] != slot && live_in[pred] != slot) {
+          live_in[pred] = slot;
+          worklist.push_back(pred);
+        }
+      }
+    }
+    auto it = loads.find(slot);
+    if (it == loads.end()) {
+      continue;
+    }
+    for (int64_t pc : it->second) {
+      if (live_out[pc] != slot) {
+        final_loads.insert(pc);
+      }
+    }
+  }
+  return final_loads;
+}
+
+}  // namespace
+
 absl::StatusOr<std::unique_ptr<BytecodeFunction>> BytecodeFunction::Create(
     const Module* owner, const Function* source_fn, const TypeInfo* type_info,
     std::vector<Bytecode> bytecodes) {
@@ -761,7 +897,8 @@ BytecodeFunction::BytecodeFunction(const Module* owner,
     : owner_(owner),
       source_fn_(source_fn),
       type_info_(type_info),
-      bytecodes_(std::move(bytecodes)) {}
+      bytecodes_(std::move(bytecodes)),
+      final_loads_(FindFinalLoads(bytecodes_)) {}
 
 std::vector<Bytecode> BytecodeFunction::CloneBytecodes() const {
   // Create a modifiable copy of the bytecodes.
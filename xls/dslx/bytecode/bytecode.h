@@ -23,6 +23,7 @@
 #include <variant>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "xls/common/strong_int.h"
@@ -488,6 +489,11 @@ class BytecodeFunction {
   const TypeInfo* type_info() const { return type_info_; }
   const std::vector<Bytecode>& bytecodes() const { return bytecodes_; }
 
+  // Returns true if the bytecode at `pc` is a kLoad which is the last read of
+  // its slot on every path through the function, i.e., the slot's value may be
+  // moved onto the stack rather than copied.
+  bool IsFinalLoad(int64_t pc) const { return final_loads_.contains(pc); }
+
   // Creates and returns a [caller-owned] copy of the internal bytecodes.
   std::vector<Bytecode> CloneBytecodes() const;
 
@@ -499,6 +505,7 @@ class BytecodeFunction {
   const Function* source_fn_;
   const TypeInfo* type_info_;
   std::vector<Bytecode> bytecodes_;
+  absl::flat_hash_set<int64_t> final_loads_;
 };
 
 // Converts the given sequence of bytecodes to a more human-readable string,
@@ -18,8 +18,10 @@
 #include <optional>
 #include <tuple>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/dslx/bytecode/bytecode.h"
 #include "xls/dslx/bytecode/bytecode_cache_interface.h"
 #include "xls/dslx/frontend/ast.h"
@@ -29,6 +31,8 @@
 
 namespace xls::dslx {
 
+// Thread-safe, so one cache may be shared by interpreters running
+// concurrently against the same ImportData.
 class BytecodeCache : public BytecodeCacheInterface {
  public:
   explicit BytecodeCache(ImportData* import_data);
@@ -42,7 +46,9 @@ class BytecodeCache : public BytecodeCacheInterface {
                          std::optional<ParametricEnv>>;
 
   ImportData* import_data_;
-  absl::flat_hash_map<Key, std::unique_ptr<BytecodeFunction>> cache_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Key, std::unique_ptr<BytecodeFunction>> cache_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace xls::dslx
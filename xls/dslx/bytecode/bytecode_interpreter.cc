@@ -214,7 +214,11 @@ absl::Status BytecodeInterpreter::Run(bool* progress_made) {
 
       if (bytecode.op() == Bytecode::Op::kCall) {
         frame = &frames_.back();
-      } else if (frame->pc() != old_pc + 1) {
+      } else if (frame->pc() != old_pc + 1 &&
+                 !(bytecode.op() == Bytecode::Op::kLoad &&
+                   frame->pc() == old_pc + kFusedLoadIndexLength)) {
+        // Note: in the optimized tier a load may be fused with the bytecodes
+        // which follow it, in which case the PC advances past all of them.
         XLS_RET_CHECK(bytecodes.at(frame->pc()).op() == Bytecode::Op::kJumpDest)
             << "Jumping from PC " << old_pc << " to PC: " << frame->pc()
             << " bytecode: " << bytecodes.at(frame->pc()).ToString(file_table())
@@ -257,7 +261,7 @@ BytecodeInterpreter::PopArgsRightToLeft(size_t count) {
   std::vector<InterpValue> args(count, InterpValue::MakeToken());
   for (int i = 0; i < count; i++) {
     XLS_ASSIGN_OR_RETURN(InterpValue arg, Pop());
-    args[count - i - 1] = arg;
+    args[count - i - 1] = std::move(arg);
   }
   return args;
 }
@@ -730,12 +734,13 @@ absl::Status BytecodeInterpreter::EvalCreateArray(const Bytecode& bytecode) {
   elements.reserve(array_size.value());
   for (int64_t i = 0; i < array_size.value(); i++) {
     XLS_ASSIGN_OR_RETURN(InterpValue value, Pop());
-    elements.push_back(value);
+    elements.push_back(std::move(value));
   }
 
   std::reverse(elements.begin(), elements.end());
-  XLS_ASSIGN_OR_RETURN(InterpValue array, InterpValue::MakeArray(elements));
-  stack_.Push(array);
+  XLS_ASSIGN_OR_RETURN(InterpValue array,
+                       InterpValue::MakeArray(std::move(elements)));
+  stack_.Push(std::move(array));
   return absl::OkStatus();
 }
 
@@ -748,12 +753,12 @@ absl::Status BytecodeInterpreter::EvalCreateTuple(const Bytecode& bytecode) {
   elements.reserve(tuple_size.value());
   for (int64_t i = 0; i < tuple_size.value(); i++) {
     XLS_ASSIGN_OR_RETURN(InterpValue value, Pop());
-    elements.push_back(value);
+    elements.push_back(std::move(value));
   }
 
   std::reverse(elements.begin(), elements.end());
 
-  stack_.Push(InterpValue::MakeTuple(elements));
+  stack_.Push(InterpValue::MakeTuple(std::move(elements)));
   return absl::OkStatus();
 }
 
@@ -817,12 +822,12 @@ absl::Status BytecodeInterpreter::EvalExpandTuple(const Bytecode& bytecode) {
   }
 
   // Note that we destructure the tuple in "reverse" order, with the first
-  // element on top of the stack.
-  XLS_ASSIGN_OR_RETURN(int64_t tuple_size, tuple.GetLength());
-  for (int64_t i = tuple_size - 1; i >= 0; i--) {
-    XLS_ASSIGN_OR_RETURN(InterpValue element,
-                         tuple.Index(InterpValue::MakeUBits(64, i)));
-    stack_.Push(element);
+  // element on top of the stack. The tuple is owned here so its elements can
+  // be moved rather than copied.
+  XLS_ASSIGN_OR_RETURN(std::vector<InterpValue> elements,
+                       std::move(tuple).TakeValues());
+  for (auto it = elements.rbegin(); it != elements.rend(); ++it) {
+    stack_.Push(std::move(*it));
   }
 
   return absl::OkStatus();
@@ -848,39 +853,42 @@ absl::Status BytecodeInterpreter::EvalGt(const Bytecode& bytecode) {
   });
 }
 
-absl::Status BytecodeInterpreter::EvalTupleIndex(const Bytecode& bytecode) {
-  XLS_ASSIGN_OR_RETURN(InterpValue index, Pop());
-  XLS_ASSIGN_OR_RETURN(InterpValue basis, Pop());
-
-  if (!basis.IsTuple()) {
+absl::StatusOr<InterpValue> BytecodeInterpreter::IndexBasis(
+    const Bytecode& bytecode, const InterpValue& basis,
+    const InterpValue& index) {
+  if (bytecode.op() == Bytecode::Op::kTupleIndex) {
+    if (!basis.IsTuple()) {
+      return absl::InternalError(
+          "BytecodeInterpreter type error: tuple_index bytecode can only index "
+          "on tuple value; got: " +
+          basis.ToString());
+    }
+  } else if (!basis.IsArray() && !basis.IsTuple()) {
     return absl::InternalError(
-        "BytecodeInterpreter type error: tuple_index bytecode can only index "
-        "on tuple value; got: " +
+        "BytecodeInterpreter type error: can only index on array or tuple "
+        "values; got: " +
         basis.ToString());
   }
 
   XLS_ASSIGN_OR_RETURN(
       InterpValue result, basis.Index(index),
       _ << " while processing " << bytecode.ToString(file_table()));
-  stack_.Push(result);
+  return result;
+}
+
+absl::Status BytecodeInterpreter::EvalTupleIndex(const Bytecode& bytecode) {
+  XLS_ASSIGN_OR_RETURN(InterpValue index, Pop());
+  XLS_ASSIGN_OR_RETURN(InterpValue basis, Pop());
+  XLS_ASSIGN_OR_RETURN(InterpValue result, IndexBasis(bytecode, basis, index));
+  stack_.Push(std::move(result));
   return absl::OkStatus();
 }
 
 absl::Status BytecodeInterpreter::EvalIndex(const Bytecode& bytecode) {
   XLS_ASSIGN_OR_RETURN(InterpValue index, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue basis, Pop());
-
-  if (!basis.IsArray() && !basis.IsTuple()) {
-    return absl::InternalError(
-        "BytecodeInterpreter type error: can only index on array or tuple "
-        "values; got: " +
-        basis.ToString());
-  }
-
-  XLS_ASSIGN_OR_RETURN(
-      InterpValue result, basis.Index(index),
-      _ << " while processing " << bytecode.ToString(file_table()));
-  stack_.Push(result);
+  XLS_ASSIGN_OR_RETURN(InterpValue result, IndexBasis(bytecode, basis, index));
+  stack_.Push(std::move(result));
   return absl::OkStatus();
 }
 
@@ -907,15 +915,76 @@ absl::Status BytecodeInterpreter::EvalLiteral(const Bytecode& bytecode) {
 
 absl::Status BytecodeInterpreter::EvalLoad(const Bytecode& bytecode) {
   XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot, bytecode.slot_index());
-  if (frames_.back().slots().size() <= slot.value()) {
+  Frame& frame = frames_.back();
+  if (frame.slots().size() <= slot.value()) {
     return absl::InternalError(absl::StrFormat(
         "Attempted to access local data in slot %d, which is out of range.",
         slot.value()));
   }
-  stack_.Push(frames_.back().slots().at(slot.value()));
+  InterpValue& value = frame.slots()[slot.value()];
+  if (options_.tier() == BytecodeTier::kOptimized) {
+    if (frame.bf()->IsFinalLoad(frame.pc())) {
+      // Nothing reads the slot again before it is overwritten, so its value
+      // can be handed to the stack without a copy.
+      stack_.Push(std::move(value));
+      return absl::OkStatus();
+    }
+    XLS_ASSIGN_OR_RETURN(bool fused, EvalFusedLoadIndex(value));
+    if (fused) {
+      return absl::OkStatus();
+    }
+  }
+  stack_.Push(value);
   return absl::OkStatus();
 }
 
+absl::StatusOr<bool> BytecodeInterpreter::EvalFusedLoadIndex(
+    const InterpValue& basis) {
+  // Matches the sequence:
+  //
+  //   load <basis slot>
+  //   literal <index> | load <index slot>
+  //   index | tuple_index
+  //
+  // and indexes directly into the basis slot rather than copying the whole
+  // aggregate onto the stack first.
+  Frame& frame = frames_.back();
+  const std::vector<Bytecode>& bytecodes = frame.bf()->bytecodes();
+  int64_t pc = frame.pc();
+  if (pc + kFusedLoadIndexLength > bytecodes.size()) {
+    return false;
+  }
+  const Bytecode& index_bytecode = bytecodes[pc + 1];
+  const Bytecode& op_bytecode = bytecodes[pc + 2];
+  if (op_bytecode.op() != Bytecode::Op::kIndex &&
+      op_bytecode.op() != Bytecode::Op::kTupleIndex) {
+    return false;
+  }
+  std::optional<InterpValue> literal;
+  const InterpValue* index;
+  if (index_bytecode.op() == Bytecode::Op::kLiteral) {
+    XLS_ASSIGN_OR_RETURN(literal, index_bytecode.value_data());
+    index = &literal.value();
+  } else if (index_bytecode.op() == Bytecode::Op::kLoad) {
+    XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot,
+                         index_bytecode.slot_index());
+    if (frame.slots().size() <= slot.value()) {
+      // Let the unfused path report the error.
+      return false;
+    }
+    index = &frame.slots()[slot.value()];
+  } else {
+    return false;
+  }
+
+  XLS_ASSIGN_OR_RETURN(InterpValue result,
+                       IndexBasis(op_bytecode, basis, *index));
+  stack_.Push(std::move(result));
+  // Skip the index bytecodes; the caller advances past the last one.
+  frame.set_pc(pc + kFusedLoadIndexLength - 1);
+  return true;
+}
+
 absl::Status BytecodeInterpreter::EvalLogicalAnd(const Bytecode& bytecode) {
   XLS_ASSIGN_OR_RETURN(InterpValue rhs, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue lhs, Pop());
@@ -1279,7 +1348,7 @@ absl::Status BytecodeInterpreter::EvalStore(const Bytecode& bytecode) {
   }
 
   XLS_ASSIGN_OR_RETURN(InterpValue value, Pop());
-  frames_.back().StoreSlot(slot, value);
+  frames_.back().StoreSlot(slot, std::move(value));
   return absl::OkStatus();
 }
 
@@ -152,11 +152,22 @@ class BytecodeInterpreter {
   absl::Status EvalGe(const Bytecode& bytecode);
   absl::Status EvalGt(const Bytecode& bytecode);
   absl::Status EvalIndex(const Bytecode& bytecode);
+  // Helper for kIndex and kTupleIndex: checks `basis` can be indexed by the
+  // given bytecode and returns the selected element.
+  absl::StatusOr<InterpValue> IndexBasis(const Bytecode& bytecode,
+                                         const InterpValue& basis,
+                                         const InterpValue& index);
   absl::Status EvalTupleIndex(const Bytecode& bytecode);
   absl::Status EvalInvert(const Bytecode& bytecode);
   absl::Status EvalLe(const Bytecode& bytecode);
   absl::Status EvalLiteral(const Bytecode& bytecode);
   absl::Status EvalLoad(const Bytecode& bytecode);
+  // Optimized-tier fusion of a load immediately followed by an index of the
+  // loaded value; returns whether the fusion applied, in which case the frame
+  // PC is left on the final bytecode of the fused sequence.
+  absl::StatusOr<bool> EvalFusedLoadIndex(const InterpValue& basis);
+  // Number of bytecodes consumed by a fused load/index sequence.
+  static constexpr int64_t kFusedLoadIndexLength = 3;
   absl::Status EvalLogicalAnd(const Bytecode& bytecode);
   absl::Status EvalLogicalOr(const Bytecode& bytecode);
   absl::Status EvalLt(const Bytecode& bytecode);
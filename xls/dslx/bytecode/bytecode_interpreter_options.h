@@ -40,6 +40,20 @@ using TraceHook =
 
 using RolloverHook = std::function<void(const Span&)>;
 
+// Selects how the interpreter executes bytecode. Both tiers produce identical
+// results; the reference tier is kept so the two can be compared.
+enum class BytecodeTier : uint8_t {
+  // Every bytecode is executed as a discrete stack operation; loads copy the
+  // value held in a frame slot onto the stack.
+  kReference,
+  // Loads which are the final read of a slot (see
+  // `BytecodeFunction::IsFinalLoad`) move the value out of the slot, and a
+  // load which is immediately indexed reads the element straight out of the
+  // slot. Together these avoid copying arrays and tuples held in locals, e.g.
+  // on every iteration of a `for` loop or on `update` of a loop accumulator.
+  kOptimized,
+};
+
 class BytecodeInterpreterOptions {
  public:
   // Callback to invoke after a DSLX function is evaluated by the interpreter.
@@ -97,6 +111,12 @@ class BytecodeInterpreterOptions {
   }
   FormatPreference format_preference() const { return format_preference_; }
 
+  BytecodeInterpreterOptions& tier(BytecodeTier value) {
+    tier_ = value;
+    return *this;
+  }
+  BytecodeTier tier() const { return tier_; }
+
  private:
   PostFnEvalHook post_fn_eval_hook_ = nullptr;
   TraceHook trace_hook_ = nullptr;
@@ -105,6 +125,7 @@ class BytecodeInterpreterOptions {
   std::optional<int64_t> max_ticks_;
   bool validate_final_stack_depth_ = true;
   FormatPreference format_preference_ = FormatPreference::kDefault;
+  BytecodeTier tier_ = BytecodeTier::kReference;
 };
 
 }  // namespace xls::dslx
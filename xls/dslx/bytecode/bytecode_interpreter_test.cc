@@ -202,6 +202,76 @@ TEST_F(BytecodeInterpreterTest, DupEmptyStack) {
                ::testing::HasSubstr("!stack_.empty()")));
 }
 
+TEST_F(BytecodeInterpreterTest, FinalLoads) {
+  std::vector<Bytecode> bytecodes;
+  bytecodes.emplace_back(kFakeSpan, Bytecode::Op::kLoad,
+                         Bytecode::SlotIndex(0));
+  bytecodes.emplace_back(kFakeSpan, Bytecode::Op::kLoad,
+                         Bytecode::SlotIndex(0));
+  bytecodes.emplace_back(kFakeSpan, Bytecode::Op::kStore,
+                         Bytecode::SlotIndex(1));
+  bytecodes.emplace_back(kFakeSpan, Bytecode::Op::kJumpDest);
+  bytecodes.emplace_back(kFakeSpan, Bytecode::Op::kLoad,
+                         Bytecode::SlotIndex(1));
+  bytecodes.emplace_back(kFakeSpan, Bytecode::Op::kJumpRelIf,
+                         Bytecode::JumpTarget(-2));
+  bytecodes.emplace_back(kFakeSpan, Bytecode::Op::kLoad,
+                         Bytecode::SlotIndex(1));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto bfunc,
+      BytecodeFunction::Create(/*owner=*/nullptr, /*source_fn=*/nullptr,
+                               /*type_info=*/nullptr, std::move(bytecodes)));
+  EXPECT_FALSE(bfunc->IsFinalLoad(0));
+  EXPECT_TRUE(bfunc->IsFinalLoad(1));
+  // Slot 1 is read again on the loop back edge.
+  EXPECT_FALSE(bfunc->IsFinalLoad(4));
+  EXPECT_TRUE(bfunc->IsFinalLoad(6));
+}
+
+TEST_F(BytecodeInterpreterTest, OptimizedTierMatchesReference) {
+  constexpr std::string_view kProgram = R"(
+fn main(x: u32) -> (u32[4], u32, u32) {
+  let a = u32[4]:[1, 2, 3, 4];
+  let t = (x, a);
+  let acc = for (i, acc): (u32, u32[4]) in u32:0..u32:4 {
+    update(acc, i, acc[i] + a[i] + t.0)
+  }(a);
+  let y = match acc[u32:0] {
+    u32:2 => a[1],
+    _ => t.1[3],
+  };
+  let (z, _) = t;
+  (acc, y, z + acc[3])
+})";
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpValue acc,
+      InterpValue::MakeArray(
+          {InterpValue::MakeU32(12), InterpValue::MakeU32(14),
+           InterpValue::MakeU32(16), InterpValue::MakeU32(18)}));
+  InterpValue expected = InterpValue::MakeTuple(
+      {acc, InterpValue::MakeU32(4), InterpValue::MakeU32(28)});
+  for (BytecodeTier tier :
+       {BytecodeTier::kReference, BytecodeTier::kOptimized}) {
+    EXPECT_THAT(Interpret(kProgram, "main", {InterpValue::MakeU32(10)},
+                          BytecodeInterpreterOptions().tier(tier)),
+                IsOkAndHolds(expected));
+  }
+}
+
+TEST_F(BytecodeInterpreterTest, OptimizedTierNestedIndex) {
+  constexpr std::string_view kProgram = R"(
+fn main() -> u32 {
+  let a = u32[2]:[1, 2];
+  let t = (a, u32:3);
+  t.0[1] + t.1
+})";
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpValue result,
+      Interpret(kProgram, "main", {},
+                BytecodeInterpreterOptions().tier(BytecodeTier::kOptimized)));
+  EXPECT_EQ(result, InterpValue::MakeU32(5));
+}
+
 TEST_F(BytecodeInterpreterTest, TraceBitsValueDefaultFormat) {
   constexpr std::string_view kProgram = R"(
 fn main() -> () {
@@ -34,6 +34,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/time/time.h"
 #include "absl/types/variant.h"
 #include "xls/common/casts.h"
 #include "xls/common/status/ret_check.h"
@@ -43,6 +44,7 @@
 #include "xls/dslx/bytecode/bytecode_emitter.h"
 #include "xls/dslx/bytecode/bytecode_interpreter.h"
 #include "xls/dslx/bytecode/bytecode_interpreter_options.h"
+#include "xls/dslx/constexpr_value_cache.h"
 #include "xls/dslx/errors.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/ast_utils.h"
@@ -686,6 +688,17 @@ absl::Status ConstexprEvaluator::InterpretExpr(const Expr* expr) {
       env, MakeConstexprEnv(import_data_, type_info_, warning_collector_, expr,
                             bindings_));
 
+  ConstexprValueCache& cache = import_data_->constexpr_value_cache();
+  std::optional<ConstexprValueCache::Key> key =
+      ConstexprValueCache::MakeKey(expr, bindings_, type_, env);
+  if (key.has_value()) {
+    if (std::optional<InterpValue> cached = cache.Lookup(*key)) {
+      type_info_->NoteConstExpr(expr, *std::move(cached));
+      return absl::OkStatus();
+    }
+  }
+  const absl::Time start = absl::Now();
+
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<BytecodeFunction> bf,
                        BytecodeEmitter::EmitExpression(import_data_, type_info_,
                                                        expr, env, bindings_));
@@ -703,6 +716,9 @@ absl::Status ConstexprEvaluator::InterpretExpr(const Expr* expr) {
           "constexpr evaluation detected rollover in operation");
     }
   }
+  if (key.has_value() && ConstexprValueCache::IsCacheable(constexpr_value)) {
+    cache.Insert(*std::move(key), constexpr_value, absl::Now() - start);
+  }
   type_info_->NoteConstExpr(expr, constexpr_value);
 
   return absl::OkStatus();
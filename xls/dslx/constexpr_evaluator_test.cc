@@ -29,6 +29,7 @@
 #include "xls/common/casts.h"
 #include "xls/common/status/matchers.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/dslx/constexpr_value_cache.h"
 #include "xls/dslx/create_import_data.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/parser.h"
@@ -680,5 +681,82 @@ fn main() -> u32 {
   EXPECT_EQ(value.GetBitValueViaSign().value(), 8);
 }
 
+TEST(ConstexprEvaluatorTest, RepeatedEvaluationReusesValue) {
+  constexpr std::string_view kModule = R"(
+const TABLE = u8[4]:[u8:1, u8:2, u8:3, u8:4];
+
+fn Foo() -> u8 {
+  TABLE[u32:2]
+}
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(TestData test_data, CreateTestData(kModule));
+  Module* module = test_data.module.get();
+  TypeInfo* type_info = test_data.type_info;
+  ImportData* import_data = test_data.import_data.get();
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f,
+                           module->GetMemberOrError<Function>("Foo"));
+  Expr* index = GetSingleBodyExpr(f);
+  XLS_ASSERT_OK_AND_ASSIGN(Type * type, GetType(type_info, index));
+
+  auto evaluate = [&]() -> absl::StatusOr<InterpValue> {
+    return ConstexprEvaluator::EvaluateToValue(import_data, type_info,
+                                               /*warning_collector=*/nullptr,
+                                               ParametricEnv(), index, type);
+  };
+  EXPECT_THAT(evaluate(), IsOkAndHolds(InterpValue::MakeUBits(8, 3)));
+
+  // The second evaluation is served from the cache.
+  const ConstexprValueCacheStats before =
+      import_data->constexpr_value_cache().stats();
+  EXPECT_THAT(evaluate(), IsOkAndHolds(InterpValue::MakeUBits(8, 3)));
+  const ConstexprValueCacheStats after =
+      import_data->constexpr_value_cache().stats();
+  EXPECT_EQ(after.hits, before.hits + 1);
+  EXPECT_EQ(after.misses, before.misses);
+}
+
+TEST(ConstexprEvaluatorTest, CacheKeyIsStructural) {
+  constexpr std::string_view kModule = R"(
+const A = u32:1;
+
+fn Foo() -> u32 {
+  A + u32:1
+}
+
+fn Bar() -> u32 {
+  A + u32:1
+}
+
+fn Baz(A: u32) -> u32 {
+  A + u32:1
+}
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(TestData test_data, CreateTestData(kModule));
+  Module* module = test_data.module.get();
+
+  auto make_key = [&](std::string_view function_name)
+      -> absl::StatusOr<ConstexprValueCache::Key> {
+    XLS_ASSIGN_OR_RETURN(Function * f,
+                         module->GetMemberOrError<Function>(function_name));
+    std::optional<ConstexprValueCache::Key> key = ConstexprValueCache::MakeKey(
+        GetSingleBodyExpr(f), ParametricEnv(), /*type=*/nullptr, /*env=*/{});
+    if (!key.has_value()) {
+      return absl::InternalError("Expression has no cache key");
+    }
+    return *std::move(key);
+  };
+  XLS_ASSERT_OK_AND_ASSIGN(ConstexprValueCache::Key foo, make_key("Foo"));
+  XLS_ASSERT_OK_AND_ASSIGN(ConstexprValueCache::Key bar, make_key("Bar"));
+  XLS_ASSERT_OK_AND_ASSIGN(ConstexprValueCache::Key baz, make_key("Baz"));
+
+  // Identical expressions at different sites share a key, unless their names
+  // resolve to different definitions.
+  EXPECT_TRUE(foo == bar);
+  EXPECT_FALSE(foo == baz);
+}
+
 }  // namespace
 }  // namespace xls::dslx
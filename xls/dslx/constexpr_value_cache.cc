@@ -0,0 +1,179 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/constexpr_value_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "xls/dslx/frontend/ast.h"
+#include "xls/dslx/frontend/module.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/dslx/type_system/parametric_env.h"
+#include "xls/dslx/type_system/type.h"
+
+namespace xls::dslx {
+namespace {
+
+// Stricter than `InterpValue::Eq`, which e.g. considers `u8:1` and `s8:1`
+// equal; values that are identical here evaluate identically.
+bool Identical(const InterpValue& lhs, const InterpValue& rhs) {
+  if (lhs.tag() != rhs.tag()) {
+    return false;
+  }
+  if (std::optional<InterpValue::EnumData> lhs_enum = lhs.GetEnumData()) {
+    std::optional<InterpValue::EnumData> rhs_enum = rhs.GetEnumData();
+    return lhs_enum->def == rhs_enum->def &&
+           lhs_enum->value == rhs_enum->value;
+  }
+  if (lhs.HasBits()) {
+    return lhs.GetBitsOrDie() == rhs.GetBitsOrDie();
+  }
+  const std::vector<InterpValue>& lhs_elements = lhs.GetValuesOrDie();
+  const std::vector<InterpValue>& rhs_elements = rhs.GetValuesOrDie();
+  if (lhs_elements.size() != rhs_elements.size()) {
+    return false;
+  }
+  for (int64_t i = 0; i < lhs_elements.size(); ++i) {
+    if (!Identical(lhs_elements[i], rhs_elements[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Appends the definitions referred to by the name and type references in the
+// tree rooted at `node` to `resolutions`.
+void CollectResolutions(const AstNode* node,
+                        std::vector<const void*>& resolutions) {
+  if (const auto* name_ref = dynamic_cast<const NameRef*>(node)) {
+    resolutions.push_back(
+        std::visit([](const auto* def) -> const void* { return def; },
+                   name_ref->name_def()));
+  } else if (const auto* type_ref = dynamic_cast<const TypeRef*>(node)) {
+    resolutions.push_back(
+        std::visit([](const auto* def) -> const void* { return def; },
+                   type_ref->type_definition()));
+  }
+  for (const AstNode* child : node->GetChildren(/*want_types=*/true)) {
+    CollectResolutions(child, resolutions);
+  }
+}
+
+}  // namespace
+
+std::string ConstexprValueCacheStats::ToString() const {
+  return absl::StrFormat("%d hits, %d misses, %s saved", hits, misses,
+                         absl::FormatDuration(time_saved));
+}
+
+bool operator==(const ConstexprValueCache::Key& lhs,
+                const ConstexprValueCache::Key& rhs) {
+  if (lhs.module_ != rhs.module_ || lhs.text_ != rhs.text_ ||
+      lhs.resolutions_ != rhs.resolutions_ || lhs.bindings_ != rhs.bindings_ || lhs.type_ != rhs.type_ ||
+      lhs.env_.size() != rhs.env_.size()) {
+    return false;
+  }
+  for (int64_t i = 0; i < lhs.env_.size(); ++i) {
+    if (lhs.env_[i].first != rhs.env_[i].first ||
+        !Identical(lhs.env_[i].second, rhs.env_[i].second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* static */ std::optional<ConstexprValueCache::Key>
+ConstexprValueCache::MakeKey(
+    const Expr* expr, const ParametricEnv& bindings, const Type* type,
+    const absl::flat_hash_map<std::string, InterpValue>& env) {
+  Key key;
+  key.module_ = expr->owner();
+  key.text_ = expr->ToString();
+  CollectResolutions(expr, key.resolutions_);
+  key.bindings_ = bindings;
+  if (type != nullptr) {
+    key.type_ = type->ToString();
+  }
+  key.env_.reserve(env.size());
+  for (const auto& [name, value] : env) {
+    if (!IsCacheable(value)) {
+      return std::nullopt;
+    }
+    key.env_.push_back({name, value});
+  }
+  std::sort(key.env_.begin(), key.env_.end(),
+            [](const auto& lhs, const auto& rhs) {
+              return lhs.first < rhs.first;
+            });
+  return key;
+}
+
+/* static */ bool ConstexprValueCache::IsCacheable(const InterpValue& value) {
+  if (value.HasBits()) {
+    return true;
+  }
+  if (!value.IsArray() && !value.IsTuple()) {
+    return false;
+  }
+  return std::all_of(value.GetValuesOrDie().begin(),
+                     value.GetValuesOrDie().end(), IsCacheable);
+}
+
+std::optional<InterpValue> ConstexprValueCache::Lookup(const Key& key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++stats_.misses;
+    return std::nullopt;
+  }
+  ++stats_.hits;
+  stats_.time_saved += it->second.elapsed;
+  return it->second.value;
+}
+
+void ConstexprValueCache::Insert(Key key, InterpValue value,
+                                 absl::Duration elapsed) {
+  absl::MutexLock lock(&mutex_);
+  entries_.emplace(std::move(key), Entry{std::move(value), elapsed});
+}
+
+void ConstexprValueCache::EraseModulesExcept(
+    const absl::flat_hash_set<const Module*>& live_modules) {
+  absl::MutexLock lock(&mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (live_modules.contains(it->first.module_)) {
+      ++it;
+    } else {
+      entries_.erase(it++);
+    }
+  }
+}
+
+ConstexprValueCacheStats ConstexprValueCache::stats() const {
+  absl::MutexLock lock(&mutex_);
+  return stats_;
+}
+
+}  // namespace xls::dslx
@@ -0,0 +1,153 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_CONSTEXPR_VALUE_CACHE_H_
+#define XLS_DSLX_CONSTEXPR_VALUE_CACHE_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "xls/dslx/frontend/ast.h"
+#include "xls/dslx/frontend/module.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/dslx/type_system/parametric_env.h"
+#include "xls/dslx/type_system/type.h"
+
+namespace xls::dslx {
+
+// Counters describing how often constexpr evaluation was able to reuse a
+// previously computed value.
+struct ConstexprValueCacheStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+
+  // Total time originally spent evaluating the values that were reused,
+  // counted once per hit.
+  absl::Duration time_saved;
+
+  std::string ToString() const;
+};
+
+// Memoizes the values of constexpr-evaluated expressions.
+//
+// The value of an expression only depends on the expression's structure, the
+// definitions its names and types resolve to, the parametric bindings and
+// (optional) contextual type it is evaluated with, and the values of the
+// constexpr names it refers to. Those make up the key, so re-evaluations reuse
+// the earlier result instead of emitting and running bytecode again: e.g. of
+// the same expression in each instantiation of a parametric function with the
+// same bindings, during IR conversion after typechecking, or of identical
+// expressions (such as repeated array dimensions) at different sites of a
+// module. The structure is keyed by the expression's text; identical text in
+// different modules is not shared as its names resolve to different
+// definitions. The cache lives on the `ImportData` so it spans all modules
+// imported into it.
+//
+// Only plain data (bits, enums, and arrays/tuples thereof) is cached, both as
+// environment and as result: e.g. evaluating a channel declaration must
+// produce a fresh channel each time.
+//
+// Thread safe.
+class ConstexprValueCache {
+ public:
+  class Key {
+   public:
+    template <typename H>
+    friend H AbslHashValue(H h, const Key& key) {
+      h = H::combine(std::move(h), key.module_, key.text_, key.resolutions_,
+                     key.bindings_, key.type_);
+      for (const auto& [name, value] : key.env_) {
+        h = CombineValue(H::combine(std::move(h), name), value);
+      }
+      return h;
+    }
+
+    friend bool operator==(const Key& lhs, const Key& rhs);
+
+   private:
+    friend class ConstexprValueCache;
+
+    template <typename H>
+    static H CombineValue(H h, const InterpValue& value) {
+      h = H::combine(std::move(h), value.tag());
+      if (std::optional<InterpValue::EnumData> enum_data =
+              value.GetEnumData()) {
+        return H::combine(std::move(h), enum_data->def, enum_data->value);
+      }
+      if (value.HasBits()) {
+        return H::combine(std::move(h), value.GetBitsOrDie());
+      }
+      for (const InterpValue& element : value.GetValuesOrDie()) {
+        h = CombineValue(std::move(h), element);
+      }
+      return h;
+    }
+
+    const Module* module_;
+    // Canonical text of the expression.
+    std::string text_;
+    // The definitions referred to by the names and type references in the
+    // expression, in traversal order.
+    std::vector<const void*> resolutions_;
+    ParametricEnv bindings_;
+    std::string type_;
+    // Sorted by name.
+    std::vector<std::pair<std::string, InterpValue>> env_;
+  };
+
+  // Returns the key for evaluating `expr` with the given parametric bindings,
+  // contextual type (which may be null), and environment of constexpr names,
+  // or nullopt if the environment holds values that cannot be cached.
+  static std::optional<Key> MakeKey(
+      const Expr* expr, const ParametricEnv& bindings, const Type* type,
+      const absl::flat_hash_map<std::string, InterpValue>& env);
+
+  // Returns whether `value` is plain data that may be cached.
+  static bool IsCacheable(const InterpValue& value);
+
+  // Returns the value recorded for `key`, if any, and updates the hit/miss
+  // counters accordingly.
+  std::optional<InterpValue> Lookup(const Key& key);
+
+  // Records the value for `key`; `elapsed` is the time it took to evaluate.
+  void Insert(Key key, InterpValue value, absl::Duration elapsed);
+
+  // Drops all entries for expressions outside of `live_modules`, e.g. because
+  // the other modules are being destroyed.
+  void EraseModulesExcept(const absl::flat_hash_set<const Module*>& live_modules);
+
+  ConstexprValueCacheStats stats() const;
+
+ private:
+  struct Entry {
+    InterpValue value;
+    absl::Duration elapsed;
+  };
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<Key, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  ConstexprValueCacheStats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_CONSTEXPR_VALUE_CACHE_H_
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/meta/type_traits.h"
@@ -87,6 +88,52 @@ absl::StatusOr<ModuleInfo*> ImportData::Put(
   return pmodule_info;
 }
 
+void ImportData::Remove(const ImportTokens& subject) {
+  if (auto it = modules_.find(subject); it != modules_.end()) {
+    path_to_module_info_.erase(std::string{it->second->path()});
+    modules_.erase(it);
+  }
+
+  absl::flat_hash_set<const Module*> live_modules;
+  for (const auto& [_, module_info] : modules_) {
+    live_modules.insert(&module_info->module());
+  }
+  for (auto it = top_level_bindings_.begin();
+       it != top_level_bindings_.end();) {
+    if (live_modules.contains(it->first)) {
+      ++it;
+    } else {
+      top_level_bindings_.erase(it++);
+    }
+  }
+  for (auto it = top_level_bindings_done_.begin();
+       it != top_level_bindings_done_.end();) {
+    if (live_modules.contains(*it)) {
+      ++it;
+    } else {
+      top_level_bindings_done_.erase(it++);
+    }
+  }
+  for (auto it = typecheck_wip_.begin(); it != typecheck_wip_.end();) {
+    if (live_modules.contains(it->first)) {
+      ++it;
+    } else {
+      typecheck_wip_.erase(it++);
+    }
+  }
+  for (auto it = lazily_typechecked_members_.begin();
+       it != lazily_typechecked_members_.end();) {
+    if (live_modules.contains(it->first)) {
+      ++it;
+    } else {
+      lazily_typechecked_members_.erase(it++);
+    }
+  }
+  constexpr_value_cache_->EraseModulesExcept(live_modules);
+  parametric_instantiation_cache_.EraseRoots(
+      type_info_owner_.EraseModulesExcept(live_modules));
+}
+
 absl::StatusOr<TypeInfo*> ImportData::GetRootTypeInfoForNode(
     const AstNode* node) {
   XLS_RET_CHECK(node != nullptr);
@@ -31,11 +31,13 @@
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
 #include "xls/dslx/bytecode/bytecode_cache_interface.h"
+#include "xls/dslx/constexpr_value_cache.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/module.h"
 #include "xls/dslx/frontend/pos.h"
 #include "xls/dslx/import_record.h"
 #include "xls/dslx/interp_bindings.h"
+#include "xls/dslx/type_system/parametric_instantiation_cache.h"
 #include "xls/dslx/type_system/type_info.h"
 #include "xls/dslx/warning_kind.h"
 
@@ -171,6 +173,16 @@ class ImportData {
   absl::StatusOr<ModuleInfo*> Put(const ImportTokens& subject,
                                   std::unique_ptr<ModuleInfo> module_info);
 
+  // Unloads the module imported as `subject` (if present) so that it may be
+  // parsed and typechecked again, e.g. after its source has been edited. Also
+  // discards type information left over from modules that failed to
+  // typecheck.
+  //
+  // Modules that import `subject` are not unloaded; the caller is responsible
+  // for removing those as well. Any bytecode cache should also be replaced, as
+  // it may refer to the unloaded module.
+  void Remove(const ImportTokens& subject);
+
   TypeInfoOwner& type_info_owner() { return type_info_owner_; }
 
   // Helper that gets the "root" type information for the module of the given
@@ -225,6 +237,44 @@ class ImportData {
   void SetBytecodeCache(std::unique_ptr<BytecodeCacheInterface> bytecode_cache);
   BytecodeCacheInterface* bytecode_cache();
 
+  // When set, modules imported from here on are not typechecked in full;
+  // instead only the top-level members their importers refer to (and what
+  // those members refer to, transitively) are typechecked. This makes
+  // importing large libraries cheap when only a few of their members are used,
+  // at the cost of not reporting errors in the members that go unused.
+  //
+  // The importing module itself is always typechecked in full.
+  bool typecheck_imports_lazily() const { return typecheck_imports_lazily_; }
+  void set_typecheck_imports_lazily(bool value) {
+    typecheck_imports_lazily_ = value;
+  }
+
+  // Notes that `module` was imported while typechecking imports lazily, i.e.
+  // its members are typechecked on demand.
+  void MarkTypecheckedLazily(const Module* module) {
+    lazily_typechecked_members_.try_emplace(module);
+  }
+
+  // Returns the top-level members of `module` that have been typechecked so
+  // far, or nullptr if `module` was typechecked in full.
+  absl::flat_hash_set<const AstNode*>* GetLazilyTypecheckedMembers(
+      const Module* module) {
+    auto it = lazily_typechecked_members_.find(module);
+    return it == lazily_typechecked_members_.end() ? nullptr : &it->second;
+  }
+
+  // Parametric instantiations deduced while typechecking any of the modules
+  // managed by this object, shared so that they are deduced only once.
+  ParametricInstantiationCache& parametric_instantiation_cache() {
+    return parametric_instantiation_cache_;
+  }
+
+  // Values of constexpr-evaluated expressions in any of the modules managed by
+  // this object, shared so that each is evaluated only once.
+  ConstexprValueCache& constexpr_value_cache() {
+    return *constexpr_value_cache_;
+  }
+
   // Helpers for finding nodes in the cluster of modules managed by this object.
   //
   // These return a NotFound error if _either_ the module (implicitly
@@ -281,7 +331,14 @@ class ImportData {
       top_level_bindings_;
   absl::flat_hash_set<Module*> top_level_bindings_done_;
   absl::flat_hash_map<Module*, AstNode*> typecheck_wip_;
+  bool typecheck_imports_lazily_ = false;
+  absl::flat_hash_map<const Module*, absl::flat_hash_set<const AstNode*>>
+      lazily_typechecked_members_;
   TypeInfoOwner type_info_owner_;
+  ParametricInstantiationCache parametric_instantiation_cache_;
+  // Held by pointer as it is not movable.
+  std::unique_ptr<ConstexprValueCache> constexpr_value_cache_ =
+      std::make_unique<ConstexprValueCache>();
   const std::filesystem::path stdlib_path_;
   std::vector<std::filesystem::path> additional_search_paths_;
   WarningKindSet enabled_warnings_;
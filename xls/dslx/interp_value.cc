@@ -629,6 +629,13 @@ absl::StatusOr<InterpValue> InterpValue::Index(const InterpValue& other) const {
 
 absl::StatusOr<InterpValue> InterpValue::Update(
     const InterpValue& index, const InterpValue& value) const {
+  InterpValue copy = *this;
+  XLS_RETURN_IF_ERROR(copy.UpdateInPlace(index, value));
+  return copy;
+}
+
+absl::Status InterpValue::UpdateInPlace(const InterpValue& index,
+                                        InterpValue value) {
   absl::Span<const xls::dslx::InterpValue> indices;
   if (index.IsTuple()) {
     indices =
@@ -636,8 +643,7 @@ absl::StatusOr<InterpValue> InterpValue::Update(
   } else {
     indices = absl::MakeConstSpan(&index, 1);
   }
-  InterpValue copy = *this;
-  InterpValue* element = &copy;
+  InterpValue* element = this;
   for (const auto& i : indices) {
     if (!element->IsArray()) {
       return absl::InvalidArgumentError(absl::StrFormat(
@@ -654,8 +660,8 @@ absl::StatusOr<InterpValue> InterpValue::Update(
     }
     element = &values[index_value];
   }
-  *element = value;
-  return copy;
+  *element = std::move(value);
+  return absl::OkStatus();
 }
 
 absl::StatusOr<InterpValue> InterpValue::ArithmeticNegate() const {
@@ -249,6 +249,9 @@ class InterpValue {
   absl::StatusOr<InterpValue> Index(int64_t index) const;
   absl::StatusOr<InterpValue> Update(const InterpValue& index,
                                      const InterpValue& value) const;
+  // As `Update` but modifies this value in place instead of returning an
+  // updated copy.
+  absl::Status UpdateInPlace(const InterpValue& index, InterpValue value);
   absl::StatusOr<InterpValue> Slice(const InterpValue& start,
                                     const InterpValue& length) const;
   absl::StatusOr<InterpValue> Flatten() const;
@@ -306,6 +309,14 @@ class InterpValue {
   const std::vector<InterpValue>& GetValuesOrDie() const {
     return std::get<std::vector<InterpValue>>(payload_);
   }
+  // Moves the element values out of this value, leaving it in a valid but
+  // unspecified state.
+  absl::StatusOr<std::vector<InterpValue>> TakeValues() && {
+    if (!std::holds_alternative<std::vector<InterpValue>>(payload_)) {
+      return absl::InvalidArgumentError("Value does not hold element values");
+    }
+    return std::move(std::get<std::vector<InterpValue>>(payload_));
+  }
   absl::StatusOr<const FnData*> GetFunction() const {
     if (!std::holds_alternative<FnData>(payload_)) {
       return absl::InvalidArgumentError(
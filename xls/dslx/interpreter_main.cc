@@ -28,6 +28,7 @@
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
@@ -88,6 +89,35 @@ ABSL_FLAG(std::string, evaluator, "dslx-interpreter",
           "What evaluator should be used to actually execute the dslx test. "
           "'dslx-interpreter' is the DSLX bytecode interpreter. 'ir-jit' is "
           "the XLS-IR JIT. ir-interpreter' is the XLS-IR interpreter.");
+ABSL_FLAG(int64_t, test_threads, 1,
+          "Number of threads on which to run the module's tests. Output is "
+          "reported in test order regardless. Only supported by the "
+          "'dslx-interpreter' evaluator; other evaluators run tests serially. "
+          "Quickchecks always run one after another after the tests; see "
+          "--quickcheck_threads.");
+ABSL_FLAG(int64_t, quickcheck_threads, 0,
+          "If positive, quickchecks are evaluated in batches by the JIT on "
+          "this many threads and their throughput is reported. Falsifying "
+          "examples differ from those found by the default (zero) mode for "
+          "the same seed.");
+ABSL_FLAG(bool, typecheck_imports_lazily, false,
+          "Only typecheck the members of imported modules that are used by "
+          "the module under test, rather than the whole of every imported "
+          "module.");
+ABSL_FLAG(double, compare_sample_rate, 1.0,
+          "With --compare, the fraction of each function's invocations which "
+          "are compared.");
+ABSL_FLAG(std::string, compare_function_sample_rates, "",
+          "With --compare, comma-delimited overrides of "
+          "--compare_sample_rate for individual functions, e.g. "
+          "`fadd=0.01,main=1`.");
+ABSL_FLAG(int64_t, compare_max_per_function, 0,
+          "With --compare, if non-zero, the maximum number of invocations of "
+          "each function which are compared.");
+ABSL_FLAG(int64_t, compare_async_threads, 0,
+          "With --compare, if positive, comparisons (including JIT "
+          "compilation) are done on this many background threads while the "
+          "interpreter continues.");
 // LINT.ThenChange(//xls/build_rules/xls_dslx_rules.bzl)
 
 namespace xls::dslx {
@@ -118,6 +148,51 @@ absl::StatusOr<EvaluatorType> GetEvaluatorType(std::string_view text) {
       "Unknown evaluator. Options are ['dslx-interpreter', 'ir-jit', "
       "'ir-interpreter']");
 }
+
+absl::StatusOr<ComparePolicy> MakeComparePolicy(
+    double sample_rate, std::string_view function_sample_rates,
+    int64_t max_per_function, int64_t async_threads) {
+  if (!(sample_rate >= 0.0 && sample_rate <= 1.0)) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "--compare_sample_rate must be in [0, 1]; got %f", sample_rate));
+  }
+  if (async_threads < 0) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "--compare_async_threads must be non-negative; got %d",
+        async_threads));
+  }
+  if (max_per_function < 0) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "--compare_max_per_function must be non-negative; got %d",
+        max_per_function));
+  }
+  ComparePolicy policy;
+  policy.sample_rate = sample_rate;
+  for (std::string_view entry :
+       absl::StrSplit(function_sample_rates, ',', absl::SkipEmpty())) {
+    std::vector<std::string_view> pieces = absl::StrSplit(entry, '=');
+    double rate;
+    if (pieces.size() != 2 || !absl::SimpleAtod(pieces[1], &rate)) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Invalid --compare_function_sample_rates entry: `%s`; want "
+          "`<function>=<rate>`",
+          entry));
+    }
+    if (!(rate >= 0.0 && rate <= 1.0)) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "--compare_function_sample_rates rate for `%s` must be in [0, 1]; "
+          "got %f",
+          pieces[0], rate));
+    }
+    policy.function_sample_rates[pieces[0]] = rate;
+  }
+  if (max_per_function != 0) {
+    policy.max_compares_per_function = max_per_function;
+  }
+  policy.async_threads = async_threads;
+  return policy;
+}
+
 static constexpr std::string_view kUsage = R"(
 Parses, typechecks, and executes all tests inside of a DSLX module.
 )";
@@ -141,7 +216,11 @@ absl::StatusOr<TestResult> RealMain(
     FormatPreference format_preference, CompareFlag compare_flag, bool execute,
     bool warnings_as_errors, std::optional<int64_t> seed, bool trace_channels,
     std::optional<int64_t> max_ticks,
-    std::optional<std::string_view> xml_output_file, EvaluatorType evaluator) {
+    std::optional<std::string_view> xml_output_file, EvaluatorType evaluator,
+    int64_t test_threads, int64_t quickcheck_threads,
+    bool typecheck_imports_lazily, double compare_sample_rate,
+    std::string_view compare_function_sample_rates,
+    int64_t compare_max_per_function, int64_t compare_async_threads) {
   XLS_ASSIGN_OR_RETURN(
       WarningKindSet warnings,
       WarningKindSetFromDisabledString(absl::GetFlag(FLAGS_disable_warnings)));
@@ -155,16 +234,21 @@ absl::StatusOr<TestResult> RealMain(
   XLS_ASSIGN_OR_RETURN(std::string program, GetFileContents(entry_module_path));
   XLS_ASSIGN_OR_RETURN(std::string module_name, PathToName(entry_module_path));
 
+  XLS_ASSIGN_OR_RETURN(
+      ComparePolicy compare_policy,
+      MakeComparePolicy(compare_sample_rate, compare_function_sample_rates,
+                        compare_max_per_function, compare_async_threads));
   std::unique_ptr<AbstractRunComparator> run_comparator;
   switch (compare_flag) {
     case CompareFlag::kNone:
       break;
     case CompareFlag::kJit:
-      run_comparator = std::make_unique<RunComparator>(CompareMode::kJit);
+      run_comparator = std::make_unique<RunComparator>(
+          CompareMode::kJit, std::move(compare_policy));
       break;
     case CompareFlag::kInterpreter:
-      run_comparator =
-          std::make_unique<RunComparator>(CompareMode::kInterpreter);
+      run_comparator = std::make_unique<RunComparator>(
+          CompareMode::kInterpreter, std::move(compare_policy));
       break;
   }
 
@@ -191,7 +275,11 @@ absl::StatusOr<TestResult> RealMain(
                                  .warnings_as_errors = warnings_as_errors,
                                  .warnings = warnings,
                                  .trace_channels = trace_channels,
-                                 .max_ticks = max_ticks};
+                                 .max_ticks = max_ticks,
+                                 .test_threads = test_threads,
+                                 .quickcheck_threads = quickcheck_threads,
+                                 .typecheck_imports_lazily =
+                                     typecheck_imports_lazily};
 
   std::unique_ptr<AbstractTestRunner> test_runner = GetTestRunner(evaluator);
   XLS_ASSIGN_OR_RETURN(TestResultData test_result,
@@ -313,7 +401,14 @@ int main(int argc, char* argv[]) {
   absl::StatusOr<xls::dslx::TestResult> test_result = xls::dslx::RealMain(
       args[0], dslx_paths, dslx_stdlib_path, test_filter, preference,
       compare_flag, execute, warnings_as_errors, seed, trace_channels,
-      max_ticks, xml_output_file, evaluator.value());
+      max_ticks, xml_output_file, evaluator.value(),
+      absl::GetFlag(FLAGS_test_threads),
+      absl::GetFlag(FLAGS_quickcheck_threads),
+      absl::GetFlag(FLAGS_typecheck_imports_lazily),
+      absl::GetFlag(FLAGS_compare_sample_rate),
+      absl::GetFlag(FLAGS_compare_function_sample_rates),
+      absl::GetFlag(FLAGS_compare_max_per_function),
+      absl::GetFlag(FLAGS_compare_async_threads));
   if (!test_result.ok()) {
     return xls::ExitStatus(test_result.status());
   }
@@ -15,6 +15,7 @@
 #ifndef XLS_DSLX_IR_CONVERT_CONVERT_OPTIONS_H_
 #define XLS_DSLX_IR_CONVERT_CONVERT_OPTIONS_H_
 
+#include <cstdint>
 #include <optional>
 
 #include "xls/dslx/warning_kind.h"
@@ -51,6 +52,18 @@ struct ConvertOptions {
   // If present, the default FIFO config to use for any FIFO that does not
   // specify a config.
   std::optional<FifoConfig> default_fifo_config;
+
+  // Number of threads used to convert the call graph. Values greater than one
+  // convert independent call trees concurrently and merge the results into
+  // the same package single-threaded conversion produces. Call graphs
+  // containing procs are always converted on a single thread.
+  int64_t conversion_threads = 1;
+
+  // Whether modules imported by the converted module only have the members
+  // that are used typechecked, see `ImportData::typecheck_imports_lazily()`.
+  //
+  // Note that this is only used in IR conversion routines that do typechecking.
+  bool typecheck_imports_lazily = false;
 };
 
 }  // namespace xls::dslx
@@ -105,6 +105,7 @@ class ConversionRecord {
   const ParametricEnv& parametric_env() const { return parametric_env_; }
   std::optional<ProcId> proc_id() const { return proc_id_; }
   bool IsTop() const { return is_top_; }
+  absl::Span<const Callee> callees() const { return callees_; }
 
   std::string ToString() const;
 
@@ -24,14 +24,17 @@
 
 #include "xls/dslx/ir_convert/ir_converter.h"
 
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/btree_set.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/log.h"
@@ -42,6 +45,7 @@
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
 #include "xls/common/file/filesystem.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/dslx/command_line_utils.h"
@@ -70,6 +74,10 @@
 #include "xls/ir/function.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_scanner.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
+#include "xls/ir/package.h"
 #include "xls/ir/value.h"
 #include "xls/ir/verifier.h"
 #include "xls/ir/xls_ir_interface.pb.h"
@@ -233,6 +241,334 @@ absl::Status CreateBoundaryChannels(absl::Span<Param* const> params,
   return absl::OkStatus();
 }
 
+// Splits `order` into at most `group_count` groups of records which can be
+// converted independently of one another: each group holds the call trees of
+// a contiguous run of the records which nothing else calls, in conversion
+// order. Callees reachable from more than one group appear in each of them.
+//
+// Returns nullopt if the call graph cannot be partitioned; procs share
+// channel and proc state across the whole conversion, so any call graph
+// containing one is converted serially.
+std::optional<std::vector<std::vector<int64_t>>> PartitionCallGraph(
+    absl::Span<const ConversionRecord> order, int64_t group_count) {
+  using RecordKey = std::pair<const Function*, ParametricEnv>;
+  absl::flat_hash_map<RecordKey, int64_t> record_index;
+  for (int64_t i = 0; i < order.size(); ++i) {
+    const ConversionRecord& record = order[i];
+    if (record.f()->tag() != FunctionTag::kNormal ||
+        record.proc_id().has_value()) {
+      return std::nullopt;
+    }
+    record_index.emplace(RecordKey(record.f(), record.parametric_env()), i);
+  }
+
+  std::vector<std::vector<int64_t>> callees(order.size());
+  std::vector<bool> is_callee(order.size(), false);
+  for (int64_t i = 0; i < order.size(); ++i) {
+    for (const Callee& callee : order[i].callees()) {
+      auto it = record_index.find(
+          RecordKey(callee.f(), callee.parametric_env()));
+      if (it == record_index.end() || it->second >= i) {
+        return std::nullopt;
+      }
+      callees[i].push_back(it->second);
+      is_callee[it->second] = true;
+    }
+  }
+
+  // Each call tree is kept sorted by record index, which (as callees precede
+  // their callers in `order`) is a valid conversion order for it.
+  std::vector<absl::btree_set<int64_t>> trees;
+  int64_t total_size = 0;
+  for (int64_t i = 0; i < order.size(); ++i) {
+    if (is_callee[i]) {
+      continue;
+    }
+    absl::btree_set<int64_t>& tree = trees.emplace_back();
+    std::vector<int64_t> worklist = {i};
+    while (!worklist.empty()) {
+      int64_t next = worklist.back();
+      worklist.pop_back();
+      if (tree.insert(next).second) {
+        worklist.insert(worklist.end(), callees[next].begin(),
+                        callees[next].end());
+      }
+    }
+    total_size += tree.size();
+  }
+
+  std::vector<std::vector<int64_t>> groups;
+  absl::btree_set<int64_t> group;
+  int64_t assigned_size = 0;
+  for (int64_t t = 0; t < trees.size(); ++t) {
+    group.insert(trees[t].begin(), trees[t].end());
+    assigned_size += trees[t].size();
+    if (t + 1 == trees.size() ||
+        assigned_size * group_count >= total_size * (groups.size() + 1)) {
+      groups.push_back(std::vector<int64_t>(group.begin(), group.end()));
+      group.clear();
+    }
+  }
+  return groups;
+}
+
+// Returns whether every node of `f` is listed after its operands, with the
+// parameters listed in order, so that `CloneForMerge` can recreate the nodes
+// in the same order.
+bool IsListedInDependencyOrder(xls::Function* f) {
+  absl::flat_hash_set<xls::Node*> listed;
+  int64_t param_index = 0;
+  for (xls::Node* node : f->nodes()) {
+    if (node->Is<xls::Param>()) {
+      if (param_index >= f->params().size() ||
+          f->params()[param_index] != node) {
+        return false;
+      }
+      ++param_index;
+    }
+    for (xls::Node* operand : node->operands()) {
+      if (!listed.contains(operand)) {
+        return false;
+      }
+    }
+    listed.insert(node);
+  }
+  return true;
+}
+
+// Clones `f` into `package`, creating nodes in the order they are listed in
+// `f` and giving each the id of its original plus `id_offset`. Names are only
+// assigned where the original had one. The result is indistinguishable from
+// `f` having been built in `package` with its node ids starting at
+// `id_offset` past those of `f`. Functions called by `f` are replaced as given
+// by `call_remapping`, which must cover all of them.
+absl::StatusOr<xls::Function*> CloneForMerge(
+    xls::Function* f, Package* package,
+    const absl::flat_hash_map<const xls::Function*, xls::Function*>&
+        call_remapping,
+    int64_t id_offset) {
+  auto remap = [&](xls::Function* callee) -> absl::StatusOr<xls::Function*> {
+    auto it = call_remapping.find(callee);
+    XLS_RET_CHECK(it != call_remapping.end()) << callee->name();
+    return it->second;
+  };
+  xls::Function* clone =
+      package->AddFunction(std::make_unique<xls::Function>(f->name(), package));
+  clone->SetForeignFunctionData(f->ForeignFunctionData());
+  absl::flat_hash_map<xls::Node*, xls::Node*> original_to_clone;
+  for (xls::Node* node : f->nodes()) {
+    std::vector<xls::Node*> operands;
+    for (xls::Node* operand : node->operands()) {
+      operands.push_back(original_to_clone.at(operand));
+    }
+    xls::Node* cloned;
+    switch (node->op()) {
+      case xls::Op::kCountedFor: {
+        xls::CountedFor* src = node->As<xls::CountedFor>();
+        XLS_ASSIGN_OR_RETURN(xls::Function * body, remap(src->body()));
+        XLS_ASSIGN_OR_RETURN(
+            cloned, clone->MakeNodeWithName<xls::CountedFor>(
+                        src->loc(), operands[0],
+                        absl::Span<xls::Node*>(operands).subspan(1),
+                        src->trip_count(), src->stride(), body,
+                        src->GetNameView()));
+        break;
+      }
+      case xls::Op::kMap: {
+        xls::Map* src = node->As<xls::Map>();
+        XLS_ASSIGN_OR_RETURN(xls::Function * to_apply, remap(src->to_apply()));
+        XLS_ASSIGN_OR_RETURN(cloned, clone->MakeNodeWithName<xls::Map>(
+                                         src->loc(), operands[0], to_apply,
+                                         src->GetNameView()));
+        break;
+      }
+      case xls::Op::kInvoke: {
+        xls::Invoke* src = node->As<xls::Invoke>();
+        XLS_ASSIGN_OR_RETURN(xls::Function * to_apply, remap(src->to_apply()));
+        XLS_ASSIGN_OR_RETURN(cloned, clone->MakeNodeWithName<xls::Invoke>(
+                                         src->loc(), operands, to_apply,
+                                         src->GetNameView()));
+        break;
+      }
+      default: {
+        XLS_ASSIGN_OR_RETURN(cloned,
+                             node->CloneInNewFunction(operands, clone));
+        break;
+      }
+    }
+    cloned->SetId(node->id() + id_offset);
+    original_to_clone[node] = cloned;
+  }
+  XLS_RETURN_IF_ERROR(
+      clone->set_return_value(original_to_clone.at(f->return_value())));
+  return clone;
+}
+
+// Converts each of `groups` (as produced by `PartitionCallGraph`) into its own
+// package on a separate thread, then merges the results into the package in
+// `package_data`.
+//
+// The merge adds the functions of each record in `order`, taken from the
+// first group which converted it, and renumbers their nodes as serial
+// conversion would have, so the resulting package is identical to that of
+// serial conversion. Returns false, without having added any functions, if
+// that cannot be guaranteed for the converted functions (see
+// `IsListedInDependencyOrder`), in which case the call graph should be
+// converted serially.
+//
+// Besides building IR in their own packages, the threads only mutate state
+// shared through `import_data` in thread-safe ways: constexpr values noted in
+// `TypeInfo` (guarded by a mutex), the constexpr value cache and the bytecode
+// cache used to evaluate constexprs. Everything else in `ImportData` and
+// `TypeInfo` is only read.
+absl::StatusOr<bool> ConvertCallGraphConcurrently(
+    absl::Span<const ConversionRecord> order,
+    absl::Span<const std::vector<int64_t>> groups, ImportData* import_data,
+    const ConvertOptions& options, PackageData& package_data) {
+  Package* package = package_data.conversion_info->package.get();
+
+  // Assign file numbers up front, in the order serial conversion would, and
+  // share them with every group so positions survive the merge.
+  for (const ConversionRecord& record : order) {
+    if (record.module()->fs_path().has_value()) {
+      package->GetOrCreateFileno(
+          std::string{record.module()->fs_path().value()});
+    }
+  }
+
+  // The functions added to a group's package by converting one record, and
+  // the node ids used while doing so.
+  struct RecordConversion {
+    std::vector<xls::Function*> functions;
+    int64_t begin_id;
+    int64_t end_id;
+  };
+  struct Fragment {
+    PackageConversionData conversion_info;
+    PackageData package_data;
+    absl::flat_hash_map<int64_t, RecordConversion> conversions;
+    absl::Status status;
+    bool mergeable = true;
+  };
+  std::vector<std::unique_ptr<Fragment>> fragments;
+  fragments.reserve(groups.size());
+  for (int64_t i = 0; i < groups.size(); ++i) {
+    auto fragment = std::make_unique<Fragment>();
+    fragment->conversion_info.package =
+        std::make_unique<Package>(package->name());
+    for (const auto& [fileno, filename] : package->fileno_to_name()) {
+      fragment->conversion_info.package->SetFileno(fileno, filename);
+    }
+    fragment->package_data.conversion_info = &fragment->conversion_info;
+    fragments.push_back(std::move(fragment));
+  }
+
+  ParallelFor(groups.size(), groups.size(), [&](int64_t i) {
+    Fragment& fragment = *fragments[i];
+    Package* fragment_package = fragment.conversion_info.package.get();
+    ProcConversionData proc_data;
+    ChannelScope channel_scope(&fragment.conversion_info, import_data,
+                               options.default_fifo_config);
+    for (int64_t index : groups[i]) {
+      const ConversionRecord& record = order[index];
+      VLOG(3) << "Converting to IR: " << record.ToString();
+      const int64_t function_count = fragment_package->functions().size();
+      RecordConversion conversion{.begin_id = fragment_package->next_node_id()};
+      channel_scope.EnterFunctionContext(record.type_info(),
+                                         record.parametric_env());
+      fragment.status = ConvertOneFunctionInternal(
+          fragment.package_data, record, import_data, &proc_data,
+          &channel_scope, options);
+      if (!fragment.status.ok()) {
+        return;
+      }
+      conversion.end_id = fragment_package->next_node_id();
+      for (int64_t f = function_count; f < fragment_package->functions().size();
+           ++f) {
+        xls::Function* function = fragment_package->functions()[f].get();
+        fragment.mergeable &= IsListedInDependencyOrder(function);
+        conversion.functions.push_back(function);
+      }
+      fragment.conversions.emplace(index, std::move(conversion));
+    }
+  });
+
+  for (const std::unique_ptr<Fragment>& fragment : fragments) {
+    XLS_RETURN_IF_ERROR(fragment->status);
+  }
+  for (const std::unique_ptr<Fragment>& fragment : fragments) {
+    if (!fragment->mergeable) {
+      VLOG(3) << "Converted functions cannot be merged node for node; "
+                 "converting serially";
+      return false;
+    }
+  }
+
+  // The group whose conversion of each record is kept.
+  std::vector<int64_t> owners(order.size(), -1);
+  int64_t id_count = 0;
+  for (int64_t g = groups.size() - 1; g >= 0; --g) {
+    for (int64_t index : groups[g]) {
+      owners[index] = g;
+    }
+  }
+  for (int64_t index = 0; index < order.size(); ++index) {
+    XLS_RET_CHECK_GE(owners[index], 0) << order[index].ToString();
+    const RecordConversion& conversion =
+        fragments[owners[index]]->conversions.at(index);
+    id_count += conversion.end_id - conversion.begin_id;
+  }
+
+  // Nodes are created with ids past those serial conversion would have used
+  // and then renumbered, so ids stay unique throughout.
+  int64_t next_id = package->next_node_id();
+  package->set_next_node_id(next_id + id_count);
+  std::vector<absl::flat_hash_map<const xls::Function*, xls::Function*>>
+      remappings(fragments.size());
+  for (int64_t index = 0; index < order.size(); ++index) {
+    const Fragment& owner = *fragments[owners[index]];
+    const RecordConversion& conversion = owner.conversions.at(index);
+    std::vector<xls::Function*> clones;
+    for (xls::Function* f : conversion.functions) {
+      XLS_ASSIGN_OR_RETURN(
+          xls::Function * clone,
+          CloneForMerge(f, package, remappings[owners[index]],
+                        next_id - conversion.begin_id));
+      clones.push_back(clone);
+      // Functions of a record may call one another (e.g. a wrapper).
+      remappings[owners[index]][f] = clone;
+      for (const PackageInterfaceProto::Function& interface :
+           owner.conversion_info.interface.functions()) {
+        if (interface.base().name() == f->name()) {
+          *package_data.conversion_info->interface.add_functions() = interface;
+        }
+      }
+      if (auto it = owner.package_data.ir_to_dslx.find(f);
+          it != owner.package_data.ir_to_dslx.end()) {
+        package_data.ir_to_dslx[clone] = it->second;
+      }
+      if (owner.package_data.wrappers.contains(f)) {
+        package_data.wrappers.insert(clone);
+      }
+    }
+    next_id += conversion.end_id - conversion.begin_id;
+
+    // Calls to this record's functions in any group now refer to the clones.
+    for (int64_t g = 0; g < fragments.size(); ++g) {
+      auto it = fragments[g]->conversions.find(index);
+      if (it == fragments[g]->conversions.end()) {
+        continue;
+      }
+      XLS_RET_CHECK_EQ(it->second.functions.size(), clones.size());
+      for (int64_t f = 0; f < clones.size(); ++f) {
+        remappings[g][it->second.functions[f]] = clones[f];
+      }
+    }
+  }
+  package->set_next_node_id(next_id);
+  return true;
+}
+
 // Converts the functions in the call graph in a specified order.
 //
 // Args:
@@ -251,6 +587,25 @@ absl::Status ConvertCallGraph(absl::Span<const ConversionRecord> order,
                    absl::StrAppend(out, record.ToString());
                  })
           << "]";
+  if (options.conversion_threads > 1) {
+    std::optional<std::vector<std::vector<int64_t>>> groups =
+        PartitionCallGraph(order, options.conversion_threads);
+    if (groups.has_value() && groups->size() > 1) {
+      XLS_ASSIGN_OR_RETURN(bool converted,
+                           ConvertCallGraphConcurrently(
+                               order, *groups, import_data, options,
+                               package_data));
+      if (converted) {
+        VLOG(3) << "Verifying converted package";
+        if (options.verify_ir) {
+          XLS_RETURN_IF_ERROR(
+              VerifyPackage(package_data.conversion_info->package.get()));
+        }
+        return absl::OkStatus();
+      }
+    }
+  }
+
   // We need to convert Functions before procs: Channels are declared inside
   // Functions, but exist as "global" entities in the IR. By processing
   // Functions first, we can collect the declarations of these global data so
@@ -553,11 +908,15 @@ absl::StatusOr<PackageConversionData> ConvertFilesToPackage(
     ImportData import_data(CreateImportData(
         stdlib_path, dslx_paths, convert_options.enabled_warnings,
         std::make_unique<RealFilesystem>()));
+    import_data.set_typecheck_imports_lazily(
+        convert_options.typecheck_imports_lazily);
     XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(path));
     XLS_ASSIGN_OR_RETURN(std::string module_name, PathToName(path));
     XLS_RETURN_IF_ERROR(AddContentsToPackage(
         text, module_name, /*path=*/path, /*entry=*/top, convert_options,
         &import_data, &conversion_data, printed_error));
+    VLOG(1) << "Constexpr values for " << path << ": "
+            << import_data.constexpr_value_cache().stats().ToString();
   }
   return conversion_data;
 }
@@ -0,0 +1,76 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <string>
+
+#include "include/benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/status/statusor.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/get_runfile_path.h"
+#include "xls/dslx/create_import_data.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/ir_convert/conversion_info.h"
+#include "xls/dslx/ir_convert/convert_options.h"
+#include "xls/dslx/ir_convert/ir_converter.h"
+#include "xls/dslx/parse_and_typecheck.h"
+
+namespace xls::dslx {
+namespace {
+
+// Measures DSLX-to-IR conversion of whole modules, with the number of
+// conversion threads as the second benchmark argument. Parsing and
+// typechecking happen once, outside of the timed loop.
+struct BenchmarkModule {
+  const char* path;
+  const char* name;
+};
+constexpr int kNumModules = 4;
+constexpr BenchmarkModule kModules[] = {
+    {"xls/modules/aes/aes.x", "aes"},
+    {"xls/modules/aes/aes_common.x", "aes_common"},
+    {"xls/modules/zstd/frame_header.x", "frame_header"},
+    {"xls/modules/zstd/buffer.x", "buffer"},
+};
+
+static void BM_ConvertModule(benchmark::State& state) {
+  const BenchmarkModule& benchmark_module = kModules[state.range(0)];
+  std::filesystem::path path =
+      GetXlsRunfilePath(benchmark_module.path).value();
+  std::string text = GetFileContents(path).value();
+  ImportData import_data = CreateImportDataForTest();
+  TypecheckedModule tm = ParseAndTypecheck(text, benchmark_module.path,
+                                           benchmark_module.name, &import_data)
+                             .value();
+  ConvertOptions options{.conversion_threads = state.range(1)};
+  state.SetLabel(benchmark_module.name);
+  for (auto _ : state) {
+    absl::StatusOr<PackageConversionData> converted =
+        ConvertModuleToPackage(tm.module, &import_data, options);
+    CHECK_OK(converted.status());
+    benchmark::DoNotOptimize(converted);
+  }
+}
+
+BENCHMARK(BM_ConvertModule)
+    ->ArgsProduct({benchmark::CreateDenseRange(0, kNumModules - 1, 1),
+                   {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace xls::dslx
+
+BENCHMARK_MAIN();
@@ -110,6 +110,9 @@ absl::Status RealMain(absl::Span<const std::string_view> paths) {
       .enabled_warnings = enabled_warnings,
       .convert_tests = convert_tests,
       .default_fifo_config = default_fifo_config,
+      .conversion_threads = ir_converter_options.conversion_threads(),
+      .typecheck_imports_lazily =
+          ir_converter_options.typecheck_imports_lazily(),
   };
 
   // The following checks are performed inside ConvertFilesToPackage(), but we
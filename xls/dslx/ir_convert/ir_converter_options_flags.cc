@@ -14,6 +14,7 @@
 
 #include "xls/dslx/ir_convert/ir_converter_options_flags.h"
 
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <optional>
 #include <string>
@@ -68,6 +69,15 @@ ABSL_FLAG(std::optional<std::string>, ir_converter_options_proto, std::nullopt,
 ABSL_FLAG(std::optional<std::string>, default_fifo_config, std::nullopt,
           "Textproto description of a default FifoConfigProto. If unspecified, "
           "no default FIFO config is specified and codegen may fail.");
+ABSL_FLAG(int64_t, conversion_threads, 1,
+          "Number of threads used to convert independent call trees of "
+          "functions to IR. The output is the same for any number of threads. "
+          "Modules containing procs are always converted on a single thread.");
+ABSL_FLAG(bool, typecheck_imports_lazily, false,
+          "Only typecheck the members of imported modules that are used by "
+          "the converted module, rather than the whole of every imported "
+          "module. Errors in unused members of imported modules then go "
+          "unreported.");
 // LINT.ThenChange(//xls/build_rules/xls_ir_rules.bzl)
 ABSL_FLAG(std::optional<std::string>, ir_converter_options_used_textproto_file,
           std::nullopt,
@@ -104,6 +114,8 @@ absl::StatusOr<bool> SetOptionsFromFlags(IrConverterOptionsFlagsProto& proto) {
   POPULATE_FLAG(warnings_as_errors);
   POPULATE_OPTIONAL_FLAG(interface_proto_file);
   POPULATE_OPTIONAL_FLAG(interface_textproto_file);
+  POPULATE_FLAG(conversion_threads);
+  POPULATE_FLAG(typecheck_imports_lazily);
 
 #undef POPULATE_FLAG
 
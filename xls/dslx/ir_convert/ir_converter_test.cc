@@ -20,6 +20,8 @@
 
 #include "xls/dslx/ir_convert/ir_converter.h"
 
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -35,10 +37,12 @@
 #include "xls/common/status/status_macros.h"
 #include "xls/dslx/create_import_data.h"
 #include "xls/dslx/import_data.h"
+#include "xls/dslx/ir_convert/conversion_info.h"
 #include "xls/dslx/ir_convert/convert_options.h"
 #include "xls/dslx/parse_and_typecheck.h"
 #include "xls/dslx/run_routines/run_comparator.h"
 #include "xls/dslx/run_routines/run_routines.h"
+#include "xls/ir/function.h"
 
 namespace xls::dslx {
 namespace {
@@ -3065,5 +3069,58 @@ fn main() -> (u5[3], u6[3]) {
   ExpectIr(converted, TestName());
 }
 
+TEST(IrConverterTest, ConcurrentConversionMatchesSerial) {
+  constexpr std::string_view program =
+      R"(
+fn widen<N: u32>(x: u8) -> uN[N] { x as uN[N] }
+
+fn square(x: u32) -> u32 { x * x }
+
+fn a(x: u8) -> u32 { square(widen<u32:32>(x)) }
+
+fn b(x: u8) -> u16 { widen<u32:16>(x) + widen<u32:16>(x + u8:1) }
+
+fn c(x: u8) -> u32 { square(widen<u32:32>(x)) + u32:1 }
+
+fn d(x: u8) -> u64 { widen<u32:64>(x) }
+
+fn checked(x: u32) -> u32 {
+  assert!(x < u32:5, "x_less_than_5");
+  x
+}
+
+fn e(x: u8) -> u32[3] { map([u32:1, u32:2, u32:3], checked) }
+
+fn f(x: u8) -> u32 {
+  let _ = square(u32:7);
+  for (i, acc): (u32, u32) in range(u32:0, u32:4) {
+    acc + checked(i)
+  }(widen<u32:32>(x))
+}
+)";
+  auto convert =
+      [&](int64_t threads) -> absl::StatusOr<PackageConversionData> {
+    auto import_data = CreateImportDataForTest();
+    XLS_ASSIGN_OR_RETURN(TypecheckedModule tm,
+                         ParseAndTypecheck(program, "test_module.x",
+                                           "test_module", &import_data));
+    return ConvertModuleToPackage(
+        tm.module, &import_data,
+        ConvertOptions{.emit_positions = false,
+                       .conversion_threads = threads});
+  };
+  XLS_ASSERT_OK_AND_ASSIGN(PackageConversionData serial, convert(1));
+  XLS_ASSERT_OK_AND_ASSIGN(PackageConversionData concurrent, convert(4));
+  XLS_ASSERT_OK_AND_ASSIGN(PackageConversionData concurrent_again,
+                           convert(4));
+
+  EXPECT_EQ(concurrent.DumpIr(), serial.DumpIr());
+  EXPECT_EQ(concurrent_again.DumpIr(), serial.DumpIr());
+  EXPECT_EQ(concurrent.package->next_node_id(),
+            serial.package->next_node_id());
+  EXPECT_EQ(concurrent.interface.DebugString(),
+            serial.interface.DebugString());
+}
+
 }  // namespace
 }  // namespace xls::dslx
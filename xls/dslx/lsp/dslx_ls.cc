@@ -15,15 +15,19 @@
 // Very simple language server for dslx that
 //  - keeps track of open files and updates them whenever they are
 //    changed in the editor (hidden under the hood).
-//  - On every change, attempts to parse and send back diagnostics
-//    on errors/warnings.
+//  - Once changes stop arriving for a short while, attempts to parse and
+//    send back diagnostics on errors/warnings.
 //
 // Heavily commented below as this serves as a sample.
 
+#include <poll.h>
 #include <unistd.h>
 
+#include <cstdint>
 #include <cstdlib>
+#include <deque>
 #include <filesystem>  // NOLINT
+#include <functional>
 #include <iostream>
 #include <optional>
 #include <ostream>
@@ -32,8 +36,10 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_split.h"
 #include "nlohmann/json.hpp"
 #include "external/verible/common/lsp/json-rpc-dispatcher.h"
@@ -52,6 +58,9 @@ static constexpr char kDslxPath[] = "DSLX_PATH";
 ABSL_FLAG(std::string, dslx_path,
           getenv(kDslxPath) != nullptr ? getenv(kDslxPath) : "",
           "Additional paths to search for modules (colon delimited).");
+ABSL_FLAG(int64_t, analysis_debounce_ms, 100,
+          "Milliseconds to wait after the last edit before analyzing, so that "
+          "a burst of keystrokes results in a single analysis.");
 
 namespace xls::dslx {
 namespace {
@@ -97,36 +106,74 @@ InitializeResult InitializeServer(const nlohmann::json& params) {
   };
 }
 
-// On text change: attempt to parse the buffer and emit diagnostics if needed.
-void TextChangeHandler(const std::string& file_uri,
-                       const EditTextBuffer& text_buffer,
-                       verible::lsp::JsonRpcDispatcher& dispatcher,
-                       LanguageServerAdapter& adapter) {
-  text_buffer.RequestContent([&](std::string_view file_content) {
-    // Note: this returns a status, but we don't need to surface it from here.
-    adapter.Update(file_uri, file_content).IgnoreError();
-  });
+// Returns whether there is input to read on stdin, waiting up to `timeout_ms`.
+bool InputAvailable(int timeout_ms) {
+  pollfd fd{.fd = STDIN_FILENO, .events = POLLIN, .revents = 0};
+  // On error we claim there is input so that the subsequent read reports it.
+  return poll(&fd, 1, timeout_ms) != 0;
+}
 
-  // For now we brute force evaluate all the files in the DAG that may be
-  // sensitive to the update. We'll need to be smarter as we observe scaling
-  // issues (e.g. only evaluate sensitive files if the original file went from
-  // being an import-time error to having no import-time error).
-  std::vector<std::string> sensitive_uris =
-      adapter.import_sensitivity().GatherAllSensitiveToChangeIn(file_uri);
-  for (const std::string& sensitive_uri : sensitive_uris) {
-    // Note to all dependent files that an update has occurred.
-    // We don't need to do this for the file that we updated directly.
-    if (sensitive_uri != file_uri) {
-      adapter.Update(sensitive_uri, std::nullopt).IgnoreError();
+// Buffers waiting to be analyzed, in the order they were queued.
+//
+// Editing a buffer that is already queued replaces its queued contents, so
+// only the latest version gets analyzed.
+class PendingAnalyses {
+ public:
+  // Queues an analysis of `uri`; `contents` is nullopt when the buffer itself
+  // is unchanged but one of its dependencies may have changed.
+  void Add(const std::string& uri, std::optional<std::string> contents) {
+    auto [it, inserted] = contents_.try_emplace(uri, std::nullopt);
+    if (inserted) {
+      order_.push_back(uri);
     }
+    if (contents.has_value()) {
+      it->second = std::move(contents);
+    }
+  }
+
+  bool empty() const { return order_.empty(); }
+
+  // Analyzes queued buffers and publishes their diagnostics. Before starting
+  // each analysis `cancel` is consulted; if it returns true the remaining
+  // buffers stay queued.
+  void Run(LanguageServerAdapter& adapter,
+           verible::lsp::JsonRpcDispatcher& dispatcher,
+           const std::function<bool()>& cancel) {
+    while (!order_.empty() && !cancel()) {
+      std::string uri = std::move(order_.front());
+      order_.pop_front();
+      std::optional<std::string> contents =
+          std::move(contents_.extract(uri).mapped());
+
+      // Note: this returns a status, but we don't need to surface it from
+      // here.
+      adapter.Update(uri, contents).IgnoreError();
+
+      // For now we brute force evaluate all the files in the DAG that may be
+      // sensitive to an edit. We'll need to be smarter as we observe scaling
+      // issues (e.g. only evaluate sensitive files if the original file went
+      // from being an import-time error to having no import-time error).
+      if (contents.has_value()) {
+        for (const std::string& sensitive_uri :
+             adapter.import_sensitivity().GatherAllSensitiveToChangeIn(uri)) {
+          if (sensitive_uri != uri) {
+            Add(sensitive_uri, std::nullopt);
+          }
+        }
+      }
 
-    verible::lsp::PublishDiagnosticsParams params{
-        .uri = sensitive_uri,
-        .diagnostics = adapter.GenerateParseDiagnostics(sensitive_uri),
-    };
-    dispatcher.SendNotification("textDocument/publishDiagnostics", params);
+      verible::lsp::PublishDiagnosticsParams params{
+          .uri = uri,
+          .diagnostics = adapter.GenerateParseDiagnostics(uri),
+      };
+      dispatcher.SendNotification("textDocument/publishDiagnostics", params);
+    }
   }
-}
+
+ private:
+  std::deque<std::string> order_;
+  absl::flat_hash_map<std::string, std::optional<std::string>> contents_;
+};
 
 absl::Status RealMain() {
   const std::string stdlib_path = absl::GetFlag(FLAGS_stdlib_path);
@@ -156,9 +203,18 @@ absl::Status RealMain() {
   // The input is continuous stream of (header/body)*. The stream
   // splitter separates these messages and feeds them one by one
   // to the dispatcher.
+  //
+  // Edits only queue up analyses (see the main loop below); any other message
+  // may query analysis results, so pending analyses are completed first.
+  PendingAnalyses pending_analyses;
   MessageStreamSplitter stream_splitter;
   stream_splitter.SetMessageProcessor(
-      [&dispatcher](std::string_view header, std::string_view body) {
+      [&](std::string_view header, std::string_view body) {
+        if (!pending_analyses.empty() &&
+            !absl::StrContains(body, "\"textDocument/didChange\"")) {
+          pending_analyses.Run(language_server_adapter, dispatcher,
+                               [] { return false; });
+        }
         return dispatcher.DispatchMessage(body);
       });
 
@@ -182,14 +238,16 @@ absl::Status RealMain() {
   BufferCollection buffers(&dispatcher);
 
   // The text buffer collection can call a callback whenever there is a change.
-  // We're using this to hook up our parser that then can send diagnostic
+  // We're using this to queue up our parser that then can send diagnostic
   // messages back.
   buffers.SetChangeListener(
       [&](const std::string& uri, const EditTextBuffer* buffer) {
         if (buffer == nullptr) {
           return;  // buffer got deleted. No interest.
         }
-        TextChangeHandler(uri, *buffer, dispatcher, language_server_adapter);
+        buffer->RequestContent([&](std::string_view content) {
+          pending_analyses.Add(uri, std::string{content});
+        });
       });
 
   dispatcher.AddRequestHandler(
@@ -279,8 +337,20 @@ absl::Status RealMain() {
       });
 
   // Main loop. Feeding the stream-splitter that then calls the dispatcher.
+  //
+  // Queued analyses run once no input has arrived for the debounce period. If
+  // a message arrives while they are running, the analyses that have not yet
+  // started are put off so the message (likely a further edit) is handled
+  // first.
+  const int debounce_ms =
+      static_cast<int>(absl::GetFlag(FLAGS_analysis_debounce_ms));
   absl::Status status = absl::OkStatus();
   while (status.ok() && !shutdown_requested) {
+    if (!pending_analyses.empty() && !InputAvailable(debounce_ms)) {
+      pending_analyses.Run(language_server_adapter, dispatcher,
+                           [] { return InputAvailable(/*timeout_ms=*/0); });
+      continue;
+    }
     status = stream_splitter.PullFrom([](char* buf, int size) -> int {  //
       return static_cast<int>(read(STDIN_FILENO, buf, size));
     });
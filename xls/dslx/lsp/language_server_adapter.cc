@@ -14,6 +14,8 @@
 
 #include "xls/dslx/lsp/language_server_adapter.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
@@ -22,6 +24,8 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
@@ -41,6 +45,7 @@
 #include "xls/common/file/filesystem.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/dslx/bytecode/bytecode_cache.h"
 #include "xls/dslx/create_import_data.h"
 #include "xls/dslx/extract_module_name.h"
 #include "xls/dslx/fmt/ast_fmt.h"
@@ -167,20 +172,43 @@ class LanguageServerFilesystem : public VirtualizableFilesystem {
     std::string uri = verible::lsp::PathToLSPUri(path.c_str());
     auto it = parent_.vfs_contents().find(uri);
     if (it == parent_.vfs_contents().end()) {
-      return xls::GetFileContents(path);
+      XLS_ASSIGN_OR_RETURN(std::string contents, xls::GetFileContents(path));
+      disk_hashes_[path.string()] = absl::HashOf(contents);
+      return contents;
     }
 
     return it->second;
   }
 
+  // Returns whether any file that was read from disk (rather than from an
+  // editor buffer) no longer has the contents that were read, e.g. because it
+  // was changed by another tool.
+  bool DiskFilesChanged() const {
+    for (const auto& [path, hash] : disk_hashes_) {
+      absl::StatusOr<std::string> contents = xls::GetFileContents(path);
+      if (!contents.ok() || absl::HashOf(*contents) != hash) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   absl::StatusOr<std::filesystem::path> GetCurrentDirectory() override {
     return xls::GetCurrentDirectory();
   }
 
  private:
   LanguageServerAdapter& parent_;
+
+  // Hash of the contents of each file read from disk, keyed by path.
+  absl::flat_hash_map<std::string, size_t> disk_hashes_;
 };
 
+bool LanguageServerAdapter::ParseData::ImportsChangedOnDisk() const {
+  return down_cast<const LanguageServerFilesystem&>(import_data_->vfs())
+      .DiskFilesChanged();
+}
+
 LanguageServerAdapter::LanguageServerAdapter(
     std::string_view stdlib,
     const std::vector<std::filesystem::path>& dslx_paths)
@@ -194,11 +222,36 @@ LanguageServerAdapter::ParseData* LanguageServerAdapter::FindParsedForUri(
   return nullptr;
 }
 
+bool LanguageServerAdapter::NoOtherEditsSince(std::string_view uri,
+                                              int64_t edit_count) const {
+  for (const auto& [edited_uri, last_edit] : last_edit_) {
+    if (last_edit > edit_count && edited_uri != uri) {
+      return false;
+    }
+  }
+  return true;
+}
+
 absl::Status LanguageServerAdapter::Update(
     std::string_view file_uri, std::optional<std::string_view> dslx_code) {
+  // Imports may only be reused when the caller is telling us about an edit to
+  // this buffer; otherwise it is because a dependency may have changed.
+  bool may_reuse_imports = dslx_code.has_value();
+
   // Either update or get the last contents from the virtual filesystem map.
   if (dslx_code.has_value()) {
-    vfs_contents_[file_uri] = std::string{dslx_code.value()};
+    auto it = vfs_contents_.find(file_uri);
+    if (it != vfs_contents_.end() && it->second == dslx_code.value()) {
+      ParseData* parsed = FindParsedForUri(file_uri);
+      if (parsed != nullptr &&
+          NoOtherEditsSince(file_uri, parsed->edit_count()) &&
+          !parsed->ImportsChangedOnDisk()) {
+        return parsed->status();
+      }
+    } else {
+      vfs_contents_[file_uri] = std::string{dslx_code.value()};
+      last_edit_[file_uri] = ++edit_count_;
+    }
   } else {
     auto it = vfs_contents_.find(file_uri);
     if (it == vfs_contents_.end()) {
@@ -217,17 +270,33 @@ absl::Status LanguageServerAdapter::Update(
     return absl::OkStatus();
   }
 
+  const std::string& module_name = module_name_or.value();
+  absl::StatusOr<ImportTokens> subject = ImportTokens::FromString(module_name);
+
   auto inserted = uri_parse_data_.emplace(file_uri, nullptr);
   std::unique_ptr<ParseData>& insert_value = inserted.first->second;
 
-  ImportData import_data =
-      CreateImportData(stdlib_, dslx_paths_, kAllWarningsSet,
-                       std::make_unique<LanguageServerFilesystem>(*this));
-
-  import_data.SetImporterStackObserver(
-      [&](const Span& importer_span, const std::filesystem::path& imported) {
+  std::unique_ptr<ImportData> import_data;
+  if (may_reuse_imports && subject.ok() && insert_value != nullptr &&
+      NoOtherEditsSince(file_uri, insert_value->edit_count()) &&
+      !insert_value->ImportsChangedOnDisk()) {
+    import_data = insert_value->ReleaseImportData();
+    import_data->Remove(subject.value());
+  } else {
+    import_data = std::make_unique<ImportData>(
+        CreateImportData(stdlib_, dslx_paths_, kAllWarningsSet,
+                         std::make_unique<LanguageServerFilesystem>(*this)));
+  }
+  // The bytecode cache refers to the import data by address, and may hold
+  // bytecode for the previous version of this module.
+  import_data->SetBytecodeCache(
+      std::make_unique<BytecodeCache>(import_data.get()));
+
+  import_data->SetImporterStackObserver(
+      [this, file_table = &import_data->file_table()](
+          const Span& importer_span, const std::filesystem::path& imported) {
         std::string_view importer_filename =
-            importer_span.GetFilename(import_data.file_table());
+            importer_span.GetFilename(*file_table);
         CHECK(absl::StartsWith(importer_filename, "file://") ||
               absl::StartsWith(importer_filename, "memfile://"))
             << "importer_filename: " << importer_filename
@@ -236,22 +305,22 @@ absl::Status LanguageServerAdapter::Update(
         import_sensitivity_.NoteImportAttempt(importer_filename, imported_uri);
       });
 
-  const std::string& module_name = module_name_or.value();
-
   std::vector<CommentData> comments;
-  absl::StatusOr<TypecheckedModule> typechecked_module =
-      ParseAndTypecheck(dslx_code.value(), /*path=*/file_uri,
-                        /*module_name=*/module_name, &import_data, &comments);
+  absl::StatusOr<TypecheckedModule> typechecked_module = ParseAndTypecheck(
+      dslx_code.value(), /*path=*/file_uri,
+      /*module_name=*/module_name, import_data.get(), &comments);
 
   if (typechecked_module.ok()) {
     insert_value = std::make_unique<ParseData>(
-        std::move(import_data), TypecheckedModuleWithComments{
-                                    .tm = std::move(typechecked_module).value(),
-                                    .comments = Comments::Create(comments),
-                                });
+        std::move(import_data),
+        TypecheckedModuleWithComments{
+            .tm = std::move(typechecked_module).value(),
+            .comments = Comments::Create(comments),
+        },
+        edit_count_);
   } else {
-    insert_value = std::make_unique<ParseData>(std::move(import_data),
-                                               typechecked_module.status());
+    insert_value = std::make_unique<ParseData>(
+        std::move(import_data), typechecked_module.status(), edit_count_);
   }
 
   const absl::Duration duration = absl::Now() - start;
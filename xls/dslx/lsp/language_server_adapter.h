@@ -15,6 +15,7 @@
 #ifndef XLS_DSLX_LSP_LANGUAGE_SERVER_ADAPTER_H_
 #define XLS_DSLX_LSP_LANGUAGE_SERVER_ADAPTER_H_
 
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <iostream>
 #include <memory>
@@ -60,10 +61,15 @@ class LanguageServerAdapter {
   // `dslx_code` can be nullopt when we're re-evaluating the previous contents
   // again; i.e. because we think a dependency may have been corrected.
   //
-  // Note: this is parsing is triggered for every keystroke. Fine for now.
   // Successful and unsuccessful parses are memoized so that their status
   // and can be queried.
   //
+  // Analysis is incremental where possible: if `dslx_code` is unchanged from
+  // the last analysis the previous result is kept, and if no other buffer has
+  // been edited since then the imported modules (and their type information)
+  // are reused, re-analyzing only the module for `file_uri` itself. Passing
+  // nullopt always re-imports everything.
+  //
   // Implementation note: since we currently do not react to buffer closed
   // events in the buffer change listener, we keep track of every file ever
   // opened and never delete.
@@ -125,6 +131,10 @@ class LanguageServerAdapter {
   // Find parse result of opened file with given URI or nullptr, if not opened.
   ParseData* FindParsedForUri(std::string_view uri) const;
 
+  // Returns whether no buffer other than `uri` has been edited since
+  // `edit_count_` was `edit_count`.
+  bool NoOtherEditsSince(std::string_view uri, int64_t edit_count) const;
+
   struct TypecheckedModuleWithComments {
     TypecheckedModule tm;
     Comments comments;
@@ -135,15 +145,32 @@ class LanguageServerAdapter {
   // This could maybe be considered to be put in a single place.
   class ParseData {
    public:
-    ParseData(ImportData&& import_data,
-              absl::StatusOr<TypecheckedModuleWithComments> tmc)
-        : import_data_(std::move(import_data)), tmc_(std::move(tmc)) {}
+    ParseData(std::unique_ptr<ImportData> import_data,
+              absl::StatusOr<TypecheckedModuleWithComments> tmc,
+              int64_t edit_count)
+        : import_data_(std::move(import_data)),
+          tmc_(std::move(tmc)),
+          edit_count_(edit_count) {}
 
     bool ok() const { return tmc_.ok(); }
     absl::Status status() const { return tmc_.status(); }
 
-    ImportData& import_data() { return import_data_; }
-    FileTable& file_table() { return import_data_.file_table(); }
+    ImportData& import_data() { return *import_data_; }
+    FileTable& file_table() { return import_data_->file_table(); }
+
+    // Value of the adapter's edit counter when this analysis was performed.
+    int64_t edit_count() const { return edit_count_; }
+
+    // Hands the import data over to a subsequent analysis of the same buffer;
+    // this object must not be used afterwards.
+    std::unique_ptr<ImportData> ReleaseImportData() {
+      return std::move(import_data_);
+    }
+
+    // Returns whether a file imported from disk (i.e. not from an editor
+    // buffer) has changed since it was read, in which case the import data
+    // must not be reused.
+    bool ImportsChangedOnDisk() const;
     const Module& module() const {
       CHECK_OK(tmc_.status());
       return *tmc_->tm.module;
@@ -162,8 +189,10 @@ class LanguageServerAdapter {
     }
 
    private:
-    ImportData import_data_;
+    // Held by pointer as the bytecode cache refers to it by address.
+    std::unique_ptr<ImportData> import_data_;
     absl::StatusOr<TypecheckedModuleWithComments> tmc_;
+    int64_t edit_count_;
   };
 
   const std::string stdlib_;
@@ -176,6 +205,11 @@ class LanguageServerAdapter {
   // disk.
   absl::flat_hash_map<std::string, std::string> vfs_contents_;
 
+  // Number of edits seen (i.e. updates that changed a buffer's contents), and
+  // the value of that counter at the most recent edit of each buffer.
+  int64_t edit_count_ = 0;
+  absl::flat_hash_map<std::string, int64_t> last_edit_;
+
   ImportSensitivity import_sensitivity_;
 };
 
@@ -382,6 +382,86 @@ fn f() -> u32 { FOO })"));
   EXPECT_EQ(highlights[3].range.start.line, 4);
 }
 
+TEST(LanguageServerAdapterTest, RepeatedEditsOfImporter) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  LanguageServerAdapter adapter(kDefaultDslxStdlibPath,
+                                /*dslx_paths=*/{tempdir.path()});
+
+  std::string imported_uri =
+      absl::StrFormat("file://%s/imported.x", tempdir.path());
+  XLS_ASSERT_OK(
+      SetFileContents(tempdir.path() / "imported.x", "pub fn f() { () }"));
+
+  std::string importer_uri =
+      absl::StrFormat("file://%s/importer.x", tempdir.path());
+  const std::string_view kGoodContents = R"(import imported;
+
+fn main() { imported::f() }
+)";
+  const std::string_view kBadContents = R"(import imported;
+
+fn main() { imported::g() }
+)";
+  XLS_ASSERT_OK(adapter.Update(importer_uri, kGoodContents));
+  // Re-analyzing identical contents yields the same result.
+  XLS_ASSERT_OK(adapter.Update(importer_uri, kGoodContents));
+
+  // Edits of the importer alone keep working against the already-imported
+  // module, whether or not they typecheck.
+  EXPECT_THAT(adapter.Update(importer_uri, kBadContents),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(adapter.GenerateParseDiagnostics(importer_uri).size(), 1);
+  XLS_ASSERT_OK(adapter.Update(importer_uri, kGoodContents));
+  EXPECT_TRUE(adapter.GenerateParseDiagnostics(importer_uri).empty());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<verible::lsp::Location> definition_locations,
+      adapter.FindDefinitions(importer_uri, verible::lsp::Position{2, 13}));
+  ASSERT_EQ(definition_locations.size(), 1);
+  EXPECT_EQ(definition_locations.at(0).uri, imported_uri);
+
+  // Once the imported module's buffer is edited, the importer's next analysis
+  // observes the edit.
+  XLS_ASSERT_OK(adapter.Update(imported_uri, "pub fn g() { () }"));
+  XLS_ASSERT_OK(adapter.Update(importer_uri, kBadContents));
+  EXPECT_TRUE(adapter.GenerateParseDiagnostics(importer_uri).empty());
+}
+
+TEST(LanguageServerAdapterTest, EditOfImporterSeesImportChangedOnDisk) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  LanguageServerAdapter adapter(kDefaultDslxStdlibPath,
+                                /*dslx_paths=*/{tempdir.path()});
+
+  XLS_ASSERT_OK(
+      SetFileContents(tempdir.path() / "imported.x", "pub fn f() { () }"));
+
+  std::string importer_uri =
+      absl::StrFormat("file://%s/importer.x", tempdir.path());
+  const std::string_view kCallsF = R"(import imported;
+
+fn main() { imported::f() }
+)";
+  const std::string_view kCallsG = R"(import imported;
+
+fn main() { imported::g() }
+)";
+  XLS_ASSERT_OK(adapter.Update(importer_uri, kCallsF));
+
+  // The imported module changes outside of the editor, e.g. via a checkout;
+  // both an edit of the importer and a re-analysis of unchanged contents must
+  // observe it.
+  XLS_ASSERT_OK(
+      SetFileContents(tempdir.path() / "imported.x", "pub fn g() { () }"));
+  XLS_EXPECT_OK(adapter.Update(importer_uri, kCallsG));
+  EXPECT_TRUE(adapter.GenerateParseDiagnostics(importer_uri).empty());
+
+  XLS_ASSERT_OK(
+      SetFileContents(tempdir.path() / "imported.x", "pub fn f() { () }"));
+  EXPECT_THAT(adapter.Update(importer_uri, kCallsG),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(adapter.GenerateParseDiagnostics(importer_uri).size(), 1);
+}
+
 // This models a scenario where we observe a problem in `outer.x`, but that
 // problem actually stems from the import of `inner.x`.
 //
@@ -14,19 +14,28 @@
 
 #include "xls/dslx/run_routines/run_comparator.h"
 
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/module.h"
 #include "xls/dslx/interp_value.h"
@@ -40,20 +49,193 @@
 #include "xls/jit/function_jit.h"
 
 namespace xls::dslx {
+namespace {
 
-absl::StatusOr<FunctionJit*> RunComparator::GetOrCompileJitFunction(
-    std::string_view ir_name, xls::Function* ir_function) {
-  auto it = jit_cache_.find(ir_name);
-  if (it != jit_cache_.end()) {
+using JitCache = absl::flat_hash_map<std::string, std::unique_ptr<FunctionJit>>;
+
+// An interpreter result which is to be checked against the IR.
+struct PendingComparison {
+  std::string ir_name;
+  xls::Function* ir_function;
+  std::vector<Value> ir_args;
+  bool requires_implicit_token;
+  Value interp_ir_value;
+};
+
+absl::StatusOr<FunctionJit*> GetOrCompile(JitCache& cache,
+                                          std::string_view ir_name,
+                                          xls::Function* ir_function) {
+  auto it = cache.find(ir_name);
+  if (it != cache.end()) {
     return it->second.get();
   }
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<FunctionJit> jit,
                        FunctionJit::Create(ir_function));
   FunctionJit* result = jit.get();
-  jit_cache_[ir_name] = std::move(jit);
+  cache[ir_name] = std::move(jit);
   return result;
 }
 
+absl::Status Compare(CompareMode mode, JitCache& jit_cache,
+                     const PendingComparison& comparison) {
+  const char* mode_str = nullptr;
+  Value ir_result;
+  switch (mode) {
+    case CompareMode::kJit: {  // Compare to IR JIT.
+      // TODO(https://github.com/google/xls/issues/506): Also compare events
+      // once the DSLX interpreter supports them (and the JIT supports traces).
+      XLS_ASSIGN_OR_RETURN(FunctionJit * jit,
+                           GetOrCompile(jit_cache, comparison.ir_name,
+                                        comparison.ir_function));
+      XLS_ASSIGN_OR_RETURN(ir_result,
+                           DropInterpreterEvents(jit->Run(comparison.ir_args)));
+      mode_str = "JIT";
+      break;
+    }
+    case CompareMode::kInterpreter: {  // Compare to IR interpreter.
+      XLS_ASSIGN_OR_RETURN(ir_result,
+                           DropInterpreterEvents(InterpretFunction(
+                               comparison.ir_function, comparison.ir_args)));
+      mode_str = "interpreter";
+      break;
+    }
+  }
+
+  if (comparison.requires_implicit_token) {
+    // Slice off the first value.
+    XLS_RET_CHECK(ir_result.element(0).IsToken());
+    XLS_RET_CHECK_EQ(ir_result.size(), 2);
+    Value real_ir_result = ir_result.element(1);
+    ir_result = std::move(real_ir_result);
+  }
+
+  if (comparison.interp_ir_value != ir_result) {
+    return absl::InternalError(absl::StrFormat(
+        "IR %s produced a different value from the DSL "
+        "interpreter for %s; IR %s: %s "
+        "DSL interpreter: %s",
+        mode_str, comparison.ir_function->name(), mode_str,
+        ir_result.ToString(), comparison.interp_ir_value.ToString()));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+// A background thread performing queued comparisons in order.
+class AsyncCompareWorker {
+ public:
+  explicit AsyncCompareWorker(CompareMode mode)
+      : mode_(mode), thread_([this] { Run(); }) {}
+
+  ~AsyncCompareWorker() {
+    {
+      absl::MutexLock lock(&mutex_);
+      stopping_ = true;
+    }
+    thread_.Join();
+  }
+
+  void Enqueue(PendingComparison comparison) {
+    absl::MutexLock lock(&mutex_);
+    queue_.push_back(std::move(comparison));
+  }
+
+  // Returns (and clears) the first mismatch found so far without waiting.
+  absl::Status TakeStatus() {
+    absl::MutexLock lock(&mutex_);
+    return std::exchange(status_, absl::OkStatus());
+  }
+
+  // As above, but first waits for all queued comparisons to complete.
+  absl::Status Flush() {
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(
+        +[](AsyncCompareWorker* w) ABSL_EXCLUSIVE_LOCKS_REQUIRED(w->mutex_) {
+          return w->queue_.empty() && !w->busy_;
+        },
+        this));
+    return std::exchange(status_, absl::OkStatus());
+  }
+
+ private:
+  void Run() {
+    while (true) {
+      PendingComparison comparison;
+      {
+        absl::MutexLock lock(&mutex_);
+        busy_ = false;
+        mutex_.Await(absl::Condition(
+            +[](AsyncCompareWorker* w) ABSL_EXCLUSIVE_LOCKS_REQUIRED(
+                 w->mutex_) { return !w->queue_.empty() || w->stopping_; },
+            this));
+        if (queue_.empty()) {
+          return;
+        }
+        comparison = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+      }
+      absl::Status status = Compare(mode_, jit_cache_, comparison);
+      if (!status.ok()) {
+        absl::MutexLock lock(&mutex_);
+        status_.Update(status);
+      }
+    }
+  }
+
+  const CompareMode mode_;
+  // Only used by the worker thread.
+  JitCache jit_cache_;
+
+  absl::Mutex mutex_;
+  std::deque<PendingComparison> queue_ ABSL_GUARDED_BY(mutex_);
+  bool busy_ ABSL_GUARDED_BY(mutex_) = false;
+  bool stopping_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::Status status_ ABSL_GUARDED_BY(mutex_);
+
+  // Declared last so that it starts after the other members are initialized.
+  Thread thread_;
+};
+
+RunComparator::RunComparator(CompareMode mode, ComparePolicy policy)
+    : mode_(mode), policy_(std::move(policy)) {
+  for (int64_t i = 0; i < policy_.async_threads; ++i) {
+    async_workers_.push_back(std::make_unique<AsyncCompareWorker>(mode_));
+  }
+}
+
+RunComparator::~RunComparator() = default;
+
+absl::StatusOr<FunctionJit*> RunComparator::GetOrCompileJitFunction(
+    std::string_view ir_name, xls::Function* ir_function) {
+  return GetOrCompile(jit_cache_, ir_name, ir_function);
+}
+
+bool RunComparator::ShouldCompare(const Function* f,
+                                  std::string_view ir_name) {
+  double rate = policy_.sample_rate;
+  if (auto it = policy_.function_sample_rates.find(f->identifier());
+      it != policy_.function_sample_rates.end()) {
+    rate = it->second;
+  }
+  int64_t invocation = invocation_counts_[ir_name]++;
+  // Invocation `n` is selected when it takes the number of invocations which
+  // should have been compared, ceil(n * rate), up to the next integer.
+  bool selected = std::ceil(static_cast<double>(invocation + 1) * rate) >
+                  std::ceil(static_cast<double>(invocation) * rate);
+  if (selected && policy_.max_compares_per_function.has_value()) {
+    selected = compare_counts_[ir_name] < *policy_.max_compares_per_function;
+  }
+  if (!selected) {
+    ++skipped_count_;
+    return false;
+  }
+  ++compare_counts_[ir_name];
+  ++compared_count_;
+  return true;
+}
+
 absl::Status RunComparator::RunComparison(Package* ir_package,
                                           bool requires_implicit_token,
                                           const dslx::Function* f,
@@ -62,6 +244,11 @@ absl::Status RunComparator::RunComparison(Package* ir_package,
                                           const InterpValue& got) {
   XLS_RET_CHECK(ir_package != nullptr);
 
+  // Report mismatches found in the background since the last call.
+  for (std::unique_ptr<AsyncCompareWorker>& worker : async_workers_) {
+    XLS_RETURN_IF_ERROR(worker->TakeStatus());
+  }
+
   XLS_ASSIGN_OR_RETURN(
       std::string ir_name,
       MangleDslxName(f->owner()->name(), f->identifier(),
@@ -81,63 +268,47 @@ absl::Status RunComparator::RunComparison(Package* ir_package,
     return absl::OkStatus();
   }
 
-  xls::Function* ir_function = *get_result;
+  if (!ShouldCompare(f, ir_name)) {
+    return absl::OkStatus();
+  }
 
-  XLS_ASSIGN_OR_RETURN(std::vector<Value> ir_args,
+  PendingComparison comparison{
+      .ir_function = *get_result,
+      .requires_implicit_token = requires_implicit_token};
+
+  XLS_ASSIGN_OR_RETURN(comparison.ir_args,
                        InterpValue::ConvertValuesToIr(args));
 
   // We need to know if the function-that-we're-doing-a-comparison-for needs an
   // implicit token.
   if (requires_implicit_token) {
-    ir_args.insert(ir_args.begin(), Value::Bool(true));
-    ir_args.insert(ir_args.begin(), Value::Token());
-  }
-
-  const char* mode_str = nullptr;
-  Value ir_result;
-  switch (mode_) {
-    case CompareMode::kJit: {  // Compare to IR JIT.
-      // TODO(https://github.com/google/xls/issues/506): Also compare events
-      // once the DSLX interpreter supports them (and the JIT supports traces).
-      XLS_ASSIGN_OR_RETURN(FunctionJit * jit,
-                           GetOrCompileJitFunction(ir_name, ir_function));
-      XLS_ASSIGN_OR_RETURN(ir_result, DropInterpreterEvents(jit->Run(ir_args)));
-      mode_str = "JIT";
-      break;
-    }
-    case CompareMode::kInterpreter: {  // Compare to IR interpreter.
-      XLS_ASSIGN_OR_RETURN(ir_result, DropInterpreterEvents(InterpretFunction(
-                                          ir_function, ir_args)));
-      mode_str = "interpreter";
-      break;
-    }
-  }
-
-  if (requires_implicit_token) {
-    // Slice off the first value.
-    XLS_RET_CHECK(ir_result.element(0).IsToken());
-    XLS_RET_CHECK_EQ(ir_result.size(), 2);
-    Value real_ir_result = ir_result.element(1);
-    ir_result = std::move(real_ir_result);
+    comparison.ir_args.insert(comparison.ir_args.begin(), Value::Bool(true));
+    comparison.ir_args.insert(comparison.ir_args.begin(), Value::Token());
   }
 
   // Convert the interpreter value to an IR value so we can compare it.
   //
   // Note this conversion is lossy, but that's ok because we're just looking for
   // mismatches.
-  XLS_ASSIGN_OR_RETURN(Value interp_ir_value, got.ConvertToIr());
+  XLS_ASSIGN_OR_RETURN(comparison.interp_ir_value, got.ConvertToIr());
+  comparison.ir_name = std::move(ir_name);
 
-  if (interp_ir_value != ir_result) {
-    return absl::InternalError(
-        absl::StrFormat("IR %s produced a different value from the DSL "
-                        "interpreter for %s; IR %s: %s "
-                        "DSL interpreter: %s",
-                        mode_str, ir_function->name(), mode_str,
-                        ir_result.ToString(), interp_ir_value.ToString()));
+  if (async_workers_.empty()) {
+    return Compare(mode_, jit_cache_, comparison);
   }
+  size_t shard = absl::HashOf(comparison.ir_name) % async_workers_.size();
+  async_workers_[shard]->Enqueue(std::move(comparison));
   return absl::OkStatus();
 }
 
+absl::Status RunComparator::Flush() {
+  absl::Status status;
+  for (std::unique_ptr<AsyncCompareWorker>& worker : async_workers_) {
+    status.Update(worker->Flush());
+  }
+  return status;
+}
+
 absl::StatusOr<InterpreterResult<xls::Value>> RunComparator::RunIrFunction(
     std::string_view ir_name, xls::Function* ir_function,
     absl::Span<const xls::Value> ir_args) {
@@ -17,8 +17,10 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
@@ -43,6 +45,30 @@ enum class CompareMode : uint8_t {
   kInterpreter,
 };
 
+// Controls which of the DSLX interpreter's function invocations a
+// RunComparator checks, and where the checking is done.
+//
+//   sample_rate: Fraction of the invocations of each function which are
+//    compared. Invocations are selected deterministically, starting with the
+//    first, e.g. a rate of 0.25 compares invocations 0, 4, 8, ...
+//   function_sample_rates: Overrides of `sample_rate` keyed by DSLX function
+//    identifier.
+//   max_compares_per_function: If set, at most this many invocations of each
+//    function (each parametric instantiation counting separately) are
+//    compared.
+//   async_threads: If positive, IR evaluation (including JIT compilation) and
+//    comparison happen on this many background threads; `RunComparison`
+//    only converts the values and queues the work. A mismatch is returned by
+//    the next `RunComparison` or `Flush` call after it is found.
+struct ComparePolicy {
+  double sample_rate = 1.0;
+  absl::flat_hash_map<std::string, double> function_sample_rates;
+  std::optional<int64_t> max_compares_per_function;
+  int64_t async_threads = 0;
+};
+
+class AsyncCompareWorker;
+
 // Helper object that is used as a post-execution hook in the interpreter,
 // comparing interpreter results to results computed by the JIT to check that
 // they're equivalent.
@@ -51,7 +77,9 @@ enum class CompareMode : uint8_t {
 // inspect cache state more easily than closing over it, e.g. for testing.
 class RunComparator : public AbstractRunComparator {
  public:
-  explicit RunComparator(CompareMode mode) : mode_(mode) {}
+  explicit RunComparator(CompareMode mode,
+                         ComparePolicy policy = ComparePolicy());
+  ~RunComparator() override;
 
   absl::Status RunComparison(Package* ir_package, bool requires_implicit_token,
                              const Function* f,
@@ -63,22 +91,46 @@ class RunComparator : public AbstractRunComparator {
       std::string_view ir_name, xls::Function* ir_function,
       absl::Span<const xls::Value> ir_args) override;
 
+  absl::Status Flush() override;
+
   // Returns the cached or newly-compiled jit function for ir_name.  ir_name has
   // already been mangled (see MangleDslxName) so it should be unique in the
   // program and is used as the cache key.
   //
   // Note: There is no locking in jit compilation or on the jit function cache
-  // so this function is *not* thread-safe.
+  // so this function is *not* thread-safe. Comparisons done on background
+  // threads (see `ComparePolicy::async_threads`) use their own caches.
   absl::StatusOr<FunctionJit*> GetOrCompileJitFunction(
       std::string_view ir_name, xls::Function* ir_function);
 
+  // Number of invocations passed to `RunComparison` which were (or, in async
+  // mode, were queued to be) compared and which were skipped by the policy.
+  int64_t compared_count() const { return compared_count_; }
+  int64_t skipped_count() const { return skipped_count_; }
+
  private:
   XLS_FRIEND_TEST(RunRoutinesTest, TestInvokedFunctionDoesJit);
   XLS_FRIEND_TEST(RunRoutinesTest, QuickcheckInvokedFunctionDoesJit);
   XLS_FRIEND_TEST(RunRoutinesTest, NoSeedStillQuickChecks);
+  XLS_FRIEND_TEST(RunRoutinesTest, AsyncComparisons);
+
+  // Returns whether the policy selects the next invocation of the function
+  // `f` whose mangled name is `ir_name` for comparison.
+  bool ShouldCompare(const Function* f, std::string_view ir_name);
 
   absl::flat_hash_map<std::string, std::unique_ptr<FunctionJit>> jit_cache_;
   CompareMode mode_;
+  ComparePolicy policy_;
+
+  // Per mangled function name: the number of invocations seen and compared.
+  absl::flat_hash_map<std::string, int64_t> invocation_counts_;
+  absl::flat_hash_map<std::string, int64_t> compare_counts_;
+  int64_t compared_count_ = 0;
+  int64_t skipped_count_ = 0;
+
+  // Background workers when `policy_.async_threads` is positive. Each
+  // function is always compared by the same worker, so it is compiled once.
+  std::vector<std::unique_ptr<AsyncCompareWorker>> async_workers_;
 };
 
 }  // namespace xls::dslx
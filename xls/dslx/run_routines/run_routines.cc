@@ -17,8 +17,11 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <ctime>
+#include <filesystem>  // NOLINT
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -39,9 +42,12 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "xls/common/math_util.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/dslx/bytecode/bytecode.h"
@@ -75,7 +81,11 @@
 #include "xls/ir/events.h"
 #include "xls/ir/nodes.h"
 #include "xls/ir/package.h"
+#include "xls/ir/type.h"
 #include "xls/ir/value.h"
+#include "xls/ir/value_utils.h"
+#include "xls/jit/function_jit.h"
+#include "xls/jit/jit_runtime.h"
 #include "xls/passes/optimization_pass_pipeline.h"
 #include "xls/solvers/z3_ir_translator.h"
 #include "re2/re2.h"
@@ -87,6 +97,49 @@ namespace {
 constexpr int kUnitSpaces = 7;
 constexpr int kQuickcheckSpaces = 15;
 
+// The outcome of running a single unit test or test proc, held until the test
+// is reported.
+struct TestOutcome {
+  absl::Time start;
+  absl::Time end;
+  absl::StatusOr<RunResult> result;
+  // Trace messages emitted by the test, in order.
+  std::vector<std::pair<Span, std::string>> traces;
+  // Set if the test ran against its own copy of the module, in which case
+  // spans in `result` and `traces` refer to this file table.
+  std::unique_ptr<ImportData> import_data;
+};
+
+// Filesystem which forwards to a filesystem owned elsewhere, so that several
+// `ImportData`s can read imports from the same (caller-provided) filesystem.
+class ForwardingFilesystem : public VirtualizableFilesystem {
+ public:
+  explicit ForwardingFilesystem(VirtualizableFilesystem& vfs) : vfs_(vfs) {}
+
+  absl::Status FileExists(const std::filesystem::path& path) override {
+    return vfs_.FileExists(path);
+  }
+  absl::StatusOr<std::string> GetFileContents(
+      const std::filesystem::path& path) override {
+    return vfs_.GetFileContents(path);
+  }
+  absl::StatusOr<std::filesystem::path> GetCurrentDirectory() override {
+    return vfs_.GetCurrentDirectory();
+  }
+
+ private:
+  VirtualizableFilesystem& vfs_;
+};
+
+// Returns the filesystem an `ImportData` created for `options` should use.
+std::unique_ptr<VirtualizableFilesystem> MakeFilesystem(
+    const ParseAndTestOptions& options) {
+  if (options.vfs == nullptr) {
+    return std::make_unique<RealFilesystem>();
+  }
+  return std::make_unique<ForwardingFilesystem>(*options.vfs);
+}
+
 void HandleError(TestResultData& result, const absl::Status& status,
                  std::string_view test_name, const Pos& start_pos,
                  const absl::Time& start, const absl::Duration& duration,
@@ -133,8 +186,6 @@ void HandleError(TestResultData& result, const absl::Status& status,
 absl::Status RunDslxTestFunction(ImportData* import_data, TypeInfo* type_info,
                                  Module* module, TestFunction* tf,
                                  const BytecodeInterpreterOptions& options) {
-  auto cache = std::make_unique<BytecodeCache>(import_data);
-  import_data->SetBytecodeCache(std::move(cache));
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<BytecodeFunction> bf,
       BytecodeEmitter::Emit(
@@ -149,9 +200,6 @@ absl::Status RunDslxTestFunction(ImportData* import_data, TypeInfo* type_info,
 absl::Status RunDslxTestProc(ImportData* import_data, TypeInfo* type_info,
                              Module* module, TestProc* tp,
                              const BytecodeInterpreterOptions& options) {
-  auto cache = std::make_unique<BytecodeCache>(import_data);
-  import_data->SetBytecodeCache(std::move(cache));
-
   XLS_ASSIGN_OR_RETURN(TypeInfo * ti,
                        type_info->GetTopLevelProcTypeInfo(tp->proc()));
 
@@ -213,6 +261,10 @@ absl::StatusOr<std::unique_ptr<AbstractParsedTestRunner>>
 DslxInterpreterTestRunner ::CreateTestRunner(ImportData* import_data,
                                              TypeInfo* type_info,
                                              Module* module) const {
+  // Note: the cache is (re)installed here as `import_data` may have been moved
+  // since its cache was created. All tests run by the returned runner share
+  // this (thread-safe) cache.
+  import_data->SetBytecodeCache(std::make_unique<BytecodeCache>(import_data));
   return std::make_unique<DslxInterpreterParsedTestRunner>(import_data,
                                                            type_info, module);
 }
@@ -331,6 +383,214 @@ absl::StatusOr<QuickCheckResults> DoQuickCheck(
   return results;
 }
 
+double BatchedQuickCheckResults::SamplesPerSecond() const {
+  double seconds = absl::ToDoubleSeconds(elapsed);
+  return seconds > 0 ? static_cast<double>(samples_evaluated) / seconds : 0.0;
+}
+
+namespace {
+
+// Returns the native layout of `value` as a buffer of `size` bytes.
+std::vector<uint8_t> NativeLayoutOf(JitRuntime* runtime, const Value& value,
+                                    xls::Type* type, int64_t size) {
+  std::vector<uint8_t> buffer(size, 0);
+  runtime->BlitValueToBuffer(value, type, absl::MakeSpan(buffer));
+  return buffer;
+}
+
+// Fills `count` consecutive native-layout values of `mask.size()` bytes each
+// at the start of `buffer` with random data. Bits clear in `mask` (padding)
+// are cleared so the JIT sees well-formed values.
+void FillRandomNativeValues(std::mt19937_64& rng,
+                            absl::Span<const uint8_t> mask, int64_t count,
+                            absl::Span<uint8_t> buffer) {
+  int64_t size = mask.size();
+  for (int64_t i = 0; i < count * size; i += sizeof(uint64_t)) {
+    uint64_t word = rng();
+    std::memcpy(buffer.data() + i, &word,
+                std::min<int64_t>(sizeof(uint64_t), count * size - i));
+  }
+  for (int64_t sample = 0; sample < count; ++sample) {
+    uint8_t* value = buffer.data() + sample * size;
+    for (int64_t i = 0; i < size; ++i) {
+      value[i] &= mask[i];
+    }
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<BatchedQuickCheckResults> DoBatchedQuickCheck(
+    xls::Function* xls_function, int64_t seed, int64_t num_tests,
+    const BatchedQuickCheckOptions& options) {
+  XLS_RET_CHECK_GT(options.threads, 0);
+  XLS_RET_CHECK_GT(options.batch_size, 0);
+  const absl::Time start = absl::Now();
+  const int64_t batch_size = options.batch_size;
+  const int64_t batch_count = CeilOfRatio(num_tests, batch_size);
+
+  // The function is compiled once; batches run concurrently on it with their
+  // own buffers.
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<FunctionJit> jit,
+                       FunctionJit::Create(xls_function));
+  JitRuntime* runtime = jit->runtime();
+  absl::Span<xls::Param* const> params = xls_function->params();
+  std::vector<std::vector<uint8_t>> arg_masks;
+  arg_masks.reserve(params.size());
+  for (int64_t i = 0; i < params.size(); ++i) {
+    xls::Type* type = params[i]->GetType();
+    arg_masks.push_back(NativeLayoutOf(runtime, AllOnesOfType(type), type,
+                                       jit->GetArgTypeSize(i)));
+  }
+
+  // The predicate holds iff any bit of the result under this mask is set. In
+  // the case of an implicit token signature the result is (token, bool) and
+  // only the boolean is considered.
+  xls::Type* return_type = xls_function->GetType()->return_type();
+  Value predicate_mask = AllOnesOfType(return_type);
+  if (return_type->IsTuple()) {
+    xls::TupleType* tuple_type = return_type->AsTupleOrDie();
+    XLS_RET_CHECK_EQ(tuple_type->size(), 2);
+    predicate_mask =
+        Value::Tuple({ZeroOfType(tuple_type->element_type(0)),
+                      AllOnesOfType(tuple_type->element_type(1))});
+  }
+  const std::vector<uint8_t> result_mask = NativeLayoutOf(
+      runtime, predicate_mask, return_type, jit->GetReturnTypeSize());
+  const int64_t result_size = result_mask.size();
+
+  // Index of the earliest falsifying sample found so far; no batch starting at
+  // or beyond it needs to be evaluated.
+  std::atomic<int64_t> first_falsified = num_tests;
+  std::atomic<int64_t> samples_evaluated = 0;
+  // The earliest falsifying example and the earliest error, guarded by
+  // `mutex`. Errors are indexed by the sample which produced them, or by the
+  // first sample of the batch when no single sample is responsible.
+  absl::Mutex mutex;
+  std::optional<int64_t> falsifying_index;
+  std::vector<Value> falsifying_args;
+  std::optional<int64_t> error_index;
+  absl::Status error;
+
+  // Lowers `first_falsified` to `index` so later batches are skipped.
+  auto stop_at = [&](int64_t index) {
+    int64_t current = first_falsified.load();
+    while (index < current &&
+           !first_falsified.compare_exchange_weak(current, index)) {
+    }
+  };
+  auto record_error = [&](int64_t index, absl::Status status) {
+    stop_at(index);
+    absl::MutexLock lock(&mutex);
+    if (!error_index.has_value() || index < *error_index) {
+      error_index = index;
+      error = std::move(status);
+    }
+  };
+  auto predicate_holds = [&](const uint8_t* result) {
+    bool holds = false;
+    for (int64_t i = 0; i < result_size; ++i) {
+      holds |= (result[i] & result_mask[i]) != 0;
+    }
+    return holds;
+  };
+
+  auto run_batch = [&](int64_t batch) -> absl::Status {
+    const int64_t begin = batch * batch_size;
+    const int64_t count = std::min(batch_size, num_tests - begin);
+
+    // Each batch is seeded separately so that a sample's arguments do not
+    // depend on which thread evaluates it.
+    std::seed_seq seed_seq{static_cast<uint32_t>(seed),
+                           static_cast<uint32_t>(seed >> 32),
+                           static_cast<uint32_t>(batch),
+                           static_cast<uint32_t>(batch >> 32)};
+    std::mt19937_64 rng(seed_seq);
+    std::vector<std::vector<uint8_t>> arg_batches;
+    std::vector<const uint8_t*> arg_views;
+    for (const std::vector<uint8_t>& mask : arg_masks) {
+      std::vector<uint8_t>& arg_batch =
+          arg_batches.emplace_back(count * mask.size());
+      FillRandomNativeValues(rng, mask, count, absl::MakeSpan(arg_batch));
+      arg_views.push_back(arg_batch.data());
+    }
+    auto sample_views = [&](int64_t sample) {
+      std::vector<const uint8_t*> views;
+      for (int64_t i = 0; i < arg_views.size(); ++i) {
+        views.push_back(arg_views[i] + sample * arg_masks[i].size());
+      }
+      return views;
+    };
+    std::vector<uint8_t> results(count * result_size);
+    InterpreterEvents events;
+    XLS_RETURN_IF_ERROR(jit->RunBatchedWithViews(
+        arg_views, absl::MakeSpan(results), count, &events));
+    samples_evaluated += count;
+
+    // The events of a batch do not say which sample failed an assertion, so
+    // such a batch is re-run one sample at a time. As in the serial path the
+    // outcome is decided by the first sample which either fails an assertion
+    // or falsifies the predicate.
+    const bool asserted = !InterpreterEventsToStatus(events).ok();
+    for (int64_t sample = 0; sample < count; ++sample) {
+      const int64_t index = begin + sample;
+      uint8_t* result = results.data() + sample * result_size;
+      if (asserted) {
+        InterpreterEvents sample_events;
+        XLS_RETURN_IF_ERROR(jit->RunBatchedWithViews(
+            sample_views(sample), absl::MakeSpan(result, result_size),
+            /*count=*/1, &sample_events));
+        if (absl::Status status = InterpreterEventsToStatus(sample_events);
+            !status.ok()) {
+          record_error(index, std::move(status));
+          return absl::OkStatus();
+        }
+      }
+      if (predicate_holds(result)) {
+        continue;
+      }
+      stop_at(index);
+      absl::MutexLock lock(&mutex);
+      if (!falsifying_index.has_value() || index < *falsifying_index) {
+        falsifying_index = index;
+        falsifying_args.clear();
+        std::vector<const uint8_t*> views = sample_views(sample);
+        for (int64_t i = 0; i < params.size(); ++i) {
+          falsifying_args.push_back(
+              runtime->UnpackBuffer(views[i], params[i]->GetType()));
+        }
+      }
+      return absl::OkStatus();
+    }
+    // No sample failed an assertion on its own; report the batch's events.
+    return InterpreterEventsToStatus(events);
+  };
+
+  ParallelFor(batch_count, options.threads, [&](int64_t batch) {
+    if (batch * batch_size >= first_falsified.load()) {
+      return;
+    }
+    if (absl::Status status = run_batch(batch); !status.ok()) {
+      // Later batches are skipped as though the error falsified the predicate.
+      record_error(batch * batch_size, std::move(status));
+    }
+  });
+
+  absl::MutexLock lock(&mutex);
+  if (error_index.has_value() &&
+      (!falsifying_index.has_value() || *error_index < *falsifying_index)) {
+    return error;
+  }
+  BatchedQuickCheckResults results{.tests_run = num_tests,
+                                   .samples_evaluated = samples_evaluated};
+  if (falsifying_index.has_value()) {
+    results.tests_run = *falsifying_index + 1;
+    results.falsifying_args = std::move(falsifying_args);
+  }
+  results.elapsed = absl::Now() - start;
+  return results;
+}
+
 struct QuickcheckIrFn {
   std::string ir_name;
   xls::Function* ir_function;
@@ -366,25 +626,46 @@ static absl::StatusOr<QuickcheckIrFn> FindQuickcheckIrFn(Function* fn,
 
 static absl::Status RunQuickCheck(AbstractRunComparator* run_comparator,
                                   Package* ir_package, QuickCheck* quickcheck,
-                                  TypeInfo* type_info, int64_t seed) {
+                                  TypeInfo* type_info, int64_t seed,
+                                  int64_t quickcheck_threads) {
   // Note: DSLX function.
   Function* fn = quickcheck->fn();
 
   XLS_ASSIGN_OR_RETURN(QuickcheckIrFn qc_fn,
                        FindQuickcheckIrFn(fn, ir_package));
 
-  XLS_ASSIGN_OR_RETURN(
-      QuickCheckResults qc_results,
-      DoQuickCheck(qc_fn.ir_function, qc_fn.ir_name, run_comparator, seed,
-                   quickcheck->GetTestCountOrDefault()));
-  const auto& [arg_sets, results] = qc_results;
-  XLS_ASSIGN_OR_RETURN(Bits last_result, results.back().GetBitsWithStatus());
-  if (!last_result.IsZero()) {
-    // Did not find a falsifying example.
-    return absl::OkStatus();
+  int64_t tests_run;
+  std::vector<Value> last_argset;
+  if (quickcheck_threads > 0) {
+    XLS_ASSIGN_OR_RETURN(
+        BatchedQuickCheckResults qc_results,
+        DoBatchedQuickCheck(
+            qc_fn.ir_function, seed, quickcheck->GetTestCountOrDefault(),
+            BatchedQuickCheckOptions{.threads = quickcheck_threads}));
+    std::cerr << absl::StreamFormat(
+        "[ QUICKCHECK THROUGHPUT ] %d samples in %s (%.0f samples/s)\n",
+        qc_results.samples_evaluated, absl::FormatDuration(qc_results.elapsed),
+        qc_results.SamplesPerSecond());
+    if (!qc_results.falsifying_args.has_value()) {
+      return absl::OkStatus();
+    }
+    tests_run = qc_results.tests_run;
+    last_argset = *std::move(qc_results.falsifying_args);
+  } else {
+    XLS_ASSIGN_OR_RETURN(
+        QuickCheckResults qc_results,
+        DoQuickCheck(qc_fn.ir_function, qc_fn.ir_name, run_comparator, seed,
+                     quickcheck->GetTestCountOrDefault()));
+    auto& [arg_sets, results] = qc_results;
+    XLS_ASSIGN_OR_RETURN(Bits last_result, results.back().GetBitsWithStatus());
+    if (!last_result.IsZero()) {
+      // Did not find a falsifying example.
+      return absl::OkStatus();
+    }
+    tests_run = results.size();
+    last_argset = std::move(arg_sets.back());
   }
 
-  const std::vector<Value>& last_argset = arg_sets.back();
   XLS_ASSIGN_OR_RETURN(FunctionType * fn_type,
                        type_info->GetItemAs<FunctionType>(fn));
   const std::vector<std::unique_ptr<Type>>& params = fn_type->params();
@@ -404,14 +685,15 @@ static absl::Status RunQuickCheck(AbstractRunComparator* run_comparator,
   return FailureErrorStatus(
       fn->span(),
       absl::StrFormat("Found falsifying example after %d tests: [%s]",
-                      results.size(), dslx_argset_str),
+                      tests_run, dslx_argset_str),
       *fn->owner()->file_table());
 }
 
 static absl::Status RunQuickChecksIfJitEnabled(
     const RE2* test_filter, Module* entry_module, TypeInfo* type_info,
     AbstractRunComparator* run_comparator, Package* ir_package,
-    std::optional<int64_t> seed, TestResultData& result) {
+    std::optional<int64_t> seed, int64_t quickcheck_threads,
+    TestResultData& result) {
   if (run_comparator == nullptr) {
     // TODO(leary): 2024-02-08 Note that this skips /all/ the quickchecks so we
     // don't make an entry for it right now in the test XML.
@@ -452,7 +734,8 @@ static absl::Status RunQuickChecksIfJitEnabled(
     std::cerr << "[ RUN QUICKCHECK        ] " << quickcheck_name
               << " count: " << quickcheck->GetTestCountOrDefault() << "\n";
     const absl::Status status =
-        RunQuickCheck(run_comparator, ir_package, quickcheck, type_info, *seed);
+        RunQuickCheck(run_comparator, ir_package, quickcheck, type_info, *seed,
+                      quickcheck_threads);
     const absl::Duration duration = absl::Now() - test_case_start;
     if (!status.ok()) {
       HandleError(result, status, quickcheck_name, start_pos, test_case_start,
@@ -660,7 +943,8 @@ absl::StatusOr<TestResultData> AbstractTestRunner::ParseAndTest(
 
   auto import_data =
       CreateImportData(options.dslx_stdlib_path, options.dslx_paths,
-                       options.warnings, std::make_unique<RealFilesystem>());
+                       options.warnings, MakeFilesystem(options));
+  import_data.set_typecheck_imports_lazily(options.typecheck_imports_lazily);
   FileTable& file_table = import_data.file_table();
 
   absl::StatusOr<TypecheckedModule> tm_or =
@@ -697,7 +981,6 @@ absl::StatusOr<TestResultData> AbstractTestRunner::ParseAndTest(
   // If JIT comparisons are "on", we register a post-evaluation hook to compare
   // with the interpreter.
   std::unique_ptr<Package> ir_package;
-  PostFnEvalHook post_fn_eval_hook;
   if (options.run_comparator != nullptr) {
     absl::StatusOr<dslx::PackageConversionData> ir_package_or =
         ConvertModuleToPackage(entry_module, &import_data,
@@ -713,28 +996,141 @@ absl::StatusOr<TestResultData> AbstractTestRunner::ParseAndTest(
                 "turning off comparison with `--compare=none`: ";
     }
     ir_package = std::move(ir_package_or).value().package;
-    post_fn_eval_hook = [&ir_package, &import_data, &options](
-                            const Function* f,
-                            absl::Span<const InterpValue> args,
-                            const ParametricEnv* parametric_env,
-                            const InterpValue& got) -> absl::Status {
+  }
+
+  // Comparisons are serialized as run comparators are not thread-safe.
+  absl::Mutex comparator_mutex;
+  // Returns the post-evaluation hook for functions owned by `hook_import_data`
+  // (tests run in isolation have their own copy of the module).
+  auto make_post_fn_eval_hook =
+      [&](ImportData* hook_import_data) -> PostFnEvalHook {
+    if (ir_package == nullptr) {
+      return nullptr;
+    }
+    return [&ir_package, &comparator_mutex, hook_import_data, &options](
+               const Function* f, absl::Span<const InterpValue> args,
+               const ParametricEnv* parametric_env,
+               const InterpValue& got) -> absl::Status {
       XLS_RET_CHECK(f != nullptr);
       std::optional<bool> requires_implicit_token =
-          import_data.GetRootTypeInfoForNode(f)
+          hook_import_data->GetRootTypeInfoForNode(f)
               .value()
               ->GetRequiresImplicitToken(*f);
       XLS_RET_CHECK(requires_implicit_token.has_value());
+      absl::MutexLock lock(&comparator_mutex);
       return options.run_comparator->RunComparison(ir_package.get(),
                                                    *requires_implicit_token, f,
                                                    args, parametric_env, got);
     };
-  }
+  };
+  // Waits for comparisons the comparator may still be doing in the background
+  // so that a mismatch is reported as a failure of the test which caused it.
+  // Tests running concurrently share the comparator, so there a mismatch may
+  // instead be attributed to another test that is still running.
+  auto flush_comparisons = [&](absl::StatusOr<RunResult>& run_result) {
+    if (ir_package == nullptr) {
+      return;
+    }
+    absl::Status status;
+    {
+      absl::MutexLock lock(&comparator_mutex);
+      status = options.run_comparator->Flush();
+    }
+    if (run_result.ok() && run_result->result.ok()) {
+      run_result->result = status;
+    }
+  };
+  auto make_interpreter_options = [&](ImportData* test_import_data,
+                                      TraceHook trace_hook) {
+    BytecodeInterpreterOptions interpreter_options;
+    interpreter_options.post_fn_eval_hook(
+                           make_post_fn_eval_hook(test_import_data))
+        .trace_hook(std::move(trace_hook))
+        .trace_channels(options.trace_channels)
+        .max_ticks(options.max_ticks)
+        .format_preference(options.format_preference);
+    return interpreter_options;
+  };
 
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<AbstractParsedTestRunner> runner,
       CreateTestRunner(&import_data, tm_or.value().type_info, entry_module));
+
+  const std::vector<std::string> test_names = entry_module->GetTestNames();
+  auto is_test_proc = [&](std::string_view test_name) {
+    ModuleMember* member = entry_module->FindMemberWithName(test_name).value();
+    return std::holds_alternative<TestProc*>(*member);
+  };
+
+  // When running concurrently, every test which passes the filter is run up
+  // front and the outcomes are then reported below exactly as they would be
+  // for a serial run.
+  std::vector<std::optional<TestOutcome>> outcomes(test_names.size());
+  if (options.test_threads > 1 && SupportsConcurrentTests()) {
+    auto run_test = [&](int64_t index) -> TestOutcome {
+      const std::string& test_name = test_names[index];
+      TestOutcome outcome;
+      outcome.start = absl::Now();
+      ImportData* test_import_data = &import_data;
+      AbstractParsedTestRunner* test_runner = runner.get();
+      std::unique_ptr<AbstractParsedTestRunner> isolated_runner;
+      if (is_test_proc(test_name)) {
+        // Test procs get their own copy of the module: channels are constexpr
+        // values in the type information, so networks spawned from the same
+        // procs would otherwise share (and race on) channel state.
+        outcome.import_data = std::make_unique<ImportData>(
+            CreateImportData(options.dslx_stdlib_path, options.dslx_paths,
+                             options.warnings, MakeFilesystem(options)));
+        test_import_data = outcome.import_data.get();
+        test_import_data->set_typecheck_imports_lazily(
+            options.typecheck_imports_lazily);
+        absl::StatusOr<TypecheckedModule> tm = ParseAndTypecheck(
+            program, filename, module_name, test_import_data);
+        if (!tm.ok()) {
+          outcome.result = tm.status();
+          outcome.end = absl::Now();
+          return outcome;
+        }
+        absl::StatusOr<std::unique_ptr<AbstractParsedTestRunner>> created =
+            CreateTestRunner(test_import_data, tm->type_info, tm->module);
+        if (!created.ok()) {
+          outcome.result = created.status();
+          outcome.end = absl::Now();
+          return outcome;
+        }
+        isolated_runner = std::move(created).value();
+        test_runner = isolated_runner.get();
+      }
+      // Traces are buffered and emitted when the test is reported so output
+      // is not interleaved between tests.
+      BytecodeInterpreterOptions interpreter_options = make_interpreter_options(
+          test_import_data,
+          [&outcome](const Span& span, std::string_view message) {
+            outcome.traces.push_back({span, std::string(message)});
+          });
+      outcome.result =
+          is_test_proc(test_name)
+              ? test_runner->RunTestProc(test_name, interpreter_options)
+              : test_runner->RunTestFunction(test_name, interpreter_options);
+      flush_comparisons(outcome.result);
+      outcome.end = absl::Now();
+      return outcome;
+    };
+
+    std::vector<int64_t> to_run;
+    for (int64_t i = 0; i < test_names.size(); ++i) {
+      if (TestMatchesFilter(test_names[i], options.test_filter)) {
+        to_run.push_back(i);
+      }
+    }
+    ParallelFor(to_run.size(), options.test_threads, [&](int64_t j) {
+      outcomes[to_run[j]] = run_test(to_run[j]);
+    });
+  }
+
   // Run unit tests.
-  for (const std::string& test_name : entry_module->GetTestNames()) {
+  for (int64_t i = 0; i < test_names.size(); ++i) {
+    const std::string& test_name = test_names[i];
     auto test_case_start = absl::Now();
     ModuleMember* member = entry_module->FindMemberWithName(test_name).value();
     const Pos start_pos = GetPos(*member);
@@ -753,21 +1149,27 @@ absl::StatusOr<TestResultData> AbstractTestRunner::ParseAndTest(
     }
 
     std::cerr << "[ RUN UNITTEST  ] " << test_name << '\n';
-    RunResult out;
-    BytecodeInterpreterOptions interpreter_options;
-    interpreter_options.post_fn_eval_hook(post_fn_eval_hook)
-        .trace_hook(absl::bind_front(InfoLoggingTraceHook, file_table))
-        .trace_channels(options.trace_channels)
-        .max_ticks(options.max_ticks)
-        .format_preference(options.format_preference);
-    if (std::holds_alternative<TestFunction*>(*member)) {
-      XLS_ASSIGN_OR_RETURN(
-          out, runner->RunTestFunction(test_name, interpreter_options));
+    TestOutcome outcome;
+    if (outcomes[i].has_value()) {
+      outcome = std::move(outcomes[i]).value();
+      FileTable& outcome_file_table = outcome.import_data != nullptr
+                                          ? outcome.import_data->file_table()
+                                          : file_table;
+      for (const auto& [span, message] : outcome.traces) {
+        InfoLoggingTraceHook(outcome_file_table, span, message);
+      }
     } else {
-      XLS_ASSIGN_OR_RETURN(out,
-                           runner->RunTestProc(test_name, interpreter_options));
+      outcome.start = test_case_start;
+      BytecodeInterpreterOptions interpreter_options = make_interpreter_options(
+          &import_data, absl::bind_front(InfoLoggingTraceHook, file_table));
+      outcome.result =
+          std::holds_alternative<TestFunction*>(*member)
+              ? runner->RunTestFunction(test_name, interpreter_options)
+              : runner->RunTestProc(test_name, interpreter_options);
+      flush_comparisons(outcome.result);
+      outcome.end = absl::Now();
     }
-    auto test_case_end = absl::Now();
+    XLS_ASSIGN_OR_RETURN(RunResult out, std::move(outcome.result));
 
     if (out.result.ok()) {
       // Add to the tracking data.
@@ -777,13 +1179,16 @@ absl::StatusOr<TestResultData> AbstractTestRunner::ParseAndTest(
           .line = start_pos.GetHumanLineno(),
           .status = test_xml::RunStatus::kRun,
           .result = test_xml::RunResult::kCompleted,
-          .time = test_case_end - test_case_start,
-          .timestamp = test_case_start});
+          .time = outcome.end - outcome.start,
+          .timestamp = outcome.start});
       std::cerr << "[            OK ]" << '\n';
     } else {
-      HandleError(result, out.result, test_name, start_pos, test_case_start,
-                  test_case_end - test_case_start,
-                  /*is_quickcheck=*/false, file_table);
+      HandleError(result, out.result, test_name, start_pos, outcome.start,
+                  outcome.end - outcome.start,
+                  /*is_quickcheck=*/false,
+                  outcome.import_data != nullptr
+                      ? outcome.import_data->file_table()
+                      : file_table);
     }
   }
 
@@ -797,7 +1202,8 @@ absl::StatusOr<TestResultData> AbstractTestRunner::ParseAndTest(
   if (!entry_module->GetQuickChecks().empty()) {
     XLS_RETURN_IF_ERROR(RunQuickChecksIfJitEnabled(
         options.test_filter, entry_module, tm_or.value().type_info,
-        options.run_comparator, ir_package.get(), options.seed, result));
+        options.run_comparator, ir_package.get(), options.seed,
+        options.quickcheck_threads, result));
   }
 
   result.Finish(
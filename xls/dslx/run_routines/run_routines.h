@@ -80,6 +80,11 @@ class AbstractRunComparator {
   virtual absl::StatusOr<InterpreterResult<xls::Value>> RunIrFunction(
       std::string_view ir_name, xls::Function* ir_function,
       absl::Span<const xls::Value> ir_args) = 0;
+
+  // Waits for any comparisons requested by `RunComparison` which have not yet
+  // completed (implementations may perform them asynchronously) and returns
+  // the first mismatch among them.
+  virtual absl::Status Flush() { return absl::OkStatus(); }
 };
 
 // Optional arguments to ParseAndTest (that have sensible defaults).
@@ -95,6 +100,24 @@ class AbstractRunComparator {
 //   warnings_as_errors: Whether warnings should be reported as errors (i.e.
 //    cause the run routine to report failure when a warning is encountered).
 //   warnings: Set of warnings to enable for reporting.
+//   test_threads: Number of threads on which to run unit tests and test procs.
+//    When greater than one (and the test runner supports it) tests run
+//    concurrently after the module is typechecked once; test procs each get a
+//    freshly typechecked copy of the module, since proc networks keep channel
+//    state in the type information. Output and results are reported in
+//    declaration order regardless of the order in which tests complete.
+//    Quickchecks are not affected: they run one after another once the tests
+//    are done (see `quickcheck_threads` for parallelism within a quickcheck).
+//   quickcheck_threads: When positive, quickchecks are run by the batched
+//    JIT engine (see `DoBatchedQuickCheck`) on this many threads instead of
+//    one sample at a time through `run_comparator`. Quickchecks still only
+//    run when `run_comparator` is set.
+//   typecheck_imports_lazily: Whether imported modules only have the members
+//    used by the module under test typechecked, see
+//    `ImportData::typecheck_imports_lazily()`.
+//   vfs: Filesystem from which imports are read; the real filesystem if null.
+//    Not owned. When tests run concurrently every copy of the module is
+//    typechecked against it, so it must be safe to use from multiple threads.
 struct ParseAndTestOptions {
   std::filesystem::path dslx_stdlib_path;
   absl::Span<const std::filesystem::path> dslx_paths;
@@ -108,6 +131,10 @@ struct ParseAndTestOptions {
   WarningKindSet warnings = kDefaultWarningsSet;
   bool trace_channels = false;
   std::optional<int64_t> max_ticks;
+  int64_t test_threads = 1;
+  int64_t quickcheck_threads = 0;
+  bool typecheck_imports_lazily = false;
+  VirtualizableFilesystem* vfs = nullptr;
 };
 
 // As above, but a subset of the options required for the ParseAndProve()
@@ -221,6 +248,10 @@ class AbstractTestRunner {
   virtual absl::StatusOr<std::unique_ptr<AbstractParsedTestRunner>>
   CreateTestRunner(ImportData* import_data, TypeInfo* type_info,
                    Module* module) const = 0;
+
+  // Whether the runners created by `CreateTestRunner` may run different tests
+  // concurrently; see `ParseAndTestOptions::test_threads`.
+  virtual bool SupportsConcurrentTests() const { return false; }
 };
 
 struct RunResult {
@@ -241,6 +272,8 @@ class DslxInterpreterTestRunner final : public AbstractTestRunner {
   absl::StatusOr<std::unique_ptr<AbstractParsedTestRunner>> CreateTestRunner(
       ImportData* import_data, TypeInfo* type_info,
       Module* module) const override;
+
+  bool SupportsConcurrentTests() const override { return true; }
 };
 
 class DslxInterpreterParsedTestRunner : public AbstractParsedTestRunner {
@@ -292,6 +325,48 @@ absl::StatusOr<QuickCheckResults> DoQuickCheck(
     xls::Function* xls_function, std::string_view ir_name,
     AbstractRunComparator* run_comparator, int64_t seed, int64_t num_tests);
 
+// Optional arguments to DoBatchedQuickCheck.
+//
+//   threads: Number of threads evaluating samples. The function is compiled
+//    once and shared by all of them.
+//   batch_size: Number of samples generated and evaluated (by a single call
+//    into the JIT) per unit of work a thread claims.
+struct BatchedQuickCheckOptions {
+  int64_t threads = 1;
+  int64_t batch_size = 4096;
+};
+
+struct BatchedQuickCheckResults {
+  // Number of samples up to and including the falsifying example, or
+  // `num_tests` if the predicate was not falsified.
+  int64_t tests_run = 0;
+
+  // Number of samples actually evaluated. May exceed `tests_run` when other
+  // threads had started on later samples when the falsifying example was
+  // found.
+  int64_t samples_evaluated = 0;
+
+  // Arguments of the first falsifying example, if any.
+  std::optional<std::vector<Value>> falsifying_args;
+
+  absl::Duration elapsed;
+
+  double SamplesPerSecond() const;
+};
+
+// As DoQuickCheck, but for running many samples quickly: random arguments are
+// generated directly in the JIT's native layout (no `Value` is built unless a
+// falsifying example is found) and evaluated in batches across
+// `options.threads` threads.
+//
+// The arguments of sample `i` depend only on `seed`, `options.batch_size` and
+// `i`, and the reported falsifying example is the lowest-numbered one, so
+// results do not depend on the thread count. They do differ from those of
+// DoQuickCheck for the same seed.
+absl::StatusOr<BatchedQuickCheckResults> DoBatchedQuickCheck(
+    xls::Function* xls_function, int64_t seed, int64_t num_tests,
+    const BatchedQuickCheckOptions& options = BatchedQuickCheckOptions());
+
 }  // namespace xls::dslx
 
 #endif  // XLS_DSLX_RUN_ROUTINES_H_
@@ -15,25 +15,32 @@
 #include "xls/dslx/run_routines/run_routines.h"
 
 #include <cstdint>
+#include <filesystem>  // NOLINT
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "xls/common/file/temp_file.h"
 #include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/import_data.h"
 #include "xls/dslx/run_routines/ir_test_runner.h"
 #include "xls/dslx/run_routines/run_comparator.h"
+#include "xls/dslx/run_routines/test_xml.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/package.h"
 #include "xls/ir/value.h"
+#include "xls/ir/value_utils.h"
 #include "re2/re2.h"
 
 namespace xls::dslx {
@@ -188,6 +195,87 @@ fn trivial(x: u5) -> bool { id(true) }
   EXPECT_EQ(jit_comparator.jit_cache_.begin()->first, "__test__trivial");
 }
 
+TEST_P(RunRoutinesTest, ComparePolicySamplesInvocations) {
+  constexpr const char* kProgram = R"(
+fn add_one(x: u32) -> u32 { x + u32:1 }
+
+#[test]
+fn test_many_calls() {
+  let x = for (_, x): (u32, u32) in u32:0..u32:8 {
+    add_one(x)
+  }(u32:0);
+  assert_eq(x, u32:8)
+}
+)";
+  if (GetParam() != RunnerType::kDslxInterpreter) {
+    GTEST_SKIP()
+        << "comparator only supported on dslx interpreter for non-quickchecks";
+  }
+  constexpr const char* kModuleName = "test";
+  constexpr const char* kFilename = "test.x";
+  {
+    RunComparator jit_comparator(CompareMode::kJit,
+                                 ComparePolicy{.sample_rate = 0.25});
+    ParseAndTestOptions options;
+    options.run_comparator = &jit_comparator;
+    XLS_ASSERT_OK_AND_ASSIGN(
+        TestResultData result,
+        ParseAndTest(kProgram, kModuleName, kFilename, options));
+    EXPECT_THAT(result, IsTestResult(TestResult::kAllPassed, 1, 0, 0));
+    // Calls 0 and 4 of the eight calls to `add_one`.
+    EXPECT_EQ(jit_comparator.compared_count(), 2);
+    EXPECT_EQ(jit_comparator.skipped_count(), 6);
+  }
+  {
+    RunComparator jit_comparator(
+        CompareMode::kJit,
+        ComparePolicy{.function_sample_rates = {{"add_one", 0.5}},
+                      .max_compares_per_function = 3});
+    ParseAndTestOptions options;
+    options.run_comparator = &jit_comparator;
+    XLS_ASSERT_OK_AND_ASSIGN(
+        TestResultData result,
+        ParseAndTest(kProgram, kModuleName, kFilename, options));
+    EXPECT_THAT(result, IsTestResult(TestResult::kAllPassed, 1, 0, 0));
+    // Calls 0, 2 and 4; call 6 is over the limit.
+    EXPECT_EQ(jit_comparator.compared_count(), 3);
+    EXPECT_EQ(jit_comparator.skipped_count(), 5);
+  }
+}
+
+TEST_P(RunRoutinesTest, AsyncComparisons) {
+  constexpr const char* kProgram = R"(
+fn add_one(x: u32) -> u32 { x + u32:1 }
+fn twice(x: u32) -> u32 { x + x }
+
+#[test]
+fn test_many_calls() {
+  let x = for (_, x): (u32, u32) in u32:0..u32:16 {
+    twice(add_one(x)) - x
+  }(u32:0);
+  assert_eq(x, u32:32)
+}
+)";
+  if (GetParam() != RunnerType::kDslxInterpreter) {
+    GTEST_SKIP()
+        << "comparator only supported on dslx interpreter for non-quickchecks";
+  }
+  constexpr const char* kModuleName = "test";
+  constexpr const char* kFilename = "test.x";
+  RunComparator jit_comparator(CompareMode::kJit,
+                               ComparePolicy{.async_threads = 2});
+  ParseAndTestOptions options;
+  options.run_comparator = &jit_comparator;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TestResultData result,
+      ParseAndTest(kProgram, kModuleName, kFilename, options));
+  EXPECT_THAT(result, IsTestResult(TestResult::kAllPassed, 1, 0, 0));
+  EXPECT_EQ(jit_comparator.compared_count(), 32);
+  XLS_EXPECT_OK(jit_comparator.Flush());
+  // Compilation happens on the background workers.
+  EXPECT_TRUE(jit_comparator.jit_cache_.empty());
+}
+
 TEST_P(RunRoutinesTest, FallibleFunctionQuickChecks) {
   constexpr const char* kProgram = R"(
 fn do_fail(x: bool) -> bool { fail!("oh_no", x) }
@@ -415,6 +503,114 @@ TEST(QuickcheckTest, Seeding) {
   EXPECT_EQ(results1, results2);
 }
 
+TEST(QuickcheckTest, BatchedQuickCheckFindsFalsifyingExample) {
+  Package package("always_false");
+  std::string ir_text = R"(
+  fn ret_false(x: (bits[8], bits[3][2])) -> bits[1] {
+    first_member: bits[8] = tuple_index(x, index=0)
+    ret ne_value: bits[1] = ne(first_member, first_member)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      BatchedQuickCheckResults results,
+      DoBatchedQuickCheck(function, /*seed=*/0, /*num_tests=*/1000));
+  EXPECT_EQ(results.tests_run, 1);
+  // All samples fit in one batch, which is evaluated by a single JIT call.
+  EXPECT_EQ(results.samples_evaluated, 1000);
+  ASSERT_TRUE(results.falsifying_args.has_value());
+  ASSERT_EQ(results.falsifying_args->size(), 1);
+  EXPECT_TRUE(ValueConformsToType(results.falsifying_args->front(),
+                                  function->param(0)->GetType()));
+}
+
+TEST(QuickcheckTest, BatchedQuickCheckNumTests) {
+  Package package("always_true");
+  std::string ir_text = R"(
+  fn ret_true(x: bits[32]) -> bits[1] {
+    ret eq_value: bits[1] = eq(x, x)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      BatchedQuickCheckResults results,
+      DoBatchedQuickCheck(function, /*seed=*/0, /*num_tests=*/5050,
+                          {.threads = 3, .batch_size = 100}));
+  EXPECT_EQ(results.tests_run, 5050);
+  EXPECT_EQ(results.samples_evaluated, 5050);
+  EXPECT_FALSE(results.falsifying_args.has_value());
+}
+
+// The falsifying example found should not depend on how many threads are
+// used.
+TEST(QuickcheckTest, BatchedQuickCheckThreadCountIndependent) {
+  Package package("rarely_false");
+  std::string ir_text = R"(
+  fn ne_zero(x: bits[12]) -> bits[1] {
+    literal.2: bits[12] = literal(value=0)
+    ret ne.3: bits[1] = ne(x, literal.2)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      BatchedQuickCheckResults serial,
+      DoBatchedQuickCheck(function, /*seed=*/12345, /*num_tests=*/100000,
+                          {.threads = 1, .batch_size = 64}));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      BatchedQuickCheckResults parallel,
+      DoBatchedQuickCheck(function, /*seed=*/12345, /*num_tests=*/100000,
+                          {.threads = 4, .batch_size = 64}));
+  ASSERT_TRUE(serial.falsifying_args.has_value());
+  EXPECT_EQ(*serial.falsifying_args,
+            std::vector<Value>({Value(UBits(0, 12))}));
+  EXPECT_EQ(serial.tests_run, parallel.tests_run);
+  EXPECT_EQ(serial.falsifying_args, parallel.falsifying_args);
+}
+
+// An assertion failing later in a batch should not mask a falsifying sample
+// earlier in that batch.
+TEST(QuickcheckTest, BatchedQuickCheckAssertionAfterFalsifyingSample) {
+  Package package("assert_after_false");
+  std::string always_false_text = R"(
+  fn always_false(x: bits[8]) -> bits[1] {
+    ret literal.1: bits[1] = literal(value=0)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * always_false,
+                           Parser::ParseFunction(always_false_text, &package));
+  // A batch's first sample does not depend on the batch size.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      BatchedQuickCheckResults first,
+      DoBatchedQuickCheck(always_false, /*seed=*/0, /*num_tests=*/1,
+                          {.threads = 1, .batch_size = 1}));
+  ASSERT_TRUE(first.falsifying_args.has_value());
+  XLS_ASSERT_OK_AND_ASSIGN(uint64_t first_value,
+                           first.falsifying_args->front().bits().ToUint64());
+
+  // Falsified by every sample; asserts on every sample but the first.
+  std::string assert_later_text = absl::StrFormat(R"(
+  fn assert_later(x: bits[8]) -> bits[1] {
+    after_all.1: token = after_all()
+    literal.2: bits[8] = literal(value=%d)
+    eq.3: bits[1] = eq(x, literal.2)
+    assert.4: token = assert(after_all.1, eq.3, message="not the first sample")
+    ret literal.5: bits[1] = literal(value=0)
+  }
+  )",
+                                                  first_value);
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * assert_later,
+                           Parser::ParseFunction(assert_later_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      BatchedQuickCheckResults results,
+      DoBatchedQuickCheck(assert_later, /*seed=*/0, /*num_tests=*/4096,
+                          {.threads = 1, .batch_size = 4096}));
+  EXPECT_EQ(results.tests_run, 1);
+  EXPECT_EQ(results.falsifying_args, first.falsifying_args);
+}
+
 TEST_P(ParseAndTestTest, DeadlockedProc) {
   // Test proc never sends to the subproc, so network is deadlocked.
   constexpr std::string_view kProgram = R"(
@@ -633,6 +829,108 @@ fn test_simple() {
   EXPECT_THAT(result, IsTestResult(TestResult::kAllPassed, 1, 0, 0));
 }
 
+TEST_P(ParseAndTestTest, ConcurrentTestsMatchSerial) {
+  constexpr std::string_view kProgram = R"(
+fn square(x: u32) -> u32 { x * x }
+
+#[test]
+fn passes() { assert_eq(square(u32:3), u32:9) }
+
+#[test]
+fn fails() { assert_eq(square(u32:3), u32:10) }
+
+#[test]
+fn filtered() { assert_eq(square(u32:2), u32:4) }
+
+#[test_proc]
+proc ProcTest {
+  terminator: chan<bool> out;
+  config(terminator: chan<bool> out) { (terminator,) }
+  init { }
+  next(_: ()) { send(join(), terminator, true); }
+}
+
+#[test]
+fn also_passes() { assert_eq(square(u32:4), u32:16) }
+)";
+  RE2 test_filter("passes|fails|ProcTest|also_passes");
+  ParseAndTestOptions options;
+  options.test_filter = &test_filter;
+  XLS_ASSERT_OK_AND_ASSIGN(TestResultData serial,
+                           ParseAndTest(kProgram, "test", "test.x", options));
+  options.test_threads = 4;
+  XLS_ASSERT_OK_AND_ASSIGN(TestResultData concurrent,
+                           ParseAndTest(kProgram, "test", "test.x", options));
+  EXPECT_THAT(concurrent, IsTestResult(TestResult::kSomeFailed, 5, 1, 1));
+
+  // Everything but the timing should match the serial run.
+  std::vector<test_xml::TestCase> serial_cases =
+      serial.ToXmlSuites("test").test_suites.at(0).test_cases;
+  std::vector<test_xml::TestCase> concurrent_cases =
+      concurrent.ToXmlSuites("test").test_suites.at(0).test_cases;
+  ASSERT_EQ(serial_cases.size(), concurrent_cases.size());
+  for (int64_t i = 0; i < serial_cases.size(); ++i) {
+    EXPECT_EQ(serial_cases[i].name, concurrent_cases[i].name);
+    EXPECT_EQ(serial_cases[i].line, concurrent_cases[i].line);
+    EXPECT_EQ(serial_cases[i].result, concurrent_cases[i].result);
+    EXPECT_EQ(serial_cases[i].failure.has_value(),
+              concurrent_cases[i].failure.has_value());
+  }
+}
+
+// Filesystem holding a fixed set of files in memory.
+class FakeFilesystem : public VirtualizableFilesystem {
+ public:
+  explicit FakeFilesystem(absl::flat_hash_map<std::string, std::string> files)
+      : files_(std::move(files)) {}
+
+  absl::Status FileExists(const std::filesystem::path& path) override {
+    if (files_.contains(path.string())) {
+      return absl::OkStatus();
+    }
+    return absl::NotFoundError(absl::StrFormat("No file `%s`", path));
+  }
+  absl::StatusOr<std::string> GetFileContents(
+      const std::filesystem::path& path) override {
+    XLS_RETURN_IF_ERROR(FileExists(path));
+    return files_.at(path.string());
+  }
+  absl::StatusOr<std::filesystem::path> GetCurrentDirectory() override {
+    return std::filesystem::path("/fake");
+  }
+
+ private:
+  const absl::flat_hash_map<std::string, std::string> files_;
+};
+
+TEST_P(ParseAndTestTest, ConcurrentTestProcsImportFromConfiguredFilesystem) {
+  // `helper.x` only exists in the fake filesystem, so the copies of the module
+  // typechecked for the test procs must import from it as well.
+  constexpr std::string_view kProgram = R"(
+import helper;
+
+#[test]
+fn unit() { assert_eq(helper::VALUE, u32:42) }
+
+#[test_proc]
+proc ProcTest {
+  terminator: chan<bool> out;
+  config(terminator: chan<bool> out) { (terminator,) }
+  init { }
+  next(_: ()) { send(join(), terminator, helper::VALUE == u32:42); }
+}
+)";
+  absl::flat_hash_map<std::string, std::string> files = {
+      {"helper.x", "pub const VALUE = u32:42;"}};
+  FakeFilesystem vfs(std::move(files));
+  ParseAndTestOptions options;
+  options.vfs = &vfs;
+  options.test_threads = 2;
+  XLS_ASSERT_OK_AND_ASSIGN(TestResultData result,
+                           ParseAndTest(kProgram, "test", "test.x", options));
+  EXPECT_THAT(result, IsTestResult(TestResult::kAllPassed, 2, 0, 0));
+}
+
 INSTANTIATE_TEST_SUITE_P(RunRoutinesTest, RunRoutinesTest,
                          testing::Values(RunnerType::kDslxInterpreter,
                                          RunnerType::kIrInterpreter,
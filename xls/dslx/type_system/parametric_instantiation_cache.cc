@@ -0,0 +1,69 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/type_system/parametric_instantiation_cache.h"
+
+#include <optional>
+#include <string>
+#include <tuple>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/time.h"
+#include "xls/dslx/frontend/ast.h"
+#include "xls/dslx/type_system/parametric_env.h"
+#include "xls/dslx/type_system/type_info.h"
+
+namespace xls::dslx {
+
+std::string ParametricInstantiationStats::ToString() const {
+  return absl::StrFormat("%d hits, %d misses, %s saved", hits, misses,
+                         absl::FormatDuration(time_saved));
+}
+
+std::optional<TypeInfo*> ParametricInstantiationCache::Lookup(
+    const TypeInfo* root, const TypeInfo* parent, const Function* f,
+    const ParametricEnv& env) {
+  auto it = entries_.find(Key(root, parent, f, env));
+  if (it == entries_.end()) {
+    ++stats_.misses;
+    return std::nullopt;
+  }
+  ++stats_.hits;
+  stats_.time_saved += it->second.elapsed;
+  return it->second.derived_type_info;
+}
+
+void ParametricInstantiationCache::Insert(const TypeInfo* root,
+                                          const TypeInfo* parent,
+                                          const Function* f,
+                                          const ParametricEnv& env,
+                                          TypeInfo* derived_type_info,
+                                          absl::Duration elapsed) {
+  entries_.emplace(Key(root, parent, f, env),
+                   Entry{derived_type_info, elapsed});
+}
+
+void ParametricInstantiationCache::EraseRoots(
+    const absl::flat_hash_set<const TypeInfo*>& roots) {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (roots.contains(std::get<const TypeInfo*>(it->first))) {
+      entries_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace xls::dslx
@@ -0,0 +1,99 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_TYPE_SYSTEM_PARAMETRIC_INSTANTIATION_CACHE_H_
+#define XLS_DSLX_TYPE_SYSTEM_PARAMETRIC_INSTANTIATION_CACHE_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/time/time.h"
+#include "xls/dslx/frontend/ast.h"
+#include "xls/dslx/type_system/parametric_env.h"
+#include "xls/dslx/type_system/type_info.h"
+
+namespace xls::dslx {
+
+// Counters describing how often typechecking was able to reuse a previously
+// deduced parametric instantiation.
+struct ParametricInstantiationStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+
+  // Total time originally spent deducing the instantiations that were reused,
+  // counted once per hit.
+  absl::Duration time_saved;
+
+  std::string ToString() const;
+};
+
+// Memoizes the derived type information produced by deducing the body of a
+// parametric function for a particular set of parametric bindings.
+//
+// An instantiation only depends on the function and its bindings, so
+// invocations reaching it from different call sites -- or from different
+// modules, since the cache lives on the `ImportData` -- can share the derived
+// `TypeInfo` instead of re-deducing the body each time.
+//
+// Entries are keyed on the root type info of the module the function was
+// typechecked in as well as the function itself: type information outlives the
+// AST of a module that fails to typecheck, so this keeps a later module that
+// happens to reuse the same addresses from observing stale entries.
+//
+// Entries are also keyed on the type info the instantiation was derived from:
+// lookups that miss in the derived type info fall back to its parent chain, so
+// an instantiation is only shared between call sites that would give it the
+// same parent. For a callee in another module that is the other module's root,
+// so those instantiations are shared regardless of the caller's own parametric
+// context.
+class ParametricInstantiationCache {
+ public:
+  // Returns the derived type information recorded for `f` instantiated with
+  // `env` from `parent`, if any, and updates the hit/miss counters
+  // accordingly.
+  std::optional<TypeInfo*> Lookup(const TypeInfo* root, const TypeInfo* parent,
+                                  const Function* f, const ParametricEnv& env);
+
+  // Records the derived type information for `f` instantiated with `env` from
+  // `parent`; `elapsed` is the time it took to deduce.
+  void Insert(const TypeInfo* root, const TypeInfo* parent, const Function* f,
+              const ParametricEnv& env, TypeInfo* derived_type_info,
+              absl::Duration elapsed);
+
+  // Drops all entries for functions typechecked under any of `roots`, e.g.
+  // because their type information is being destroyed.
+  void EraseRoots(const absl::flat_hash_set<const TypeInfo*>& roots);
+
+  const ParametricInstantiationStats& stats() const { return stats_; }
+
+ private:
+  struct Entry {
+    TypeInfo* derived_type_info;
+    absl::Duration elapsed;
+  };
+
+  using Key = std::tuple<const TypeInfo*, const TypeInfo*, const Function*,
+                         ParametricEnv>;
+
+  absl::flat_hash_map<Key, Entry> entries_;
+  ParametricInstantiationStats stats_;
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_TYPE_SYSTEM_PARAMETRIC_INSTANTIATION_CACHE_H_
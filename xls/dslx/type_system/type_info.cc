@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/memory/memory.h"
@@ -30,6 +31,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/variant.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -160,6 +162,36 @@ absl::StatusOr<TypeInfo*> TypeInfoOwner::GetRootTypeInfo(const Module* module) {
   return it->second;
 }
 
+absl::flat_hash_set<const TypeInfo*> TypeInfoOwner::EraseModulesExcept(
+    const absl::flat_hash_set<const Module*>& live_modules) {
+  absl::flat_hash_set<const TypeInfo*> erased_roots;
+  for (auto it = module_to_root_.begin(); it != module_to_root_.end();) {
+    if (live_modules.contains(it->first)) {
+      ++it;
+      continue;
+    }
+    erased_roots.insert(it->second);
+    module_to_root_.erase(it++);
+  }
+
+  std::vector<std::unique_ptr<TypeInfo>> retained;
+  std::vector<std::unique_ptr<TypeInfo>> erased;
+  for (std::unique_ptr<TypeInfo>& type_info : type_infos_) {
+    if (live_modules.contains(type_info->module())) {
+      retained.push_back(std::move(type_info));
+    } else {
+      erased.push_back(std::move(type_info));
+    }
+  }
+  type_infos_ = std::move(retained);
+  // Derived type information looks at its parent chain when destroyed, so
+  // destroy in reverse order of creation.
+  while (!erased.empty()) {
+    erased.pop_back();
+  }
+  return erased_roots;
+}
+
 // -- class TypeInfo
 
 void TypeInfo::NoteConstExpr(const AstNode* const_expr, InterpValue value) {
@@ -181,6 +213,7 @@ void TypeInfo::NoteConstExpr(const AstNode* const_expr, InterpValue value) {
   //   }
   // }
 
+  absl::MutexLock lock(&const_exprs_mutex_);
   const_exprs_.insert_or_assign(const_expr, std::move(value));
 }
 
@@ -190,8 +223,11 @@ absl::StatusOr<InterpValue> TypeInfo::GetConstExpr(
       << const_expr->owner()->name() << " vs " << module_->name()
       << " node: " << const_expr->ToString();
 
-  if (auto it = const_exprs_.find(const_expr); it != const_exprs_.end()) {
-    return it->second.value();
+  {
+    absl::ReaderMutexLock lock(&const_exprs_mutex_);
+    if (auto it = const_exprs_.find(const_expr); it != const_exprs_.end()) {
+      return it->second.value();
+    }
   }
 
   if (parent_ != nullptr) {
@@ -213,8 +249,11 @@ std::optional<InterpValue> TypeInfo::GetConstExprOption(
       << const_expr->owner()->name() << " vs " << module_->name()
       << " node: " << const_expr->ToString();
 
-  if (auto it = const_exprs_.find(const_expr); it != const_exprs_.end()) {
-    return it->second;
+  {
+    absl::ReaderMutexLock lock(&const_exprs_mutex_);
+    if (auto it = const_exprs_.find(const_expr); it != const_exprs_.end()) {
+      return it->second;
+    }
   }
 
   if (parent_ != nullptr) {
@@ -228,8 +267,11 @@ std::optional<InterpValue> TypeInfo::GetConstExprOption(
 }
 
 bool TypeInfo::IsKnownConstExpr(const AstNode* node) const {
-  if (const_exprs_.contains(node)) {
-    return const_exprs_.at(node).has_value();
+  {
+    absl::ReaderMutexLock lock(&const_exprs_mutex_);
+    if (auto it = const_exprs_.find(node); it != const_exprs_.end()) {
+      return it->second.has_value();
+    }
   }
 
   if (parent_ != nullptr) {
@@ -240,8 +282,11 @@ bool TypeInfo::IsKnownConstExpr(const AstNode* node) const {
 }
 
 bool TypeInfo::IsKnownNonConstExpr(const AstNode* node) const {
-  if (const_exprs_.contains(node)) {
-    return !const_exprs_.at(node).has_value();
+  {
+    absl::ReaderMutexLock lock(&const_exprs_mutex_);
+    if (auto it = const_exprs_.find(node); it != const_exprs_.end()) {
+      return !it->second.has_value();
+    }
   }
 
   if (parent_ != nullptr) {
@@ -24,11 +24,14 @@
 #include <variant>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/variant.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/pos.h"
@@ -136,6 +139,14 @@ class TypeInfoOwner {
   // status error if it is not present.
   absl::StatusOr<TypeInfo*> GetRootTypeInfo(const Module* module);
 
+  // Destroys all type information for modules not in `live_modules` (e.g.
+  // modules that have been unloaded, or that failed to typecheck and so were
+  // never loaded) and returns the root type information objects that were
+  // destroyed. Only the addresses of the dead modules are used, so they may
+  // already have been freed.
+  absl::flat_hash_set<const TypeInfo*> EraseModulesExcept(
+      const absl::flat_hash_set<const Module*>& live_modules);
+
  private:
   // Mapping from module to the "root" (or "parentmost") type info -- these have
   // nullptr as their parent. There should only be one of these for any given
@@ -380,7 +391,13 @@ class TypeInfo {
   // Node to constexpr-value mapping -- this is also present on "derived" type
   // info as constexprs take on different values in different parametric
   // instantiation contexts.
-  absl::flat_hash_map<const AstNode*, std::optional<InterpValue>> const_exprs_;
+  //
+  // Unlike the other maps this one is still written after typechecking (the
+  // constexpr evaluator notes values as IR conversion evaluates e.g. loop
+  // bounds), and IR conversion may run on several threads, so it is locked.
+  mutable absl::Mutex const_exprs_mutex_;
+  absl::flat_hash_map<const AstNode*, std::optional<InterpValue>> const_exprs_
+      ABSL_GUARDED_BY(const_exprs_mutex_);
 
   // Unrolled versions of `unroll_for!` loops.
   absl::flat_hash_map<const UnrollFor*,
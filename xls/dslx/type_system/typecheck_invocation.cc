@@ -29,6 +29,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "xls/common/casts.h"
@@ -51,6 +52,7 @@
 #include "xls/dslx/type_system/deduce_utils.h"
 #include "xls/dslx/type_system/instantiate_parametric_function.h"
 #include "xls/dslx/type_system/parametric_env.h"
+#include "xls/dslx/type_system/parametric_instantiation_cache.h"
 #include "xls/dslx/type_system/parametric_with_type.h"
 #include "xls/dslx/type_system/scoped_fn_stack_entry.h"
 #include "xls/dslx/type_system/type.h"
@@ -422,9 +424,45 @@ absl::StatusOr<TypeAndParametricEnv> TypecheckInvocation(
   parent_ctx->type_info()->SetItem(invocation->callee(), instantiated_ft);
   ctx->type_info()->SetItem(callee_fn.name_def(), instantiated_ft);
 
+  TypeInfo* const original_ti = parent_ctx->type_info();
+
+  // The body of a parametric function only depends on its bindings, so an
+  // instantiation already deduced for another call site can be reused. Procs
+  // are excluded as they need separate constexpr data for every instantiation
+  // (see below).
+  //
+  // The derived type info falls back to the one it is derived from, so that is
+  // part of the key. For an imported callee that is a fresh type info per call
+  // site which only holds the signature of this instantiation, so we key on
+  // the imported module's root beneath it instead; that way instantiations of
+  // imported functions are shared between parametric contexts of the caller.
+  ParametricInstantiationCache* instantiation_cache = nullptr;
+  const TypeInfo* callee_root_ti = nullptr;
+  const TypeInfo* instantiation_parent_ti = nullptr;
+  if (!callee_fn.proc().has_value() && constexpr_env.empty() &&
+      ctx->import_data() != nullptr) {
+    XLS_ASSIGN_OR_RETURN(callee_root_ti,
+                         ctx->import_data()->type_info_owner().GetRootTypeInfo(
+                             callee_fn.owner()));
+    instantiation_parent_ti = imported_ctx_holder != nullptr
+                                  ? ctx->type_info()->parent()
+                                  : ctx->type_info();
+    instantiation_cache =
+        &ctx->import_data()->parametric_instantiation_cache();
+    if (std::optional<TypeInfo*> cached = instantiation_cache->Lookup(
+            callee_root_ti, instantiation_parent_ti, &callee_fn,
+            callee_tab.parametric_env);
+        cached.has_value()) {
+      XLS_RETURN_IF_ERROR(original_ti->AddInvocationTypeInfo(
+          *invocation, caller, caller_parametric_env,
+          callee_tab.parametric_env, *cached));
+      return callee_tab;
+    }
+  }
+  const absl::Time deduce_start = absl::Now();
+
   // We need to deduce fn body, so we're going to call Deduce, which means we'll
   // need a new stack entry w/the new symbolic bindings.
-  TypeInfo* const original_ti = parent_ctx->type_info();
   ctx->AddFnStackEntry(FnStackEntry::Make(
       callee_fn, callee_tab.parametric_env, invocation,
       callee_fn.proc().has_value() ? WithinProc::kYes : WithinProc::kNo));
@@ -518,6 +556,11 @@ absl::StatusOr<TypeAndParametricEnv> TypecheckInvocation(
 
   XLS_RETURN_IF_ERROR(ctx->PopDerivedTypeInfo(derived_type_info));
   ctx->PopFnStackEntry();
+  if (instantiation_cache != nullptr) {
+    instantiation_cache->Insert(callee_root_ti, instantiation_parent_ti,
+                                &callee_fn, callee_tab.parametric_env,
+                                derived_type_info, absl::Now() - deduce_start);
+  }
 
   // Implementation note: though we could have all functions have
   // NoteRequiresImplicitToken() be false unless otherwise noted, this helps
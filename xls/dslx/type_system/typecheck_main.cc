@@ -37,6 +37,7 @@
 #include "xls/dslx/default_dslx_stdlib_path.h"
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/parse_and_typecheck.h"
+#include "xls/dslx/type_system/parametric_instantiation_cache.h"
 #include "xls/dslx/type_system/type_info.pb.h"
 #include "xls/dslx/type_system/type_info_to_proto.h"
 #include "xls/dslx/warning_kind.h"
@@ -77,6 +78,10 @@ absl::Status RealMain(absl::Span<const std::filesystem::path> dslx_paths,
     }
     return tm_or.status();
   }
+  VLOG(1) << "Parametric instantiations: "
+          << import_data.parametric_instantiation_cache().stats().ToString();
+  VLOG(1) << "Constexpr values: "
+          << import_data.constexpr_value_cache().stats().ToString();
   XLS_ASSIGN_OR_RETURN(TypeInfoProto tip, TypeInfoToProto(*tm_or->type_info));
   if (output_path.has_value()) {
     std::string output;
@@ -14,16 +14,22 @@
 
 #include "xls/dslx/type_system/typecheck_module.h"
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <variant>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -51,6 +57,10 @@
 namespace xls::dslx {
 namespace {
 
+absl::Status TypecheckImport(Import* import,
+                             absl::Span<const AstNode* const> users,
+                             ImportData* import_data, DeduceCtx* ctx);
+
 // Checks a single #[test_proc] construct.
 absl::Status CheckTestProc(const TestProc* test_proc, Module* module,
                            DeduceCtx* ctx) {
@@ -215,16 +225,15 @@ absl::Status TypecheckModuleMember(const ModuleMember& member, Module* module,
 
   XLS_RETURN_IF_ERROR(absl::visit(
       Visitor{
-          [import_data, ctx](Import* import) -> absl::Status {
-            XLS_ASSIGN_OR_RETURN(
-                ModuleInfo * imported,
-                DoImport(ctx->typecheck_module(),
-                         ImportTokens(import->subject()), import_data,
-                         import->span(), import_data->vfs()));
-
-            ctx->type_info()->AddImport(import, &imported->module(),
-                                        imported->type_info());
-            return absl::OkStatus();
+          [module, import_data, ctx](Import* import) -> absl::Status {
+            // The whole of this module gets typechecked, so any of its members
+            // may refer into the import.
+            std::vector<const AstNode*> users;
+            users.reserve(module->top().size());
+            for (const ModuleMember& user : module->top()) {
+              users.push_back(ToAstNode(user));
+            }
+            return TypecheckImport(import, users, import_data, ctx);
           },
           [ctx](ConstantDef* member) -> absl::Status {
             return ctx->Deduce(ToAstNode(member)).status();
@@ -349,6 +358,206 @@ absl::Status MaybeExpandTypeErrorData(absl::Status orig, const DeduceCtx& ctx) {
   return orig;
 }
 
+// Returns the routine used to typecheck modules that get imported while
+// typechecking with `import_data`.
+TypecheckModuleFn MakeImportTypechecker(ImportData* import_data,
+                                        WarningCollector* warnings) {
+  return [import_data, warnings](Module* module) -> absl::StatusOr<TypeInfo*> {
+    if (!import_data->typecheck_imports_lazily()) {
+      return TypecheckModule(module, import_data, warnings);
+    }
+    // Members get typechecked as importers refer to them, see
+    // `TypecheckImport()`.
+    XLS_ASSIGN_OR_RETURN(TypeInfo * type_info,
+                         import_data->type_info_owner().New(module));
+    import_data->MarkTypecheckedLazily(module);
+    return type_info;
+  };
+}
+
+// Calls `f` on `node` and everything under it, including type annotations and
+// the colon-references named by type references (which are not children of
+// the `TypeRef`).
+void ForEachReferencingNode(const AstNode* node,
+                            const std::function<void(const AstNode*)>& f) {
+  f(node);
+  if (const auto* type_ref = dynamic_cast<const TypeRef*>(node)) {
+    if (const auto* colon_ref =
+            std::get_if<ColonRef*>(&type_ref->type_definition())) {
+      ForEachReferencingNode(*colon_ref, f);
+    }
+  }
+  for (const AstNode* child : node->GetChildren(/*want_types=*/true)) {
+    ForEachReferencingNode(child, f);
+  }
+}
+
+// Returns the top-level members of `module` needed to typecheck `roots`, in
+// module order: the roots themselves and whatever they refer to within
+// `module`, transitively.
+//
+// Since names must be defined before they are used, typechecking the result in
+// order never refers to a member that has not been typechecked yet.
+std::vector<const ModuleMember*> GetMemberClosure(
+    Module* module, absl::Span<const AstNode* const> roots) {
+  // Maps both member nodes and the name definitions they introduce to the
+  // index of the member in `module->top()`.
+  absl::flat_hash_map<const AstNode*, int64_t> member_index;
+  for (int64_t i = 0; i < module->top().size(); ++i) {
+    const ModuleMember& member = module->top()[i];
+    member_index[ToAstNode(member)] = i;
+    if (const NameDef* name_def = ModuleMemberGetNameDef(member)) {
+      member_index[name_def] = i;
+    }
+  }
+
+  std::vector<bool> needed(module->top().size(), false);
+  std::vector<int64_t> worklist;
+  auto add = [&](const AstNode* node) {
+    auto it = member_index.find(node);
+    if (it != member_index.end() && !needed[it->second]) {
+      needed[it->second] = true;
+      worklist.push_back(it->second);
+    }
+  };
+  for (const AstNode* root : roots) {
+    add(root);
+  }
+  while (!worklist.empty()) {
+    const ModuleMember& member = module->top()[worklist.back()];
+    worklist.pop_back();
+
+    // Members that are typechecked together with the one at hand.
+    if (auto* f = std::get_if<Function*>(&member); f && (*f)->proc()) {
+      add(*(*f)->proc());
+    } else if (auto* p = std::get_if<Proc*>(&member)) {
+      add(&(*p)->config());
+      add(&(*p)->next());
+      add(&(*p)->init());
+    } else if (auto* s = std::get_if<StructDef*>(&member); s && (*s)->impl()) {
+      add(*(*s)->impl());
+    } else if (auto* d = std::get_if<ProcDef*>(&member); d && (*d)->impl()) {
+      add(*(*d)->impl());
+    }
+
+    ForEachReferencingNode(ToAstNode(member), [&](const AstNode* node) {
+      if (const auto* name_ref = dynamic_cast<const NameRef*>(node)) {
+        if (!name_ref->IsBuiltin()) {
+          add(std::get<const NameDef*>(name_ref->name_def()));
+        }
+      } else if (const auto* type_ref = dynamic_cast<const TypeRef*>(node)) {
+        add(ToAstNode(type_ref->type_definition()));
+      }
+    });
+  }
+
+  std::vector<const ModuleMember*> result;
+  for (int64_t i = 0; i < module->top().size(); ++i) {
+    if (needed[i]) {
+      result.push_back(&module->top()[i]);
+    }
+  }
+  return result;
+}
+
+// Typechecks the members of the lazily-typechecked `module` that are needed by
+// `roots` and have not been typechecked yet.
+absl::Status TypecheckMembersOnDemand(Module* module,
+                                      absl::Span<const AstNode* const> roots,
+                                      ImportData* import_data,
+                                      WarningCollector* warnings) {
+  std::vector<const ModuleMember*> members = GetMemberClosure(module, roots);
+
+  // Members that are new to this round; imports are revisited as the new
+  // members may refer to further members of the imported module.
+  std::vector<const AstNode*> users;
+  {
+    const absl::flat_hash_set<const AstNode*>* done =
+        import_data->GetLazilyTypecheckedMembers(module);
+    XLS_RET_CHECK(done != nullptr) << module->name();
+    for (const ModuleMember* member : members) {
+      if (!done->contains(ToAstNode(*member))) {
+        users.push_back(ToAstNode(*member));
+      }
+    }
+  }
+  if (users.empty()) {
+    return absl::OkStatus();
+  }
+  VLOG(3) << "Typechecking " << users.size() << " of " << module->top().size()
+          << " members of lazily imported module `" << module->name() << "`";
+
+  XLS_ASSIGN_OR_RETURN(TypeInfo * type_info,
+                       import_data->GetRootTypeInfo(module));
+  DeduceCtx ctx(type_info, module,
+                /*deduce_function=*/&Deduce,
+                /*typecheck_function=*/&TypecheckFunction,
+                /*typecheck_module=*/
+                MakeImportTypechecker(import_data, warnings),
+                /*typecheck_invocation=*/&TypecheckInvocation, import_data,
+                warnings, /*parent=*/nullptr);
+  ctx.AddFnStackEntry(FnStackEntry::MakeTop(module));
+
+  for (const ModuleMember* member : members) {
+    const AstNode* node = ToAstNode(*member);
+    absl::Status status;
+    if (auto* import = std::get_if<Import*>(member)) {
+      status = TypecheckImport(*import, users, import_data, &ctx);
+    } else if (!import_data->GetLazilyTypecheckedMembers(module)->contains(
+                   node)) {
+      status = TypecheckModuleMember(*member, module, import_data, &ctx);
+    }
+    if (!status.ok()) {
+      return MaybeExpandTypeErrorData(status, ctx);
+    }
+    // Note: this is looked up again as nested imports may have added entries.
+    import_data->GetLazilyTypecheckedMembers(module)->insert(node);
+  }
+  return absl::OkStatus();
+}
+
+// Brings the module imported by `import` into the module that `ctx` is
+// typechecking. If the imported module is typechecked lazily, this also
+// typechecks the members of it that `users` (members of the importing module)
+// refer to.
+absl::Status TypecheckImport(Import* import,
+                             absl::Span<const AstNode* const> users,
+                             ImportData* import_data, DeduceCtx* ctx) {
+  XLS_ASSIGN_OR_RETURN(
+      ModuleInfo * imported,
+      DoImport(ctx->typecheck_module(), ImportTokens(import->subject()),
+               import_data, import->span(), import_data->vfs()));
+  if (!ctx->type_info()->GetImported(import).has_value()) {
+    ctx->type_info()->AddImport(import, &imported->module(),
+                                imported->type_info());
+  }
+
+  Module* imported_module = &imported->module();
+  if (import_data->GetLazilyTypecheckedMembers(imported_module) == nullptr) {
+    return absl::OkStatus();
+  }
+  std::vector<const AstNode*> roots;
+  for (const AstNode* user : users) {
+    ForEachReferencingNode(user, [&](const AstNode* node) {
+      const auto* colon_ref = dynamic_cast<const ColonRef*>(node);
+      if (colon_ref == nullptr) {
+        return;
+      }
+      std::optional<Import*> subject = colon_ref->ResolveImportSubject();
+      if (!subject.has_value() || *subject != import) {
+        return;
+      }
+      // Members that do not exist are reported when the reference is deduced.
+      if (std::optional<ModuleMember*> member =
+              imported_module->FindMemberWithName(colon_ref->attr())) {
+        roots.push_back(ToAstNode(**member));
+      }
+    });
+  }
+  return TypecheckMembersOnDemand(imported_module, roots, import_data,
+                                  ctx->warnings());
+}
+
 }  // namespace
 
 absl::StatusOr<TypeInfo*> TypecheckModule(Module* module,
@@ -357,15 +566,11 @@ absl::StatusOr<TypeInfo*> TypecheckModule(Module* module,
   XLS_ASSIGN_OR_RETURN(TypeInfo * type_info,
                        import_data->type_info_owner().New(module));
 
-  auto typecheck_module =
-      [import_data, warnings](Module* module) -> absl::StatusOr<TypeInfo*> {
-    return TypecheckModule(module, import_data, warnings);
-  };
-
   DeduceCtx ctx(type_info, module,
                 /*deduce_function=*/&Deduce,
                 /*typecheck_function=*/&TypecheckFunction,
-                /*typecheck_module=*/typecheck_module,
+                /*typecheck_module=*/
+                MakeImportTypechecker(import_data, warnings),
                 /*typecheck_invocation=*/&TypecheckInvocation, import_data,
                 warnings, /*parent=*/nullptr);
 
@@ -12,28 +12,38 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <filesystem>  // NOLINT
 #include <iostream>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_replace.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
 #include "xls/common/status/matchers.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/dslx/create_import_data.h"
+#include "xls/dslx/default_dslx_stdlib_path.h"
 #include "xls/dslx/error_printer.h"
 #include "xls/dslx/error_test_utils.h"
 #include "xls/dslx/frontend/ast.h"
+#include "xls/dslx/frontend/module.h"
 #include "xls/dslx/frontend/pos.h"
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/parse_and_typecheck.h"
+#include "xls/dslx/type_system/parametric_instantiation_cache.h"
 #include "xls/dslx/type_system/type_info.h"
 #include "xls/dslx/type_system/typecheck_test_utils.h"
+#include "xls/dslx/warning_kind.h"
 
 namespace xls::dslx {
 namespace {
@@ -535,6 +545,154 @@ struct Bar {
                HasSubstr("Structs cannot contain procs as members.")));
 }
 
+TEST(TypecheckTest, ParametricInstantiationReusedAcrossCallSites) {
+  constexpr std::string_view kImported = R"(
+pub fn widen<N: u32>(x: u8) -> uN[N] { x as uN[N] }
+)";
+  constexpr std::string_view kProgram = R"(
+import imported;
+
+fn f(x: u8) -> u32 { imported::widen<u32:32>(x) }
+
+fn g(x: u8) -> u32 {
+  imported::widen<u32:32>(x) + imported::widen<u32:32>(x + u8:1)
+}
+
+fn h(x: u8) -> u16 { imported::widen<u32:16>(x) }
+)";
+  auto import_data = CreateImportDataForTest();
+  XLS_ASSERT_OK(
+      ParseAndTypecheck(kImported, "imported.x", "imported", &import_data));
+  XLS_ASSERT_OK(
+      ParseAndTypecheck(kProgram, "fake_main_path.x", "main", &import_data));
+
+  const ParametricInstantiationStats& stats =
+      import_data.parametric_instantiation_cache().stats();
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.hits, 2);
+}
+
+TEST(TypecheckTest, ParametricInstantiationSharedAcrossParametricContexts) {
+  constexpr std::string_view kImported = R"(
+pub fn widen<N: u32>(x: u8) -> uN[N] { x as uN[N] }
+)";
+  constexpr std::string_view kProgram = R"(
+import imported;
+
+fn local<N: u32>(x: u8) -> uN[N] { x as uN[N] }
+
+fn p<M: u32>(x: u8) -> u32 { imported::widen<u32:32>(x) + local<u32:32>(x) + M }
+
+fn q<M: u32>(x: u8) -> u32 { imported::widen<u32:32>(x) + local<u32:32>(x) }
+
+fn main(x: u8) -> u32 { p<u32:1>(x) + p<u32:2>(x) + q<u32:3>(x) }
+)";
+  auto import_data = CreateImportDataForTest();
+  XLS_ASSERT_OK(
+      ParseAndTypecheck(kImported, "imported.x", "imported", &import_data));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule main,
+      ParseAndTypecheck(kProgram, "fake_main_path.x", "main", &import_data));
+
+  // The imported instantiation is deduced once and then reused from the other
+  // two contexts. The local one would fall back to the type info of whichever
+  // caller deduced it first, so it is deduced again in every context.
+  const ParametricInstantiationStats& stats =
+      import_data.parametric_instantiation_cache().stats();
+  EXPECT_EQ(stats.misses, 7);
+  EXPECT_EQ(stats.hits, 2);
+
+  // Both instantiations of `p` record the same type info for the imported
+  // callee, and nothing in its parent chain belongs to the caller's module.
+  std::vector<TypeInfo*> widen_type_infos;
+  for (const auto& [invocation, data] :
+       main.type_info->GetRootInvocations()) {
+    if (data.caller()->identifier() != "p" ||
+        invocation->callee()->ToString() != "imported::widen") {
+      continue;
+    }
+    for (const auto& [caller_env, callee_data] : data.env_to_callee_data()) {
+      widen_type_infos.push_back(callee_data.derived_type_info);
+    }
+  }
+  ASSERT_EQ(widen_type_infos.size(), 2);
+  EXPECT_EQ(widen_type_infos[0], widen_type_infos[1]);
+  for (const TypeInfo* ti = widen_type_infos[0]; ti != nullptr;
+       ti = ti->parent()) {
+    EXPECT_NE(ti->module(), main.module);
+  }
+}
+
+TEST(TypecheckTest, LazilyTypecheckedImportOnlyChecksUsedMembers) {
+  constexpr std::string_view kProgram = R"(
+import std;
+
+fn f(x: u32) -> u32 { std::round_up_to_nearest(x, u32:4) }
+)";
+  auto import_data = CreateImportDataForTest();
+  import_data.set_typecheck_imports_lazily(true);
+  XLS_ASSERT_OK(
+      ParseAndTypecheck(kProgram, "fake_main_path.x", "main", &import_data));
+
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleInfo * std_info,
+                           import_data.Get(ImportTokens({"std"})));
+  Module& std_module = std_info->module();
+  auto member_node = [&](std::string_view name) -> const AstNode* {
+    return ToAstNode(*std_module.FindMemberWithName(name).value());
+  };
+  const absl::flat_hash_set<const AstNode*>* checked =
+      import_data.GetLazilyTypecheckedMembers(&std_module);
+  ASSERT_NE(checked, nullptr);
+  EXPECT_TRUE(checked->contains(member_node("round_up_to_nearest")));
+  // Called by `round_up_to_nearest`.
+  EXPECT_TRUE(checked->contains(member_node("ceil_div")));
+  EXPECT_FALSE(checked->contains(member_node("round_up_to_nearest_test")));
+  EXPECT_FALSE(checked->contains(member_node("popcount")));
+  const int64_t checked_count = checked->size();
+  EXPECT_LT(checked_count, std_module.top().size());
+
+  // A later importer of the same module gets the members it uses checked.
+  constexpr std::string_view kOtherProgram = R"(
+import std;
+
+fn g(x: u32) -> u32 { std::popcount(x) }
+)";
+  XLS_ASSERT_OK(ParseAndTypecheck(kOtherProgram, "fake_other_path.x", "other",
+                                  &import_data));
+  checked = import_data.GetLazilyTypecheckedMembers(&std_module);
+  EXPECT_TRUE(checked->contains(member_node("popcount")));
+  EXPECT_GT(checked->size(), checked_count);
+}
+
+TEST(TypecheckTest, LazilyTypecheckedImportIgnoresErrorsInUnusedMembers) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  XLS_ASSERT_OK(SetFileContents(tempdir.path() / "imported.x", R"(
+pub const WIDTH = u32:8;
+pub fn used(x: uN[WIDTH]) -> uN[WIDTH] { x }
+fn unused() -> u32 { u8:1 }
+)"));
+  constexpr std::string_view kProgram = R"(
+import imported;
+
+fn f(x: u8) -> u8 { imported::used(x) }
+)";
+  const std::vector<std::filesystem::path> dslx_paths = {tempdir.path()};
+  for (bool lazily : {false, true}) {
+    ImportData import_data = CreateImportData(
+        kDefaultDslxStdlibPath, dslx_paths, kDefaultWarningsSet,
+        std::make_unique<RealFilesystem>());
+    import_data.set_typecheck_imports_lazily(lazily);
+    absl::StatusOr<TypecheckedModule> tm =
+        ParseAndTypecheck(kProgram, "fake_main_path.x", "main", &import_data);
+    if (lazily) {
+      XLS_EXPECT_OK(tm);
+    } else {
+      EXPECT_THAT(tm, StatusIs(absl::StatusCode::kInvalidArgument,
+                               HasSubstr("uN[32] vs uN[8]")));
+    }
+  }
+}
+
 TEST(TypecheckTest, ParametricStructInstantiatedByGlobal) {
   constexpr std::string_view kProgram = R"(
 struct MyStruct<WIDTH: u32> {
@@ -0,0 +1,312 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/forked_sample_worker.h"
+
+#include <signal.h>  // NOLINT
+#include <stdlib.h>  // NOLINT for WIFEXITED, WEXITSTATUS; not in <cstdlib>
+#include <string.h>  // NOLINT for strsignal
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/file/file_descriptor.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/strerror.h"
+#include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_runner.h"
+#include "xls/fuzzer/sample_summary.pb.h"
+
+namespace xls {
+namespace {
+
+// Requests and responses are sequences of fields, each a 64-bit length
+// followed by that many bytes. A request holds the arguments of RunFromFiles
+// (an empty path standing for an absent optional one); a response holds the
+// status code, the status message and the serialized timing proto.
+struct Request {
+  std::filesystem::path run_dir;
+  std::filesystem::path input_path;
+  std::filesystem::path options_path;
+  std::optional<std::filesystem::path> args_path;
+  std::optional<std::filesystem::path> ir_channel_names_path;
+};
+
+void AppendField(std::string_view field, std::string* message) {
+  uint64_t size = field.size();
+  message->append(reinterpret_cast<const char*>(&size), sizeof(size));
+  message->append(field);
+}
+
+absl::Status WriteAll(int fd, std::string_view data) {
+  while (!data.empty()) {
+    // MSG_NOSIGNAL turns a write to a dead peer into EPIPE rather than SIGPIPE.
+    ssize_t written = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return absl::InternalError(
+          absl::StrCat("Failed to write to sample worker: ", Strerror(errno)));
+    }
+    data.remove_prefix(written);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ReadExactly(int fd, char* data, int64_t size) {
+  while (size > 0) {
+    ssize_t count = recv(fd, data, size, 0);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return absl::InternalError(
+          absl::StrCat("Failed to read from sample worker: ", Strerror(errno)));
+    }
+    if (count == 0) {
+      return absl::InternalError("Sample worker closed its connection.");
+    }
+    data += count;
+    size -= count;
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> ReadField(int fd) {
+  uint64_t size;
+  XLS_RETURN_IF_ERROR(
+      ReadExactly(fd, reinterpret_cast<char*>(&size), sizeof(size)));
+  std::string field(size, '\0');
+  XLS_RETURN_IF_ERROR(ReadExactly(fd, field.data(), size));
+  return field;
+}
+
+// Reads everything written to `fd` until the peer closes it.
+absl::StatusOr<std::string> ReadToEnd(int fd) {
+  std::string result;
+  std::array<char, 4096> buffer;
+  while (true) {
+    ssize_t count = recv(fd, buffer.data(), buffer.size(), 0);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return absl::InternalError(
+          absl::StrCat("Failed to read from sample child: ", Strerror(errno)));
+    }
+    if (count == 0) {
+      return result;
+    }
+    result.append(buffer.data(), count);
+  }
+}
+
+std::string EncodeResponse(
+    const absl::StatusOr<fuzzer::SampleTimingProto>& timing) {
+  std::string response;
+  AppendField(absl::StrCat(static_cast<int>(timing.status().code())),
+              &response);
+  AppendField(timing.status().message(), &response);
+  AppendField(timing.ok() ? timing->SerializeAsString() : "", &response);
+  return response;
+}
+
+absl::StatusOr<Request> ReadRequest(int fd) {
+  Request request;
+  XLS_ASSIGN_OR_RETURN(std::string run_dir, ReadField(fd));
+  request.run_dir = run_dir;
+  XLS_ASSIGN_OR_RETURN(std::string input_path, ReadField(fd));
+  request.input_path = input_path;
+  XLS_ASSIGN_OR_RETURN(std::string options_path, ReadField(fd));
+  request.options_path = options_path;
+  XLS_ASSIGN_OR_RETURN(std::string args_path, ReadField(fd));
+  if (!args_path.empty()) {
+    request.args_path = args_path;
+  }
+  XLS_ASSIGN_OR_RETURN(std::string ir_channel_names_path, ReadField(fd));
+  if (!ir_channel_names_path.empty()) {
+    request.ir_channel_names_path = ir_channel_names_path;
+  }
+  return request;
+}
+
+// Runs the sample; called in the per-sample child process.
+absl::StatusOr<fuzzer::SampleTimingProto> RunSampleInChild(
+    const Request& request) {
+  XLS_ASSIGN_OR_RETURN(std::string options_text,
+                       GetFileContents(request.options_path));
+  XLS_ASSIGN_OR_RETURN(SampleOptions options,
+                       SampleOptions::FromPbtxt(options_text));
+  if (options.timeout_seconds().has_value()) {
+    // The default action of SIGALRM terminates the child, which is reported
+    // as a timeout by RunInChild.
+    alarm(*options.timeout_seconds() * ForkedSampleWorker::kStagesPerSample);
+  }
+  SampleRunner runner(request.run_dir,
+                      SampleRunner::ExecutionMode::kInProcess);
+  XLS_RETURN_IF_ERROR(runner.RunFromFiles(request.input_path,
+                                          request.options_path,
+                                          request.args_path,
+                                          request.ir_channel_names_path));
+  return runner.timing();
+}
+
+// Forks a child which runs the sample and returns its encoded response, or an
+// encoded error if the child did not complete normally.
+std::string RunInChild(const Request& request) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+    return EncodeResponse(absl::InternalError(
+        absl::StrCat("socketpair failed: ", Strerror(errno))));
+  }
+  FileDescriptor read_end(fds[0]);
+  FileDescriptor write_end(fds[1]);
+  pid_t pid = fork();
+  if (pid == -1) {
+    return EncodeResponse(
+        absl::InternalError(absl::StrCat("fork failed: ", Strerror(errno))));
+  }
+  if (pid == 0) {
+    read_end.Close();
+    (void)WriteAll(write_end.get(), EncodeResponse(RunSampleInChild(request)));
+    _exit(EXIT_SUCCESS);
+  }
+  write_end.Close();
+  absl::StatusOr<std::string> response = ReadToEnd(read_end.get());
+
+  int wait_status;
+  while (waitpid(pid, &wait_status, 0) == -1) {
+    if (errno != EINTR) {
+      return EncodeResponse(absl::InternalError(
+          absl::StrCat("waitpid failed: ", Strerror(errno))));
+    }
+  }
+  if (WIFSIGNALED(wait_status)) {
+    int signal = WTERMSIG(wait_status);
+    if (signal == SIGALRM) {
+      return EncodeResponse(absl::DeadlineExceededError(
+          "Sample timed out in the sample worker."));
+    }
+    return EncodeResponse(absl::InternalError(
+        absl::StrFormat("Sample worker crashed: terminated by signal %d (%s)",
+                        signal, strsignal(signal))));
+  }
+  if (!WIFEXITED(wait_status) || WEXITSTATUS(wait_status) != EXIT_SUCCESS ||
+      !response.ok() || response->empty()) {
+    return EncodeResponse(absl::InternalError(absl::StrFormat(
+        "Sample worker exited abnormally (wait status %d).", wait_status)));
+  }
+  return *std::move(response);
+}
+
+// Main loop of the helper process: runs requests until the connection is
+// closed.
+[[noreturn]] void RunHelper(int fd) {
+  // Don't outlive the fuzzer if it dies without closing the connection.
+  prctl(PR_SET_PDEATHSIG, SIGKILL);
+  while (true) {
+    absl::StatusOr<Request> request = ReadRequest(fd);
+    if (!request.ok() || !WriteAll(fd, RunInChild(*request)).ok()) {
+      _exit(EXIT_SUCCESS);
+    }
+  }
+}
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<ForkedSampleWorker>>
+ForkedSampleWorker::Create() {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+    return absl::InternalError(
+        absl::StrCat("socketpair failed: ", Strerror(errno)));
+  }
+  pid_t pid = fork();
+  if (pid == -1) {
+    close(fds[0]);
+    close(fds[1]);
+    return absl::InternalError(absl::StrCat("fork failed: ", Strerror(errno)));
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    RunHelper(fds[1]);
+  }
+  close(fds[1]);
+  return absl::WrapUnique(new ForkedSampleWorker(pid, FileDescriptor(fds[0])));
+}
+
+ForkedSampleWorker::~ForkedSampleWorker() {
+  socket_.Close();
+  // Helpers forked later may hold a copy of this worker's end of the
+  // connection, so the helper cannot be relied upon to see it close.
+  kill(pid_, SIGKILL);
+  while (waitpid(pid_, nullptr, 0) == -1 && errno == EINTR) {
+  }
+}
+
+absl::StatusOr<fuzzer::SampleTimingProto> ForkedSampleWorker::RunFromFiles(
+    const std::filesystem::path& run_dir,
+    const std::filesystem::path& input_path,
+    const std::filesystem::path& options_path,
+    const std::optional<std::filesystem::path>& args_path,
+    const std::optional<std::filesystem::path>& ir_channel_names_path) {
+  std::string request;
+  AppendField(run_dir.string(), &request);
+  AppendField(input_path.string(), &request);
+  AppendField(options_path.string(), &request);
+  AppendField(args_path.has_value() ? args_path->string() : "", &request);
+  AppendField(
+      ir_channel_names_path.has_value() ? ir_channel_names_path->string() : "",
+      &request);
+  XLS_RETURN_IF_ERROR(WriteAll(socket_.get(), request));
+
+  XLS_ASSIGN_OR_RETURN(std::string code, ReadField(socket_.get()));
+  XLS_ASSIGN_OR_RETURN(std::string message, ReadField(socket_.get()));
+  XLS_ASSIGN_OR_RETURN(std::string timing_bytes, ReadField(socket_.get()));
+  int code_value;
+  if (!absl::SimpleAtoi(code, &code_value)) {
+    return absl::InternalError("Malformed response from sample worker.");
+  }
+  if (code_value != static_cast<int>(absl::StatusCode::kOk)) {
+    return absl::Status(static_cast<absl::StatusCode>(code_value), message);
+  }
+  fuzzer::SampleTimingProto timing;
+  if (!timing.ParseFromString(timing_bytes)) {
+    return absl::InternalError("Malformed timing from sample worker.");
+  }
+  return timing;
+}
+
+}  // namespace xls
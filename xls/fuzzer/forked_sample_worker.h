@@ -0,0 +1,76 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_FUZZER_FORKED_SAMPLE_WORKER_H_
+#define XLS_FUZZER_FORKED_SAMPLE_WORKER_H_
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "xls/common/file/file_descriptor.h"
+#include "xls/fuzzer/sample_summary.pb.h"
+
+namespace xls {
+
+// Runs samples with a SampleRunner in in-process mode, isolated from the
+// calling process so that a crash (e.g., a CHECK failure in the optimizer or
+// the JIT) fails the sample rather than the fuzzer.
+//
+// Creating a worker forks a helper process. The helper forks a fresh child for
+// every sample, which runs the sample and reports its status and timing back;
+// if the child dies instead, the sample fails with an error naming the signal.
+// Forking from the single-threaded helper rather than from the (generally
+// multi-threaded) caller keeps the children in a well-defined state, so
+// workers must be created before the caller starts any threads.
+//
+// A worker handles one sample at a time and is not thread-safe; use one worker
+// per thread.
+class ForkedSampleWorker {
+ public:
+  // Upper bound on the number of timed stages in a function sample; a sample
+  // whose options give a per-command timeout is allowed this many multiples of
+  // it, matching the bound on the subprocess pipeline.
+  static constexpr int64_t kStagesPerSample = 9;
+
+  static absl::StatusOr<std::unique_ptr<ForkedSampleWorker>> Create();
+
+  ~ForkedSampleWorker();
+
+  // As SampleRunner::RunFromFiles, with the SampleRunner constructed in
+  // `run_dir`. Returns the timing of the sample on success.
+  absl::StatusOr<fuzzer::SampleTimingProto> RunFromFiles(
+      const std::filesystem::path& run_dir,
+      const std::filesystem::path& input_path,
+      const std::filesystem::path& options_path,
+      const std::optional<std::filesystem::path>& args_path,
+      const std::optional<std::filesystem::path>& ir_channel_names_path);
+
+ private:
+  ForkedSampleWorker(pid_t pid, FileDescriptor socket)
+      : pid_(pid), socket_(std::move(socket)) {}
+
+  pid_t pid_;
+  // Connected to the helper process.
+  FileDescriptor socket_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_FUZZER_FORKED_SAMPLE_WORKER_H_
@@ -0,0 +1,118 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/forked_sample_worker.h"
+
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_summary.pb.h"
+
+namespace xls {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::testing::HasSubstr;
+
+constexpr std::string_view kLongLoopIR = R"(package long_loop
+
+fn body(i: bits[64], accum: bits[64]) -> bits[64] {
+  ret one: bits[64] = literal(value=1)
+}
+
+top fn main(x: bits[64]) -> bits[64] {
+  zero: bits[64] = literal(value=0, id=1)
+  ret result: bits[64] = counted_for(zero, trip_count=0xffff_ffff_ffff, stride=1, body=body, id=5)
+}
+)";
+
+// Writes the sample files into `run_dir` and runs them with `worker`.
+absl::StatusOr<fuzzer::SampleTimingProto> RunSample(
+    ForkedSampleWorker& worker, const std::filesystem::path& run_dir,
+    std::string_view input_text, const SampleOptions& options,
+    std::string_view args_text) {
+  std::filesystem::path input_path =
+      run_dir / (options.input_is_dslx() ? "sample.x" : "sample.ir");
+  XLS_RETURN_IF_ERROR(SetFileContents(input_path, input_text));
+  std::filesystem::path options_path = run_dir / "options.pbtxt";
+  XLS_RETURN_IF_ERROR(SetTextProtoFile(options_path, options.proto()));
+  std::filesystem::path args_path = run_dir / "args.txt";
+  XLS_RETURN_IF_ERROR(SetFileContents(args_path, args_text));
+  return worker.RunFromFiles(run_dir, input_path, options_path, args_path,
+                             /*ir_channel_names_path=*/std::nullopt);
+}
+
+TEST(ForkedSampleWorkerTest, RunsSamples) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ForkedSampleWorker> worker,
+                           ForkedSampleWorker::Create());
+  SampleOptions options;
+  options.set_input_is_dslx(true);
+  options.set_ir_converter_args({"--top=main"});
+  // The worker is reused across samples.
+  for (int i = 0; i < 2; ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+    XLS_ASSERT_OK_AND_ASSIGN(
+        fuzzer::SampleTimingProto timing,
+        RunSample(*worker, temp_dir.path(),
+                  "fn main(x: u8, y: u8) -> u8 { x + y }", options,
+                  "bits[8]:0x2a; bits[8]:0x64"));
+    EXPECT_GT(timing.optimize_ns(), 0);
+    EXPECT_THAT(GetFileContents(temp_dir.path() / "sample.opt.ir.results"),
+                IsOkAndHolds("bits[8]:0x8e\n"));
+  }
+}
+
+TEST(ForkedSampleWorkerTest, ReportsSampleFailure) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ForkedSampleWorker> worker,
+                           ForkedSampleWorker::Create());
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  SampleOptions options;
+  options.set_input_is_dslx(false);
+  EXPECT_THAT(RunSample(*worker, temp_dir.path(), "bogus ir string", options,
+                        "bits[8]:0x2a"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Expected 'package' keyword")));
+}
+
+TEST(ForkedSampleWorkerTest, Timeout) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ForkedSampleWorker> worker,
+                           ForkedSampleWorker::Create());
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  SampleOptions options;
+  options.set_input_is_dslx(false);
+  options.set_optimize_ir(false);
+  options.set_use_jit(false);
+  options.set_codegen(false);
+  options.set_timeout_seconds(1);
+  EXPECT_THAT(RunSample(*worker, temp_dir.path(), kLongLoopIR, options,
+                        "bits[64]:0x2a"),
+              StatusIs(absl::StatusCode::kDeadlineExceeded));
+}
+
+}  // namespace
+}  // namespace xls
@@ -47,6 +47,7 @@
 #include "xls/dslx/frontend/pos.h"
 #include "xls/fuzzer/ast_generator.h"
 #include "xls/fuzzer/cpp_run_fuzz.h"
+#include "xls/fuzzer/forked_sample_worker.h"
 #include "xls/fuzzer/sample.h"
 #include "xls/fuzzer/sample_generator.h"
 #include "xls/fuzzer/sample_runner.h"
@@ -178,7 +179,9 @@ absl::StatusOr<std::filesystem::path> SaveCrasher(
 
 absl::Status RunSample(const Sample& smp, const std::filesystem::path& run_dir,
                        const std::optional<std::filesystem::path>& summary_file,
-                       std::optional<absl::Duration> generate_sample_elapsed) {
+                       std::optional<absl::Duration> generate_sample_elapsed,
+                       ForkedSampleWorker* worker,
+                       fuzzer::SampleTimingProto* timing_out) {
   XLS_ASSIGN_OR_RETURN(std::filesystem::path sample_runner_main_path,
                        GetXlsRunfilePath(kSampleRunnerMainPath));
 
@@ -220,6 +223,10 @@ absl::Status RunSample(const Sample& smp, const std::filesystem::path& run_dir,
     argv.push_back("--ir_channel_names_file=ir_channel_names.txt");
   }
 
+  if (worker != nullptr) {
+    argv.push_back("--in_process");
+  }
+
   argv.push_back("\"$RUNDIR\"");
 
   std::filesystem::path run_script_path = run_dir / "run.sh";
@@ -236,12 +243,19 @@ cd "$RUNDIR"
 
   VLOG(1) << "Starting to run sample";
   VLOG(2) << smp.input_text();
-  SampleRunner runner(run_dir);
-  XLS_RETURN_IF_ERROR(runner.RunFromFiles(sample_file_name, options_file_name,
-                                          args_file_name,
-                                          ir_channel_names_file_name));
-
-  fuzzer::SampleTimingProto timing = runner.timing();
+  fuzzer::SampleTimingProto timing;
+  if (worker != nullptr) {
+    XLS_ASSIGN_OR_RETURN(
+        timing, worker->RunFromFiles(run_dir, sample_file_name,
+                                     options_file_name, args_file_name,
+                                     ir_channel_names_file_name));
+  } else {
+    SampleRunner runner(run_dir);
+    XLS_RETURN_IF_ERROR(runner.RunFromFiles(sample_file_name,
+                                            options_file_name, args_file_name,
+                                            ir_channel_names_file_name));
+    timing = runner.timing();
+  }
 
   absl::Duration total_elapsed = stopwatch.GetElapsedTime();
   if (generate_sample_elapsed.has_value()) {
@@ -259,29 +273,27 @@ cd "$RUNDIR"
   if (summary_file.has_value()) {
     XLS_RETURN_IF_ERROR(WriteIrSummaries(run_dir, timing, *summary_file));
   }
+  if (timing_out != nullptr) {
+    *timing_out = timing;
+  }
   return absl::OkStatus();
 }
 
-absl::StatusOr<Sample> GenerateSampleAndRun(
-    dslx::FileTable& file_table, absl::BitGenRef bit_gen,
-    const dslx::AstGeneratorOptions& ast_generator_options,
-    const SampleOptions& sample_options, const std::filesystem::path& run_dir,
+absl::Status RunGeneratedSample(
+    const Sample& smp, absl::Duration generate_sample_elapsed,
+    const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& crasher_dir,
     const std::optional<std::filesystem::path>& summary_file,
-    bool force_failure) {
-  Stopwatch stopwatch;
-  XLS_ASSIGN_OR_RETURN(
-      Sample smp, GenerateSample(ast_generator_options, sample_options, bit_gen,
-                                 file_table));
-  absl::Duration generate_sample_elapsed = stopwatch.GetElapsedTime();
-
+    bool force_failure, ForkedSampleWorker* worker,
+    fuzzer::SampleTimingProto* timing) {
   absl::Status status =
-      RunSample(smp, run_dir, summary_file, generate_sample_elapsed);
+      RunSample(smp, run_dir, summary_file, generate_sample_elapsed, worker,
+                timing);
   if (force_failure) {
     status = absl::InternalError("Forced sample failure.");
   }
   if (status.ok()) {
-    return smp;
+    return absl::OkStatus();
   }
 
   LOG(ERROR) << "Sample failed: " << status;
@@ -291,9 +303,9 @@ absl::StatusOr<Sample> GenerateSampleAndRun(
     if (!absl::IsDeadlineExceeded(status)) {
       LOG(INFO) << "Attempting to minimize IR...";
       std::optional<absl::Duration> timeout =
-          sample_options.timeout_seconds().has_value()
+          smp.options().timeout_seconds().has_value()
               ? std::optional<absl::Duration>(
-                    absl::Seconds(*sample_options.timeout_seconds()))
+                    absl::Seconds(*smp.options().timeout_seconds()))
               : std::nullopt;
       XLS_ASSIGN_OR_RETURN(
           std::optional<std::filesystem::path> minimized_path,
@@ -311,4 +323,23 @@ absl::StatusOr<Sample> GenerateSampleAndRun(
   return status;
 }
 
+absl::StatusOr<Sample> GenerateSampleAndRun(
+    dslx::FileTable& file_table, absl::BitGenRef bit_gen,
+    const dslx::AstGeneratorOptions& ast_generator_options,
+    const SampleOptions& sample_options, const std::filesystem::path& run_dir,
+    const std::optional<std::filesystem::path>& crasher_dir,
+    const std::optional<std::filesystem::path>& summary_file,
+    bool force_failure, ForkedSampleWorker* worker,
+    fuzzer::SampleTimingProto* timing) {
+  Stopwatch stopwatch;
+  XLS_ASSIGN_OR_RETURN(
+      Sample smp, GenerateSample(ast_generator_options, sample_options, bit_gen,
+                                 file_table));
+  absl::Duration generate_sample_elapsed = stopwatch.GetElapsedTime();
+  XLS_RETURN_IF_ERROR(RunGeneratedSample(smp, generate_sample_elapsed, run_dir,
+                                         crasher_dir, summary_file,
+                                         force_failure, worker, timing));
+  return smp;
+}
+
 }  // namespace xls
@@ -24,7 +24,9 @@
 #include "absl/time/time.h"
 #include "xls/dslx/frontend/pos.h"
 #include "xls/fuzzer/ast_generator.h"
+#include "xls/fuzzer/forked_sample_worker.h"
 #include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_summary.pb.h"
 
 namespace xls {
 
@@ -33,10 +35,17 @@ namespace xls {
 // given, it will be recorded in the timings in the sample summary.
 //
 // `run_dir` must be an empty directory.
+//
+// If `worker` is given, the sample is run in-process in a child of the worker
+// (see ForkedSampleWorker); otherwise the stages of the sample are run as
+// subprocesses. If `timing` is given, it is set to the timing of the sample
+// when the sample runs successfully.
 absl::Status RunSample(
     const Sample& smp, const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& summary_file = std::nullopt,
-    std::optional<absl::Duration> generate_sample_elapsed = std::nullopt);
+    std::optional<absl::Duration> generate_sample_elapsed = std::nullopt,
+    ForkedSampleWorker* worker = nullptr,
+    fuzzer::SampleTimingProto* timing = nullptr);
 
 absl::StatusOr<Sample> GenerateSampleAndRun(
     dslx::FileTable& file_table, absl::BitGenRef bit_gen,
@@ -44,7 +53,20 @@ absl::StatusOr<Sample> GenerateSampleAndRun(
     const SampleOptions& sample_options, const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& crasher_dir = std::nullopt,
     const std::optional<std::filesystem::path>& summary_file = std::nullopt,
-    bool force_failure = false);
+    bool force_failure = false, ForkedSampleWorker* worker = nullptr,
+    fuzzer::SampleTimingProto* timing = nullptr);
+
+// Runs the already generated sample `smp`, which took
+// `generate_sample_elapsed` to generate (e.g., as a mutation of an earlier
+// sample; see MutateSample). The remaining arguments are as for
+// GenerateSampleAndRun.
+absl::Status RunGeneratedSample(
+    const Sample& smp, absl::Duration generate_sample_elapsed,
+    const std::filesystem::path& run_dir,
+    const std::optional<std::filesystem::path>& crasher_dir = std::nullopt,
+    const std::optional<std::filesystem::path>& summary_file = std::nullopt,
+    bool force_failure = false, ForkedSampleWorker* worker = nullptr,
+    fuzzer::SampleTimingProto* timing = nullptr);
 
 }  // namespace xls
 
@@ -19,8 +19,8 @@
 #include <memory>
 #include <optional>
 #include <random>
-#include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "absl/log/log.h"
@@ -30,7 +30,6 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
-#include "absl/strings/str_join.h"
 #include "absl/time/time.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/temp_directory.h"
@@ -39,8 +38,13 @@
 #include "xls/common/thread.h"
 #include "xls/dslx/frontend/pos.h"
 #include "xls/fuzzer/ast_generator.h"
+#include "xls/fuzzer/forked_sample_worker.h"
 #include "xls/fuzzer/run_fuzz.h"
 #include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_coverage.h"
+#include "xls/fuzzer/sample_generator.h"
+#include "xls/fuzzer/sample_scheduler.h"
+#include "xls/fuzzer/sample_summary.pb.h"
 
 namespace xls {
 namespace {
@@ -49,15 +53,22 @@ static constexpr std::string_view kBlueText = "\033[34m";
 static constexpr std::string_view kRedText = "\033[31m";
 static constexpr std::string_view kDefaultColor = "\033[0m";
 
-absl::Status GenerateAndRunSamples(
-    int64_t worker_number,
-    const dslx::AstGeneratorOptions& ast_generator_options,
+// In coverage-guided mode, the probability of mutating a corpus sample rather
+// than generating a new one.
+constexpr double kMutationProbability = 0.5;
+
+// Generates and runs the samples claimed from `scheduler` until the run is
+// over. Returns the number of samples run.
+//
+// If `corpus` is given, the coverage of each passing sample is recorded in it,
+// and samples are mutated from its seeds as often as they are newly generated.
+absl::StatusOr<int64_t> GenerateAndRunSamples(
+    int64_t worker_number, SampleScheduler& scheduler,
     const SampleOptions& sample_options, const std::optional<uint64_t>& seed,
     const std::optional<std::filesystem::path>& top_run_dir,
     const std::optional<std::filesystem::path>& crasher_dir,
     const std::optional<std::filesystem::path>& summary_dir,
-    std::optional<int64_t> sample_count,
-    const std::optional<absl::Duration>& duration, bool force_failure) {
+    bool force_failure, ForkedSampleWorker* worker, CoverageCorpus* corpus) {
   int64_t crashers = 0;
   LOG(INFO) << "--- Started worker " << worker_number;
   Stopwatch stopwatch;
@@ -84,7 +95,7 @@ absl::Status GenerateAndRunSamples(
   dslx::FileTable file_table;
 
   int64_t sample = 0;
-  while (true) {
+  while (scheduler.ClaimSample().has_value()) {
     std::filesystem::path run_dir;
     std::optional<TempDirectory> temp_run_dir;
     if (top_run_dir.has_value()) {
@@ -96,11 +107,45 @@ absl::Status GenerateAndRunSamples(
       run_dir = temp_run_dir->path();
     }
 
-    absl::Status sample_status =
-        GenerateSampleAndRun(file_table, rng, ast_generator_options,
-                             sample_options, run_dir, crasher_dir, summary_file,
-                             force_failure)
-            .status();
+    Stopwatch sample_stopwatch;
+    fuzzer::SampleTimingProto timing;
+    std::optional<Sample> mutant;
+    if (corpus != nullptr && absl::Bernoulli(rng, kMutationProbability)) {
+      if (std::optional<Sample> seed_sample = corpus->ChooseSeed(rng);
+          seed_sample.has_value()) {
+        absl::StatusOr<Sample> mutated =
+            MutateSample(*seed_sample, rng, file_table);
+        if (mutated.ok()) {
+          mutant = *std::move(mutated);
+        } else {
+          VLOG(1) << "Failed to mutate corpus sample: " << mutated.status();
+        }
+      }
+    }
+    absl::StatusOr<Sample> smp;
+    if (mutant.has_value()) {
+      smp = *std::move(mutant);
+      absl::Status run_status = RunGeneratedSample(
+          *smp, sample_stopwatch.GetElapsedTime(), run_dir, crasher_dir,
+          summary_file, force_failure, worker, &timing);
+      if (!run_status.ok()) {
+        smp = run_status;
+      }
+    } else {
+      smp = GenerateSampleAndRun(file_table, rng,
+                                 scheduler.GetAstGeneratorOptions(),
+                                 sample_options, run_dir, crasher_dir,
+                                 summary_file, force_failure, worker, &timing);
+    }
+    absl::Status sample_status = smp.status();
+    if (corpus != nullptr && sample_status.ok()) {
+      XLS_ASSIGN_OR_RETURN(SampleCoverage coverage,
+                           CollectSampleCoverage(run_dir));
+      corpus->Add(*smp, coverage);
+    }
+    scheduler.RecordSample(
+        sample_stopwatch.GetElapsedTime(),
+        timing.has_total_ns() ? std::make_optional(timing) : std::nullopt);
     if (!sample_status.ok()) {
       LOG(INFO) << kRedText
                 << absl::StreamFormat(
@@ -109,43 +154,16 @@ absl::Status GenerateAndRunSamples(
                 << kDefaultColor;
       crashers++;
     }
-
-    absl::Duration elapsed = stopwatch.GetElapsedTime();
-    if (sample > 0 && sample % 16 == 0) {
-      std::vector<std::string> metrics;
-      metrics.reserve(3);
-      if (sample_count.has_value()) {
-        metrics.push_back(
-            absl::StrFormat("%d/%d samples", sample, *sample_count));
-      } else {
-        metrics.push_back(absl::StrCat(sample, " samples"));
-      }
-      metrics.push_back(absl::StrFormat(
-          "%.2f samples/s",
-          static_cast<double>(sample) / absl::ToDoubleSeconds(elapsed)));
-      if (duration.has_value()) {
-        metrics.push_back(absl::StrFormat("running for %s (limit %s)",
-                                          absl::FormatDuration(elapsed),
-                                          absl::FormatDuration(*duration)));
-      } else {
-        metrics.push_back(
-            absl::StrFormat("running for %s", absl::FormatDuration(elapsed)));
-      }
-      LOG(INFO) << absl::StreamFormat("--- Worker #%d: %s", worker_number,
-                                      absl::StrJoin(metrics, ", "));
-    }
-
-    if (duration.has_value() && elapsed >= *duration) {
-      LOG(INFO) << absl::StreamFormat("--- Worker #%d: Ran for %s. Exiting.",
-                                      worker_number,
-                                      absl::FormatDuration(elapsed));
-      break;
-    }
     ++sample;
-    if (sample_count.has_value() && sample >= *sample_count) {
+
+    if (sample % 16 == 0) {
+      absl::Duration elapsed = stopwatch.GetElapsedTime();
       LOG(INFO) << absl::StreamFormat(
-          "--- Worker #%d: Ran %d samples. Exiting.", worker_number, sample);
-      break;
+          "--- Worker #%d: %d samples (%d overall), %.2f samples/s, running "
+          "for %s, sample width scale %.3f",
+          worker_number, sample, scheduler.samples_completed(),
+          static_cast<double>(sample) / absl::ToDoubleSeconds(elapsed),
+          absl::FormatDuration(elapsed), scheduler.scale());
     }
   }
 
@@ -156,7 +174,7 @@ absl::Status GenerateAndRunSamples(
       worker_number, sample, crashers,
       static_cast<double>(sample) / absl::ToDoubleSeconds(elapsed),
       absl::FormatDuration(elapsed));
-  return absl::OkStatus();
+  return sample;
 }
 
 }  // namespace
@@ -169,33 +187,63 @@ absl::Status ParallelGenerateAndRunSamples(
     const std::optional<std::filesystem::path>& crasher_dir,
     const std::optional<std::filesystem::path>& summary_dir,
     std::optional<int64_t> sample_count, std::optional<absl::Duration> duration,
-    bool force_failure) {
+    bool force_failure, bool in_process,
+    std::optional<double> target_samples_per_second, bool coverage_guided) {
+  // The sample workers fork helper processes, so they must be created before
+  // any threads are started.
+  std::vector<std::unique_ptr<ForkedSampleWorker>> sample_workers;
+  if (in_process) {
+    for (int64_t i = 0; i < worker_count; ++i) {
+      XLS_ASSIGN_OR_RETURN(sample_workers.emplace_back(),
+                           ForkedSampleWorker::Create());
+    }
+  }
+
+  SampleScheduler scheduler(ast_generator_options, worker_count, sample_count,
+                            duration, target_samples_per_second);
+  std::optional<CoverageCorpus> corpus;
+  if (coverage_guided) {
+    corpus.emplace();
+  }
+  Stopwatch stopwatch;
   std::vector<std::unique_ptr<Thread>> workers;
   workers.resize(worker_count);
-  std::vector<absl::Status> worker_status;
+  std::vector<absl::StatusOr<int64_t>> worker_status;
   worker_status.resize(workers.size(),
                        absl::InternalError("worker did not terminate."));
   for (int64_t i = 0; i < workers.size(); ++i) {
-    std::optional<int64_t> worker_sample_count =
-        sample_count.has_value()
-            ? std::make_optional((*sample_count + i) / worker_count)
-            : std::nullopt;
-    workers[i] = std::make_unique<Thread>([&, i, worker_sample_count,
-                                           status = &worker_status[i]] {
-      *status =
-          GenerateAndRunSamples(i, ast_generator_options, sample_options, seed,
-                                top_run_dir, crasher_dir, summary_dir,
-                                worker_sample_count, duration, force_failure);
+    workers[i] = std::make_unique<Thread>([&, i, status = &worker_status[i]] {
+      *status = GenerateAndRunSamples(
+          i, scheduler, sample_options, seed, top_run_dir, crasher_dir,
+          summary_dir, force_failure,
+          in_process ? sample_workers[i].get() : nullptr,
+          corpus.has_value() ? &*corpus : nullptr);
     });
   }
+  int64_t total_samples = 0;
   for (int64_t i = 0; i < workers.size(); ++i) {
     LOG(INFO) << "-- Waiting on worker " << i;
     workers[i]->Join();
     if (!worker_status[i].ok()) {
       LOG(ERROR) << kRedText << "-- Worker #" << i
-                 << " failed: " << worker_status[i] << kDefaultColor;
+                 << " failed: " << worker_status[i].status() << kDefaultColor;
+    } else {
+      total_samples += *worker_status[i];
     }
   }
+  absl::Duration elapsed = stopwatch.GetElapsedTime();
+  LOG(INFO) << absl::StreamFormat(
+      "-- All workers finished (%s mode): %d samples; %.2f samples/s; ran for "
+      "%s",
+      in_process ? "in-process" : "subprocess", total_samples,
+      static_cast<double>(total_samples) / absl::ToDoubleSeconds(elapsed),
+      absl::FormatDuration(elapsed));
+  LOG(INFO) << "-- Stage latencies:\n" << scheduler.StageLatencySummary();
+  if (corpus.has_value()) {
+    LOG(INFO) << absl::StreamFormat(
+        "-- Coverage: %d features; %d samples in corpus",
+        corpus->feature_count(), corpus->size());
+  }
   return absl::OkStatus();
 }
 
@@ -28,6 +28,9 @@ namespace xls {
 
 // Generate and run fuzzer samples on `worker_count` threads; runs up to
 // `sample_count` samples (unbounded if unspecified) for up to `duration` time.
+// The threads claim samples one at a time from the shared budget (see
+// SampleScheduler), and the latencies of the sample stages are logged at the
+// end.
 //
 // Generates samples according to `ast_generator_options`, and runs them
 // according to `sample_options`. Uses a nondeterministic seed if `seed` is not
@@ -37,6 +40,19 @@ namespace xls {
 //
 // If `force_failure` is true, every sample run will be considered a failure.
 // This is useful for testing failure paths.
+//
+// If `in_process` is true, each thread runs its samples in-process through a
+// ForkedSampleWorker rather than invoking a subprocess for every stage. Either
+// way, the overall throughput is logged in samples per second when done.
+//
+// If `target_samples_per_second` is given, the widths in
+// `ast_generator_options` are scaled down as needed to reach that rate.
+//
+// If `coverage_guided` is true, the IR ops, optimization passes and Verilog
+// constructs exercised by each sample are recorded (see CollectSampleCoverage),
+// samples which add coverage are kept in a corpus, and (once the corpus is
+// non-empty) about half of the samples are mutations of corpus samples,
+// favoring those with rare coverage.
 absl::Status ParallelGenerateAndRunSamples(
     int64_t worker_count,
     const dslx::AstGeneratorOptions& ast_generator_options,
@@ -47,7 +63,9 @@ absl::Status ParallelGenerateAndRunSamples(
     const std::optional<std::filesystem::path>& summary_dir = std::nullopt,
     std::optional<int64_t> sample_count = std::nullopt,
     std::optional<absl::Duration> duration = std::nullopt,
-    bool force_failure = false);
+    bool force_failure = false, bool in_process = false,
+    std::optional<double> target_samples_per_second = std::nullopt,
+    bool coverage_guided = false);
 
 }  // namespace xls
 
@@ -42,11 +42,20 @@ ABSL_FLAG(int64_t, calls_per_sample, 128, "Arguments to generate per sample.");
 ABSL_FLAG(std::optional<std::string>, crash_path, std::nullopt,
           "Path at which to place crash data.");
 ABSL_FLAG(bool, codegen, false, "Run code generation.");
+ABSL_FLAG(bool, coverage_guided, false,
+          "Record the IR ops, optimization passes and Verilog constructs each "
+          "sample exercises, and mutate the samples which add coverage in "
+          "addition to generating new ones. Pass coverage is only recorded "
+          "with --in_process.");
 ABSL_FLAG(bool, emit_loops, true, "Emit loops in generator.");
 ABSL_FLAG(
     bool, force_failure, false,
     "Forces the samples to fail. Can be used to test failure code paths.");
 ABSL_FLAG(bool, generate_proc, false, "Generate a proc sample.");
+ABSL_FLAG(bool, in_process, false,
+          "Run DSLX conversion, IR evaluation and optimization of function "
+          "samples in-process, in a forked child per sample, rather than by "
+          "invoking a subprocess for every stage.");
 ABSL_FLAG(int64_t, max_width_aggregate_types, 1024,
           "The maximum width of aggregate types (tuples and arrays) in the "
           "generated samples.");
@@ -71,6 +80,10 @@ ABSL_FLAG(std::optional<std::string>, summary_path, std::nullopt,
           "records information about each generated sample including which XLS "
           "op types and widths. Information is written in Protobuf text format "
           "with one file per worker. Files are appended to by the worker.");
+ABSL_FLAG(std::optional<double>, target_samples_per_second, std::nullopt,
+          "If given, the maximum widths of generated types are scaled down "
+          "(never above --max_width_bits_types and "
+          "--max_width_aggregate_types) to hold this overall rate.");
 ABSL_FLAG(std::optional<int64_t>, timeout_seconds, std::nullopt,
           "The timeout value in seconds for each subcommand invocation.");
 ABSL_FLAG(bool, use_llvm_jit, true,
@@ -92,9 +105,11 @@ struct Options {
   int64_t calls_per_sample;
   std::optional<std::filesystem::path> crash_path;
   bool codegen;
+  bool coverage_guided;
   bool emit_loops;
   bool force_failure;
   bool generate_proc;
+  bool in_process;
   int64_t max_width_aggregate_types;
   int64_t max_width_bits_types;
   int64_t proc_ticks;
@@ -104,6 +119,7 @@ struct Options {
   bool simulate;
   std::optional<std::string> simulator;
   std::optional<std::filesystem::path> summary_path;
+  std::optional<double> target_samples_per_second;
   std::optional<int64_t> timeout_seconds;
   bool use_llvm_jit;
   bool use_system_verilog;
@@ -173,7 +189,9 @@ absl::Status RealMain(const Options& options) {
       worker_count, ast_generator_options, sample_options, options.seed,
       /*top_run_dir=*/options.save_temps_path,
       /*crasher_dir=*/options.crash_path, /*summary_dir=*/options.summary_path,
-      options.sample_count, options.duration, options.force_failure);
+      options.sample_count, options.duration, options.force_failure,
+      options.in_process, options.target_samples_per_second,
+      options.coverage_guided);
 }
 
 }  // namespace
@@ -193,15 +211,22 @@ int main(int argc, char** argv) {
   if (absl::GetFlag(FLAGS_simulate) && !absl::GetFlag(FLAGS_codegen)) {
     LOG(QFATAL) << "Must specify --codegen when --simulate is given.";
   }
+  if (std::optional<double> target =
+          absl::GetFlag(FLAGS_target_samples_per_second);
+      target.has_value() && *target <= 0) {
+    LOG(QFATAL) << "--target_samples_per_second must be positive.";
+  }
 
   return xls::ExitStatus(xls::RealMain({
       .duration = absl::GetFlag(FLAGS_duration),
       .calls_per_sample = absl::GetFlag(FLAGS_calls_per_sample),
       .crash_path = absl::GetFlag(FLAGS_crash_path),
       .codegen = absl::GetFlag(FLAGS_codegen),
+      .coverage_guided = absl::GetFlag(FLAGS_coverage_guided),
       .emit_loops = absl::GetFlag(FLAGS_emit_loops),
       .force_failure = absl::GetFlag(FLAGS_force_failure),
       .generate_proc = absl::GetFlag(FLAGS_generate_proc),
+      .in_process = absl::GetFlag(FLAGS_in_process),
       .max_width_aggregate_types =
           absl::GetFlag(FLAGS_max_width_aggregate_types),
       .max_width_bits_types = absl::GetFlag(FLAGS_max_width_bits_types),
@@ -212,6 +237,8 @@ int main(int argc, char** argv) {
       .simulate = absl::GetFlag(FLAGS_simulate),
       .simulator = absl::GetFlag(FLAGS_simulator),
       .summary_path = absl::GetFlag(FLAGS_summary_path),
+      .target_samples_per_second =
+          absl::GetFlag(FLAGS_target_samples_per_second),
       .timeout_seconds = absl::GetFlag(FLAGS_timeout_seconds),
       .use_llvm_jit = absl::GetFlag(FLAGS_use_llvm_jit),
       .use_system_verilog = absl::GetFlag(FLAGS_use_system_verilog),
@@ -0,0 +1,217 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/sample_coverage.h"
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/random/bit_gen_ref.h"
+#include "absl/random/distributions.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/fuzzer/sample.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/node.h"
+#include "xls/ir/op.h"
+#include "xls/ir/package.h"
+#include "xls/ir/type.h"
+
+namespace xls {
+namespace {
+
+// Verilog keywords whose use is recorded as coverage.
+constexpr std::string_view kVerilogKeywords[] = {
+    "always",      "always_comb", "always_ff",   "assert",      "assign",
+    "case",        "casez",       "cover",       "default",     "else",
+    "final",       "for",         "function",    "generate",    "genvar",
+    "if",          "initial",     "localparam",  "logic",       "negedge",
+    "posedge",     "reg",         "signed",      "unique",      "wire",
+};
+
+// Adds the op coverage features of the IR file at `path`, if it exists.
+absl::Status CollectIrCoverage(const std::filesystem::path& path,
+                               std::string_view prefix,
+                               SampleCoverage& coverage) {
+  if (!FileExists(path).ok()) {
+    return absl::OkStatus();
+  }
+  XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(path));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(ir_text, path.string()));
+  for (FunctionBase* function_base : package->GetFunctionBases()) {
+    for (Node* node : function_base->nodes()) {
+      std::string op = OpToString(node->op());
+      coverage.insert(absl::StrCat(prefix, ":op:", op, ":",
+                                   TypeKindToString(node->GetType()->kind())));
+      coverage.insert(absl::StrCat(
+          prefix, ":width:", op, ":",
+          CeilOfLog2(node->GetType()->GetFlatBitCount() + 1)));
+      for (Node* operand : node->operands()) {
+        coverage.insert(absl::StrCat(prefix, ":edge:", op, "(",
+                                     OpToString(operand->op()), ")"));
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Adds a feature for each line of the file at `path`, if it exists.
+absl::Status CollectLineCoverage(const std::filesystem::path& path,
+                                 std::string_view prefix,
+                                 SampleCoverage& coverage) {
+  if (!FileExists(path).ok()) {
+    return absl::OkStatus();
+  }
+  XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(path));
+  for (std::string_view line :
+       absl::StrSplit(text, '\n', absl::SkipWhitespace())) {
+    coverage.insert(absl::StrCat(prefix, ":", line));
+  }
+  return absl::OkStatus();
+}
+
+// Adds a feature for each Verilog keyword used in the file at `path`, if it
+// exists.
+absl::Status CollectVerilogCoverage(const std::filesystem::path& path,
+                                    SampleCoverage& coverage) {
+  if (!FileExists(path).ok()) {
+    return absl::OkStatus();
+  }
+  static const absl::NoDestructor<absl::flat_hash_set<std::string_view>>
+      kKeywords(std::begin(kVerilogKeywords), std::end(kVerilogKeywords));
+  XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(path));
+  int64_t i = 0;
+  while (i < text.size()) {
+    if (!absl::ascii_isalpha(text[i]) && text[i] != '_') {
+      ++i;
+      continue;
+    }
+    int64_t start = i;
+    while (i < text.size() &&
+           (absl::ascii_isalnum(text[i]) || text[i] == '_' || text[i] == '$')) {
+      ++i;
+    }
+    std::string_view word(text.data() + start, i - start);
+    if (kKeywords->contains(word)) {
+      coverage.insert(absl::StrCat("verilog:", word));
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<SampleCoverage> CollectSampleCoverage(
+    const std::filesystem::path& run_dir) {
+  SampleCoverage coverage;
+  XLS_RETURN_IF_ERROR(
+      CollectIrCoverage(run_dir / "sample.ir", "ir", coverage));
+  XLS_RETURN_IF_ERROR(
+      CollectIrCoverage(run_dir / "sample.opt.ir", "opt_ir", coverage));
+  XLS_RETURN_IF_ERROR(
+      CollectLineCoverage(run_dir / "passes_fired.txt", "pass", coverage));
+  XLS_RETURN_IF_ERROR(CollectVerilogCoverage(run_dir / "sample.v", coverage));
+  XLS_RETURN_IF_ERROR(CollectVerilogCoverage(run_dir / "sample.sv", coverage));
+  return coverage;
+}
+
+int64_t CoverageCorpus::Add(const Sample& sample,
+                            const SampleCoverage& coverage) {
+  absl::MutexLock lock(&mutex_);
+  std::vector<std::string> new_features;
+  for (const std::string& feature : coverage) {
+    if (hit_counts_[feature]++ == 0) {
+      new_features.push_back(feature);
+    }
+  }
+  if (new_features.empty()) {
+    return 0;
+  }
+  int64_t new_feature_count = new_features.size();
+  Entry entry{.sample = sample, .features = std::move(new_features)};
+  if (entries_.size() < max_size_) {
+    entries_.push_back(std::move(entry));
+    return new_feature_count;
+  }
+  int64_t lowest = 0;
+  for (int64_t i = 1; i < entries_.size(); ++i) {
+    if (Weight(entries_[i]) < Weight(entries_[lowest])) {
+      lowest = i;
+    }
+  }
+  if (Weight(entry) > Weight(entries_[lowest])) {
+    entries_[lowest] = std::move(entry);
+  }
+  return new_feature_count;
+}
+
+std::optional<Sample> CoverageCorpus::ChooseSeed(absl::BitGenRef bit_gen) {
+  absl::MutexLock lock(&mutex_);
+  if (entries_.empty()) {
+    return std::nullopt;
+  }
+  std::vector<double> weights;
+  weights.reserve(entries_.size());
+  double total_weight = 0.0;
+  for (const Entry& entry : entries_) {
+    weights.push_back(Weight(entry));
+    total_weight += weights.back();
+  }
+  double point = absl::Uniform(bit_gen, 0.0, total_weight);
+  int64_t chosen = 0;
+  while (chosen + 1 < entries_.size() && point >= weights[chosen]) {
+    point -= weights[chosen];
+    ++chosen;
+  }
+  ++entries_[chosen].times_chosen;
+  return entries_[chosen].sample;
+}
+
+int64_t CoverageCorpus::size() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+int64_t CoverageCorpus::feature_count() const {
+  absl::MutexLock lock(&mutex_);
+  return hit_counts_.size();
+}
+
+double CoverageCorpus::Weight(const Entry& entry) const {
+  double rarity = 0.0;
+  for (const std::string& feature : entry.features) {
+    rarity += 1.0 / static_cast<double>(hit_counts_.at(feature));
+  }
+  return rarity / static_cast<double>(1 + entry.times_chosen);
+}
+
+}  // namespace xls
@@ -0,0 +1,108 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_FUZZER_SAMPLE_COVERAGE_H_
+#define XLS_FUZZER_SAMPLE_COVERAGE_H_
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/random/bit_gen_ref.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/fuzzer/sample.h"
+
+namespace xls {
+
+// The coverage features exercised by a sample, e.g. "opt_ir:op:add:bits",
+// "pass:narrow" or "verilog:always_ff".
+using SampleCoverage = absl::btree_set<std::string>;
+
+// Collects the coverage features of the sample run in `run_dir` from the
+// artifacts the run left there:
+//
+//  * IR ("ir:" for sample.ir, "opt_ir:" for sample.opt.ir): each op with the
+//    kind of its type ("op:<op>:<kind>"), each op with the log2 bucket of its
+//    flat bit count ("width:<op>:<bucket>"), and each pair of an op and the op
+//    of one of its operands ("edge:<op>(<operand op>)").
+//  * Optimization passes which changed the IR ("pass:<name>"), from
+//    passes_fired.txt. This is only written when the sample is optimized
+//    in-process (see SampleRunner::ExecutionMode).
+//  * Verilog keywords used by the generated RTL ("verilog:<keyword>"), as a
+//    proxy for the codegen paths taken.
+//
+// Artifacts missing from `run_dir` (e.g. because the stage was not run) are
+// skipped.
+absl::StatusOr<SampleCoverage> CollectSampleCoverage(
+    const std::filesystem::path& run_dir);
+
+// A corpus of samples which exercised coverage features not exercised before,
+// for use as seeds of mutation. Thread-safe.
+//
+// Each entry is weighted by the rarity of the features it first exercised
+// (the sum over those features of one over the number of samples which have
+// exercised the feature since), divided by one plus the number of times the
+// entry has been chosen as a seed. Mutation is thereby biased towards samples
+// which reach rarely exercised parts of the toolchain, and away from seeds
+// which have already been mutated many times.
+class CoverageCorpus {
+ public:
+  static constexpr int64_t kDefaultMaxSize = 512;
+
+  explicit CoverageCorpus(int64_t max_size = kDefaultMaxSize)
+      : max_size_(max_size) {}
+
+  // Records the coverage of `sample`, adding the sample to the corpus if it
+  // exercised any feature not exercised before. If the corpus is full, the
+  // entry of lowest weight is evicted. Returns the number of new features.
+  int64_t Add(const Sample& sample, const SampleCoverage& coverage);
+
+  // Chooses a corpus entry to mutate with probability proportional to its
+  // weight. Returns std::nullopt if the corpus is empty.
+  std::optional<Sample> ChooseSeed(absl::BitGenRef bit_gen);
+
+  // Number of samples in the corpus.
+  int64_t size() const;
+
+  // Number of distinct features exercised by all recorded samples.
+  int64_t feature_count() const;
+
+ private:
+  struct Entry {
+    Sample sample;
+    // The features first exercised by this sample.
+    std::vector<std::string> features;
+    int64_t times_chosen = 0;
+  };
+
+  double Weight(const Entry& entry) const ABSL_SHARED_LOCKS_REQUIRED(mutex_);
+
+  const int64_t max_size_;
+
+  mutable absl::Mutex mutex_;
+  // Number of recorded samples which exercised each feature.
+  absl::flat_hash_map<std::string, int64_t> hit_counts_
+      ABSL_GUARDED_BY(mutex_);
+  std::vector<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace xls
+
+#endif  // XLS_FUZZER_SAMPLE_COVERAGE_H_
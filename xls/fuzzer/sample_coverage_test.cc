@@ -0,0 +1,151 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/sample_coverage.h"
+
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status_matchers.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/fuzzer/sample.h"
+
+namespace xls {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::testing::AnyOf;
+using ::testing::Contains;
+using ::testing::IsEmpty;
+using ::testing::Not;
+
+constexpr char kIr[] = R"(package sample
+
+top fn main(x: bits[8], y: bits[8]) -> bits[8] {
+  add.1: bits[8] = add(x, y)
+  ret neg.2: bits[8] = neg(add.1)
+}
+)";
+
+constexpr char kOptIr[] = R"(package sample
+
+top fn main(x: bits[8], y: bits[8]) -> bits[8] {
+  ret sub.3: bits[8] = sub(y, x)
+}
+)";
+
+constexpr char kVerilog[] = R"(module main(
+  input wire clk,
+  input wire [7:0] x,
+  output wire [7:0] out
+);
+  reg [7:0] p0;
+  always_ff @ (posedge clk) begin
+    p0 <= x;
+  end
+  assign out = p0;
+endmodule
+)";
+
+Sample MakeSample(std::string_view text) {
+  return Sample(std::string(text), SampleOptions(), /*args_batch=*/{});
+}
+
+TEST(SampleCoverageTest, CollectsFeatures) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  XLS_ASSERT_OK(SetFileContents(temp_dir.path() / "sample.ir", kIr));
+  XLS_ASSERT_OK(SetFileContents(temp_dir.path() / "sample.opt.ir", kOptIr));
+  XLS_ASSERT_OK(SetFileContents(temp_dir.path() / "passes_fired.txt",
+                                "dce\nnarrow\n"));
+  XLS_ASSERT_OK(SetFileContents(temp_dir.path() / "sample.v", kVerilog));
+
+  XLS_ASSERT_OK_AND_ASSIGN(SampleCoverage coverage,
+                           CollectSampleCoverage(temp_dir.path()));
+  EXPECT_THAT(coverage, Contains("ir:op:add:bits"));
+  EXPECT_THAT(coverage, Contains("ir:width:add:4"));
+  EXPECT_THAT(coverage, Contains("ir:edge:neg(add)"));
+  EXPECT_THAT(coverage, Contains("ir:edge:add(param)"));
+  EXPECT_THAT(coverage, Contains("opt_ir:op:sub:bits"));
+  EXPECT_THAT(coverage, Not(Contains("opt_ir:op:add:bits")));
+  EXPECT_THAT(coverage, Contains("pass:dce"));
+  EXPECT_THAT(coverage, Contains("pass:narrow"));
+  EXPECT_THAT(coverage, Contains("verilog:always_ff"));
+  EXPECT_THAT(coverage, Contains("verilog:posedge"));
+  EXPECT_THAT(coverage, Not(Contains("verilog:always_comb")));
+}
+
+TEST(SampleCoverageTest, MissingArtifactsAreSkipped) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  EXPECT_THAT(CollectSampleCoverage(temp_dir.path()),
+              IsOkAndHolds(IsEmpty()));
+}
+
+TEST(CoverageCorpusTest, KeepsSamplesWithNewCoverage) {
+  CoverageCorpus corpus;
+  std::mt19937_64 rng;
+  EXPECT_FALSE(corpus.ChooseSeed(rng).has_value());
+
+  EXPECT_EQ(corpus.Add(MakeSample("fn main() {}"), {"a", "b"}), 2);
+  EXPECT_EQ(corpus.Add(MakeSample("fn main() { () }"), {"a"}), 0);
+  EXPECT_EQ(corpus.Add(MakeSample("fn main() { (()) }"), {"b", "c"}), 1);
+  EXPECT_EQ(corpus.size(), 2);
+  EXPECT_EQ(corpus.feature_count(), 3);
+
+  std::optional<Sample> seed = corpus.ChooseSeed(rng);
+  ASSERT_TRUE(seed.has_value());
+  EXPECT_THAT(seed->input_text(),
+              AnyOf("fn main() {}", "fn main() { (()) }"));
+}
+
+TEST(CoverageCorpusTest, FavorsRareFeatures) {
+  CoverageCorpus corpus;
+  corpus.Add(MakeSample("common"), {"common"});
+  corpus.Add(MakeSample("rare"), {"rare"});
+  // Hit the first sample's feature many more times.
+  for (int i = 0; i < 99; ++i) {
+    corpus.Add(MakeSample("other"), {"common"});
+  }
+  std::mt19937_64 rng;
+  int rare_choices = 0;
+  for (int i = 0; i < 100; ++i) {
+    if (corpus.ChooseSeed(rng)->input_text() == "rare") {
+      ++rare_choices;
+    }
+  }
+  EXPECT_GT(rare_choices, 50);
+}
+
+TEST(CoverageCorpusTest, EvictsLowestWeightEntry) {
+  CoverageCorpus corpus(/*max_size=*/2);
+  corpus.Add(MakeSample("common"), {"common"});
+  corpus.Add(MakeSample("other"), {"other"});
+  for (int i = 0; i < 9; ++i) {
+    corpus.Add(MakeSample("common"), {"common"});
+  }
+  corpus.Add(MakeSample("new"), {"new"});
+  EXPECT_EQ(corpus.size(), 2);
+  std::mt19937_64 rng;
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_NE(corpus.ChooseSeed(rng)->input_text(), "common");
+  }
+}
+
+}  // namespace
+}  // namespace xls
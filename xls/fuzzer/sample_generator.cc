@@ -53,6 +53,7 @@
 #include "xls/dslx/type_system/unwrap_meta_type.h"
 #include "xls/dslx/warning_kind.h"
 #include "xls/fuzzer/ast_generator.h"
+#include "xls/fuzzer/dslx_mutator.h"
 #include "xls/fuzzer/sample.h"
 #include "xls/fuzzer/sample.pb.h"
 #include "xls/fuzzer/value_generator.h"
@@ -429,4 +430,49 @@ absl::StatusOr<Sample> GenerateSample(
                                 sample_options_copy, bit_gen, dslx_text);
 }
 
+absl::StatusOr<Sample> MutateSample(const Sample& seed, absl::BitGenRef bit_gen,
+                                    dslx::FileTable& file_table) {
+  constexpr std::string_view top_name = "main";
+  // Most token removals produce text which fails to parse or typecheck, so
+  // allow a generous number of attempts.
+  constexpr int64_t kMaxAttempts = 256;
+  XLS_RET_CHECK(seed.options().input_is_dslx())
+      << "Only DSLX samples can be mutated";
+
+  for (int64_t attempt = 0; attempt < kMaxAttempts; ++attempt) {
+    XLS_ASSIGN_OR_RETURN(std::string dslx_text,
+                         dslx::RemoveDslxToken(seed.input_text(), bit_gen));
+    ImportData import_data(
+        dslx::CreateImportData(/*stdlib_path=*/"",
+                               /*additional_search_paths=*/{},
+                               /*enabled_warnings=*/dslx::kAllWarningsSet,
+                               std::make_unique<dslx::RealFilesystem>()));
+    absl::StatusOr<TypecheckedModule> tm =
+        ParseAndTypecheck(dslx_text, "sample.x", "sample", &import_data);
+    if (!tm.ok()) {
+      VLOG(2) << "Discarding mutation: " << tm.status();
+      continue;
+    }
+    std::optional<ModuleMember*> member =
+        tm->module->FindMemberWithName(top_name);
+    if (!member.has_value()) {
+      continue;
+    }
+    if (seed.options().IsProcSample()) {
+      if (!std::holds_alternative<dslx::Proc*>(**member)) {
+        continue;
+      }
+      return GenerateProcSample(std::get<dslx::Proc*>(**member), *tm,
+                                seed.options(), bit_gen, dslx_text);
+    }
+    if (!std::holds_alternative<dslx::Function*>(**member)) {
+      continue;
+    }
+    return GenerateFunctionSample(std::get<dslx::Function*>(**member), *tm,
+                                  seed.options(), bit_gen, dslx_text);
+  }
+  return absl::NotFoundError(absl::StrFormat(
+      "No valid mutation of the sample found in %d attempts", kMaxAttempts));
+}
+
 }  // namespace xls
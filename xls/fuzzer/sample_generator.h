@@ -29,6 +29,14 @@ absl::StatusOr<Sample> GenerateSample(
     const SampleOptions& sample_options, absl::BitGenRef bit_gen,
     dslx::FileTable& file_table);
 
+// Returns a new Sample derived from the DSLX sample `seed` by removing a
+// random token from its text (see RemoveDslxToken). Mutations are retried
+// until the text typechecks and still has a top-level `main` of the same kind
+// as the seed. The seed's options (including codegen arguments) are reused and
+// new arguments are generated.
+absl::StatusOr<Sample> MutateSample(const Sample& seed, absl::BitGenRef bit_gen,
+                                    dslx::FileTable& file_table);
+
 }  // namespace xls
 
 #endif  // XLS_FUZZER_SAMPLE_GENERATOR_H_
@@ -116,5 +116,21 @@ TEST(SampleGeneratorTest, GenerateBasicProcSample) {
   EXPECT_THAT(sample.input_text(), HasSubstr("proc main"));
 }
 
+TEST(SampleGeneratorTest, MutateSample) {
+  dslx::FileTable file_table;
+  std::mt19937_64 rng;
+  SampleOptions sample_options;
+  sample_options.set_calls_per_sample(3);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Sample seed, GenerateSample(dslx::AstGeneratorOptions{}, sample_options,
+                                  rng, file_table));
+  XLS_ASSERT_OK_AND_ASSIGN(Sample mutant,
+                           MutateSample(seed, rng, file_table));
+  EXPECT_NE(mutant.input_text(), seed.input_text());
+  EXPECT_THAT(mutant.input_text(), HasSubstr("fn main"));
+  EXPECT_EQ(mutant.options(), seed.options());
+  EXPECT_EQ(mutant.args_batch().size(), 3);
+}
+
 }  // namespace
 }  // namespace xls
@@ -39,6 +39,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -64,6 +65,9 @@
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/interp_value.h"
 #include "xls/dslx/interp_value_utils.h"
+#include "xls/dslx/ir_convert/conversion_info.h"
+#include "xls/dslx/ir_convert/convert_options.h"
+#include "xls/dslx/ir_convert/ir_converter.h"
 #include "xls/dslx/parse_and_typecheck.h"
 #include "xls/dslx/type_system/type.h"
 #include "xls/dslx/type_system/type_info.h"
@@ -71,12 +75,19 @@
 #include "xls/fuzzer/cpp_sample_runner.h"
 #include "xls/fuzzer/sample.h"
 #include "xls/fuzzer/sample.pb.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/events.h"
 #include "xls/ir/format_preference.h"
+#include "xls/ir/function.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
 #include "xls/ir/value.h"
+#include "xls/jit/function_jit.h"
+#include "xls/passes/pass_base.h"
 #include "xls/public/runtime_build_actions.h"
 #include "xls/simulation/check_simulator.h"
 #include "xls/tools/eval_utils.h"
+#include "xls/tools/opt.h"
 #include "re2/re2.h"
 
 // These are used to forward, but also see comment below.
@@ -392,6 +403,115 @@ absl::StatusOr<std::filesystem::path> OptimizeIr(
   return opt_ir_path;
 }
 
+// Returns whether the IR converter arguments can be honored by an in-process
+// conversion, i.e., whether they consist of at most a `--top` flag, which is
+// then stored in `top`.
+bool GetInProcessConverterTop(const SampleOptions& options,
+                              std::optional<std::string>* top) {
+  for (const std::string& arg : options.ir_converter_args()) {
+    std::string_view value = arg;
+    if (!absl::ConsumePrefix(&value, "--top=")) {
+      return false;
+    }
+    *top = std::string(value);
+  }
+  return true;
+}
+
+// In-process equivalent of DslxToIrFunction. Converts the DSLX file to a
+// package which is returned; the IR is written to "sample.ir" in `run_dir`.
+absl::StatusOr<std::unique_ptr<Package>> DslxToIrFunctionInProcess(
+    const std::filesystem::path& input_path,
+    const std::optional<std::string>& top,
+    const std::filesystem::path& run_dir) {
+  VLOG(1) << "Converting DSLX to IR in-process";
+  const dslx::ConvertOptions convert_options = {
+      .warnings_as_errors = false,
+  };
+  bool printed_error = false;
+  XLS_ASSIGN_OR_RETURN(
+      dslx::PackageConversionData conversion,
+      dslx::ConvertFilesToPackage({input_path.string()},
+                                  GetDefaultDslxStdlibPath(),
+                                  /*dslx_paths=*/{}, convert_options, top,
+                                  /*package_name=*/std::nullopt,
+                                  &printed_error));
+  if (printed_error) {
+    return absl::InternalError(
+        "IR conversion failed with an earlier non-fatal error.");
+  }
+  std::string ir_text = conversion.DumpIr();
+  VLOG(3) << "Unoptimized IR:\n" << ir_text;
+  XLS_RETURN_IF_ERROR(SetFileContents(run_dir / "sample.ir", ir_text));
+  return std::move(conversion.package);
+}
+
+// In-process equivalent of EvaluateIrFunction. Evaluates the top function of
+// `package` on the arguments in `args_path`; the results are written next to
+// `ir_path` in the same format as eval_ir_main prints them.
+absl::StatusOr<std::vector<dslx::InterpValue>> EvaluateIrFunctionInProcess(
+    Package* package, const std::filesystem::path& ir_path,
+    const std::filesystem::path& args_path, bool use_jit) {
+  VLOG(1) << absl::StrFormat("Evaluating IR in-process (%s): %s",
+                             (use_jit ? "JIT" : "interpreter"), ir_path);
+  XLS_ASSIGN_OR_RETURN(Function * f, package->GetTopAsFunction());
+  std::unique_ptr<FunctionJit> jit;
+  if (use_jit) {
+    XLS_ASSIGN_OR_RETURN(jit, FunctionJit::Create(f));
+  }
+
+  XLS_ASSIGN_OR_RETURN(std::string args_text, GetFileContents(args_path));
+  std::string results_text;
+  for (std::string_view line :
+       absl::StrSplit(args_text, '\n', absl::SkipWhitespace())) {
+    std::vector<Value> args;
+    for (std::string_view arg : absl::StrSplit(line, ';')) {
+      XLS_ASSIGN_OR_RETURN(args.emplace_back(),
+                           xls::Parser::ParseTypedValue(arg));
+    }
+    Value result;
+    if (use_jit) {
+      XLS_ASSIGN_OR_RETURN(result, DropInterpreterEvents(jit->Run(args)));
+    } else {
+      XLS_ASSIGN_OR_RETURN(result,
+                           DropInterpreterEvents(InterpretFunction(f, args)));
+    }
+    absl::StrAppend(&results_text, result.ToString(FormatPreference::kHex),
+                    "\n");
+  }
+  XLS_RETURN_IF_ERROR(SetFileContents(
+      absl::StrCat(ir_path.string(), ".results"), results_text));
+  return ParseValues(results_text);
+}
+
+// In-process equivalent of OptimizeIr. Optimizes `package` in place and writes
+// the result to "sample.opt.ir" in `run_dir`, whose path is returned. The
+// names of the passes which changed the IR are written, one per line, to
+// "passes_fired.txt" for coverage collection (see sample_coverage.h).
+absl::StatusOr<std::filesystem::path> OptimizeIrInProcess(
+    Package* package, const std::filesystem::path& run_dir) {
+  VLOG(1) << "Optimizing IR in-process";
+  PassResults pass_results;
+  XLS_RETURN_IF_ERROR(tools::OptimizeIrForTop(
+      package,
+      tools::OptOptions{.inline_procs = false,
+                        .use_context_narrowing_analysis = false},
+      &pass_results));
+  std::string opt_ir_text = package->DumpIr();
+  VLOG(3) << "Optimized IR:\n" << opt_ir_text;
+  std::filesystem::path opt_ir_path = run_dir / "sample.opt.ir";
+  XLS_RETURN_IF_ERROR(SetFileContents(opt_ir_path, opt_ir_text));
+  std::string passes_fired;
+  for (const PassInvocation& invocation : pass_results.invocations) {
+    if (invocation.ir_changed) {
+      absl::StrAppend(&passes_fired, invocation.pass_name, "\n");
+    }
+  }
+  XLS_RETURN_IF_ERROR(
+      SetFileContents(run_dir / "passes_fired.txt", passes_fired));
+  return opt_ir_path;
+}
+
 // Simulates the Verilog file representing a function and returns the results.
 absl::StatusOr<std::vector<dslx::InterpValue>> SimulateFunction(
     const std::filesystem::path& verilog_path,
@@ -906,6 +1026,10 @@ absl::Status SampleRunner::RunFunction(
 
   absl::flat_hash_map<std::string, std::vector<dslx::InterpValue>> results;
 
+  // In in-process mode the package is kept in memory from conversion through
+  // optimization; it is null whenever the stages run in subprocesses.
+  const bool in_process = mode_ == ExecutionMode::kInProcess;
+  std::unique_ptr<Package> package;
   std::filesystem::path ir_path;
   if (options.input_is_dslx()) {
     if (args_batch.has_value()) {
@@ -924,29 +1048,50 @@ absl::Status SampleRunner::RunFunction(
     }
 
     Stopwatch t;
-    XLS_ASSIGN_OR_RETURN(
-        ir_path, DslxToIrFunction(input_path, options, run_dir_, commands_));
+    std::optional<std::string> top;
+    if (in_process && !commands_.ir_converter_main.has_value() &&
+        GetInProcessConverterTop(options, &top)) {
+      XLS_ASSIGN_OR_RETURN(
+          package, DslxToIrFunctionInProcess(input_path, top, run_dir_));
+      ir_path = run_dir_ / "sample.ir";
+    } else {
+      XLS_ASSIGN_OR_RETURN(
+          ir_path, DslxToIrFunction(input_path, options, run_dir_, commands_));
+    }
     timing_.set_convert_ir_ns(absl::ToInt64Nanoseconds(t.GetElapsedTime()));
   } else {
     ir_path = run_dir_ / "sample.ir";
     XLS_RETURN_IF_ERROR(SetFileContents(ir_path, input_text));
+    if (in_process) {
+      XLS_ASSIGN_OR_RETURN(
+          package, xls::Parser::ParsePackage(input_text, ir_path.string()));
+    }
   }
 
+  // Evaluates the given IR, in-process if its package is available.
+  auto evaluate_ir = [&](const std::filesystem::path& path, bool use_jit)
+      -> absl::StatusOr<std::vector<dslx::InterpValue>> {
+    if (package != nullptr && !commands_.eval_ir_main.has_value()) {
+      return EvaluateIrFunctionInProcess(package.get(), path, *args_path,
+                                         use_jit);
+    }
+    return EvaluateIrFunction(path, *args_path, use_jit, options, run_dir_,
+                              commands_);
+  };
+
   if (args_path.has_value()) {
     Stopwatch t;
 
     // Unconditionally evaluate with the interpreter even if using the JIT. This
     // exercises the interpreter and serves as a reference.
     XLS_ASSIGN_OR_RETURN(results["evaluated unopt IR (interpreter)"],
-                         EvaluateIrFunction(ir_path, *args_path, false, options,
-                                            run_dir_, commands_));
+                         evaluate_ir(ir_path, /*use_jit=*/false));
     timing_.set_unoptimized_interpret_ir_ns(
         absl::ToInt64Nanoseconds(t.GetElapsedTime()));
 
     if (options.use_jit()) {
       XLS_ASSIGN_OR_RETURN(results["evaluated unopt IR (JIT)"],
-                           EvaluateIrFunction(ir_path, *args_path, true,
-                                              options, run_dir_, commands_));
+                           evaluate_ir(ir_path, /*use_jit=*/true));
       timing_.set_unoptimized_jit_ns(
           absl::ToInt64Nanoseconds(t.GetElapsedTime()));
     }
@@ -954,23 +1099,28 @@ absl::Status SampleRunner::RunFunction(
 
   if (options.optimize_ir()) {
     Stopwatch t;
-    XLS_ASSIGN_OR_RETURN(std::filesystem::path opt_ir_path,
-                         OptimizeIr(ir_path, options, run_dir_, commands_));
+    std::filesystem::path opt_ir_path;
+    if (package != nullptr && !commands_.ir_opt_main.has_value()) {
+      XLS_ASSIGN_OR_RETURN(opt_ir_path,
+                           OptimizeIrInProcess(package.get(), run_dir_));
+    } else {
+      XLS_ASSIGN_OR_RETURN(opt_ir_path,
+                           OptimizeIr(ir_path, options, run_dir_, commands_));
+      package.reset();
+    }
     timing_.set_optimize_ns(absl::ToInt64Nanoseconds(t.GetElapsedTime()));
 
     if (args_path.has_value()) {
       if (options.use_jit()) {
         t.Reset();
         XLS_ASSIGN_OR_RETURN(results["evaluated opt IR (JIT)"],
-                             EvaluateIrFunction(opt_ir_path, *args_path, true,
-                                                options, run_dir_, commands_));
+                             evaluate_ir(opt_ir_path, /*use_jit=*/true));
         timing_.set_optimized_jit_ns(
             absl::ToInt64Nanoseconds(t.GetElapsedTime()));
       }
       t.Reset();
       XLS_ASSIGN_OR_RETURN(results["evaluated opt IR (interpreter)"],
-                           EvaluateIrFunction(opt_ir_path, *args_path, false,
-                                              options, run_dir_, commands_));
+                           evaluate_ir(opt_ir_path, /*use_jit=*/false));
       timing_.set_optimized_interpret_ir_ns(
           absl::ToInt64Nanoseconds(t.GetElapsedTime()));
     }
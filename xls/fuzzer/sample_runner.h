@@ -43,6 +43,20 @@ namespace xls {
 // enable easier debugging and replay.
 class SampleRunner {
  public:
+  // How the stages of a function sample are executed.
+  enum class ExecutionMode {
+    // Every stage invokes the corresponding tool binary in a subprocess.
+    kSubprocess,
+    // DSLX conversion, IR evaluation and optimization call the library entry
+    // points directly, keeping the package in memory between stages. The IR
+    // files are still written to the run directory so samples can be replayed.
+    // Codegen and simulation, all stages of proc samples, and any stage whose
+    // command is overridden still run as in kSubprocess mode. A crash in an
+    // in-process stage takes down the calling process; see ForkedSampleWorker
+    // for isolating it.
+    kInProcess,
+  };
+
   struct Commands {
     // Call the particular operation with given arguments and options. Return
     // their output or failure status.
@@ -64,6 +78,8 @@ class SampleRunner {
       : run_dir_(std::move(run_dir)) {}
   SampleRunner(std::filesystem::path run_dir, Commands commands)
       : run_dir_(std::move(run_dir)), commands_(std::move(commands)) {}
+  SampleRunner(std::filesystem::path run_dir, ExecutionMode mode)
+      : run_dir_(std::move(run_dir)), mode_(mode) {}
 
   // Runs the provided sample, writing out files under the SampleRunner's
   // `run_dir` as appropriate.
@@ -92,6 +108,7 @@ class SampleRunner {
 
   const std::filesystem::path run_dir_;
   const Commands commands_;
+  const ExecutionMode mode_ = ExecutionMode::kSubprocess;
   fuzzer::SampleTimingProto timing_;
 };
 
@@ -51,6 +51,9 @@ ABSL_FLAG(std::optional<std::string>, args_file, std::nullopt,
           "simulation.");
 ABSL_FLAG(std::optional<std::string>, ir_channel_names_file, std::nullopt,
           "Optional file containing IR names of input channels for a proc.");
+ABSL_FLAG(bool, in_process, false,
+          "Run DSLX conversion, IR evaluation and optimization in-process "
+          "rather than by invoking the tool binaries.");
 
 namespace xls {
 
@@ -77,8 +80,10 @@ std::filesystem::path MaybeCopyFile(const std::filesystem::path& file_path,
 static absl::Status RealMain(
     const std::filesystem::path& run_dir, const std::string& options_file,
     const std::string& input_file, const std::optional<std::string>& args_file,
-    const std::optional<std::string>& ir_channel_names_file) {
-  SampleRunner runner(run_dir);
+    const std::optional<std::string>& ir_channel_names_file, bool in_process) {
+  SampleRunner runner(run_dir, in_process
+                                   ? SampleRunner::ExecutionMode::kInProcess
+                                   : SampleRunner::ExecutionMode::kSubprocess);
   std::filesystem::path input_filename = MaybeCopyFile(input_file, run_dir);
   std::filesystem::path options_filename = MaybeCopyFile(options_file, run_dir);
   std::optional<std::filesystem::path> args_filename =
@@ -132,6 +137,7 @@ int main(int argc, char** argv) {
       xls::RealMain(run_dir, absl::GetFlag(FLAGS_options_file),
                     absl::GetFlag(FLAGS_input_file),
                     absl::GetFlag(FLAGS_args_file),
-                    absl::GetFlag(FLAGS_ir_channel_names_file)),
+                    absl::GetFlag(FLAGS_ir_channel_names_file),
+                    absl::GetFlag(FLAGS_in_process)),
       /*log_on_error=*/false);
 }
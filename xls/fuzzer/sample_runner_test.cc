@@ -538,6 +538,43 @@ TEST_F(SampleRunnerTest, InterpretOptIR) {
               ElementsAre("bits[8]:0x8e"));
 }
 
+TEST_F(SampleRunnerTest, InterpretOptIRInProcess) {
+  SampleRunner runner(GetTempPath(), SampleRunner::ExecutionMode::kInProcess);
+  constexpr std::string_view dslx_text =
+      "fn main(x: u8, y: u8) -> u8 { x + y }";
+  SampleOptions options;
+  options.set_input_is_dslx(true);
+  options.set_ir_converter_args({"--top=main"});
+  XLS_ASSERT_OK_AND_ASSIGN(ArgsBatch args_batch, ToArgsBatch({
+                                                     {
+                                                         "bits[8]:42",
+                                                         "bits[8]:100",
+                                                     },
+                                                 }));
+  XLS_ASSERT_OK(
+      runner.Run(Sample(std::string(dslx_text), options, args_batch)));
+  XLS_ASSERT_OK_AND_ASSIGN(std::string ir,
+                           GetFileContents(GetTempPath() / "sample.ir"));
+  EXPECT_THAT(ir, HasSubstr("package sample"));
+  XLS_ASSERT_OK_AND_ASSIGN(std::string opt_ir,
+                           GetFileContents(GetTempPath() / "sample.opt.ir"));
+  EXPECT_THAT(opt_ir, HasSubstr("package sample"));
+  for (std::string_view results_file :
+       {"sample.ir.results", "sample.opt.ir.results"}) {
+    XLS_ASSERT_OK_AND_ASSIGN(std::string results,
+                             GetFileContents(GetTempPath() / results_file));
+    EXPECT_THAT(absl::StrSplit(absl::StripAsciiWhitespace(results), "\n",
+                               absl::SkipEmpty()),
+                ElementsAre("bits[8]:0x8e"))
+        << results_file;
+  }
+  // No tool binaries were invoked.
+  EXPECT_FALSE(FileExists(GetTempPath() / "ir_converter_main.stderr").ok());
+  EXPECT_FALSE(FileExists(GetTempPath() / "eval_ir_main.stderr").ok());
+  EXPECT_FALSE(FileExists(GetTempPath() / "opt_main.stderr").ok());
+  EXPECT_GT(runner.timing().optimize_ns(), 0);
+}
+
 TEST_F(SampleRunnerTest, InterpretOptIRMiscompare) {
   SampleRunner runner(
       GetTempPath(),
@@ -0,0 +1,208 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/sample_scheduler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/log/log.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "xls/fuzzer/ast_generator.h"
+#include "xls/fuzzer/sample_summary.pb.h"
+
+namespace xls {
+
+void LatencyHistogram::Add(absl::Duration latency) {
+  int64_t micros = std::max(int64_t{1}, absl::ToInt64Microseconds(latency));
+  int64_t bucket = std::bit_width(static_cast<uint64_t>(micros)) - 1;
+  ++buckets_[std::min(bucket, kBucketCount - 1)];
+  ++count_;
+  max_ = std::max(max_, latency);
+}
+
+absl::Duration LatencyHistogram::Quantile(double quantile) const {
+  if (count_ == 0) {
+    return absl::ZeroDuration();
+  }
+  int64_t rank = static_cast<int64_t>(std::ceil(quantile * count_));
+  int64_t seen = 0;
+  for (int64_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank && seen > 0) {
+      return std::min(max_, absl::Microseconds(int64_t{1} << (i + 1)));
+    }
+  }
+  return max_;
+}
+
+std::string LatencyHistogram::ToString() const {
+  return absl::StrFormat("n=%d p50<=%s p90<=%s max=%s", count_,
+                         absl::FormatDuration(Quantile(0.5)),
+                         absl::FormatDuration(Quantile(0.9)),
+                         absl::FormatDuration(max_));
+}
+
+SampleScheduler::SampleScheduler(
+    const dslx::AstGeneratorOptions& ast_generator_options,
+    int64_t worker_count, std::optional<int64_t> sample_count,
+    std::optional<absl::Duration> duration,
+    std::optional<double> target_samples_per_second, absl::Time start)
+    : ast_generator_options_(ast_generator_options),
+      sample_count_(sample_count),
+      deadline_(duration.has_value() ? std::make_optional(start + *duration)
+                                     : std::nullopt),
+      target_latency_(target_samples_per_second.has_value()
+                          ? std::make_optional(absl::Seconds(
+                                worker_count / *target_samples_per_second))
+                          : std::nullopt) {}
+
+std::optional<int64_t> SampleScheduler::ClaimSample(absl::Time now) {
+  absl::MutexLock lock(&mutex_);
+  if (sample_count_.has_value() && samples_claimed_ >= *sample_count_) {
+    return std::nullopt;
+  }
+  if (deadline_.has_value() && now >= *deadline_) {
+    return std::nullopt;
+  }
+  return samples_claimed_++;
+}
+
+dslx::AstGeneratorOptions SampleScheduler::GetAstGeneratorOptions() const {
+  double scale = this->scale();
+  dslx::AstGeneratorOptions options = ast_generator_options_;
+  options.max_width_bits_types = std::max<int64_t>(
+      1, std::llround(ast_generator_options_.max_width_bits_types * scale));
+  // The generator wants aggregates to be wider than the widest bits type.
+  options.max_width_aggregate_types = std::min(
+      ast_generator_options_.max_width_aggregate_types,
+      std::max<int64_t>(
+          options.max_width_bits_types + 1,
+          std::llround(ast_generator_options_.max_width_aggregate_types *
+                       scale)));
+  return options;
+}
+
+void SampleScheduler::RecordSample(
+    absl::Duration elapsed,
+    const std::optional<fuzzer::SampleTimingProto>& timing) {
+  absl::MutexLock lock(&mutex_);
+  ++samples_completed_;
+  histograms_[kTotal].Add(elapsed);
+  if (timing.has_value()) {
+    auto add = [&](Stage stage, bool has_time, int64_t ns) {
+      if (has_time) {
+        histograms_[stage].Add(absl::Nanoseconds(ns));
+      }
+    };
+    add(kGenerate, timing->has_generate_sample_ns(),
+        timing->generate_sample_ns());
+    add(kInterpretDslx, timing->has_interpret_dslx_ns(),
+        timing->interpret_dslx_ns());
+    add(kConvertIr, timing->has_convert_ir_ns(), timing->convert_ir_ns());
+    add(kEvaluateIr,
+        timing->has_unoptimized_interpret_ir_ns() ||
+            timing->has_unoptimized_jit_ns() ||
+            timing->has_optimized_interpret_ir_ns() ||
+            timing->has_optimized_jit_ns(),
+        timing->unoptimized_interpret_ir_ns() + timing->unoptimized_jit_ns() +
+            timing->optimized_interpret_ir_ns() + timing->optimized_jit_ns());
+    add(kOptimize, timing->has_optimize_ns(), timing->optimize_ns());
+    add(kCodegen, timing->has_codegen_ns(), timing->codegen_ns());
+    add(kSimulate, timing->has_simulate_ns(), timing->simulate_ns());
+  }
+
+  if (!target_latency_.has_value()) {
+    return;
+  }
+  window_latency_ += elapsed;
+  if (++window_samples_ < kAdjustmentInterval) {
+    return;
+  }
+  // Scale the widths in proportion to how far off target the samples were,
+  // ignoring small deviations and limiting each step.
+  absl::Duration mean_latency = window_latency_ / window_samples_;
+  double ratio = absl::FDivDuration(*target_latency_, mean_latency);
+  window_latency_ = absl::ZeroDuration();
+  window_samples_ = 0;
+  if (ratio > 0.8 && ratio < 1.25) {
+    return;
+  }
+  double scale = std::clamp(scale_ * std::clamp(ratio, 0.5, 2.0), kMinScale,
+                            1.0);
+  if (scale != scale_) {
+    VLOG(1) << absl::StreamFormat(
+        "Mean sample latency %s vs. target %s; scaling widths by %.3f",
+        absl::FormatDuration(mean_latency),
+        absl::FormatDuration(*target_latency_), scale);
+    scale_ = scale;
+  }
+}
+
+int64_t SampleScheduler::samples_completed() const {
+  absl::MutexLock lock(&mutex_);
+  return samples_completed_;
+}
+
+double SampleScheduler::scale() const {
+  absl::MutexLock lock(&mutex_);
+  return scale_;
+}
+
+std::string SampleScheduler::StageLatencySummary() const {
+  absl::MutexLock lock(&mutex_);
+  std::string summary;
+  for (int64_t stage = 0; stage < kStageCount; ++stage) {
+    if (histograms_[stage].count() == 0) {
+      continue;
+    }
+    absl::StrAppendFormat(&summary, "  %-14s %s\n",
+                          StageName(static_cast<Stage>(stage)),
+                          histograms_[stage].ToString());
+  }
+  return summary;
+}
+
+/* static */ std::string_view SampleScheduler::StageName(Stage stage) {
+  switch (stage) {
+    case kGenerate:
+      return "generate";
+    case kInterpretDslx:
+      return "interpret DSLX";
+    case kConvertIr:
+      return "convert IR";
+    case kEvaluateIr:
+      return "evaluate IR";
+    case kOptimize:
+      return "optimize";
+    case kCodegen:
+      return "codegen";
+    case kSimulate:
+      return "simulate";
+    case kTotal:
+      return "total";
+    case kStageCount:
+      break;
+  }
+  return "unknown";
+}
+
+}  // namespace xls
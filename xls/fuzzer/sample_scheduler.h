@@ -0,0 +1,136 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_FUZZER_SAMPLE_SCHEDULER_H_
+#define XLS_FUZZER_SAMPLE_SCHEDULER_H_
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/fuzzer/ast_generator.h"
+#include "xls/fuzzer/sample_summary.pb.h"
+
+namespace xls {
+
+// Histogram of latencies with power-of-two buckets, from 1us up.
+class LatencyHistogram {
+ public:
+  static constexpr int64_t kBucketCount = 40;
+
+  void Add(absl::Duration latency);
+
+  int64_t count() const { return count_; }
+  absl::Duration max() const { return max_; }
+
+  // Returns an upper bound on the given quantile (in [0, 1]) of the recorded
+  // latencies, i.e., the upper edge of the bucket holding it.
+  absl::Duration Quantile(double quantile) const;
+
+  // E.g., "n=12 p50<=4.096ms p90<=65.536ms max=41.2ms".
+  std::string ToString() const;
+
+ private:
+  std::array<int64_t, kBucketCount> buckets_ = {};
+  int64_t count_ = 0;
+  absl::Duration max_ = absl::ZeroDuration();
+};
+
+// Hands out the samples of a fuzzing run to worker threads and adapts the size
+// of the generated samples to the observed throughput. Thread-safe.
+//
+// Samples are claimed one at a time from a shared budget rather than being
+// split between the workers up front, so workers which draw fast samples take
+// over the remaining work of those stuck on slow ones instead of going idle at
+// the end of the run.
+//
+// If a target rate is given, the maximum widths in the AST generator options
+// are scaled (never above the configured widths) so that the samples take
+// about as long as the target allows: each of the `worker_count` workers has
+// `worker_count / target_samples_per_second` per sample.
+class SampleScheduler {
+ public:
+  // Number of samples between adjustments of the sample size.
+  static constexpr int64_t kAdjustmentInterval = 8;
+  // Lower bound on the factor by which the widths are scaled.
+  static constexpr double kMinScale = 1.0 / 64;
+
+  SampleScheduler(const dslx::AstGeneratorOptions& ast_generator_options,
+                  int64_t worker_count, std::optional<int64_t> sample_count,
+                  std::optional<absl::Duration> duration,
+                  std::optional<double> target_samples_per_second,
+                  absl::Time start = absl::Now());
+
+  // Claims the next sample, returning its index in the run, or std::nullopt
+  // if the run is over (the sample budget is exhausted or its duration has
+  // elapsed).
+  std::optional<int64_t> ClaimSample(absl::Time now = absl::Now());
+
+  // Returns the generator options to use for the next sample.
+  dslx::AstGeneratorOptions GetAstGeneratorOptions() const;
+
+  // Records a finished sample which took `elapsed` overall; `timing` holds the
+  // per-stage times if the sample got far enough to report them.
+  void RecordSample(absl::Duration elapsed,
+                    const std::optional<fuzzer::SampleTimingProto>& timing);
+
+  // Returns the number of recorded samples.
+  int64_t samples_completed() const;
+
+  // Returns the current factor by which the generator widths are scaled.
+  double scale() const;
+
+  // Returns a multi-line summary of the per-stage latency histograms.
+  std::string StageLatencySummary() const;
+
+ private:
+  enum Stage {
+    kGenerate,
+    kInterpretDslx,
+    kConvertIr,
+    kEvaluateIr,
+    kOptimize,
+    kCodegen,
+    kSimulate,
+    kTotal,
+    kStageCount,
+  };
+  static std::string_view StageName(Stage stage);
+
+  const dslx::AstGeneratorOptions ast_generator_options_;
+  const std::optional<int64_t> sample_count_;
+  const std::optional<absl::Time> deadline_;
+  // Per-sample latency aimed for, if adapting sample sizes.
+  const std::optional<absl::Duration> target_latency_;
+
+  mutable absl::Mutex mutex_;
+  int64_t samples_claimed_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t samples_completed_ ABSL_GUARDED_BY(mutex_) = 0;
+  double scale_ ABSL_GUARDED_BY(mutex_) = 1.0;
+  // Total latency of the samples recorded since the last adjustment.
+  absl::Duration window_latency_ ABSL_GUARDED_BY(mutex_);
+  int64_t window_samples_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::array<LatencyHistogram, kStageCount> histograms_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace xls
+
+#endif  // XLS_FUZZER_SAMPLE_SCHEDULER_H_
@@ -0,0 +1,122 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/sample_scheduler.h"
+
+#include <cstdint>
+#include <optional>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "xls/fuzzer/ast_generator.h"
+#include "xls/fuzzer/sample_summary.pb.h"
+
+namespace xls {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+using ::testing::Optional;
+
+TEST(LatencyHistogramTest, Quantiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Quantile(0.5), absl::ZeroDuration());
+  for (int64_t i = 0; i < 9; ++i) {
+    histogram.Add(absl::Microseconds(100));
+  }
+  histogram.Add(absl::Seconds(3));
+  EXPECT_EQ(histogram.count(), 10);
+  EXPECT_EQ(histogram.max(), absl::Seconds(3));
+  // 100us falls in the bucket [64us, 128us).
+  EXPECT_EQ(histogram.Quantile(0.5), absl::Microseconds(128));
+  EXPECT_EQ(histogram.Quantile(0.9), absl::Microseconds(128));
+  EXPECT_EQ(histogram.Quantile(1.0), absl::Seconds(3));
+  EXPECT_THAT(histogram.ToString(), HasSubstr("n=10"));
+}
+
+TEST(SampleSchedulerTest, SharedSampleBudget) {
+  SampleScheduler scheduler(dslx::AstGeneratorOptions{}, /*worker_count=*/4,
+                            /*sample_count=*/3, /*duration=*/std::nullopt,
+                            /*target_samples_per_second=*/std::nullopt);
+  EXPECT_THAT(scheduler.ClaimSample(), Optional(0));
+  EXPECT_THAT(scheduler.ClaimSample(), Optional(1));
+  EXPECT_THAT(scheduler.ClaimSample(), Optional(2));
+  EXPECT_EQ(scheduler.ClaimSample(), std::nullopt);
+}
+
+TEST(SampleSchedulerTest, Deadline) {
+  absl::Time start = absl::UnixEpoch();
+  SampleScheduler scheduler(dslx::AstGeneratorOptions{}, /*worker_count=*/1,
+                            /*sample_count=*/std::nullopt,
+                            /*duration=*/absl::Minutes(1),
+                            /*target_samples_per_second=*/std::nullopt, start);
+  EXPECT_TRUE(scheduler.ClaimSample(start + absl::Seconds(59)).has_value());
+  EXPECT_FALSE(scheduler.ClaimSample(start + absl::Seconds(60)).has_value());
+}
+
+TEST(SampleSchedulerTest, AdaptsWidthsToTargetRate) {
+  dslx::AstGeneratorOptions options;
+  options.max_width_bits_types = 64;
+  options.max_width_aggregate_types = 1024;
+  // Two workers at one sample per second overall: two seconds per sample.
+  SampleScheduler scheduler(options, /*worker_count=*/2,
+                            /*sample_count=*/std::nullopt,
+                            /*duration=*/std::nullopt,
+                            /*target_samples_per_second=*/1.0);
+  EXPECT_EQ(scheduler.GetAstGeneratorOptions().max_width_bits_types, 64);
+
+  // Samples taking four seconds halve the widths.
+  for (int64_t i = 0; i < SampleScheduler::kAdjustmentInterval; ++i) {
+    scheduler.RecordSample(absl::Seconds(4), std::nullopt);
+  }
+  EXPECT_DOUBLE_EQ(scheduler.scale(), 0.5);
+  EXPECT_EQ(scheduler.GetAstGeneratorOptions().max_width_bits_types, 32);
+  EXPECT_EQ(scheduler.GetAstGeneratorOptions().max_width_aggregate_types,
+            512);
+
+  // Samples close to the target leave them alone.
+  for (int64_t i = 0; i < SampleScheduler::kAdjustmentInterval; ++i) {
+    scheduler.RecordSample(absl::Milliseconds(2100), std::nullopt);
+  }
+  EXPECT_DOUBLE_EQ(scheduler.scale(), 0.5);
+
+  // Fast samples grow them again, but never beyond the configured widths.
+  for (int64_t i = 0; i < 3 * SampleScheduler::kAdjustmentInterval; ++i) {
+    scheduler.RecordSample(absl::Milliseconds(100), std::nullopt);
+  }
+  EXPECT_DOUBLE_EQ(scheduler.scale(), 1.0);
+  EXPECT_EQ(scheduler.GetAstGeneratorOptions().max_width_bits_types, 64);
+  EXPECT_EQ(scheduler.samples_completed(),
+            5 * SampleScheduler::kAdjustmentInterval);
+}
+
+TEST(SampleSchedulerTest, StageLatencySummary) {
+  SampleScheduler scheduler(dslx::AstGeneratorOptions{}, /*worker_count=*/1,
+                            /*sample_count=*/std::nullopt,
+                            /*duration=*/std::nullopt,
+                            /*target_samples_per_second=*/std::nullopt);
+  fuzzer::SampleTimingProto timing;
+  timing.set_total_ns(absl::ToInt64Nanoseconds(absl::Seconds(1)));
+  timing.set_optimize_ns(absl::ToInt64Nanoseconds(absl::Milliseconds(200)));
+  scheduler.RecordSample(absl::Seconds(1), timing);
+  // A failed sample only contributes its total latency.
+  scheduler.RecordSample(absl::Seconds(2), std::nullopt);
+  EXPECT_THAT(scheduler.StageLatencySummary(), HasSubstr("optimize"));
+  EXPECT_THAT(scheduler.StageLatencySummary(), HasSubstr("total          n=2"));
+  EXPECT_THAT(scheduler.StageLatencySummary(), Not(HasSubstr("codegen")));
+}
+
+}  // namespace
+}  // namespace xls
@@ -30,6 +30,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/package.h"
@@ -122,6 +123,38 @@ std::optional<Value> ChannelQueue::ReadInternal() {
   return std::move(value);
 }
 
+absl::Status ChannelQueue::SetContents(absl::Span<const Value> values) {
+  XLS_RETURN_IF_ERROR(CheckContents(values));
+  absl::MutexLock lock(&mutex_);
+  SetContentsInternal(values);
+  return absl::OkStatus();
+}
+
+absl::Status ChannelQueue::CheckContents(
+    absl::Span<const Value> values) const {
+  if (channel()->kind() == ChannelKind::kSingleValue && values.size() > 1) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Single-value channel `%s` can hold at most one value, got %d",
+        channel()->name(), values.size()));
+  }
+  for (const Value& value : values) {
+    if (!ValueConformsToType(value, channel()->type())) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Channel `%s` expects values to have type %s, got: %s",
+          channel()->name(), channel()->type()->ToString(), value.ToString()));
+    }
+  }
+  return absl::OkStatus();
+}
+
+std::vector<Value> ChannelQueue::GetContentsInternal() const {
+  return std::vector<Value>(queue_.begin(), queue_.end());
+}
+
+void ChannelQueue::SetContentsInternal(absl::Span<const Value> values) {
+  queue_.assign(values.begin(), values.end());
+}
+
 /* static */ absl::StatusOr<std::unique_ptr<ChannelQueueManager>>
 ChannelQueueManager::Create(Package* package) {
   XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
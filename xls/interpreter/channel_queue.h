@@ -101,6 +101,22 @@ class ChannelQueue {
     callbacks_.push_back(std::move(callback));
   }
 
+  // Returns the values currently held in the queue in read order. The queue is
+  // not modified and no callbacks are invoked. Values which an attached
+  // generator has not yet produced are not included.
+  std::vector<Value> GetContents() const {
+    absl::MutexLock lock(&mutex_);
+    return GetContentsInternal();
+  }
+
+  // Replaces the contents of the queue with `values` (given in read order)
+  // without invoking callbacks. Used to restore a previously captured queue
+  // state.
+  absl::Status SetContents(absl::Span<const Value> values);
+
+  // Returns an error if `SetContents` would reject `values`.
+  absl::Status CheckContents(absl::Span<const Value> values) const;
+
  protected:
   void CallReadCallbacks(const Value& value) const {
     for (const std::unique_ptr<ChannelQueueCallback>& callback : callbacks_) {
@@ -120,6 +136,10 @@ class ChannelQueue {
       ABSL_SHARED_LOCKS_REQUIRED(mutex_);
   virtual std::optional<Value> ReadInternal()
       ABSL_SHARED_LOCKS_REQUIRED(mutex_);
+  virtual std::vector<Value> GetContentsInternal() const
+      ABSL_SHARED_LOCKS_REQUIRED(mutex_);
+  virtual void SetContentsInternal(absl::Span<const Value> values)
+      ABSL_SHARED_LOCKS_REQUIRED(mutex_);
   ChannelInstance* channel_instance_;
 
   std::deque<Value> queue_ ABSL_GUARDED_BY(mutex_);
@@ -468,6 +468,54 @@ TEST_P(IrEvaluatorTestBase, InterpretEq) {
               IsOkAndHolds(Value(UBits(1, 1))));
 }
 
+TEST_P(IrEvaluatorTestBase, InterpretArrayEqAndNe) {
+  // Covers arrays the JIT compares with a single vector operation (narrow bits
+  // elements, including sub-byte and non-power-of-two counts) as well as arrays
+  // whose elements are too wide to vectorize.
+  struct TestCase {
+    std::string_view type;
+    std::string_view a;
+    std::string_view b;
+    bool equal;
+  };
+  const TestCase kTestCases[] = {
+      {"bits[16][5]",
+       "[bits[16]:1, bits[16]:2, bits[16]:3, bits[16]:4, bits[16]:5]",
+       "[bits[16]:1, bits[16]:2, bits[16]:3, bits[16]:4, bits[16]:5]", true},
+      {"bits[16][5]",
+       "[bits[16]:1, bits[16]:2, bits[16]:3, bits[16]:4, bits[16]:5]",
+       "[bits[16]:1, bits[16]:2, bits[16]:3, bits[16]:4, bits[16]:6]", false},
+      {"bits[4][3]", "[bits[4]:0xf, bits[4]:0, bits[4]:7]",
+       "[bits[4]:0xf, bits[4]:0, bits[4]:7]", true},
+      {"bits[4][3]", "[bits[4]:0xf, bits[4]:0, bits[4]:7]",
+       "[bits[4]:0xf, bits[4]:8, bits[4]:7]", false},
+      {"bits[128][2]", "[bits[128]:1, bits[128]:0x10000000000000000]",
+       "[bits[128]:1, bits[128]:0x10000000000000000]", true},
+      {"bits[128][2]", "[bits[128]:1, bits[128]:0x10000000000000000]",
+       "[bits[128]:1, bits[128]:0]", false},
+  };
+  for (const TestCase& test_case : kTestCases) {
+    Package package("my_package");
+    XLS_ASSERT_OK_AND_ASSIGN(
+        Function * function,
+        ParseAndGetFunction(
+            &package,
+            absl::Substitute(R"(
+  fn compare(a: $0, b: $0) -> (bits[1], bits[1]) {
+    eq.1: bits[1] = eq(a, b)
+    ne.2: bits[1] = ne(a, b)
+    ret tuple.3: (bits[1], bits[1]) = tuple(eq.1, ne.2)
+  }
+  )",
+                             test_case.type)));
+    ArgMap args = {{"a", AsValue(test_case.a)}, {"b", AsValue(test_case.b)}};
+    EXPECT_THAT(RunWithKwargsNoEvents(function, args),
+                IsOkAndHolds(Value::Tuple({Value(UBits(test_case.equal, 1)),
+                                           Value(UBits(!test_case.equal, 1))})))
+        << test_case.type << " " << test_case.a << " vs " << test_case.b;
+  }
+}
+
 TEST_P(IrEvaluatorTestBase, InterpretULt) {
   Package package("my_package");
   XLS_ASSERT_OK_AND_ASSIGN(Function * function,
@@ -84,7 +84,8 @@ class ProcContinuation {
   // could cause crashes.
   virtual bool SupportsObservers() const { return true; }
 
- protected:
+  // Returns an error if `v` is not a valid state for the proc, i.e. if it
+  // would be rejected by `SetState`.
   absl::Status CheckConformsToStateType(const std::vector<Value>& v) const;
 
  private:
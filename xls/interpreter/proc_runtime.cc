@@ -15,6 +15,7 @@
 #include "xls/interpreter/proc_runtime.h"
 
 #include <cstdint>
+#include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
 #include <string>
@@ -31,11 +32,16 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/mapped_file.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/evaluator_options.h"
 #include "xls/interpreter/observer.h"
 #include "xls/interpreter/proc_evaluator.h"
+#include "xls/interpreter/proc_runtime_snapshot.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/channel_ops.h"
 #include "xls/ir/events.h"
@@ -238,6 +244,81 @@ void ProcRuntime::ResetState() {
   }
 }
 
+absl::StatusOr<ProcRuntimeSnapshot> ProcRuntime::GetSnapshot() const {
+  ProcRuntimeSnapshot snapshot;
+  for (ProcInstance* instance : elaboration().proc_instances()) {
+    const ProcContinuation& continuation = *continuations_.at(instance);
+    if (!continuation.AtStartOfTick()) {
+      return absl::FailedPreconditionError(absl::StrFormat(
+          "Cannot snapshot proc network: proc instance `%s` is part way "
+          "through a tick",
+          instance->GetName()));
+    }
+    snapshot.proc_states.push_back(continuation.GetState());
+  }
+  for (ChannelInstance* instance : elaboration().channel_instances()) {
+    snapshot.channel_contents.push_back(
+        queue_manager_->GetQueue(instance).GetContents());
+  }
+  return snapshot;
+}
+
+absl::Status ProcRuntime::RestoreSnapshot(const ProcRuntimeSnapshot& snapshot) {
+  absl::Span<ProcInstance* const> proc_instances =
+      elaboration().proc_instances();
+  absl::Span<ChannelInstance* const> channel_instances =
+      elaboration().channel_instances();
+  XLS_RET_CHECK_EQ(snapshot.proc_states.size(), proc_instances.size());
+  XLS_RET_CHECK_EQ(snapshot.channel_contents.size(), channel_instances.size());
+  // Check the whole snapshot before modifying anything so a rejected snapshot
+  // leaves the runtime as it was.
+  for (int64_t i = 0; i < proc_instances.size(); ++i) {
+    XLS_RETURN_IF_ERROR(continuations_.at(proc_instances[i])
+                            ->CheckConformsToStateType(snapshot.proc_states[i]));
+  }
+  for (int64_t i = 0; i < channel_instances.size(); ++i) {
+    XLS_RETURN_IF_ERROR(queue_manager_->GetQueue(channel_instances[i])
+                            .CheckContents(snapshot.channel_contents[i]));
+  }
+  ResetState();
+  for (int64_t i = 0; i < proc_instances.size(); ++i) {
+    XLS_RETURN_IF_ERROR(
+        continuations_.at(proc_instances[i])
+            ->SetState(snapshot.proc_states[i]));
+  }
+  for (int64_t i = 0; i < channel_instances.size(); ++i) {
+    XLS_RETURN_IF_ERROR(queue_manager_->GetQueue(channel_instances[i])
+                            .SetContents(snapshot.channel_contents[i]));
+  }
+  ClearInterpreterEvents();
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> ProcRuntime::SaveSnapshot() const {
+  XLS_ASSIGN_OR_RETURN(ProcRuntimeSnapshot snapshot, GetSnapshot());
+  return EncodeProcRuntimeSnapshot(snapshot, elaboration());
+}
+
+absl::Status ProcRuntime::RestoreSnapshot(
+    absl::Span<const uint8_t> encoded_snapshot) {
+  XLS_ASSIGN_OR_RETURN(
+      ProcRuntimeSnapshot snapshot,
+      DecodeProcRuntimeSnapshot(encoded_snapshot, elaboration()));
+  return RestoreSnapshot(snapshot);
+}
+
+absl::Status ProcRuntime::SaveSnapshotToFile(
+    const std::filesystem::path& path) const {
+  XLS_ASSIGN_OR_RETURN(std::string encoded, SaveSnapshot());
+  return SetFileContents(path, encoded);
+}
+
+absl::Status ProcRuntime::RestoreSnapshotFromFile(
+    const std::filesystem::path& path) {
+  XLS_ASSIGN_OR_RETURN(MappedFile file, MappedFile::Open(path));
+  return RestoreSnapshot(file.data());
+}
+
 absl::StatusOr<JitChannelQueueManager*>
 ProcRuntime::GetJitChannelQueueManager() {
   auto* jit_qm = dynamic_cast<JitChannelQueueManager*>(queue_manager_.get());
@@ -16,8 +16,10 @@
 #define XLS_INTERPRETER_PROC_RUNTIME_H_
 
 #include <cstdint>
+#include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -26,10 +28,12 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/evaluator_options.h"
 #include "xls/interpreter/observer.h"
 #include "xls/interpreter/proc_evaluator.h"
+#include "xls/interpreter/proc_runtime_snapshot.h"
 #include "xls/ir/events.h"
 #include "xls/ir/package.h"
 #include "xls/ir/proc_elaboration.h"
@@ -109,6 +113,26 @@ class ProcRuntime {
   // Reset the state of all of the procs to their initial state.
   void ResetState();
 
+  // Captures the state elements of every proc and the contents of every
+  // channel queue. Returns an error if any proc is blocked part way through a
+  // tick since the partially executed tick cannot be represented.
+  absl::StatusOr<ProcRuntimeSnapshot> GetSnapshot() const;
+
+  // Restores the network to the state captured in `snapshot`. Every proc is
+  // positioned at the start of a tick and channel queue contents are replaced.
+  // Events are cleared. If the snapshot is rejected the runtime is unchanged.
+  absl::Status RestoreSnapshot(const ProcRuntimeSnapshot& snapshot);
+
+  // As above but using the binary encoding produced by
+  // `EncodeProcRuntimeSnapshot`.
+  absl::StatusOr<std::string> SaveSnapshot() const;
+  absl::Status RestoreSnapshot(absl::Span<const uint8_t> encoded_snapshot);
+
+  // Saves/restores an encoded snapshot to/from a file. The file is
+  // memory-mapped on restore.
+  absl::Status SaveSnapshotToFile(const std::filesystem::path& path) const;
+  absl::Status RestoreSnapshotFromFile(const std::filesystem::path& path);
+
   // Returns the events for each proc in the network.
   const InterpreterEvents& GetInterpreterEvents(ProcInstance* instance) const {
     return continuations_.at(instance)->GetEvents();
@@ -0,0 +1,360 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/proc_runtime_snapshot.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/proc_elaboration.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+#include "xls/ir/value_utils.h"
+
+namespace xls {
+namespace {
+
+constexpr std::string_view kMagic("XLSSNAP\0", 8);
+constexpr uint32_t kVersion = 1;
+constexpr int64_t kAlignment = 8;
+
+// Upper bound on the number of zero-sized values (tokens, empty tuples,
+// zero-width bits) in a single value block. Such values occupy no bytes in the
+// encoding so their count cannot be bounded by the size of the data.
+constexpr uint64_t kMaxZeroSizeValueCount = uint64_t{1} << 24;
+
+// Returns the number of bytes used to encode a value of the given type.
+int64_t EncodedByteSize(const Type* type) {
+  switch (type->kind()) {
+    case TypeKind::kBits:
+      return CeilOfRatio(type->GetFlatBitCount(), int64_t{8});
+    case TypeKind::kTuple: {
+      int64_t total = 0;
+      for (const Type* element_type : type->AsTupleOrDie()->element_types()) {
+        total += EncodedByteSize(element_type);
+      }
+      return total;
+    }
+    case TypeKind::kArray:
+      return type->AsArrayOrDie()->size() *
+             EncodedByteSize(type->AsArrayOrDie()->element_type());
+    case TypeKind::kToken:
+      return 0;
+  }
+  LOG(FATAL) << "Invalid type kind: " << type->kind();
+}
+
+class SnapshotWriter {
+ public:
+  void WriteUint64(uint64_t value) {
+    for (int64_t i = 0; i < 8; ++i) {
+      buffer_.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+  }
+
+  void WriteString(std::string_view s) {
+    WriteUint64(s.size());
+    buffer_.append(s);
+    Align();
+  }
+
+  // Writes a block of values which all have type `type`.
+  void WriteValues(absl::Span<const Value> values, const Type* type) {
+    WriteUint64(values.size());
+    WriteUint64(EncodedByteSize(type));
+    for (const Value& value : values) {
+      WriteValue(value);
+    }
+    Align();
+  }
+
+  std::string Finish() && { return std::move(buffer_); }
+
+ private:
+  void WriteValue(const Value& value) {
+    if (value.IsBits()) {
+      std::vector<uint8_t> bytes = value.bits().ToBytes();
+      buffer_.append(reinterpret_cast<const char*>(bytes.data()),
+                     bytes.size());
+      return;
+    }
+    if (value.IsTuple() || value.IsArray()) {
+      for (const Value& element : value.elements()) {
+        WriteValue(element);
+      }
+    }
+  }
+
+  void Align() {
+    buffer_.resize(RoundUpToNearest(static_cast<int64_t>(buffer_.size()),
+                                    kAlignment),
+                   '\0');
+  }
+
+  std::string buffer_;
+};
+
+class SnapshotReader {
+ public:
+  explicit SnapshotReader(absl::Span<const uint8_t> data) : data_(data) {}
+
+  absl::StatusOr<uint64_t> ReadUint64() {
+    XLS_ASSIGN_OR_RETURN(absl::Span<const uint8_t> bytes, ReadBytes(8));
+    uint64_t value = 0;
+    for (int64_t i = 0; i < 8; ++i) {
+      value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+  }
+
+  absl::StatusOr<std::string_view> ReadString() {
+    XLS_ASSIGN_OR_RETURN(uint64_t size, ReadUint64());
+    XLS_ASSIGN_OR_RETURN(absl::Span<const uint8_t> bytes, ReadBytes(size));
+    XLS_RETURN_IF_ERROR(Align());
+    return std::string_view(reinterpret_cast<const char*>(bytes.data()),
+                            bytes.size());
+  }
+
+  // Reads a block of values which all have type `type`. Returns an error if
+  // the block holds more than `max_count` values.
+  absl::StatusOr<std::vector<Value>> ReadValues(const Type* type,
+                                                uint64_t max_count) {
+    XLS_ASSIGN_OR_RETURN(uint64_t count, ReadUint64());
+    XLS_ASSIGN_OR_RETURN(uint64_t value_size, ReadUint64());
+    if (value_size != EncodedByteSize(type)) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Snapshot value size %d does not match size %d of type %s",
+          value_size, EncodedByteSize(type), type->ToString()));
+    }
+    if (count > max_count) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Snapshot value block has %d values, at most %d allowed", count,
+          max_count));
+    }
+    if (value_size == 0 && count > kMaxZeroSizeValueCount) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Snapshot value block has %d zero-sized values, at most %d allowed",
+          count, kMaxZeroSizeValueCount));
+    }
+    if (value_size != 0 && count > (data_.size() - offset_) / value_size) {
+      return absl::InvalidArgumentError("Snapshot is truncated");
+    }
+    std::vector<Value> values;
+    values.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+      XLS_ASSIGN_OR_RETURN(Value value, ReadValue(type));
+      values.push_back(std::move(value));
+    }
+    XLS_RETURN_IF_ERROR(Align());
+    return values;
+  }
+
+  bool AtEnd() const { return offset_ == data_.size(); }
+
+ private:
+  absl::StatusOr<absl::Span<const uint8_t>> ReadBytes(uint64_t size) {
+    if (size > data_.size() - offset_) {
+      return absl::InvalidArgumentError("Snapshot is truncated");
+    }
+    absl::Span<const uint8_t> bytes = data_.subspan(offset_, size);
+    offset_ += size;
+    return bytes;
+  }
+
+  absl::StatusOr<Value> ReadValue(const Type* type) {
+    switch (type->kind()) {
+      case TypeKind::kBits: {
+        int64_t bit_count = type->GetFlatBitCount();
+        XLS_ASSIGN_OR_RETURN(absl::Span<const uint8_t> bytes,
+                             ReadBytes(CeilOfRatio(bit_count, int64_t{8})));
+        return Value(Bits::FromBytes(bytes, bit_count));
+      }
+      case TypeKind::kTuple: {
+        std::vector<Value> elements;
+        for (const Type* element_type :
+             type->AsTupleOrDie()->element_types()) {
+          XLS_ASSIGN_OR_RETURN(Value element, ReadValue(element_type));
+          elements.push_back(std::move(element));
+        }
+        return Value::Tuple(elements);
+      }
+      case TypeKind::kArray: {
+        const ArrayType* array_type = type->AsArrayOrDie();
+        std::vector<Value> elements;
+        elements.reserve(array_type->size());
+        for (int64_t i = 0; i < array_type->size(); ++i) {
+          XLS_ASSIGN_OR_RETURN(Value element,
+                               ReadValue(array_type->element_type()));
+          elements.push_back(std::move(element));
+        }
+        return Value::Array(elements);
+      }
+      case TypeKind::kToken:
+        return Value::Token();
+    }
+    return absl::InternalError(
+        absl::StrCat("Invalid type kind: ", TypeKindToString(type->kind())));
+  }
+
+  absl::Status Align() {
+    int64_t aligned = RoundUpToNearest(static_cast<int64_t>(offset_),
+                                       kAlignment);
+    return ReadBytes(aligned - offset_).status();
+  }
+
+  absl::Span<const uint8_t> data_;
+  uint64_t offset_ = 0;
+};
+
+absl::Status CheckRecordName(std::string_view kind, std::string_view actual,
+                             std::string_view expected) {
+  if (actual != expected) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Snapshot %s `%s` does not match `%s` in the network",
+                        kind, actual, expected));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<std::string> EncodeProcRuntimeSnapshot(
+    const ProcRuntimeSnapshot& snapshot, const ProcElaboration& elaboration) {
+  absl::Span<ProcInstance* const> proc_instances =
+      elaboration.proc_instances();
+  absl::Span<ChannelInstance* const> channel_instances =
+      elaboration.channel_instances();
+  XLS_RET_CHECK_EQ(snapshot.proc_states.size(), proc_instances.size());
+  XLS_RET_CHECK_EQ(snapshot.channel_contents.size(), channel_instances.size());
+
+  SnapshotWriter writer;
+  writer.WriteUint64(0);  // Placeholder for the magic.
+  writer.WriteUint64(kVersion);
+  writer.WriteUint64(proc_instances.size());
+  writer.WriteUint64(channel_instances.size());
+  for (int64_t i = 0; i < proc_instances.size(); ++i) {
+    Proc* proc = proc_instances[i]->proc();
+    const std::vector<Value>& state = snapshot.proc_states[i];
+    XLS_RET_CHECK_EQ(state.size(), proc->GetStateElementCount());
+    writer.WriteString(proc_instances[i]->GetName());
+    writer.WriteUint64(state.size());
+    for (int64_t j = 0; j < state.size(); ++j) {
+      Type* type = proc->GetStateElementType(j);
+      XLS_RET_CHECK(ValueConformsToType(state[j], type))
+          << absl::StreamFormat("State element %d of proc `%s` has value %s "
+                                "which does not match type %s",
+                                j, proc->name(), state[j].ToString(),
+                                type->ToString());
+      writer.WriteValues(absl::MakeConstSpan(&state[j], 1), type);
+    }
+  }
+  for (int64_t i = 0; i < channel_instances.size(); ++i) {
+    Type* type = channel_instances[i]->channel->type();
+    for (const Value& value : snapshot.channel_contents[i]) {
+      XLS_RET_CHECK(ValueConformsToType(value, type));
+    }
+    writer.WriteString(channel_instances[i]->ToString());
+    writer.WriteValues(snapshot.channel_contents[i], type);
+  }
+
+  std::string encoded = std::move(writer).Finish();
+  encoded.replace(0, kMagic.size(), kMagic);
+  return encoded;
+}
+
+absl::StatusOr<ProcRuntimeSnapshot> DecodeProcRuntimeSnapshot(
+    absl::Span<const uint8_t> data, const ProcElaboration& elaboration) {
+  if (data.size() < kMagic.size() ||
+      std::memcmp(data.data(), kMagic.data(), kMagic.size()) != 0) {
+    return absl::InvalidArgumentError("Data is not a proc runtime snapshot");
+  }
+  SnapshotReader reader(data.subspan(kMagic.size()));
+  XLS_ASSIGN_OR_RETURN(uint64_t version, reader.ReadUint64());
+  if (version != kVersion) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Unsupported snapshot version %d (expected %d)", version, kVersion));
+  }
+  absl::Span<ProcInstance* const> proc_instances =
+      elaboration.proc_instances();
+  absl::Span<ChannelInstance* const> channel_instances =
+      elaboration.channel_instances();
+  XLS_ASSIGN_OR_RETURN(uint64_t proc_count, reader.ReadUint64());
+  XLS_ASSIGN_OR_RETURN(uint64_t channel_count, reader.ReadUint64());
+  if (proc_count != proc_instances.size() ||
+      channel_count != channel_instances.size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Snapshot has %d proc instances and %d channel instances, the "
+        "network has %d and %d",
+        proc_count, channel_count, proc_instances.size(),
+        channel_instances.size()));
+  }
+
+  ProcRuntimeSnapshot snapshot;
+  snapshot.proc_states.reserve(proc_count);
+  for (ProcInstance* instance : proc_instances) {
+    Proc* proc = instance->proc();
+    XLS_ASSIGN_OR_RETURN(std::string_view name, reader.ReadString());
+    XLS_RETURN_IF_ERROR(CheckRecordName("proc", name, instance->GetName()));
+    XLS_ASSIGN_OR_RETURN(uint64_t element_count, reader.ReadUint64());
+    if (element_count != proc->GetStateElementCount()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Snapshot of proc `%s` has %d state elements, expected %d", name,
+          element_count, proc->GetStateElementCount()));
+    }
+    std::vector<Value>& state = snapshot.proc_states.emplace_back();
+    state.reserve(element_count);
+    for (int64_t j = 0; j < element_count; ++j) {
+      XLS_ASSIGN_OR_RETURN(std::vector<Value> values,
+                           reader.ReadValues(proc->GetStateElementType(j),
+                                             /*max_count=*/1));
+      if (values.size() != 1) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Snapshot of proc `%s` has %d values for state element %d", name,
+            values.size(), j));
+      }
+      state.push_back(std::move(values.front()));
+    }
+  }
+  snapshot.channel_contents.reserve(channel_count);
+  for (ChannelInstance* instance : channel_instances) {
+    XLS_ASSIGN_OR_RETURN(std::string_view name, reader.ReadString());
+    XLS_RETURN_IF_ERROR(CheckRecordName("channel", name, instance->ToString()));
+    XLS_ASSIGN_OR_RETURN(
+        std::vector<Value> values,
+        reader.ReadValues(instance->channel->type(),
+                          /*max_count=*/std::numeric_limits<uint64_t>::max()));
+    snapshot.channel_contents.push_back(std::move(values));
+  }
+  if (!reader.AtEnd()) {
+    return absl::InvalidArgumentError("Trailing data after snapshot");
+  }
+  return snapshot;
+}
+
+}  // namespace xls
@@ -0,0 +1,59 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_INTERPRETER_PROC_RUNTIME_SNAPSHOT_H_
+#define XLS_INTERPRETER_PROC_RUNTIME_SNAPSHOT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/ir/proc_elaboration.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+
+// The checkpointable state of a network of procs: the state element values of
+// every proc instance and the contents of every channel queue. Both vectors
+// are indexed in elaboration order (`ProcElaboration::proc_instances()` and
+// `ProcElaboration::channel_instances()` respectively).
+struct ProcRuntimeSnapshot {
+  std::vector<std::vector<Value>> proc_states;
+  std::vector<std::vector<Value>> channel_contents;
+};
+
+// Encodes `snapshot` of a network with the given elaboration into a compact
+// binary form.
+//
+// The encoding is a fixed 32-byte header followed by one record per proc
+// instance and then one record per channel instance. All integers are 64-bit
+// little-endian and every record starts on an 8-byte boundary, so an encoded
+// snapshot may be decoded in place from a memory-mapped file. Values are
+// stored as the concatenation of their leaf bits values, each leaf occupying
+// ceil(bit_count / 8) little-endian bytes; all values in a block share a
+// type, so value `i` of a block lives at a fixed offset. Records carry the
+// name of the instance they describe which is checked on decode.
+absl::StatusOr<std::string> EncodeProcRuntimeSnapshot(
+    const ProcRuntimeSnapshot& snapshot, const ProcElaboration& elaboration);
+
+// Decodes a snapshot produced by `EncodeProcRuntimeSnapshot`. Returns an error
+// if the data is malformed or does not match `elaboration`.
+absl::StatusOr<ProcRuntimeSnapshot> DecodeProcRuntimeSnapshot(
+    absl::Span<const uint8_t> data, const ProcElaboration& elaboration);
+
+}  // namespace xls
+
+#endif  // XLS_INTERPRETER_PROC_RUNTIME_SNAPSHOT_H_
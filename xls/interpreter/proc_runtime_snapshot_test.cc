@@ -0,0 +1,196 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/proc_runtime_snapshot.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/channel_ops.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+#include "xls/ir/proc_elaboration.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+absl::Span<const uint8_t> AsBytes(const std::string& s) {
+  return absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(s.data()),
+                             s.size());
+}
+
+class ProcRuntimeSnapshotTest : public IrTestBase {
+ protected:
+  // Builds a proc with a mix of state element types which sends on a channel
+  // carrying tuples.
+  absl::StatusOr<ProcElaboration> BuildNetwork(Package* package) {
+    XLS_ASSIGN_OR_RETURN(
+        Channel * channel,
+        package->CreateStreamingChannel(
+            "out", ChannelOps::kSendOnly,
+            package->GetTupleType({package->GetBitsType(3),
+                                   package->GetBitsType(70)})));
+    ProcBuilder pb("p", package);
+    BValue a = pb.StateElement("a", Value(UBits(0, 1)));
+    BValue b = pb.StateElement(
+        "b", Value::UBitsArray({1, 2, 3}, 17).value());
+    BValue tok = pb.StateElement("tok", Value::Token());
+    pb.Send(channel, tok,
+            pb.Tuple({pb.Literal(UBits(0, 3)), pb.Literal(UBits(0, 70))}));
+    XLS_RETURN_IF_ERROR(pb.Build({a, b, tok}).status());
+    return ProcElaboration::ElaborateOldStylePackage(package);
+  }
+
+  ProcRuntimeSnapshot MakeSnapshot() {
+    ProcRuntimeSnapshot snapshot;
+    snapshot.proc_states.push_back(
+        {Value(UBits(1, 1)), Value::UBitsArray({7, 0x1ffff, 0}, 17).value(),
+         Value::Token()});
+    snapshot.channel_contents.push_back(
+        {Value::Tuple({Value(UBits(5, 3)), Value(Bits::AllOnes(70))}),
+         Value::Tuple({Value(UBits(2, 3)), Value(UBits(42, 70))})});
+    return snapshot;
+  }
+};
+
+TEST_F(ProcRuntimeSnapshotTest, RoundTrip) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           BuildNetwork(package.get()));
+  ProcRuntimeSnapshot snapshot = MakeSnapshot();
+  XLS_ASSERT_OK_AND_ASSIGN(std::string encoded,
+                           EncodeProcRuntimeSnapshot(snapshot, elaboration));
+  EXPECT_EQ(encoded.size() % 8, 0);
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ProcRuntimeSnapshot decoded,
+      DecodeProcRuntimeSnapshot(AsBytes(encoded), elaboration));
+  EXPECT_EQ(decoded.proc_states, snapshot.proc_states);
+  EXPECT_EQ(decoded.channel_contents, snapshot.channel_contents);
+}
+
+TEST_F(ProcRuntimeSnapshotTest, EmptyQueues) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           BuildNetwork(package.get()));
+  ProcRuntimeSnapshot snapshot = MakeSnapshot();
+  snapshot.channel_contents[0].clear();
+  XLS_ASSERT_OK_AND_ASSIGN(std::string encoded,
+                           EncodeProcRuntimeSnapshot(snapshot, elaboration));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ProcRuntimeSnapshot decoded,
+      DecodeProcRuntimeSnapshot(AsBytes(encoded), elaboration));
+  EXPECT_THAT(decoded.channel_contents, ElementsAre(ElementsAre()));
+}
+
+TEST_F(ProcRuntimeSnapshotTest, MalformedData) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           BuildNetwork(package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string encoded,
+      EncodeProcRuntimeSnapshot(MakeSnapshot(), elaboration));
+
+  EXPECT_THAT(DecodeProcRuntimeSnapshot(AsBytes("not a snapshot"),
+                                        elaboration),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("not a proc runtime snapshot")));
+  EXPECT_THAT(DecodeProcRuntimeSnapshot(
+                  AsBytes(encoded.substr(0, encoded.size() - 8)), elaboration),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("truncated")));
+  EXPECT_THAT(DecodeProcRuntimeSnapshot(AsBytes(encoded + std::string(8, 0)),
+                                        elaboration),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Trailing data")));
+}
+
+TEST_F(ProcRuntimeSnapshotTest, MalformedZeroSizeValueCount) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package->CreateStreamingChannel("out", ChannelOps::kSendOnly,
+                                      package->GetTupleType({})));
+  ProcBuilder pb("p", package.get());
+  BValue tok = pb.StateElement("tok", Value::Token());
+  pb.Send(channel, tok, pb.Tuple({}));
+  XLS_ASSERT_OK(pb.Build({tok}).status());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ProcElaboration elaboration,
+      ProcElaboration::ElaborateOldStylePackage(package.get()));
+
+  ProcRuntimeSnapshot snapshot;
+  snapshot.proc_states.push_back({Value::Token()});
+  snapshot.channel_contents.push_back({Value::Tuple({}), Value::Tuple({})});
+  XLS_ASSERT_OK_AND_ASSIGN(std::string encoded,
+                           EncodeProcRuntimeSnapshot(snapshot, elaboration));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ProcRuntimeSnapshot decoded,
+      DecodeProcRuntimeSnapshot(AsBytes(encoded), elaboration));
+  EXPECT_EQ(decoded.channel_contents, snapshot.channel_contents);
+
+  // The channel's value block is the last record: a count followed by the
+  // (zero) value size and no value bytes. Replace the count with a huge one.
+  std::string corrupt = encoded;
+  corrupt.replace(corrupt.size() - 16, 8, std::string(8, '\xff'));
+  EXPECT_THAT(DecodeProcRuntimeSnapshot(AsBytes(corrupt), elaboration),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("zero-sized values")));
+}
+
+TEST_F(ProcRuntimeSnapshotTest, MismatchedNetwork) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           BuildNetwork(package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string encoded,
+      EncodeProcRuntimeSnapshot(MakeSnapshot(), elaboration));
+
+  auto other_package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      other_package->CreateStreamingChannel("out", ChannelOps::kSendOnly,
+                                            other_package->GetBitsType(32)));
+  ProcBuilder pb("p", other_package.get());
+  BValue st = pb.StateElement("st", Value(UBits(0, 32)));
+  pb.Send(channel, pb.Literal(Value::Token()), st);
+  XLS_ASSERT_OK(pb.Build({st}).status());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ProcElaboration other_elaboration,
+      ProcElaboration::ElaborateOldStylePackage(other_package.get()));
+
+  EXPECT_THAT(DecodeProcRuntimeSnapshot(AsBytes(encoded), other_elaboration),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("state elements")));
+}
+
+}  // namespace
+}  // namespace xls
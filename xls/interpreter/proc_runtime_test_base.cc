@@ -15,6 +15,7 @@
 #include "xls/interpreter/proc_runtime_test_base.h"
 
 #include <cstdint>
+#include <filesystem>  // NOLINT
 #include <memory>
 #include <string>
 #include <string_view>
@@ -26,12 +27,14 @@
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
+#include "xls/common/file/temp_directory.h"
 #include "xls/common/status/matchers.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/evaluator_options.h"
 #include "xls/interpreter/observer.h"
 #include "xls/interpreter/proc_runtime.h"
+#include "xls/interpreter/proc_runtime_snapshot.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/channel_ops.h"
@@ -1165,5 +1168,130 @@ TEST_P(ProcRuntimeTestBase, TraceChannels) {
   }
 }
 
+TEST_P(ProcRuntimeTestBase, SnapshotAndRestore) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package->CreateStreamingChannel("iota_out", ChannelOps::kSendOnly,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc,
+                           CreateIotaProc("iota", /*starting_value=*/5,
+                                          /*step=*/10, channel, package.get()));
+
+  std::unique_ptr<ProcRuntime> runtime =
+      GetParam().CreateRuntime(package.get());
+  ChannelQueue& queue = runtime->queue_manager().GetQueue(channel);
+
+  XLS_ASSERT_OK(runtime->Tick());
+  XLS_ASSERT_OK(runtime->Tick());
+  XLS_ASSERT_OK_AND_ASSIGN(std::string snapshot, runtime->SaveSnapshot());
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path snapshot_path = temp_dir.path() / "snapshot.bin";
+  XLS_ASSERT_OK(runtime->SaveSnapshotToFile(snapshot_path));
+
+  // Advance the network and drain the queue.
+  XLS_ASSERT_OK(runtime->Tick());
+  EXPECT_THAT(queue.Read(), Optional(Value(UBits(5, 32))));
+  EXPECT_THAT(runtime->ResolveState(proc), ElementsAre(Value(UBits(35, 32))));
+
+  XLS_ASSERT_OK(runtime->RestoreSnapshot(absl::MakeConstSpan(
+      reinterpret_cast<const uint8_t*>(snapshot.data()), snapshot.size())));
+  EXPECT_THAT(runtime->ResolveState(proc), ElementsAre(Value(UBits(25, 32))));
+  EXPECT_THAT(queue.GetContents(),
+              ElementsAre(Value(UBits(5, 32)), Value(UBits(15, 32))));
+
+  // Execution resumes from the restored state.
+  XLS_ASSERT_OK(runtime->Tick());
+  EXPECT_THAT(queue.GetContents(),
+              ElementsAre(Value(UBits(5, 32)), Value(UBits(15, 32)),
+                          Value(UBits(25, 32))));
+
+  XLS_ASSERT_OK(runtime->RestoreSnapshotFromFile(snapshot_path));
+  EXPECT_THAT(runtime->ResolveState(proc), ElementsAre(Value(UBits(25, 32))));
+  EXPECT_EQ(queue.GetSize(), 2);
+  EXPECT_THAT(queue.Read(), Optional(Value(UBits(5, 32))));
+  EXPECT_THAT(queue.Read(), Optional(Value(UBits(15, 32))));
+}
+
+TEST_P(ProcRuntimeTestBase, RejectedSnapshotLeavesRuntimeIntact) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package->CreateStreamingChannel("iota_out", ChannelOps::kSendOnly,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc,
+                           CreateIotaProc("iota", /*starting_value=*/5,
+                                          /*step=*/10, channel, package.get()));
+
+  std::unique_ptr<ProcRuntime> runtime =
+      GetParam().CreateRuntime(package.get());
+  ChannelQueue& queue = runtime->queue_manager().GetQueue(channel);
+  XLS_ASSERT_OK(runtime->Tick());
+  XLS_ASSERT_OK(runtime->Tick());
+
+  // The state is valid but the channel contents are not, so nothing may be
+  // applied.
+  ProcRuntimeSnapshot bad_contents;
+  bad_contents.proc_states.push_back({Value(UBits(100, 32))});
+  bad_contents.channel_contents.push_back({Value(UBits(1, 8))});
+  EXPECT_THAT(runtime->RestoreSnapshot(bad_contents),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("expects values to have type")));
+  EXPECT_THAT(runtime->ResolveState(proc), ElementsAre(Value(UBits(25, 32))));
+  EXPECT_THAT(queue.GetContents(),
+              ElementsAre(Value(UBits(5, 32)), Value(UBits(15, 32))));
+
+  ProcRuntimeSnapshot bad_state;
+  bad_state.proc_states.push_back({Value(UBits(100, 16))});
+  bad_state.channel_contents.push_back({});
+  EXPECT_THAT(runtime->RestoreSnapshot(bad_state),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(runtime->ResolveState(proc), ElementsAre(Value(UBits(25, 32))));
+  EXPECT_THAT(queue.GetContents(),
+              ElementsAre(Value(UBits(5, 32)), Value(UBits(15, 32))));
+
+  // The runtime carries on from where it was.
+  XLS_ASSERT_OK(runtime->Tick());
+  EXPECT_THAT(queue.GetContents(),
+              ElementsAre(Value(UBits(5, 32)), Value(UBits(15, 32)),
+                          Value(UBits(25, 32))));
+}
+
+TEST_P(ProcRuntimeTestBase, SnapshotOfBlockedProc) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * in_channel,
+      package->CreateStreamingChannel("in", ChannelOps::kReceiveOnly,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * out_channel,
+      package->CreateStreamingChannel("out", ChannelOps::kSendOnly,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK(
+      CreateAccumProc("accum", in_channel, out_channel, package.get())
+          .status());
+
+  std::unique_ptr<ProcRuntime> runtime =
+      GetParam().CreateRuntime(package.get());
+
+  // Queue contents alone may be snapshotted before any execution.
+  ChannelQueue& in_queue = runtime->queue_manager().GetQueue(in_channel);
+  XLS_ASSERT_OK(in_queue.Write(Value(UBits(3, 32))));
+  XLS_ASSERT_OK_AND_ASSIGN(std::string snapshot, runtime->SaveSnapshot());
+
+  // Once the proc blocks part way through a tick it cannot be snapshotted.
+  XLS_ASSERT_OK(runtime->TickUntilBlocked(/*max_ticks=*/100));
+  EXPECT_THAT(runtime->SaveSnapshot(),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       HasSubstr("part way through a tick")));
+
+  // Restoring returns the proc to the start of a tick.
+  XLS_ASSERT_OK(runtime->RestoreSnapshot(absl::MakeConstSpan(
+      reinterpret_cast<const uint8_t*>(snapshot.data()), snapshot.size())));
+  XLS_ASSERT_OK(runtime->TickUntilBlocked(/*max_ticks=*/100));
+  EXPECT_THAT(runtime->queue_manager().GetQueue(out_channel).GetContents(),
+              ElementsAre(Value(UBits(3, 32))));
+}
+
 }  // namespace
 }  // namespace xls
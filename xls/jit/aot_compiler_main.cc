@@ -44,6 +44,7 @@
 #include "xls/ir/function.h"
 #include "xls/ir/function_base.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/ir/node.h"
 #include "xls/ir/nodes.h"
 #include "xls/ir/package.h"
 #include "xls/ir/type.h"
@@ -160,6 +161,18 @@ absl::StatusOr<AotEntrypointProto> GenerateEntrypointProto(
         object_code.continuation_points().end());
     proc_metadata_proto->mutable_channel_queue_indices()->insert(
         object_code.queue_indices().begin(), object_code.queue_indices().end());
+    for (Node* node : func->nodes()) {
+      if (!node->Is<ChannelNode>()) {
+        continue;
+      }
+      ChannelNode* channel_node = node->As<ChannelNode>();
+      Type* data_type =
+          node->Is<Send>() ? node->As<Send>()->data()->GetType()
+                           : node->As<Receive>()->GetPayloadType();
+      proc_metadata_proto->mutable_channel_layouts()->insert(
+          {channel_node->channel_name(),
+           type_converter.CreateTypeLayout(data_type).ToProto()});
+    }
     *proc_metadata_proto->mutable_proc_interface() =
         ExtractProcInterface(func->AsProcOrDie());
   } else {
@@ -44,6 +44,8 @@
 #include "xls/jit/aot_compiler.h"
 #include "xls/jit/aot_entrypoint.pb.h"
 #include "xls/jit/function_base_jit.h"
+#include "xls/jit/jit_buffer.h"
+#include "xls/jit/jit_callbacks.h"
 #include "xls/jit/jit_runtime.h"
 #include "xls/jit/observer.h"
 #include "xls/jit/orc_jit.h"
@@ -233,6 +235,35 @@ template absl::Status FunctionJit::RunWithViews</*kForceZeroCopy=*/false>(
     absl::Span<uint8_t* const> args, absl::Span<uint8_t> result_buffer,
     InterpreterEvents* events);
 
+absl::Status FunctionJit::RunBatchedWithViews(
+    absl::Span<const uint8_t* const> args, absl::Span<uint8_t> results,
+    int64_t count, InterpreterEvents* events) const {
+  if (args.size() != metadata_.ParamCount()) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Arg list has the wrong size: %d vs expected %d.",
+                        args.size(), metadata_.ParamCount()));
+  }
+  if (results.size() < count * GetReturnTypeSize()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Result buffer too small - must be at least %d bytes!",
+        count * GetReturnTypeSize()));
+  }
+
+  JitTempBuffer temp_buffer = jitted_function_base_.CreateTempBuffer();
+  InstanceContext instance_context = InstanceContext::CreateForFunc();
+  std::vector<const uint8_t*> run_args(args.begin(), args.end());
+  for (int64_t j = 0; j < count; ++j) {
+    uint8_t* output_buffers[1] = {results.data() + j * GetReturnTypeSize()};
+    jitted_function_base_.RunUnalignedJittedFunction</*kForceZeroCopy=*/false>(
+        run_args.data(), output_buffers, temp_buffer.get(), events,
+        &instance_context, runtime(), /*continuation=*/0);
+    for (int64_t i = 0; i < run_args.size(); ++i) {
+      run_args[i] += GetArgTypeSize(i);
+    }
+  }
+  return absl::OkStatus();
+}
+
 template <bool kForceZeroCopy>
 void FunctionJit::InvokeUnalignedJitFunction(
     absl::Span<const uint8_t* const> arg_buffers, uint8_t* output_buffer,
@@ -93,6 +93,19 @@ class FunctionJit {
                             absl::Span<uint8_t> result_buffer,
                             InterpreterEvents* events);
 
+  // Executes the compiled function `count` times on argument sets stored
+  // back-to-back in the native layout: argument `i` of run `j` is read from
+  // `args[i] + j * GetArgTypeSize(i)` and the result of run `j` is written to
+  // `results + j * GetReturnTypeSize()`. Events of all runs are appended to
+  // `events`.
+  //
+  // Unlike the other Run methods this uses a temporary buffer of its own
+  // rather than the one held by this object, so it may be called concurrently
+  // from several threads.
+  absl::Status RunBatchedWithViews(absl::Span<const uint8_t* const> args,
+                                   absl::Span<uint8_t> results, int64_t count,
+                                   InterpreterEvents* events) const;
+
   // Similar to RunWithViews(), except the arguments here are _packed_views_ -
   // views whose data elements are tightly packed, with no padding bits or bytes
   // between them. The function return value is specified as the last arg - its
@@ -1003,6 +1003,48 @@ fn f(x: bits[1], y: bits[21]) -> (bits[1], bits[21]) {
   }
 }
 
+TEST(FunctionJitTest, RunBatchedWithViews) {
+  Package package("my_package");
+  std::string ir_text = R"(
+  fn sub(x: bits[32], y: bits[8]) -> bits[32] {
+    zero_ext.1: bits[32] = zero_ext(y, new_bit_count=32)
+    ret sub.2: bits[32] = sub(x, zero_ext.1)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+  ASSERT_EQ(jit->GetArgTypeSize(0), 4);
+  ASSERT_EQ(jit->GetArgTypeSize(1), 1);
+  ASSERT_EQ(jit->GetReturnTypeSize(), 4);
+
+  constexpr int64_t kCount = 100;
+  alignas(16) std::array<uint32_t, kCount> x;
+  std::array<uint8_t, kCount> y;
+  for (int64_t i = 0; i < kCount; ++i) {
+    x[i] = 1000 * i;
+    y[i] = i;
+  }
+  alignas(16) std::array<uint32_t, kCount> result{};
+  InterpreterEvents events;
+  XLS_ASSERT_OK(jit->RunBatchedWithViews(
+      {reinterpret_cast<uint8_t*>(x.data()), y.data()},
+      absl::MakeSpan(reinterpret_cast<uint8_t*>(result.data()),
+                     sizeof(result)),
+      kCount, &events));
+  for (int64_t i = 0; i < kCount; ++i) {
+    EXPECT_EQ(result[i], static_cast<uint32_t>(999 * i)) << i;
+  }
+
+  EXPECT_THAT(jit->RunBatchedWithViews(
+                  {reinterpret_cast<uint8_t*>(x.data()), y.data()},
+                  absl::MakeSpan(reinterpret_cast<uint8_t*>(result.data()),
+                                 sizeof(result)),
+                  kCount + 1, &events),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Result buffer too small")));
+}
+
 TEST(FunctionJitTest, TupleViewSmokeTest) {
   Package package("my_package");
 
@@ -529,6 +529,27 @@ absl::StatusOr<std::vector<CompareTerm>> ExpandTerms(
   return terms;
 }
 
+// Compares the arrays pointed to by `lhs_ptr` and `rhs_ptr` using vector
+// operations. `vector_type` is the vector type for the array type as returned
+// by LlvmTypeConverter::GetArrayVectorType. Returns an i1 value which is true
+// if all elements are equal (`is_eq`) or if any element differs (`!is_eq`).
+llvm::Value* EmitVectorArrayCompare(llvm::Value* lhs_ptr, llvm::Value* rhs_ptr,
+                                    ArrayType* array_type,
+                                    llvm::FixedVectorType* vector_type,
+                                    bool is_eq,
+                                    LlvmTypeConverter* type_converter,
+                                    llvm::IRBuilder<>& builder) {
+  llvm::Align alignment(
+      type_converter->GetArrayVectorLoadAlignment(array_type));
+  llvm::Value* lhs =
+      builder.CreateAlignedLoad(vector_type, lhs_ptr, alignment, "lhs_vector");
+  llvm::Value* rhs =
+      builder.CreateAlignedLoad(vector_type, rhs_ptr, alignment, "rhs_vector");
+  llvm::Value* lanes_equal = builder.CreateICmpEQ(lhs, rhs);
+  llvm::Value* all_equal = builder.CreateAndReduce(lanes_equal);
+  return is_eq ? all_equal : builder.CreateNot(all_equal);
+}
+
 // Returns an llvm::Value (i1 type) indicating whether `index` is an in-bounds
 // index into an array of type `array_type`.
 llvm::Value* IsIndexInBounds(llvm::Value* index, ArrayType* array_type,
@@ -2312,6 +2333,16 @@ absl::Status IrBuilderVisitor::HandleEq(CompareOp* eq) {
   XLS_ASSIGN_OR_RETURN(NodeIrContext node_context,
                        NewNodeIrContext(eq, {"lhs", "rhs"}));
   llvm::IRBuilder<>& b = node_context.entry_builder();
+
+  if (llvm::FixedVectorType* vector_type =
+          type_converter()->GetArrayVectorType(eq->operand(0)->GetType())) {
+    llvm::Value* result = EmitVectorArrayCompare(
+        node_context.GetOperandPtr(0), node_context.GetOperandPtr(1),
+        eq->operand(0)->GetType()->AsArrayOrDie(), vector_type,
+        /*is_eq=*/true, type_converter(), b);
+    return FinalizeNodeIrContextWithValue(std::move(node_context), result);
+  }
+
   llvm::Value* llvm_lhs = node_context.LoadOperand(0);
   llvm::Value* llvm_rhs = node_context.LoadOperand(1);
 
@@ -2605,6 +2636,16 @@ absl::Status IrBuilderVisitor::HandleNe(CompareOp* ne) {
   XLS_ASSIGN_OR_RETURN(NodeIrContext node_context,
                        NewNodeIrContext(ne, {"lhs", "rhs"}));
   llvm::IRBuilder<>& b = node_context.entry_builder();
+
+  if (llvm::FixedVectorType* vector_type =
+          type_converter()->GetArrayVectorType(ne->operand(0)->GetType())) {
+    llvm::Value* result = EmitVectorArrayCompare(
+        node_context.GetOperandPtr(0), node_context.GetOperandPtr(1),
+        ne->operand(0)->GetType()->AsArrayOrDie(), vector_type,
+        /*is_eq=*/false, type_converter(), b);
+    return FinalizeNodeIrContextWithValue(std::move(node_context), result);
+  }
+
   llvm::Value* llvm_lhs = node_context.LoadOperand(0);
   llvm::Value* llvm_rhs = node_context.LoadOperand(1);
 
@@ -2748,6 +2789,19 @@ std::unique_ptr<llvm::IRBuilder<>> OrInPlace(
     builder->CreateStore(result, tgt_buffer);
     return builder;
   }
+  if (llvm::FixedVectorType* vector_type =
+          type_converter->GetArrayVectorType(xls_type)) {
+    // OR all of the elements at once with a vector operation.
+    llvm::Align alignment(type_converter->GetArrayVectorLoadAlignment(
+        xls_type->AsArrayOrDie()));
+    llvm::Value* src =
+        builder->CreateAlignedLoad(vector_type, src_buffer, alignment);
+    llvm::Value* tgt =
+        builder->CreateAlignedLoad(vector_type, tgt_buffer, alignment);
+    builder->CreateAlignedStore(builder->CreateOr(src, tgt), tgt_buffer,
+                                alignment);
+    return builder;
+  }
   if (xls_type->IsArray()) {
     // Create a loop in LLVM and iterate through each element.
     ArrayType* array_type = xls_type->AsArrayOrDie();
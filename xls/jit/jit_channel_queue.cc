@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -56,6 +57,24 @@ std::optional<Value> ReadValueFromQueue(Type* type, JitRuntime& runtime,
   return runtime.UnpackBuffer(buffer.data(), type);
 }
 
+std::vector<Value> ByteQueueContents(Type* type, JitRuntime& runtime,
+                                     const ByteQueue& queue) {
+  std::vector<Value> values;
+  values.reserve(queue.size());
+  for (int64_t i = 0; i < queue.size(); ++i) {
+    values.push_back(runtime.UnpackBuffer(queue.Peek(i), type));
+  }
+  return values;
+}
+
+void SetByteQueueContents(absl::Span<const Value> values, Type* type,
+                          JitRuntime& runtime, ByteQueue& queue) {
+  queue.Clear();
+  for (const Value& value : values) {
+    WriteValueOnQueue(value, type, runtime, queue);
+  }
+}
+
 }  // namespace
 
 ByteQueue::ByteQueue(int64_t channel_element_size, bool is_single_value)
@@ -102,6 +121,147 @@ void ByteQueue::Resize() {
   }
 }
 
+void ByteQueue::WriteN(const uint8_t* data, int64_t count) {
+  if (count == 0) {
+    return;
+  }
+  if (is_single_value_) {
+    Write(data + (count - 1) * channel_element_size_);
+    return;
+  }
+#ifdef ABSL_HAVE_MEMORY_SANITIZER
+  __msan_unpoison(data, count * channel_element_size_);
+#endif
+  while (count > 0) {
+    // The queue can only grow when it is full, so fill the free space before
+    // resizing.
+    if (bytes_used_ == max_byte_count_) {
+      Resize();
+    }
+    int64_t chunk_count = std::min(
+        count, (max_byte_count_ - bytes_used_) / allocated_element_size_);
+    CopyIn(data, chunk_count);
+    data += chunk_count * channel_element_size_;
+    count -= chunk_count;
+  }
+}
+
+int64_t ByteQueue::ReadN(uint8_t* buffer, int64_t max_count) {
+  if (bytes_used_ == 0 || max_count == 0) {
+    return 0;
+  }
+  if (is_single_value_) {
+    for (int64_t i = 0; i < max_count; ++i) {
+      Read(buffer + i * channel_element_size_);
+    }
+    return max_count;
+  }
+  int64_t count = std::min(max_count, size());
+  CopyOut(buffer, count);
+  return count;
+}
+
+void ByteQueue::CopyIn(const uint8_t* data, int64_t count) {
+  int64_t total_bytes = count * allocated_element_size_;
+  if (channel_element_size_ == allocated_element_size_) {
+    // Elements are stored densely in the circular buffer so the data can be
+    // copied in at most two chunks: up to the end of the circular buffer and
+    // then wrapping around to the beginning.
+    int64_t first_chunk = std::min(total_bytes, max_byte_count_ - write_index_);
+    memcpy(circular_buffer_.data() + write_index_, data, first_chunk);
+    memcpy(circular_buffer_.data(), data + first_chunk,
+           total_bytes - first_chunk);
+    write_index_ = (write_index_ + total_bytes) % max_byte_count_;
+  } else {
+    // Elements are padded in the circular buffer, so each one is copied to its
+    // slot. Slots never straddle the end of the circular buffer.
+    for (int64_t i = 0; i < count; ++i) {
+      memcpy(circular_buffer_.data() + write_index_,
+             data + i * channel_element_size_, channel_element_size_);
+      write_index_ += allocated_element_size_;
+      if (write_index_ == max_byte_count_) {
+        write_index_ = 0;
+      }
+    }
+  }
+  bytes_used_ += total_bytes;
+}
+
+void ByteQueue::CopyOut(uint8_t* buffer, int64_t count) {
+  int64_t total_bytes = count * allocated_element_size_;
+  if (channel_element_size_ == allocated_element_size_) {
+    int64_t first_chunk = std::min(total_bytes, max_byte_count_ - read_index_);
+    memcpy(buffer, circular_buffer_.data() + read_index_, first_chunk);
+    memcpy(buffer + first_chunk, circular_buffer_.data(),
+           total_bytes - first_chunk);
+    read_index_ = (read_index_ + total_bytes) % max_byte_count_;
+  } else {
+    for (int64_t i = 0; i < count; ++i) {
+      memcpy(buffer + i * channel_element_size_,
+             circular_buffer_.data() + read_index_, channel_element_size_);
+      read_index_ += allocated_element_size_;
+      if (read_index_ == max_byte_count_) {
+        read_index_ = 0;
+      }
+    }
+  }
+  bytes_used_ -= total_bytes;
+}
+
+int64_t JitChannelQueue::BulkElementCount(int64_t buffer_size) const {
+  if (element_size_ == 0) {
+    // Zero-width values (e.g., empty tuples) occupy no space in the buffer so
+    // the count of values cannot be derived from the buffer size.
+    return 0;
+  }
+  CHECK_EQ(buffer_size % element_size_, 0)
+      << "Bulk transfer buffer size is not a multiple of the element size of "
+         "channel "
+      << channel()->name();
+  return buffer_size / element_size_;
+}
+
+void ThreadSafeJitChannelQueue::WriteRawBulk(absl::Span<const uint8_t> data) {
+  int64_t count = BulkElementCount(data.size());
+  absl::MutexLock lock(&mutex_);
+  if (callbacks_.empty()) {
+    byte_queue_.WriteN(data.data(), count);
+    return;
+  }
+  for (int64_t i = 0; i < count; ++i) {
+    const uint8_t* element = data.data() + i * element_size_;
+    byte_queue_.Write(element);
+    CallWriteCallbacks(jit_runtime_->UnpackBuffer(element, channel()->type()));
+  }
+}
+
+int64_t ThreadSafeJitChannelQueue::ReadRawBulk(absl::Span<uint8_t> buffer) {
+  int64_t max_count = BulkElementCount(buffer.size());
+  absl::MutexLock lock(&mutex_);
+  if (callbacks_.empty() && !generator_.has_value()) {
+    return byte_queue_.ReadN(buffer.data(), max_count);
+  }
+  // Generators and callbacks operate on one value at a time.
+  int64_t count = 0;
+  while (count < max_count) {
+    if (generator_.has_value()) {
+      std::optional<Value> generated_value = (*generator_)();
+      if (generated_value.has_value()) {
+        WriteInternal(generated_value.value());
+      }
+    }
+    uint8_t* element = buffer.data() + count * element_size_;
+    if (!byte_queue_.Read(element)) {
+      break;
+    }
+    if (!callbacks_.empty()) {
+      CallReadCallbacks(jit_runtime_->UnpackBuffer(element, channel()->type()));
+    }
+    ++count;
+  }
+  return count;
+}
+
 int64_t ThreadSafeJitChannelQueue::GetSizeInternal() const {
   return byte_queue_.size();
 }
@@ -120,6 +280,55 @@ std::optional<Value> ThreadSafeJitChannelQueue::ReadInternal() {
   return value;
 }
 
+std::vector<Value> ThreadSafeJitChannelQueue::GetContentsInternal() const {
+  return ByteQueueContents(channel()->type(), *jit_runtime_, byte_queue_);
+}
+
+void ThreadSafeJitChannelQueue::SetContentsInternal(
+    absl::Span<const Value> values) {
+  SetByteQueueContents(values, channel()->type(), *jit_runtime_, byte_queue_);
+}
+
+void ThreadUnsafeJitChannelQueue::WriteRawBulk(
+    absl::Span<const uint8_t> data) {
+  int64_t count = BulkElementCount(data.size());
+  if (callbacks_.empty()) {
+    byte_queue_.WriteN(data.data(), count);
+    return;
+  }
+  for (int64_t i = 0; i < count; ++i) {
+    const uint8_t* element = data.data() + i * element_size_;
+    byte_queue_.Write(element);
+    CallWriteCallbacks(jit_runtime_->UnpackBuffer(element, channel()->type()));
+  }
+}
+
+int64_t ThreadUnsafeJitChannelQueue::ReadRawBulk(absl::Span<uint8_t> buffer) {
+  int64_t max_count = BulkElementCount(buffer.size());
+  if (callbacks_.empty() && !generator_.has_value()) {
+    return byte_queue_.ReadN(buffer.data(), max_count);
+  }
+  // Generators and callbacks operate on one value at a time.
+  int64_t count = 0;
+  while (count < max_count) {
+    if (generator_.has_value()) {
+      std::optional<Value> generated_value = (*generator_)();
+      if (generated_value.has_value()) {
+        WriteInternal(generated_value.value());
+      }
+    }
+    uint8_t* element = buffer.data() + count * element_size_;
+    if (!byte_queue_.Read(element)) {
+      break;
+    }
+    if (!callbacks_.empty()) {
+      CallReadCallbacks(jit_runtime_->UnpackBuffer(element, channel()->type()));
+    }
+    ++count;
+  }
+  return count;
+}
+
 int64_t ThreadUnsafeJitChannelQueue::GetSizeInternal() const {
   return byte_queue_.size();
 }
@@ -138,6 +347,15 @@ std::optional<Value> ThreadUnsafeJitChannelQueue::ReadInternal() {
   return value;
 }
 
+std::vector<Value> ThreadUnsafeJitChannelQueue::GetContentsInternal() const {
+  return ByteQueueContents(channel()->type(), *jit_runtime_, byte_queue_);
+}
+
+void ThreadUnsafeJitChannelQueue::SetContentsInternal(
+    absl::Span<const Value> values) {
+  SetByteQueueContents(values, channel()->type(), *jit_runtime_, byte_queue_);
+}
+
 /* static */ absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
 JitChannelQueueManager::CreateThreadSafe(Package* package,
                                          std::unique_ptr<JitRuntime> runtime) {
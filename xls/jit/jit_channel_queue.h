@@ -25,6 +25,7 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/package.h"
@@ -86,11 +87,43 @@ class ByteQueue {
     return true;
   }
 
+  // Writes `count` elements from `data`. Element `i` is read from
+  // `data + i * element_size()`. For single-value queues only the last element
+  // is retained.
+  void WriteN(const uint8_t* data, int64_t count);
+
+  // Reads up to `max_count` elements into `buffer`. Element `i` is written to
+  // `buffer + i * element_size()`. Returns the number of elements read. For
+  // single-value queues, the single value is written to all `max_count`
+  // elements of `buffer` if the queue is not empty.
+  int64_t ReadN(uint8_t* buffer, int64_t max_count);
+
   int64_t size() const { return bytes_used_ / allocated_element_size_; }
 
+  // Returns a pointer to the `index`-th element from the head of the queue
+  // without consuming it. `index` must be less than `size()`.
+  const uint8_t* Peek(int64_t index) const {
+    return circular_buffer_.data() +
+           (read_index_ + index * allocated_element_size_) % max_byte_count_;
+  }
+
+  // Removes all elements from the queue.
+  void Clear() {
+    bytes_used_ = 0;
+    read_index_ = 0;
+    write_index_ = 0;
+  }
+
   static constexpr int64_t kInitBufferSize = 128;
 
  private:
+  // Copies `count` elements between the caller's buffer, where they are
+  // `channel_element_size_` bytes apart, and the circular buffer. For `CopyIn`
+  // the elements must fit in the free space and for `CopyOut` the queue must
+  // hold at least `count` elements.
+  void CopyIn(const uint8_t* data, int64_t count);
+  void CopyOut(uint8_t* buffer, int64_t count);
+
   // Size of an element in the channel in units of bytes.
   int64_t channel_element_size_ = 0;
   // Allocated size of an element in the circular buffer in units of bytes. The
@@ -118,14 +151,39 @@ class ByteQueue {
 class JitChannelQueue : public ChannelQueue {
  public:
   JitChannelQueue(ChannelInstance* channel, JitRuntime* jit_runtime)
-      : ChannelQueue(channel), jit_runtime_(jit_runtime) {}
+      : ChannelQueue(channel),
+        jit_runtime_(jit_runtime),
+        element_size_(jit_runtime->GetTypeByteSize(channel->channel->type())) {}
   ~JitChannelQueue() override = default;
 
+  // Returns the size in bytes of a single value of the channel's type in the
+  // native layout used by the JIT. This is the size of the buffers passed to
+  // WriteRaw and ReadRaw and the stride between consecutive values in the
+  // buffers passed to WriteRawBulk and ReadRawBulk.
+  int64_t element_size() const { return element_size_; }
+
   virtual void WriteRaw(const uint8_t* data) = 0;
   virtual bool ReadRaw(uint8_t* buffer) = 0;
 
+  // Writes the values held in the caller-owned buffer `data` to the queue. The
+  // buffer holds consecutive values in the native layout, each
+  // `element_size()` bytes. The size of `data` must be a multiple of
+  // `element_size()`. The data is copied directly into the queue with no
+  // intermediate conversion to xls::Value unless callbacks are attached to the
+  // queue.
+  virtual void WriteRawBulk(absl::Span<const uint8_t> data) = 0;
+
+  // Reads values into the caller-owned buffer `buffer` in the native layout,
+  // `element_size()` bytes per value. At most `buffer.size() / element_size()`
+  // values are read. Returns the number of values read.
+  virtual int64_t ReadRawBulk(absl::Span<uint8_t> buffer) = 0;
+
  protected:
+  // Returns the number of values in a bulk transfer buffer of the given size.
+  int64_t BulkElementCount(int64_t buffer_size) const;
+
   JitRuntime* jit_runtime_;
+  int64_t element_size_;
 };
 
 // A thread-safe version of the JIT channel queue. All accesses are guarded by a
@@ -166,12 +224,19 @@ class ThreadSafeJitChannelQueue : public JitChannelQueue {
     return value_read;
   }
 
+  void WriteRawBulk(absl::Span<const uint8_t> data) override;
+  int64_t ReadRawBulk(absl::Span<uint8_t> buffer) override;
+
  protected:
   int64_t GetSizeInternal() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
   void WriteInternal(const Value& value)
       ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
   std::optional<Value> ReadInternal()
       ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
+  std::vector<Value> GetContentsInternal() const
+      ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
+  void SetContentsInternal(absl::Span<const Value> values)
+      ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
 
   ByteQueue byte_queue_ ABSL_GUARDED_BY(mutex_);
 };
@@ -207,10 +272,15 @@ class ThreadUnsafeJitChannelQueue : public JitChannelQueue {
     return value_read;
   }
 
+  void WriteRawBulk(absl::Span<const uint8_t> data) override;
+  int64_t ReadRawBulk(absl::Span<uint8_t> buffer) override;
+
  protected:
   int64_t GetSizeInternal() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
   void WriteInternal(const Value& value) override;
   std::optional<Value> ReadInternal() override;
+  std::vector<Value> GetContentsInternal() const override;
+  void SetContentsInternal(absl::Span<const Value> values) override;
 
   ByteQueue byte_queue_;
 };
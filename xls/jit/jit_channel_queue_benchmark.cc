@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "absl/log/check.h"
+#include "absl/types/span.h"
 #include "include/benchmark/benchmark.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/channel_ops.h"
@@ -70,6 +71,41 @@ static void BM_QueueWriteThenRead(benchmark::State& state) {
   }
 }
 
+// Benchmark evaluating writing a batch of values to the channel with a single
+// bulk write then reading them back with a single bulk read.
+template <typename QueueT,
+          typename std::enable_if<std::is_base_of_v<JitChannelQueue, QueueT>,
+                                  QueueT>::type* = nullptr>
+static void BM_QueueBulkWriteThenRead(benchmark::State& state) {
+  int64_t element_size_bytes = state.range(0);
+
+  Package package("benchmark");
+  auto orc_jit = OrcJit::Create().value();
+  auto jit_runtime =
+      std::make_unique<JitRuntime>(orc_jit->CreateDataLayout().value());
+  Channel* channel =
+      package
+          .CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                  package.GetBitsType(8 * element_size_bytes))
+          .value();
+  ProcElaboration elaboration =
+      ProcElaboration::ElaborateOldStylePackage(&package).value();
+
+  QueueT queue(elaboration.GetUniqueInstance(channel).value(),
+               jit_runtime.get());
+
+  int64_t send_count = state.range(1);
+  CHECK(queue.IsEmpty());
+  std::vector<uint8_t> send_buffer(element_size_bytes * send_count);
+  std::vector<uint8_t> recv_buffer(element_size_bytes * send_count);
+  std::fill(send_buffer.begin(), send_buffer.end(), 42);
+  for (auto _ : state) {
+    queue.WriteRawBulk(send_buffer);
+    queue.ReadRawBulk(absl::MakeSpan(recv_buffer));
+  }
+  state.SetBytesProcessed(state.iterations() * send_buffer.size());
+}
+
 // For the following benchmark, the first element in the pair denotes the buffer
 // size written/read from the channel queue. The second element in the pair
 // denotes the number of writes and/or reads to the channel queue.
@@ -93,6 +129,22 @@ BENCHMARK(BM_QueueWriteThenRead<ThreadUnsafeJitChannelQueue>)
     ->ArgPair(2048, 1)
     ->ArgPair(2048, 128);
 
+BENCHMARK(BM_QueueBulkWriteThenRead<ThreadSafeJitChannelQueue>)
+    ->ArgPair(1, 128)
+    ->ArgPair(8, 128)
+    ->ArgPair(8, 4096)
+    ->ArgPair(32, 128)
+    ->ArgPair(32, 4096)
+    ->ArgPair(2048, 128);
+
+BENCHMARK(BM_QueueBulkWriteThenRead<ThreadUnsafeJitChannelQueue>)
+    ->ArgPair(1, 128)
+    ->ArgPair(8, 128)
+    ->ArgPair(8, 4096)
+    ->ArgPair(32, 128)
+    ->ArgPair(32, 4096)
+    ->ArgPair(2048, 128);
+
 }  // namespace
 }  // namespace xls
 
@@ -14,6 +14,7 @@
 
 #include "xls/jit/jit_channel_queue.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <memory>
@@ -24,6 +25,7 @@
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/types/span.h"
 #include "xls/common/status/matchers.h"
 #include "xls/interpreter/channel_queue_test_base.h"
 #include "xls/ir/bits.h"
@@ -146,6 +148,149 @@ TYPED_TEST(JitChannelQueueTest, BasicAccess) {
   EXPECT_TRUE(queue.IsEmpty());
 }
 
+TYPED_TEST(JitChannelQueueTest, BulkAccess) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+
+  TypeParam queue(elaboration.GetUniqueInstance(channel).value(),
+                  GetJitRuntime());
+  EXPECT_EQ(queue.element_size(), 4);
+
+  // Write enough values to force the queue to grow and interleave reads so
+  // the circular buffer wraps around.
+  std::vector<uint32_t> send_buffer(100);
+  std::vector<uint32_t> recv_buffer(30);
+  uint32_t next_send = 0;
+  uint32_t next_recv = 0;
+  for (int64_t round = 0; round < 5; ++round) {
+    for (uint32_t& v : send_buffer) {
+      v = next_send++;
+    }
+    queue.WriteRawBulk(absl::MakeConstSpan(
+        reinterpret_cast<const uint8_t*>(send_buffer.data()),
+        send_buffer.size() * sizeof(uint32_t)));
+    for (int64_t i = 0; i < 3; ++i) {
+      EXPECT_EQ(queue.ReadRawBulk(absl::MakeSpan(
+                    reinterpret_cast<uint8_t*>(recv_buffer.data()),
+                    recv_buffer.size() * sizeof(uint32_t))),
+                recv_buffer.size());
+      for (uint32_t v : recv_buffer) {
+        EXPECT_EQ(v, next_recv++);
+      }
+    }
+  }
+  EXPECT_EQ(queue.GetSize(), next_send - next_recv);
+
+  // Drain the queue with a partial bulk read.
+  std::vector<uint32_t> drain_buffer(1000);
+  int64_t remaining = queue.GetSize();
+  EXPECT_EQ(queue.ReadRawBulk(absl::MakeSpan(
+                reinterpret_cast<uint8_t*>(drain_buffer.data()),
+                drain_buffer.size() * sizeof(uint32_t))),
+            remaining);
+  for (int64_t i = 0; i < remaining; ++i) {
+    EXPECT_EQ(drain_buffer[i], next_recv++);
+  }
+  EXPECT_TRUE(queue.IsEmpty());
+
+  // Single-element raw and value accesses interoperate with bulk accesses.
+  uint32_t value = 42;
+  queue.WriteRaw(reinterpret_cast<const uint8_t*>(&value));
+  XLS_ASSERT_OK(queue.Write(Value(UBits(43, 32))));
+  EXPECT_EQ(queue.ReadRawBulk(absl::MakeSpan(
+                reinterpret_cast<uint8_t*>(drain_buffer.data()),
+                drain_buffer.size() * sizeof(uint32_t))),
+            2);
+  EXPECT_EQ(drain_buffer[0], 42);
+  EXPECT_EQ(drain_buffer[1], 43);
+}
+
+// Writes and reads `element_size`-byte elements through the bulk interface of
+// a byte queue, wrapping around the end of the circular buffer and growing it.
+void TestByteQueueBulkAccess(int64_t element_size) {
+  ByteQueue queue(element_size, /*is_single_value=*/false);
+  uint8_t next_write = 0;
+  uint8_t next_read = 0;
+  auto write = [&](int64_t count) {
+    std::vector<uint8_t> data(count * element_size);
+    for (uint8_t& byte : data) {
+      byte = next_write++;
+    }
+    queue.WriteN(data.data(), count);
+  };
+  auto read = [&](int64_t max_count, int64_t expected_count) {
+    std::vector<uint8_t> buffer(max_count * element_size);
+    EXPECT_EQ(queue.ReadN(buffer.data(), max_count), expected_count);
+    for (int64_t i = 0; i < expected_count * element_size; ++i) {
+      EXPECT_EQ(buffer[i], next_read++) << "byte " << i;
+    }
+  };
+
+  // The initial buffer holds eight 16-byte elements; advance the indices so
+  // the next bulk transfers wrap around its end.
+  write(5);
+  read(3, 3);
+  write(5);
+  EXPECT_EQ(queue.size(), 7);
+  read(10, 7);
+  EXPECT_EQ(queue.size(), 0);
+
+  // Fill the queue past its capacity with a wrapped read index so it has to
+  // grow in the middle of a bulk write.
+  write(6);
+  read(4, 4);
+  write(40);
+  EXPECT_EQ(queue.size(), 42);
+  read(42, 42);
+  EXPECT_EQ(queue.ReadN(nullptr, 0), 0);
+}
+
+TEST(ByteQueueTest, BulkAccessDense) {
+  // Elements a multiple of the slot alignment are stored densely and copied
+  // with memcpy.
+  TestByteQueueBulkAccess(alignof(std::max_align_t));
+}
+
+TEST(ByteQueueTest, BulkAccessPadded) {
+  // Narrower elements are padded out to their slot and copied one by one.
+  TestByteQueueBulkAccess(3);
+}
+
+TYPED_TEST(JitChannelQueueTest, BulkAccessWithGenerator) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+
+  TypeParam queue(elaboration.GetUniqueInstance(channel).value(),
+                  GetJitRuntime());
+
+  int64_t counter = 42;
+  XLS_ASSERT_OK(queue.AttachGenerator([&]() -> std::optional<Value> {
+    if (counter == 45) {
+      return std::nullopt;
+    }
+    return Value(UBits(counter++, 32));
+  }));
+
+  std::vector<uint32_t> recv_buffer(10);
+  EXPECT_EQ(queue.ReadRawBulk(absl::MakeSpan(
+                reinterpret_cast<uint8_t*>(recv_buffer.data()),
+                recv_buffer.size() * sizeof(uint32_t))),
+            3);
+  EXPECT_EQ(recv_buffer[0], 42);
+  EXPECT_EQ(recv_buffer[1], 43);
+  EXPECT_EQ(recv_buffer[2], 44);
+}
+
 TYPED_TEST(JitChannelQueueTest, IotaGeneratorWithRawApi) {
   Package package("test");
   XLS_ASSERT_OK_AND_ASSIGN(
@@ -52,6 +52,8 @@
 #include "xls/jit/llvm_compiler.h"
 #include "xls/jit/observer.h"
 #include "xls/jit/proc_jit.h"
+#include "xls/jit/type_layout.h"
+#include "xls/jit/type_layout.pb.h"
 
 namespace xls {
 namespace {
@@ -161,6 +163,25 @@ struct AotProcJitArgs {
   JitFunctionType unpacked;
   std::optional<JitFunctionType> packed;
 };
+
+// Registers the state and channel type layouts recorded in `entrypoint` with
+// `runtime`.
+absl::Status AddAotTypeLayouts(const AotEntrypointProto& entrypoint,
+                               Package* package, JitRuntime& runtime) {
+  for (const TypeLayoutProto& layout_proto :
+       entrypoint.inputs_layout().layouts()) {
+    XLS_ASSIGN_OR_RETURN(TypeLayout layout,
+                         TypeLayout::FromProto(layout_proto, package));
+    runtime.AddTypeLayout(std::move(layout));
+  }
+  for (const auto& [_, layout_proto] :
+       entrypoint.proc_metadata().channel_layouts()) {
+    XLS_ASSIGN_OR_RETURN(TypeLayout layout,
+                         TypeLayout::FromProto(layout_proto, package));
+    runtime.AddTypeLayout(std::move(layout));
+  }
+  return absl::OkStatus();
+}
 }  // namespace
 
 absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateAotRuntime(
@@ -205,12 +226,18 @@ absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateAotRuntime(
       llvm::DataLayout::parse(entrypoints.data_layout());
   XLS_RET_CHECK(layout) << "Unable to parse '" << entrypoints.data_layout()
                         << "' to an llvm data-layout.";
+  // Seed the runtime with the layouts recorded at compile time so that
+  // converting state and channel data never requires building LLVM types.
+  auto runtime = std::make_unique<JitRuntime>(*layout);
+  for (const auto& [_, jit_args] : procs_by_name) {
+    XLS_RETURN_IF_ERROR(AddAotTypeLayouts(jit_args.entrypoint,
+                                          elaboration.package(), *runtime));
+  }
   // Create a queue manager for the queues. This factory verifies that there an
   // receive only queue for every receive only channel.
-  XLS_ASSIGN_OR_RETURN(
-      std::unique_ptr<JitChannelQueueManager> queue_manager,
-      JitChannelQueueManager::CreateThreadSafe(
-          std::move(elaboration), std::make_unique<JitRuntime>(*layout)));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<JitChannelQueueManager> queue_manager,
+                       JitChannelQueueManager::CreateThreadSafe(
+                           std::move(elaboration), std::move(runtime)));
   // Create a ProcJit for each Proc.
   std::vector<std::unique_ptr<ProcEvaluator>> proc_jits;
   for (const auto& [_, jit_args] : procs_by_name) {
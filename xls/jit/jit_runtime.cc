@@ -20,6 +20,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
@@ -38,14 +39,43 @@
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
 #include "xls/jit/llvm_type_converter.h"
+#include "xls/jit/type_layout.h"
 
 namespace xls {
 
 JitRuntime::JitRuntime(llvm::DataLayout data_layout)
-    : data_layout_(data_layout),
-      context_(std::make_unique<llvm::LLVMContext>()),
-      type_converter_(
-          std::make_unique<LlvmTypeConverter>(context_.get(), data_layout_)) {}
+    : data_layout_(data_layout) {}
+
+void JitRuntime::AddTypeLayout(TypeLayout layout) {
+  absl::MutexLock lock(&mutex_);
+  const Type* type = layout.type();
+  type_layouts_.insert_or_assign(type, std::move(layout));
+}
+
+LlvmTypeConverter& JitRuntime::type_converter() {
+  if (type_converter_ == nullptr) {
+    context_ = std::make_unique<llvm::LLVMContext>();
+    type_converter_ =
+        std::make_unique<LlvmTypeConverter>(context_.get(), data_layout_);
+  }
+  return *type_converter_;
+}
+
+int64_t JitRuntime::GetTypeByteSizeInternal(const Type* type) {
+  auto it = type_layouts_.find(type);
+  if (it != type_layouts_.end()) {
+    return it->second.size();
+  }
+  return type_converter().GetTypeByteSize(type);
+}
+
+int64_t JitRuntime::GetTypeAlignmentInternal(const Type* type) {
+  auto it = type_layouts_.find(type);
+  if (it != type_layouts_.end() && it->second.alignment().has_value()) {
+    return *it->second.alignment();
+  }
+  return type_converter().GetTypePreferredAlignment(type);
+}
 
 absl::Status JitRuntime::PackArgs(absl::Span<const Value> args,
                                   absl::Span<Type* const> arg_types,
@@ -73,6 +103,9 @@ Value JitRuntime::UnpackBuffer(const uint8_t* buffer, const Type* result_type) {
 
 Value JitRuntime::UnpackBufferInternal(const uint8_t* buffer,
                                        const Type* result_type) {
+  if (auto it = type_layouts_.find(result_type); it != type_layouts_.end()) {
+    return it->second.NativeLayoutToValue(buffer);
+  }
   switch (result_type->kind()) {
     case TypeKind::kBits: {
       const BitsType* bits_type = result_type->AsBitsOrDie();
@@ -85,7 +118,7 @@ Value JitRuntime::UnpackBufferInternal(const uint8_t* buffer,
       // Just as with arg packing, we need the DataLayout to tell us where each
       // arg is placed in the output buffer.
       const TupleType* tuple_type = result_type->AsTupleOrDie();
-      llvm::Type* llvm_type = type_converter_->ConvertToLlvmType(tuple_type);
+      llvm::Type* llvm_type = type_converter().ConvertToLlvmType(tuple_type);
       const llvm::StructLayout* layout =
           data_layout_.getStructLayout(llvm::cast<llvm::StructType>(llvm_type));
 
@@ -106,7 +139,7 @@ Value JitRuntime::UnpackBufferInternal(const uint8_t* buffer,
 
       const Type* element_type = array_type->element_type();
       llvm::Type* llvm_element_type =
-          type_converter_->ConvertToLlvmType(array_type->element_type());
+          type_converter().ConvertToLlvmType(array_type->element_type());
       std::vector<Value> values;
       values.reserve(array_type->size());
       // This BitsType is only used inside the ToLlvmConstantCall() (and isn't
@@ -114,7 +147,7 @@ Value JitRuntime::UnpackBufferInternal(const uint8_t* buffer,
       BitsType bits_type(64);
       for (int i = 0; i < array_type->size(); ++i) {
         llvm::Constant* index =
-            type_converter_->ToLlvmConstant(&bits_type, Value(UBits(i, 64)))
+            type_converter().ToLlvmConstant(&bits_type, Value(UBits(i, 64)))
                 .value();
         int64_t offset =
             data_layout_.getIndexedOffsetInType(llvm_element_type, index);
@@ -136,7 +169,11 @@ void JitRuntime::BlitValueToBuffer(const Value& value, const Type* type,
   absl::MutexLock lock(&mutex_);
   // Zero the buffer before filling in values. This ensures all padding bytes
   // are cleared.
-  memset(buffer.data(), 0, type_converter_->GetTypeByteSize(type));
+  memset(buffer.data(), 0, GetTypeByteSizeInternal(type));
+  if (auto it = type_layouts_.find(type); it != type_layouts_.end()) {
+    it->second.ValueToNativeLayout(value, buffer.data());
+    return;
+  }
   BlitValueToBufferInternal(value, type, buffer);
 }
 
@@ -168,7 +205,7 @@ void JitRuntime::BlitValueToBufferInternal(const Value& value, const Type* type,
   } else if (value.IsArray()) {
     const ArrayType* array_type = type->AsArrayOrDie();
     int64_t element_size =
-        type_converter_->GetTypeByteSize(array_type->element_type());
+        type_converter().GetTypeByteSize(array_type->element_type());
     for (int i = 0; i < value.size(); ++i) {
       BlitValueToBufferInternal(value.element(i), array_type->element_type(),
                                 buffer);
@@ -179,7 +216,7 @@ void JitRuntime::BlitValueToBufferInternal(const Value& value, const Type* type,
     // load/store instructions), we need to make sure we blit args into LLVM
     // space as the underlying runtime expects, which means we need the
     // DataLayout to tell us where each constituent element should be placed.
-    llvm::Type* llvm_type = type_converter_->ConvertToLlvmType(type);
+    llvm::Type* llvm_type = type_converter().ConvertToLlvmType(type);
     const llvm::StructLayout* layout =
         data_layout_.getStructLayout(llvm::cast<llvm::StructType>(llvm_type));
 
@@ -20,6 +20,7 @@
 #include <memory>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
@@ -27,6 +28,7 @@
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
 #include "xls/jit/llvm_type_converter.h"
+#include "xls/jit/type_layout.h"
 
 namespace xls {
 
@@ -57,6 +59,14 @@ class JitRuntime {
 
   const llvm::DataLayout& data_layout() { return data_layout_; }
 
+  // Registers a precomputed native layout for values of type `layout.type()`.
+  // Conversions and size queries for that type then use the layout directly
+  // rather than deriving it from the LLVM type. AOT-compiled code records the
+  // layouts of its state and channel types so that a runtime driving it never
+  // needs to build LLVM types. `layout` must match the layout the compiled
+  // code was built with.
+  void AddTypeLayout(TypeLayout layout);
+
   // Returns the number of bytes that should be allocated for a native LLVM
   // value storing `size` bytes with `alignment` alignment.
   //
@@ -100,28 +110,45 @@ class JitRuntime {
 
   int64_t GetTypeByteSize(Type* xls_type) {
     absl::MutexLock lock(&mutex_);
-    return type_converter_->GetTypeByteSize(xls_type);
+    return GetTypeByteSizeInternal(xls_type);
   }
 
   int64_t GetTypeAlignment(Type* xls_type) {
     absl::MutexLock lock(&mutex_);
-    return type_converter_->GetTypePreferredAlignment(xls_type);
+    return GetTypeAlignmentInternal(xls_type);
+  }
+
+  // Returns true if the LLVM type converter (and its LLVM context) has been
+  // created, i.e. some query was not answered by a registered layout.
+  bool HasTypeConverterForTesting() const {
+    absl::MutexLock lock(&mutex_);
+    return type_converter_ != nullptr;
   }
 
   const llvm::DataLayout& data_layout() const { return data_layout_; }
 
  private:
   Value UnpackBufferInternal(const uint8_t* buffer, const Type* result_type)
-      ABSL_SHARED_LOCKS_REQUIRED(mutex_);
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   void BlitValueToBufferInternal(const Value& value, const Type* type,
                                  absl::Span<uint8_t> buffer)
-      ABSL_SHARED_LOCKS_REQUIRED(mutex_);
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  int64_t GetTypeByteSizeInternal(const Type* type)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  int64_t GetTypeAlignmentInternal(const Type* type)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns the type converter, creating it (and the LLVM context) on first
+  // use. Runtimes whose types all have registered layouts never create it.
+  LlvmTypeConverter& type_converter() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   mutable absl::Mutex mutex_;
 
   const llvm::DataLayout data_layout_;
   std::unique_ptr<llvm::LLVMContext> context_ ABSL_GUARDED_BY(mutex_);
   std::unique_ptr<LlvmTypeConverter> type_converter_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<const Type*, TypeLayout> type_layouts_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace xls
@@ -0,0 +1,107 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/jit_runtime.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/types/span.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+#include "xls/jit/orc_jit.h"
+#include "xls/jit/type_layout.h"
+
+namespace xls {
+namespace {
+
+class JitRuntimeTest : public IrTestBase {
+ protected:
+  std::unique_ptr<JitRuntime> CreateRuntime() {
+    std::unique_ptr<OrcJit> orc_jit = OrcJit::Create().value();
+    return std::make_unique<JitRuntime>(orc_jit->CreateDataLayout().value());
+  }
+};
+
+TEST_F(JitRuntimeTest, RoundTrip) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Type * type, Parser::ParseType("(bits[3], bits[17][2], ())",
+                                     package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(Value value,
+                           Parser::ParseTypedValue(
+                               "(bits[3]:5, [bits[17]:1, bits[17]:2], ())"));
+  std::unique_ptr<JitRuntime> runtime = CreateRuntime();
+  std::vector<uint8_t> buffer(runtime->GetTypeByteSize(type));
+  runtime->BlitValueToBuffer(value, type, absl::MakeSpan(buffer));
+  EXPECT_EQ(runtime->UnpackBuffer(buffer.data(), type), value);
+}
+
+TEST_F(JitRuntimeTest, RegisteredLayoutIsUsed) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Type * type, Parser::ParseType("(bits[8], bits[8])", package.get()));
+  std::unique_ptr<JitRuntime> runtime = CreateRuntime();
+  EXPECT_EQ(runtime->GetTypeByteSize(type), 2);
+
+  // Register a layout which spaces the elements out differently than the
+  // default layout would.
+  runtime->AddTypeLayout(TypeLayout(
+      type, /*size=*/16,
+      {ElementLayout{.offset = 0, .data_size = 1, .padded_size = 1},
+       ElementLayout{.offset = 8, .data_size = 1, .padded_size = 1}}));
+  EXPECT_EQ(runtime->GetTypeByteSize(type), 16);
+
+  Value value = Value::Tuple({Value(UBits(0xab, 8)), Value(UBits(0xcd, 8))});
+  std::vector<uint8_t> buffer(16, 0xff);
+  runtime->BlitValueToBuffer(value, type, absl::MakeSpan(buffer));
+  EXPECT_EQ(buffer[0], 0xab);
+  EXPECT_EQ(buffer[1], 0);
+  EXPECT_EQ(buffer[8], 0xcd);
+  EXPECT_EQ(runtime->UnpackBuffer(buffer.data(), type), value);
+}
+
+TEST_F(JitRuntimeTest, RegisteredLayoutsNeedNoTypeConverter) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Type * type, Parser::ParseType("(bits[8], bits[32])", package.get()));
+  std::unique_ptr<JitRuntime> runtime = CreateRuntime();
+  runtime->AddTypeLayout(TypeLayout(
+      type, /*size=*/8,
+      {ElementLayout{.offset = 0, .data_size = 1, .padded_size = 1},
+       ElementLayout{.offset = 4, .data_size = 4, .padded_size = 4}},
+      /*alignment=*/4));
+
+  EXPECT_EQ(runtime->GetTypeByteSize(type), 8);
+  EXPECT_EQ(runtime->GetTypeAlignment(type), 4);
+  Value value = Value::Tuple({Value(UBits(1, 8)), Value(UBits(2, 32))});
+  std::vector<uint8_t> buffer(8);
+  runtime->BlitValueToBuffer(value, type, absl::MakeSpan(buffer));
+  EXPECT_EQ(runtime->UnpackBuffer(buffer.data(), type), value);
+  EXPECT_FALSE(runtime->HasTypeConverterForTesting());
+
+  // A type with no registered layout falls back to building LLVM types.
+  EXPECT_EQ(runtime->GetTypeByteSize(package->GetBitsType(16)), 2);
+  EXPECT_TRUE(runtime->HasTypeConverterForTesting());
+}
+
+}  // namespace
+}  // namespace xls
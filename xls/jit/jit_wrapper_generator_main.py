@@ -148,6 +148,9 @@ class XlsChannel:
   packed_type: str
   unpacked_type: str
   specialized_type: Optional[str]
+  # C++ type with the same representation as the JIT's native layout of the
+  # channel type, if any. Used for batched transfers with no conversion.
+  native_type: Optional[str] = None
 
 
 @dataclasses.dataclass(frozen=True)
@@ -306,6 +309,30 @@ def to_specialized(
   return None
 
 
+def to_native(t: type_pb2.TypeProto) -> Optional[str]:
+  """Get the c++ type with the same representation as the JIT native layout.
+
+  Bits types are stored in the JIT as the next power-of-two number of bytes so
+  they match the unsigned integer types chosen by to_specialized. Arrays of such
+  types are stored densely. Floating point tuples are laid out as structs of
+  their components in the JIT so they do not match float/double.
+
+  Args:
+    t: The xls type
+
+  Returns:
+    the C++ type or None if no C++ type matches the native layout.
+  """
+  if t.type_enum == type_pb2.TypeProto.BITS:
+    return to_specialized(t)
+  if (
+      t.type_enum == type_pb2.TypeProto.ARRAY
+      and t.array_element.type_enum == type_pb2.TypeProto.BITS
+  ):
+    return to_specialized(t)
+  return None
+
+
 def to_chan(
     c: ir_interface_pb2.PackageInterfaceProto.Channel, package_name: str
 ) -> XlsChannel:
@@ -315,6 +342,7 @@ def to_chan(
       packed_type=to_packed(c.type),
       unpacked_type=to_unpacked(c.type),
       specialized_type=to_specialized(c.type),
+      native_type=to_native(c.type),
   )
 
 
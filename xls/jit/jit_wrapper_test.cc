@@ -17,12 +17,14 @@
 #include <cstdint>
 #include <optional>
 #include <string_view>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/algorithm/container.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/types/span.h"
 #include "xls/common/status/matchers.h"
 #include "xls/dslx/stdlib/float32_mul_jit_wrapper.h"
 #include "xls/dslx/stdlib/tests/float32_upcast_jit_wrapper.h"
@@ -205,6 +207,25 @@ TEST(JitWrapperTest, ProcTickUnitlBlocked) {
   EXPECT_THAT(jit->ReceiveFromStringOutput(), IsOkAndHolds(std::nullopt));
 }
 
+TEST(JitWrapperTest, ProcBatchSendReceive) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, examples::SomeCaps::Create());
+  std::vector<std::array<uint8_t, 8>> inputs = {
+      StrArray("abcdefgh"), StrArray("ijklmnop"), StrArray("qrstuvwx"),
+      StrArray("yz012345")};
+  XLS_ASSERT_OK(jit->SendBatchToStringInput(inputs));
+  XLS_ASSERT_OK(jit->TickUntilBlocked());
+  std::vector<std::array<uint8_t, 8>> outputs(10);
+  EXPECT_THAT(jit->ReceiveBatchFromStringOutput(absl::MakeSpan(outputs)),
+              IsOkAndHolds(4));
+  EXPECT_EQ(outputs[0], StrArray("ABCDEFGH"));
+  EXPECT_EQ(outputs[1], StrArray("ijklmnop"));
+  EXPECT_EQ(outputs[2], StrArray("QrStUvWx"));
+  EXPECT_EQ(outputs[3], StrArray("YZ012345"));
+  // No more data right now.
+  EXPECT_THAT(jit->ReceiveBatchFromStringOutput(absl::MakeSpan(outputs)),
+              IsOkAndHolds(0));
+}
+
 TEST(JitWrapperTest, ProcOptIrWrapper) {
   XLS_ASSERT_OK_AND_ASSIGN(auto jit, examples::SomeCapsOpt::Create());
   XLS_ASSERT_OK(
@@ -198,6 +198,44 @@ int64_t LlvmTypeConverter::AlignFor(const Type* type, int64_t offset) const {
   return llvm::alignTo(offset, alignment);
 }
 
+int64_t LlvmTypeConverter::GetLlvmVectorElementBitCount(
+    const ArrayType* type) const {
+  if (!type->element_type()->IsBits()) {
+    return 0;
+  }
+  int64_t element_bit_count =
+      GetLlvmBitCount(type->element_type()->AsBitsOrDie());
+  // Single-bit elements are represented as i1 which is bit-packed in LLVM
+  // vectors but byte-sized in LLVM arrays so the layouts differ.
+  if (element_bit_count < 8 || element_bit_count > 64) {
+    return 0;
+  }
+  return element_bit_count;
+}
+
+llvm::FixedVectorType* LlvmTypeConverter::GetArrayVectorType(
+    const Type* type) const {
+  if (!type->IsArray() || type->AsArrayOrDie()->size() == 0) {
+    return nullptr;
+  }
+  const ArrayType* array_type = type->AsArrayOrDie();
+  int64_t element_bit_count = GetLlvmVectorElementBitCount(array_type);
+  if (element_bit_count == 0) {
+    return nullptr;
+  }
+  return llvm::FixedVectorType::get(
+      llvm::IntegerType::get(context_, element_bit_count), array_type->size());
+}
+
+int64_t LlvmTypeConverter::GetArrayVectorLoadAlignment(
+    const ArrayType* type) const {
+  // Arrays nested within other types are not necessarily placed at offsets
+  // aligned beyond the natural alignment of the element type.
+  return data_layout_
+      .getABITypeAlign(ConvertToLlvmType(type->element_type()))
+      .value();
+}
+
 llvm::Type* LlvmTypeConverter::GetTokenType() const {
   return llvm::ArrayType::get(llvm::IntegerType::get(context_, 1), 0);
 }
@@ -304,7 +342,8 @@ void LlvmTypeConverter::ComputeElementLayouts(
 TypeLayout LlvmTypeConverter::CreateTypeLayout(Type* xls_type) {
   std::vector<ElementLayout> element_layouts;
   ComputeElementLayouts(xls_type, &element_layouts, /*offset=*/0);
-  return TypeLayout(xls_type, GetTypeByteSize(xls_type), element_layouts);
+  return TypeLayout(xls_type, GetTypeByteSize(xls_type), element_layouts,
+                    GetTypePreferredAlignment(xls_type));
 }
 
 }  // namespace xls
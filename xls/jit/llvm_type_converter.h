@@ -23,6 +23,7 @@
 #include "absl/status/statusor.h"
 #include "llvm/include/llvm/IR/Constant.h"
 #include "llvm/include/llvm/IR/DataLayout.h"
+#include "llvm/include/llvm/IR/DerivedTypes.h"
 #include "llvm/include/llvm/IR/IRBuilder.h"
 #include "llvm/include/llvm/IR/LLVMContext.h"
 #include "llvm/include/llvm/IR/Type.h"
@@ -86,6 +87,20 @@ class LlvmTypeConverter {
   // DataLayout object takes care of the details.
   int64_t AlignFor(const Type* type, int64_t offset) const;
 
+  // Returns the LLVM vector type which can be used to load, store, and operate
+  // on all of the elements of the given array type at once. Returns nullptr if
+  // the array is not amenable to vectorization: only arrays of bits types whose
+  // LLVM representation is a power-of-two number of bytes no wider than 64 bits
+  // are vectorizable. In memory, such an array has the same layout as the
+  // returned vector type, which has one lane per array element.
+  llvm::FixedVectorType* GetArrayVectorType(const Type* type) const;
+
+  // Returns the alignment which can be assumed when loading the vector type
+  // returned by GetArrayVectorType from a pointer to the given array type
+  // which is not necessarily a top-level buffer (e.g., an array nested in a
+  // tuple).
+  int64_t GetArrayVectorLoadAlignment(const ArrayType* type) const;
+
   // Returns a new Value representing the LLVM form of a Token.
   llvm::Value* GetToken() const;
 
@@ -160,6 +175,10 @@ class LlvmTypeConverter {
                              std::vector<ElementLayout>* layouts,
                              int64_t offset);
 
+  // Returns the bit width of the LLVM integer type used for the elements of the
+  // given array type if the array is vectorizable, otherwise returns zero.
+  int64_t GetLlvmVectorElementBitCount(const ArrayType* type) const;
+
   llvm::LLVMContext& context_;
   llvm::DataLayout data_layout_;
 };
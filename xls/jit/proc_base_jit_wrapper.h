@@ -37,6 +37,7 @@
 #include "xls/ir/nodes.h"
 #include "xls/ir/package.h"
 #include "xls/ir/proc.h"
+#include "xls/ir/type.h"
 #include "xls/ir/value.h"
 #include "xls/ir/xls_ir_interface.pb.h"
 #include "xls/jit/aot_entrypoint.pb.h"
@@ -157,6 +158,54 @@ class BaseProcJitWrapper {
     return queue->Read();
   }
 
+  // Add all of `values` onto the queue of things to be sent to the proc on the
+  // given channel. `T` must have the same representation as the native JIT
+  // layout of the channel's type (e.g., uint32_t for a bits[32] channel). The
+  // values are copied directly into the channel queue with no conversion
+  // through xls::Value. For bits-typed channels narrower than `T`, returns an
+  // error if any value does not fit in the channel's bit width.
+  template <typename T>
+    requires(std::is_trivially_copyable_v<T>)
+  absl::Status SendBatchToChannel(std::string_view chan_name,
+                                  absl::Span<const T> values) {
+    XLS_ASSIGN_OR_RETURN(JitChannelQueue * queue, GetJitQueue(chan_name));
+    XLS_RET_CHECK_EQ(sizeof(T), queue->element_size()) << absl::StrFormat(
+        "Type does not match the native layout of channel `%s`", chan_name);
+    if constexpr (std::is_integral_v<T>) {
+      Type* type = queue->channel()->type();
+      if (type->IsBits() && type->GetFlatBitCount() < 8 * sizeof(T)) {
+        int64_t bit_count = type->GetFlatBitCount();
+        for (T value : values) {
+          if ((static_cast<uint64_t>(value) >> bit_count) != 0) {
+            return absl::InvalidArgumentError(absl::StrFormat(
+                "Value %d does not fit in the %d bits of channel `%s`", value,
+                bit_count, chan_name));
+          }
+        }
+      }
+    }
+    queue->WriteRawBulk(absl::MakeConstSpan(
+        reinterpret_cast<const uint8_t*>(values.data()),
+        values.size() * sizeof(T)));
+    return absl::OkStatus();
+  }
+
+  // Remove the oldest elements in the channel's queue, writing them into
+  // `values` in order. At most `values.size()` elements are received. Returns
+  // the number of elements received. `T` must have the same representation as
+  // the native JIT layout of the channel's type.
+  template <typename T>
+    requires(std::is_trivially_copyable_v<T>)
+  absl::StatusOr<int64_t> ReceiveBatchFromChannel(std::string_view chan_name,
+                                                  absl::Span<T> values) {
+    XLS_ASSIGN_OR_RETURN(JitChannelQueue * queue, GetJitQueue(chan_name));
+    XLS_RET_CHECK_EQ(sizeof(T), queue->element_size()) << absl::StrFormat(
+        "Type does not match the native layout of channel `%s`", chan_name);
+    return queue->ReadRawBulk(
+        absl::MakeSpan(reinterpret_cast<uint8_t*>(values.data()),
+                       values.size() * sizeof(T)));
+  }
+
  protected:
   BaseProcJitWrapper(std::unique_ptr<Package> package, Proc* proc,
                      std::unique_ptr<ProcRuntime> runtime,
@@ -198,6 +247,12 @@ class BaseProcJitWrapper {
   JitRuntime& jit_runtime_;
 
  private:
+  absl::StatusOr<JitChannelQueue*> GetJitQueue(std::string_view chan_name) {
+    XLS_ASSIGN_OR_RETURN(auto* man, runtime_->GetJitChannelQueueManager());
+    XLS_ASSIGN_OR_RETURN(auto* queue, man->GetQueueByName(chan_name));
+    return &man->GetJitQueue(queue->channel_instance());
+  }
+
   std::tuple<std::unique_ptr<Package>, std::unique_ptr<ProcRuntime>>
   DoTakeRuntime() {
     return {std::move(package_), std::move(runtime_)};
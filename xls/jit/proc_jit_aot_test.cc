@@ -18,6 +18,7 @@
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -222,6 +223,40 @@ TEST_F(ProcJitAotTest, Tick) {
   EXPECT_THAT(chan_output->Read(), Optional(StrValue("YZ012345")));
 }
 
+// The runtime is seeded with the layouts recorded at compile time, so running
+// the network and moving data through its queues builds no LLVM types.
+TEST_F(ProcJitAotTest, NoLlvmTypeConverter) {
+  XLS_ASSERT_OK_AND_ASSIGN(AotPackageEntrypointsProto proto,
+                           GetCapsEntrypointsProto());
+  XLS_ASSERT_OK_AND_ASSIGN(auto gold_file, GetXlsRunfilePath(kCapsGoldIr));
+  XLS_ASSERT_OK_AND_ASSIGN(std::string pkg_text, GetFileContents(gold_file));
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackage(pkg_text, kCapsGoldIr));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * p0, p->GetProc("proc_0"));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * p1, p->GetProc("proc_1"));
+  PackageInterfaceProto::Proc p0_interface = ExtractProcInterface(p0);
+  PackageInterfaceProto::Proc p1_interface = ExtractProcInterface(p1);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto aot_runtime,
+      CreateAotSerialProcRuntime(
+          p.get(), proto,
+          {ProcAotEntrypoints{.proc_interface_proto = p0_interface,
+                              .unpacked = proc_0},
+           ProcAotEntrypoints{.proc_interface_proto = p1_interface,
+                              .unpacked = proc_1}}));
+  XLS_ASSERT_OK_AND_ASSIGN(JitChannelQueueManager * chan_man,
+                           aot_runtime->GetJitChannelQueueManager());
+  XLS_ASSERT_OK_AND_ASSIGN(ChannelQueue * chan_input,
+                           chan_man->GetQueueByName("chan_0"));
+  XLS_ASSERT_OK_AND_ASSIGN(ChannelQueue * chan_output,
+                           chan_man->GetQueueByName("chan_1"));
+  XLS_EXPECT_OK(chan_input->Write(StrValue("abcdefgh")));
+  XLS_EXPECT_OK(aot_runtime->Tick());
+  EXPECT_THAT(chan_output->Read(), Optional(StrValue("ABCDEFGH")));
+  std::vector<Value> state = aot_runtime->ResolveState(p0);
+  XLS_EXPECT_OK(aot_runtime->SetState(p0, state));
+  EXPECT_FALSE(chan_man->runtime().HasTypeConverterForTesting());
+}
+
 TEST_F(ProcJitAotTest, TickUntilBlocked) {
   XLS_ASSERT_OK_AND_ASSIGN(AotPackageEntrypointsProto proto,
                            GetCapsEntrypointsProto());
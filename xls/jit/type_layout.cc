@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -175,13 +176,20 @@ std::string TypeLayout::ToString() const {
                       .data_size = element_proto.data_size(),
                       .padded_size = element_proto.padded_size()});
   }
-  return TypeLayout(type, proto.size(), elements);
+  std::optional<int64_t> alignment;
+  if (proto.has_alignment()) {
+    alignment = proto.alignment();
+  }
+  return TypeLayout(type, proto.size(), elements, alignment);
 }
 
 TypeLayoutProto TypeLayout::ToProto() const {
   TypeLayoutProto proto;
   proto.set_type(type()->ToString());
   proto.set_size(size());
+  if (alignment_.has_value()) {
+    proto.set_alignment(*alignment_);
+  }
   for (const ElementLayout& element : elements_) {
     ElementLayoutProto* element_proto = proto.add_elements();
     element_proto->set_offset(element.offset);
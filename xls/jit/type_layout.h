@@ -16,6 +16,7 @@
 #define XLS_JIT_TYPE_LAYOUT_H_
 
 #include <cstdint>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -87,8 +88,12 @@ struct ElementLayout {
 class TypeLayout {
  public:
   explicit TypeLayout(Type* type, int64_t size,
-                      absl::Span<const ElementLayout> elements)
-      : type_(type), size_(size), elements_(elements.begin(), elements.end()) {
+                      absl::Span<const ElementLayout> elements,
+                      std::optional<int64_t> alignment = std::nullopt)
+      : type_(type),
+        size_(size),
+        alignment_(alignment),
+        elements_(elements.begin(), elements.end()) {
     CHECK_EQ(elements.size(), type->leaf_count());
   }
 
@@ -114,6 +119,9 @@ class TypeLayout {
   // Returns the number of bytes an instances of the type occupies.
   int64_t size() const { return size_; }
 
+  // Returns the preferred alignment in bytes of the type, if it was recorded.
+  std::optional<int64_t> alignment() const { return alignment_; }
+
   Type* type() const { return type_; }
 
   std::string ToString() const;
@@ -124,6 +132,7 @@ class TypeLayout {
 
   Type* type_;
   int64_t size_;
+  std::optional<int64_t> alignment_;
   std::vector<ElementLayout> elements_;
 };
 
@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <random>
 #include <string>
 #include <vector>
@@ -27,6 +28,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
+#include "llvm/include/llvm/IR/DerivedTypes.h"
 #include "xls/common/bits_util.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/status/matchers.h"
@@ -95,6 +97,7 @@ TEST_F(TypeLayoutTest, EmptyTuple) {
       TypeLayout copy, TypeLayout::FromProto(layout.ToProto(), package.get()));
   EXPECT_TRUE(copy.type() == layout.type());
   EXPECT_EQ(copy.size(), layout.size());
+  EXPECT_EQ(copy.alignment(), std::nullopt);
   EXPECT_TRUE(copy.elements().empty());
 }
 
@@ -268,7 +271,8 @@ TEST_F(TypeLayoutTest, SimpleTuple) {
       tuple, 6,
       {ElementLayout{.offset = 0, .data_size = 1, .padded_size = 1},
        ElementLayout{.offset = 2, .data_size = 2, .padded_size = 2},
-       ElementLayout{.offset = 4, .data_size = 2, .padded_size = 2}});
+       ElementLayout{.offset = 4, .data_size = 2, .padded_size = 2}},
+      /*alignment=*/2);
   EXPECT_EQ(layout.size(), 6);
   EXPECT_THAT(layout.mask(), ElementsAre(0x0F, 0x0, 0xFF, 0x7F, 0xFF, 0xFF));
   EXPECT_EQ(layout.elements().size(), 3);
@@ -288,7 +292,8 @@ TEST_F(TypeLayoutTest, SimpleArray) {
       array, 6,
       {ElementLayout{.offset = 0, .data_size = 2, .padded_size = 2},
        ElementLayout{.offset = 2, .data_size = 2, .padded_size = 2},
-       ElementLayout{.offset = 4, .data_size = 2, .padded_size = 2}});
+       ElementLayout{.offset = 4, .data_size = 2, .padded_size = 2}},
+      /*alignment=*/2);
   EXPECT_EQ(layout.size(), 6);
   EXPECT_THAT(layout.mask(), ElementsAre(0xFF, 0x01, 0xFF, 0x01, 0xFF, 0x01));
   EXPECT_EQ(layout.elements().size(), 3);
@@ -304,6 +309,7 @@ TEST_F(TypeLayoutTest, SimpleArray) {
       TypeLayout copy, TypeLayout::FromProto(layout.ToProto(), package.get()));
   EXPECT_TRUE(copy.type() == layout.type());
   EXPECT_EQ(copy.size(), layout.size());
+  EXPECT_EQ(copy.alignment(), 2);
   EXPECT_THAT(
       copy.elements(),
       ElementsAre(
@@ -312,6 +318,26 @@ TEST_F(TypeLayoutTest, SimpleArray) {
           ElementLayout{.offset = 4, .data_size = 2, .padded_size = 2}));
 }
 
+TEST_F(TypeLayoutTest, ArrayVectorType) {
+  auto package = CreatePackage();
+  std::unique_ptr<OrcJit> orc_jit = OrcJit::Create().value();
+  LlvmTypeConverter type_converter(orc_jit->GetContext(),
+                                   orc_jit->CreateDataLayout().value());
+  ArrayType* u16_array = package->GetArrayType(5, package->GetBitsType(16));
+  llvm::FixedVectorType* vector_type =
+      type_converter.GetArrayVectorType(u16_array);
+  ASSERT_NE(vector_type, nullptr);
+  EXPECT_EQ(vector_type->getNumElements(), 5);
+
+  // Arrays of single bits and of non-bits types are not vectorizable.
+  EXPECT_EQ(type_converter.GetArrayVectorType(
+                package->GetArrayType(3, package->GetBitsType(1))),
+            nullptr);
+  EXPECT_EQ(type_converter.GetArrayVectorType(package->GetArrayType(
+                3, package->GetTupleType({package->GetBitsType(32)}))),
+            nullptr);
+}
+
 TEST_F(TypeLayoutTest, JitTypes) {
   // Randomly test the layout of a bunch of types. TypeLayouts are generated by
   // the JIT and random xls::Values are round-tripped through the native layout.
@@ -0,0 +1,526 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/netlist/bit_parallel_interpreter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xls/common/parallel_for.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/netlist/cell_library.h"
+#include "xls/netlist/function_parser.h"
+#include "xls/netlist/netlist.h"
+
+namespace xls {
+namespace netlist {
+
+namespace {
+
+// Truth tables are built for statetable-defined signals of cells with at most
+// this many inputs.
+constexpr int64_t kMaxTruthTableInputs = 10;
+
+}  // namespace
+
+// Lowers the cells of a netlist module (and of the submodules it instantiates)
+// into the instruction stream of a BitParallelInterpreter.
+class BitParallelCompiler {
+ public:
+  using Instruction = BitParallelInterpreter::Instruction;
+  using Opcode = BitParallelInterpreter::Opcode;
+
+  BitParallelCompiler(const rtl::Netlist* netlist,
+                      BitParallelInterpreter* interpreter)
+      : netlist_(netlist), interpreter_(interpreter) {}
+
+  // Returns a new value slot.
+  int64_t AllocateSlot() { return interpreter_->slot_count_++; }
+
+  // Appends the instructions computing the nets of `module` given the slots
+  // holding its inputs (in the order of `module->inputs()`) and returns the
+  // slots holding its outputs (in the order of `module->outputs()`).
+  absl::StatusOr<std::vector<int64_t>> CompileModule(
+      const rtl::Module* module, absl::Span<const int64_t> input_slots);
+
+ private:
+  // The lowered function of one output pin of a cell library entry. Operands
+  // are local to the function: [0, input_count) are the entry's inputs in the
+  // order of `input_names()`, followed by zero, one and then temporaries.
+  struct PinFunction {
+    int64_t input_count;
+    int64_t temp_count = 0;
+    std::vector<Instruction> instructions;
+    int64_t result;
+
+    int64_t zero() const { return input_count; }
+    int64_t one() const { return input_count + 1; }
+
+    int64_t Emit(Opcode opcode, int64_t lhs, int64_t rhs = 0) {
+      int64_t dst = input_count + 2 + temp_count++;
+      instructions.push_back(
+          Instruction{.opcode = opcode, .dst = dst, .lhs = lhs, .rhs = rhs});
+      return dst;
+    }
+  };
+
+  absl::StatusOr<const PinFunction*> GetPinFunction(
+      const CellLibraryEntry* entry, const std::string& pin_name);
+  absl::StatusOr<int64_t> LowerAst(const CellLibraryEntry* entry,
+                                   const function::Ast& ast, PinFunction& f);
+  absl::StatusOr<int64_t> LowerStateTableSignal(const CellLibraryEntry* entry,
+                                                const std::string& signal,
+                                                PinFunction& f);
+  int64_t LowerTruthTable(absl::Span<const uint8_t> table,
+                          int64_t var_count, PinFunction& f);
+
+  // Appends the instructions computing the outputs of `cell` and returns the
+  // slot of each output net it drives.
+  absl::StatusOr<std::vector<std::pair<rtl::NetRef, int64_t>>> CompileCell(
+      const rtl::Module* module, const rtl::Cell* cell,
+      const absl::flat_hash_map<rtl::NetRef, int64_t>& slots);
+
+  const rtl::Netlist* netlist_;
+  BitParallelInterpreter* interpreter_;
+  absl::flat_hash_map<std::pair<const CellLibraryEntry*, std::string>,
+                      std::unique_ptr<PinFunction>>
+      pin_functions_;
+};
+
+absl::StatusOr<const BitParallelCompiler::PinFunction*>
+BitParallelCompiler::GetPinFunction(const CellLibraryEntry* entry,
+                                    const std::string& pin_name) {
+  auto key = std::make_pair(entry, pin_name);
+  if (auto it = pin_functions_.find(key); it != pin_functions_.end()) {
+    return it->second.get();
+  }
+  auto function_it = entry->output_pin_to_function().find(pin_name);
+  if (function_it == entry->output_pin_to_function().end()) {
+    return absl::NotFoundError(
+        absl::StrFormat("Output pin \"%s\" of cell \"%s\" has no function.",
+                        pin_name, entry->name()));
+  }
+  XLS_ASSIGN_OR_RETURN(function::Ast ast,
+                       function::Parser::ParseFunction(function_it->second));
+  auto f = std::make_unique<PinFunction>();
+  f->input_count = entry->input_names().size();
+  XLS_ASSIGN_OR_RETURN(f->result, LowerAst(entry, ast, *f));
+  return pin_functions_.emplace(key, std::move(f)).first->second.get();
+}
+
+absl::StatusOr<int64_t> BitParallelCompiler::LowerAst(
+    const CellLibraryEntry* entry, const function::Ast& ast, PinFunction& f) {
+  switch (ast.kind()) {
+    case function::Ast::Kind::kIdentifier: {
+      absl::Span<const std::string> input_names = entry->input_names();
+      auto it = std::find(input_names.begin(), input_names.end(), ast.name());
+      if (it != input_names.end()) {
+        return std::distance(input_names.begin(), it);
+      }
+      if (entry->state_table().has_value() &&
+          entry->state_table()->internal_signals().contains(ast.name())) {
+        return LowerStateTableSignal(entry, ast.name(), f);
+      }
+      return absl::NotFoundError(
+          absl::StrFormat("Identifier \"%s\" not found in cell %s's inputs "
+                          "or internal signals.",
+                          ast.name(), entry->name()));
+    }
+    case function::Ast::Kind::kLiteralZero:
+      return f.zero();
+    case function::Ast::Kind::kLiteralOne:
+      return f.one();
+    case function::Ast::Kind::kNot: {
+      XLS_ASSIGN_OR_RETURN(int64_t operand,
+                           LowerAst(entry, ast.children()[0], f));
+      if (operand == f.zero() || operand == f.one()) {
+        return operand == f.zero() ? f.one() : f.zero();
+      }
+      return f.Emit(Opcode::kNot, operand);
+    }
+    case function::Ast::Kind::kAnd:
+    case function::Ast::Kind::kOr:
+    case function::Ast::Kind::kXor: {
+      XLS_ASSIGN_OR_RETURN(int64_t lhs, LowerAst(entry, ast.children()[0], f));
+      XLS_ASSIGN_OR_RETURN(int64_t rhs, LowerAst(entry, ast.children()[1], f));
+      Opcode opcode = ast.kind() == function::Ast::Kind::kAnd ? Opcode::kAnd
+                      : ast.kind() == function::Ast::Kind::kOr
+                          ? Opcode::kOr
+                          : Opcode::kXor;
+      return f.Emit(opcode, lhs, rhs);
+    }
+  }
+  return absl::InvalidArgumentError(
+      absl::StrFormat("Unknown AST element type: %d",
+                      static_cast<int>(ast.kind())));
+}
+
+absl::StatusOr<int64_t> BitParallelCompiler::LowerStateTableSignal(
+    const CellLibraryEntry* entry, const std::string& signal, PinFunction& f) {
+  absl::Span<const std::string> input_names = entry->input_names();
+  if (input_names.size() > kMaxTruthTableInputs) {
+    return absl::UnimplementedError(absl::StrFormat(
+        "Cell \"%s\" has %d inputs; statetables of cells with more than %d "
+        "inputs are not supported in bit-parallel interpretation.",
+        entry->name(), input_names.size(), kMaxTruthTableInputs));
+  }
+  const StateTable& state_table = entry->state_table().value();
+  std::vector<uint8_t> table(int64_t{1} << input_names.size());
+  StateTable::InputStimulus stimulus;
+  for (int64_t row = 0; row < table.size(); ++row) {
+    for (int64_t i = 0; i < input_names.size(); ++i) {
+      stimulus[input_names[i]] = ((row >> i) & 1) == 1;
+    }
+    XLS_ASSIGN_OR_RETURN(bool value,
+                         state_table.GetSignalValue(stimulus, signal));
+    table[row] = value;
+  }
+  return LowerTruthTable(table, input_names.size(), f);
+}
+
+// Lowers the function with the given truth table (indexed by the values of
+// variables [0, var_count) as bits of the index) by Shannon expansion on the
+// highest variable.
+int64_t BitParallelCompiler::LowerTruthTable(absl::Span<const uint8_t> table,
+                                             int64_t var_count,
+                                             PinFunction& f) {
+  if (std::all_of(table.begin(), table.end(), [](uint8_t b) { return !b; })) {
+    return f.zero();
+  }
+  if (std::all_of(table.begin(), table.end(), [](uint8_t b) { return b; })) {
+    return f.one();
+  }
+  int64_t half = table.size() / 2;
+  absl::Span<const uint8_t> low = table.first(half);
+  absl::Span<const uint8_t> high = table.subspan(half);
+  if (low == high) {
+    return LowerTruthTable(low, var_count - 1, f);
+  }
+  int64_t var = var_count - 1;
+  int64_t r0 = LowerTruthTable(low, var_count - 1, f);
+  int64_t r1 = LowerTruthTable(high, var_count - 1, f);
+  if (r0 == f.zero() && r1 == f.one()) {
+    return var;
+  }
+  if (r0 == f.one() && r1 == f.zero()) {
+    return f.Emit(Opcode::kNot, var);
+  }
+  if (r0 == f.zero()) {
+    return f.Emit(Opcode::kAnd, var, r1);
+  }
+  if (r1 == f.one()) {
+    return f.Emit(Opcode::kOr, var, r0);
+  }
+  int64_t not_var = f.Emit(Opcode::kNot, var);
+  if (r1 == f.zero()) {
+    return f.Emit(Opcode::kAnd, not_var, r0);
+  }
+  if (r0 == f.one()) {
+    return f.Emit(Opcode::kOr, not_var, r1);
+  }
+  return f.Emit(Opcode::kOr, f.Emit(Opcode::kAnd, var, r1),
+                f.Emit(Opcode::kAnd, not_var, r0));
+}
+
+absl::StatusOr<std::vector<std::pair<rtl::NetRef, int64_t>>>
+BitParallelCompiler::CompileCell(
+    const rtl::Module* module, const rtl::Cell* cell,
+    const absl::flat_hash_map<rtl::NetRef, int64_t>& slots) {
+  const CellLibraryEntry* entry = cell->cell_library_entry();
+  std::vector<std::pair<rtl::NetRef, int64_t>> results;
+
+  std::optional<const rtl::Module*> submodule =
+      netlist_->MaybeGetModule(entry->name());
+  if (submodule.has_value()) {
+    // Inline the instantiated module, matching pins by name as in
+    // `Interpreter`.
+    const rtl::Module* child = submodule.value();
+    absl::Span<const std::string> child_input_names =
+        child->AsCellLibraryEntry()->input_names();
+    std::vector<int64_t> child_input_slots(child->inputs().size(), -1);
+    for (const rtl::Cell::Pin& input : cell->inputs()) {
+      auto it = std::find(child_input_names.begin(), child_input_names.end(),
+                          input.name);
+      XLS_RET_CHECK(it != child_input_names.end()) << absl::StrFormat(
+          "Could not find input pin \"%s\" in module \"%s\", referenced in "
+          "cell \"%s\"!",
+          input.name, child->name(), cell->name());
+      child_input_slots[std::distance(child_input_names.begin(), it)] =
+          slots.at(input.netref);
+    }
+    for (int64_t i = 0; i < child_input_slots.size(); ++i) {
+      XLS_RET_CHECK_NE(child_input_slots[i], -1) << absl::StrFormat(
+          "Input \"%s\" of module \"%s\" is not connected in cell \"%s\"",
+          child->inputs()[i]->name(), child->name(), cell->name());
+    }
+    XLS_ASSIGN_OR_RETURN(std::vector<int64_t> child_output_slots,
+                         CompileModule(child, child_input_slots));
+    for (int64_t i = 0; i < child->outputs().size(); ++i) {
+      for (const rtl::Cell::OutputPin& output : cell->outputs()) {
+        if (output.name == child->outputs()[i]->name()) {
+          results.push_back({output.netref, child_output_slots[i]});
+        }
+      }
+    }
+    return results;
+  }
+
+  absl::Span<const std::string> input_names = entry->input_names();
+  std::vector<int64_t> input_slots(input_names.size(), -1);
+  for (const rtl::Cell::Pin& input : cell->inputs()) {
+    auto it = std::find(input_names.begin(), input_names.end(), input.name);
+    XLS_RET_CHECK(it != input_names.end());
+    input_slots[std::distance(input_names.begin(), it)] =
+        slots.at(input.netref);
+  }
+
+  for (const rtl::Cell::OutputPin& output : cell->outputs()) {
+    if (output.netref == module->GetDummyRef()) {
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(const PinFunction* f,
+                         GetPinFunction(entry, output.name));
+    int64_t temp_base = interpreter_->slot_count_;
+    interpreter_->slot_count_ += f->temp_count;
+    auto to_slot = [&](int64_t operand) -> absl::StatusOr<int64_t> {
+      if (operand < f->input_count) {
+        XLS_RET_CHECK_NE(input_slots[operand], -1) << absl::StrFormat(
+            "Input pin \"%s\" of cell \"%s\" is not connected",
+            input_names[operand], cell->name());
+        return input_slots[operand];
+      }
+      if (operand == f->zero()) {
+        return BitParallelInterpreter::kZeroSlot;
+      }
+      if (operand == f->one()) {
+        return BitParallelInterpreter::kOneSlot;
+      }
+      return temp_base + operand - f->input_count - 2;
+    };
+    for (const Instruction& instruction : f->instructions) {
+      Instruction lowered = instruction;
+      XLS_ASSIGN_OR_RETURN(lowered.dst, to_slot(instruction.dst));
+      XLS_ASSIGN_OR_RETURN(lowered.lhs, to_slot(instruction.lhs));
+      if (instruction.opcode != Opcode::kNot) {
+        XLS_ASSIGN_OR_RETURN(lowered.rhs, to_slot(instruction.rhs));
+      }
+      interpreter_->instructions_.push_back(lowered);
+    }
+    XLS_ASSIGN_OR_RETURN(int64_t result_slot, to_slot(f->result));
+    results.push_back({output.netref, result_slot});
+  }
+  return results;
+}
+
+absl::StatusOr<std::vector<int64_t>> BitParallelCompiler::CompileModule(
+    const rtl::Module* module, absl::Span<const int64_t> input_slots) {
+  XLS_RET_CHECK_EQ(input_slots.size(), module->inputs().size());
+  absl::Span<rtl::Cell* const> cells = module->cells();
+
+  // Cells reading each net, and the number of input pins of each cell whose
+  // value is not yet known.
+  absl::flat_hash_map<rtl::NetRef, std::vector<int64_t>> users;
+  std::vector<int64_t> missing_inputs(cells.size());
+  std::deque<int64_t> ready_cells;
+  for (int64_t i = 0; i < cells.size(); ++i) {
+    for (const rtl::Cell::Pin& input : cells[i]->inputs()) {
+      users[input.netref].push_back(i);
+    }
+    missing_inputs[i] = cells[i]->inputs().size();
+    if (missing_inputs[i] == 0) {
+      ready_cells.push_back(i);
+    }
+  }
+  absl::flat_hash_map<rtl::NetRef, std::vector<rtl::NetRef>> assigned_from;
+  for (const auto& [lhs, rhs] : module->assigns()) {
+    assigned_from[rhs].push_back(lhs);
+  }
+
+  // Records the slot holding the value of `net` (and of every net assigned
+  // from it) and notes which cells became ready as a result.
+  absl::flat_hash_map<rtl::NetRef, int64_t> slots;
+  auto set_slot = [&](rtl::NetRef net, int64_t slot) {
+    std::vector<rtl::NetRef> worklist = {net};
+    while (!worklist.empty()) {
+      rtl::NetRef n = worklist.back();
+      worklist.pop_back();
+      if (!slots.emplace(n, slot).second) {
+        continue;
+      }
+      if (auto it = users.find(n); it != users.end()) {
+        for (int64_t cell_index : it->second) {
+          if (--missing_inputs[cell_index] == 0) {
+            ready_cells.push_back(cell_index);
+          }
+        }
+      }
+      if (auto it = assigned_from.find(n); it != assigned_from.end()) {
+        worklist.insert(worklist.end(), it->second.begin(), it->second.end());
+      }
+    }
+  };
+  set_slot(module->zero(), BitParallelInterpreter::kZeroSlot);
+  set_slot(module->one(), BitParallelInterpreter::kOneSlot);
+  for (int64_t i = 0; i < input_slots.size(); ++i) {
+    set_slot(module->inputs()[i], input_slots[i]);
+  }
+
+  while (!ready_cells.empty()) {
+    int64_t cell_index = ready_cells.front();
+    ready_cells.pop_front();
+    XLS_ASSIGN_OR_RETURN(
+        auto outputs, CompileCell(module, cells[cell_index], slots));
+    for (const auto& [net, slot] : outputs) {
+      set_slot(net, slot);
+    }
+  }
+
+  for (int64_t i = 0; i < cells.size(); ++i) {
+    if (missing_inputs[i] > 0) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Netlist contains unconnected subgraphs and cannot be translated. "
+          "Example: cell %s",
+          cells[i]->name()));
+    }
+  }
+
+  std::vector<int64_t> output_slots;
+  output_slots.reserve(module->outputs().size());
+  for (rtl::NetRef output : module->outputs()) {
+    auto it = slots.find(output);
+    if (it == slots.end()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Output \"%s\" of module \"%s\" is not driven.",
+                          output->name(), module->name()));
+    }
+    output_slots.push_back(it->second);
+  }
+  return output_slots;
+}
+
+/* static */ absl::StatusOr<BitParallelInterpreter>
+BitParallelInterpreter::Create(const rtl::Netlist* netlist,
+                               const rtl::Module* module) {
+  BitParallelInterpreter interpreter;
+  interpreter.module_ = module;
+  BitParallelCompiler compiler(netlist, &interpreter);
+  for (int64_t i = 0; i < module->inputs().size(); ++i) {
+    interpreter.input_slots_.push_back(compiler.AllocateSlot());
+  }
+  XLS_ASSIGN_OR_RETURN(
+      interpreter.output_slots_,
+      compiler.CompileModule(module, interpreter.input_slots_));
+  return interpreter;
+}
+
+void BitParallelInterpreter::Evaluate(Word* values) const {
+  for (const Instruction& instruction : instructions_) {
+    switch (instruction.opcode) {
+      case Opcode::kAnd:
+        values[instruction.dst] =
+            values[instruction.lhs] & values[instruction.rhs];
+        break;
+      case Opcode::kOr:
+        values[instruction.dst] =
+            values[instruction.lhs] | values[instruction.rhs];
+        break;
+      case Opcode::kXor:
+        values[instruction.dst] =
+            values[instruction.lhs] ^ values[instruction.rhs];
+        break;
+      case Opcode::kNot:
+        values[instruction.dst] = ~values[instruction.lhs];
+        break;
+    }
+  }
+}
+
+absl::StatusOr<std::vector<BitParallelInterpreter::Word>>
+BitParallelInterpreter::Run(absl::Span<const Word> inputs) const {
+  XLS_RET_CHECK_EQ(inputs.size(), input_slots_.size());
+  std::vector<Word> values(slot_count_);
+  values[kZeroSlot] = 0;
+  values[kOneSlot] = ~Word{0};
+  for (int64_t i = 0; i < inputs.size(); ++i) {
+    values[input_slots_[i]] = inputs[i];
+  }
+  Evaluate(values.data());
+  std::vector<Word> outputs;
+  outputs.reserve(output_slots_.size());
+  for (int64_t slot : output_slots_) {
+    outputs.push_back(values[slot]);
+  }
+  return outputs;
+}
+
+absl::StatusOr<std::vector<NetRef2Value>>
+BitParallelInterpreter::InterpretVectors(
+    absl::Span<const NetRef2Value> vectors, int64_t threads) const {
+  XLS_RET_CHECK_GE(threads, 1);
+  const std::vector<rtl::NetRef>& module_inputs = module_->inputs();
+  const std::vector<rtl::NetRef>& module_outputs = module_->outputs();
+  std::vector<NetRef2Value> results(vectors.size());
+  const int64_t word_count =
+      (vectors.size() + kVectorsPerWord - 1) / kVectorsPerWord;
+
+  // Words are independent of each other, so each is packed, evaluated and
+  // unpacked on its own; every word writes a disjoint range of `results`.
+  auto interpret_word = [&](int64_t word) -> absl::Status {
+    int64_t base = word * kVectorsPerWord;
+    int64_t count =
+        std::min<int64_t>(kVectorsPerWord, vectors.size() - base);
+    std::vector<Word> inputs(module_inputs.size(), 0);
+    for (int64_t v = 0; v < count; ++v) {
+      const NetRef2Value& vector = vectors[base + v];
+      for (int64_t i = 0; i < module_inputs.size(); ++i) {
+        auto it = vector.find(module_inputs[i]);
+        XLS_RET_CHECK(it != vector.end()) << absl::StrFormat(
+            "Vector %d has no value for input \"%s\"", base + v,
+            module_inputs[i]->name());
+        inputs[i] |= Word{it->second} << v;
+      }
+    }
+    XLS_ASSIGN_OR_RETURN(std::vector<Word> outputs, Run(inputs));
+    for (int64_t v = 0; v < count; ++v) {
+      NetRef2Value& result = results[base + v];
+      result.reserve(module_outputs.size());
+      for (int64_t i = 0; i < module_outputs.size(); ++i) {
+        result[module_outputs[i]] = ((outputs[i] >> v) & 1) == 1;
+      }
+    }
+    return absl::OkStatus();
+  };
+  std::vector<absl::Status> statuses(word_count);
+  ParallelFor(word_count, threads,
+              [&](int64_t word) { statuses[word] = interpret_word(word); });
+  for (absl::Status& status : statuses) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+  return results;
+}
+
+}  // namespace netlist
+}  // namespace xls
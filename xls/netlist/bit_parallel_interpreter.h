@@ -0,0 +1,104 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_NETLIST_BIT_PARALLEL_INTERPRETER_H_
+#define XLS_NETLIST_BIT_PARALLEL_INTERPRETER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/netlist/interpreter.h"
+#include "xls/netlist/netlist.h"
+
+namespace xls {
+namespace netlist {
+
+// Interprets a (combinational) netlist module on many independent input
+// vectors at once. Every net holds a 64-bit word in which bit `i` is the value
+// of the net for vector `i`, so each cell is evaluated for 64 vectors with a
+// handful of bitwise operations.
+//
+// Creation compiles the module once: instantiated submodules are flattened,
+// every net is given a dense index, cells are put in topological order and
+// each cell output function is lowered (once per cell library entry and pin)
+// to straight-line AND/OR/XOR/NOT instructions. Functions which read a
+// combinational "statetable" are lowered through their truth table. The
+// instructions are kept in the order they are emitted, which keeps each cell's
+// instructions together.
+//
+// As with `Interpreter`, cells are treated as combinational functions of their
+// inputs. Evaluation functions installed with `AddCellEvaluationFns` operate on
+// single bools and are ignored; the cell library functions are used instead.
+class BitParallelInterpreter {
+ public:
+  using Word = uint64_t;
+  static constexpr int64_t kVectorsPerWord = 64;
+
+  static absl::StatusOr<BitParallelInterpreter> Create(
+      const rtl::Netlist* netlist, const rtl::Module* module);
+
+  // Interprets the module for up to 64 input vectors. `inputs` holds one word
+  // per module input, in the order of `module->inputs()`; the result holds one
+  // word per module output, in the order of `module->outputs()`.
+  absl::StatusOr<std::vector<Word>> Run(absl::Span<const Word> inputs) const;
+
+  // Interprets the module for each of the given input mappings, 64 vectors at
+  // a time. Each element of `vectors` must provide a value for every module
+  // input; the result maps every module output to its value.
+  //
+  // If `threads` is greater than one, the words of 64 vectors are spread
+  // across that many threads.
+  absl::StatusOr<std::vector<NetRef2Value>> InterpretVectors(
+      absl::Span<const NetRef2Value> vectors, int64_t threads = 1) const;
+
+  // Number of compiled instructions evaluated per call to `Run`.
+  int64_t instruction_count() const { return instructions_.size(); }
+
+ private:
+  enum class Opcode : uint8_t { kAnd, kOr, kXor, kNot };
+
+  // Computes `values[dst] = values[lhs] <op> values[rhs]` (`rhs` is unused for
+  // kNot).
+  struct Instruction {
+    Opcode opcode;
+    int64_t dst;
+    int64_t lhs;
+    int64_t rhs;
+  };
+
+  // Value slots 0 and 1 always hold all-zeros and all-ones respectively.
+  static constexpr int64_t kZeroSlot = 0;
+  static constexpr int64_t kOneSlot = 1;
+
+  friend class BitParallelCompiler;
+
+  BitParallelInterpreter() = default;
+
+  // Evaluates all instructions on `values`.
+  void Evaluate(Word* values) const;
+
+  const rtl::Module* module_ = nullptr;
+  int64_t slot_count_ = 2;
+  std::vector<Instruction> instructions_;
+  std::vector<int64_t> input_slots_;
+  std::vector<int64_t> output_slots_;
+};
+
+}  // namespace netlist
+}  // namespace xls
+
+#endif  // XLS_NETLIST_BIT_PARALLEL_INTERPRETER_H_
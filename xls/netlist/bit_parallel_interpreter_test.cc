@@ -0,0 +1,220 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/netlist/bit_parallel_interpreter.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/matchers.h"
+#include "xls/netlist/cell_library.h"
+#include "xls/netlist/fake_cell_library.h"
+#include "xls/netlist/interpreter.h"
+#include "xls/netlist/netlist.h"
+#include "xls/netlist/netlist_parser.h"
+
+namespace xls {
+namespace netlist {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+constexpr char kSubmodules[] = R"(
+module submodule_0 (i2_0, i2_1, o2_0);
+  input i2_0, i2_1;
+  output o2_0;
+
+  AND and0( .A(i2_0), .B(i2_1), .Z(o2_0) );
+endmodule
+
+module submodule_1 (i2_2, i2_3, o2_1);
+  input i2_2, i2_3;
+  output o2_1;
+
+  OR or0( .A(i2_2), .B(i2_3), .Z(o2_1) );
+endmodule
+
+module main (i0, i1, i2, i3, o0, o1);
+  input i0, i1, i2, i3;
+  output o0, o1;
+  wire res0, res1, res2;
+
+  submodule_0 and0 ( .i2_0(i0), .i2_1(i1), .o2_0(res0) );
+  submodule_1 or0 ( .i2_2(i2), .i2_3(i3), .o2_1(res1) );
+  XOR xor0 ( .A(res0), .B(res1), .Z(res2) );
+  STATETABLE_AND and1 ( .A(res2), .B(i3), .Z(o0) );
+  AOI21 aoi0 ( .A(i0), .B(res2), .C(i2), .ZN(o1) );
+endmodule
+)";
+
+class BitParallelInterpreterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    XLS_ASSERT_OK_AND_ASSIGN(cell_library_, MakeFakeCellLibrary());
+  }
+
+  absl::StatusOr<std::unique_ptr<rtl::Netlist>> Parse(
+      const std::string& text) {
+    rtl::Scanner scanner(text);
+    return rtl::Parser::ParseNetlist(&cell_library_, &scanner);
+  }
+
+  CellLibrary cell_library_;
+};
+
+TEST_F(BitParallelInterpreterTest, MatchesInterpreterOnAllInputs) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<rtl::Netlist> netlist,
+                           Parse(kSubmodules));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      BitParallelInterpreter bit_parallel,
+      BitParallelInterpreter::Create(netlist.get(), module));
+
+  std::vector<NetRef2Value> vectors;
+  for (int64_t v = 0; v < 16; ++v) {
+    NetRef2Value& inputs = vectors.emplace_back();
+    for (int64_t i = 0; i < 4; ++i) {
+      inputs[module->inputs()[i]] = ((v >> i) & 1) == 1;
+    }
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<NetRef2Value> results,
+                           bit_parallel.InterpretVectors(vectors));
+
+  Interpreter interpreter(netlist.get());
+  ASSERT_EQ(results.size(), vectors.size());
+  for (int64_t v = 0; v < vectors.size(); ++v) {
+    XLS_ASSERT_OK_AND_ASSIGN(NetRef2Value expected,
+                             interpreter.InterpretModule(module, vectors[v]));
+    EXPECT_EQ(results[v], expected) << "vector " << v;
+  }
+}
+
+TEST_F(BitParallelInterpreterTest, ManyRandomVectors) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<rtl::Netlist> netlist,
+                           Parse(kSubmodules));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      BitParallelInterpreter bit_parallel,
+      BitParallelInterpreter::Create(netlist.get(), module));
+
+  // Enough vectors to span several words, with a partially filled last word.
+  std::mt19937_64 rng(42);
+  std::vector<NetRef2Value> vectors(1000);
+  for (NetRef2Value& inputs : vectors) {
+    for (rtl::NetRef input : module->inputs()) {
+      inputs[input] = (rng() & 1) == 1;
+    }
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<NetRef2Value> results,
+                           bit_parallel.InterpretVectors(vectors));
+
+  Interpreter interpreter(netlist.get());
+  for (int64_t v = 0; v < vectors.size(); ++v) {
+    XLS_ASSERT_OK_AND_ASSIGN(NetRef2Value expected,
+                             interpreter.InterpretModule(module, vectors[v]));
+    EXPECT_EQ(results[v], expected) << "vector " << v;
+  }
+}
+
+TEST_F(BitParallelInterpreterTest, RunOnWords) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<rtl::Netlist> netlist, Parse(R"(
+module main (a, b, c, o0, o1, o2);
+  input a, b, c;
+  output o0, o1, o2;
+  wire x;
+
+  XOR xor0 ( .A(a), .B(b), .Z(x) );
+  NAND nand0 ( .A(x), .B(c), .ZN(o0) );
+  assign o1 = x;
+  assign o2 = 1'b1;
+endmodule
+)"));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      BitParallelInterpreter bit_parallel,
+      BitParallelInterpreter::Create(netlist.get(), module));
+
+  uint64_t a = 0xff00ff00ff00ff00;
+  uint64_t b = 0xf0f0f0f0f0f0f0f0;
+  uint64_t c = 0xcccccccccccccccc;
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<uint64_t> outputs,
+                           bit_parallel.Run({a, b, c}));
+  EXPECT_THAT(outputs, ElementsAre(~((a ^ b) & c), a ^ b, ~uint64_t{0}));
+}
+
+TEST_F(BitParallelInterpreterTest, ThreadedInterpretVectorsMatchesSerial) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<rtl::Netlist> netlist,
+                           Parse(kSubmodules));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      BitParallelInterpreter bit_parallel,
+      BitParallelInterpreter::Create(netlist.get(), module));
+
+  std::mt19937_64 rng(42);
+  std::vector<NetRef2Value> vectors(1000);
+  for (NetRef2Value& inputs : vectors) {
+    for (rtl::NetRef input : module->inputs()) {
+      inputs[input] = (rng() & 1) == 1;
+    }
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<NetRef2Value> serial,
+                           bit_parallel.InterpretVectors(vectors));
+  for (int64_t threads : {2, 3, 8}) {
+    EXPECT_THAT(bit_parallel.InterpretVectors(vectors, threads),
+                IsOkAndHolds(serial))
+        << threads << " threads";
+  }
+
+  // An incomplete vector in a later word is still reported.
+  vectors[700].erase(module->inputs()[0]);
+  EXPECT_THAT(bit_parallel.InterpretVectors(vectors, /*threads=*/4),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("Vector 700 has no value for input")));
+}
+
+TEST_F(BitParallelInterpreterTest, UnconnectedCell) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<rtl::Netlist> netlist, Parse(R"(
+module main (a, o);
+  input a;
+  output o;
+  wire floating;
+
+  AND and0 ( .A(a), .B(floating), .Z(o) );
+endmodule
+)"));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  EXPECT_THAT(BitParallelInterpreter::Create(netlist.get(), module),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("unconnected subgraphs")));
+}
+
+}  // namespace
+}  // namespace netlist
+}  // namespace xls
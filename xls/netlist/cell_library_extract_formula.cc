@@ -73,7 +73,7 @@ absl::Status DumpOutputPinExpressions(std::string_view cell_name,
 absl::Status RealMain(std::string_view path, std::string_view cell_name,
                       bool stream_from_file) {
   // Either make a char stream that loads the file entirely into memory or
-  // streams it from disk. Since these files can get quite large this can be
+  // maps it from disk. Since these files can get quite large this can be
   // useful.
   std::function<absl::StatusOr<CharStream>()> make_cs;
   std::optional<std::string> text;
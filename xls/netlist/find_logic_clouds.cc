@@ -66,8 +66,7 @@ std::vector<Cluster> FindLogicClouds(const Module& module,
     return cell_to_uf.GetRepresentatives().size();
   };
 
-  for (auto& item : module.cells()) {
-    Cell* cell = item.get();
+  for (Cell* cell : module.cells()) {
     VLOG(4) << "Considering cell: " << cell->name();
 
     // Flop output connectivity is excluded from the equivalence class, so we
@@ -123,8 +122,7 @@ std::vector<Cluster> FindLogicClouds(const Module& module,
   // Run through the cells and put them into clusters according to their
   // equivalence classes.
   absl::flat_hash_map<Cell*, Cluster> equivalence_set_to_cluster;
-  for (auto& item : module.cells()) {
-    Cell* cell = item.get();
+  for (Cell* cell : module.cells()) {
     equivalence_set_to_cluster[get_uf(cell)].Add(cell);
   }
 
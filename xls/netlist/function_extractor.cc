@@ -14,10 +14,17 @@
 
 #include "xls/netlist/function_extractor.h"
 
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <system_error>  // NOLINT
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -26,9 +33,12 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_split.h"
 #include "absl/types/variant.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/error_code_to_status.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/netlist/lib_parser.h"
@@ -43,6 +53,7 @@ constexpr const char kDirectionKey[] = "direction";
 constexpr const char kFunctionKey[] = "function";
 constexpr const char kNextStateKey[] = "next_state";
 constexpr const char kStateFunctionKey[] = "state_function";
+constexpr const char kTableKey[] = "table";
 constexpr const char kInputValue[] = "input";
 constexpr const char kOutputValue[] = "output";
 constexpr const char kPinKind[] = "pin";
@@ -274,15 +285,45 @@ absl::Status ExtractFromCell(const cell_lib::Block& cell,
   return absl::OkStatus();
 }
 
+// Bump when a change to the extraction would change its result for a given
+// Liberty file, so stale caches are ignored.
+constexpr int64_t kCacheVersion = 1;
+
+// Identifies a version of a Liberty file for ExtractFunctionsCached.
+struct LibraryFileStamp {
+  int64_t size;
+  int64_t mtime_ns;
+};
+
+absl::StatusOr<LibraryFileStamp> GetLibraryFileStamp(
+    const std::filesystem::path& path) {
+  std::error_code ec;
+  uintmax_t size = std::filesystem::file_size(path, ec);
+  XLS_RETURN_IF_ERROR(ErrorCodeToStatus(ec)) << "for " << path;
+  std::filesystem::file_time_type mtime =
+      std::filesystem::last_write_time(path, ec);
+  XLS_RETURN_IF_ERROR(ErrorCodeToStatus(ec)) << "for " << path;
+  return LibraryFileStamp{
+      .size = static_cast<int64_t>(size),
+      .mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      mtime.time_since_epoch())
+                      .count()};
+}
+
 }  // namespace
 
 absl::StatusOr<CellLibraryProto> ExtractFunctions(
     cell_lib::CharStream* stream) {
   cell_lib::Scanner scanner(stream);
+  // Only these blocks and attributes are read below; everything else (timing,
+  // power, etc., the bulk of a real library) is parsed but not retained.
   absl::flat_hash_set<std::string> kind_allowlist(
-      {"library", "cell", "pin", "direction", "function", "ff", "next_state",
-       "statetable"});
-  cell_lib::Parser parser(&scanner);
+      {"library", "cell", "pin", "ff", "statetable"});
+  absl::flat_hash_set<std::string> attribute_allowlist(
+      {kDirectionKey, kFunctionKey, kNextStateKey, kStateFunctionKey,
+       kTableKey});
+  cell_lib::Parser parser(&scanner, std::move(kind_allowlist),
+                          std::move(attribute_allowlist));
 
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<cell_lib::Block> block,
                        parser.ParseLibrary());
@@ -300,6 +341,49 @@ absl::StatusOr<CellLibraryProto> ExtractFunctions(
   return proto;
 }
 
+absl::StatusOr<CellLibraryProto> ExtractFunctionsFromFile(
+    const std::filesystem::path& path) {
+  XLS_ASSIGN_OR_RETURN(cell_lib::CharStream stream,
+                       cell_lib::CharStream::FromPath(path.string()));
+  return ExtractFunctions(&stream);
+}
+
+absl::StatusOr<CellLibraryProto> ExtractFunctionsCached(
+    const std::filesystem::path& path,
+    const std::filesystem::path& cache_path) {
+  XLS_ASSIGN_OR_RETURN(LibraryFileStamp stamp, GetLibraryFileStamp(path));
+  CellLibraryCacheProto cache;
+  if (ParseProtobinFile(cache_path, &cache).ok() &&
+      cache.version() == kCacheVersion && cache.source_size() == stamp.size &&
+      cache.source_mtime_ns() == stamp.mtime_ns) {
+    return std::move(*cache.mutable_library());
+  }
+
+  XLS_ASSIGN_OR_RETURN(CellLibraryProto proto, ExtractFunctionsFromFile(path));
+  cache.Clear();
+  cache.set_version(kCacheVersion);
+  cache.set_source_size(stamp.size);
+  cache.set_source_mtime_ns(stamp.mtime_ns);
+  *cache.mutable_library() = proto;
+  // Write to a temporary file and rename it so that concurrent readers never
+  // observe a partially written cache.
+  std::filesystem::path temp_path =
+      absl::StrCat(cache_path.string(), ".", getpid(), ".tmp");
+  absl::Status written = SetProtobinFile(temp_path, cache);
+  if (written.ok()) {
+    std::error_code ec;
+    std::filesystem::rename(temp_path, cache_path, ec);
+    written = ErrorCodeToStatus(ec);
+  }
+  if (!written.ok()) {
+    LOG(WARNING) << "Could not write cell library cache " << cache_path << ": "
+                 << written;
+    std::error_code ec;
+    std::filesystem::remove(temp_path, ec);
+  }
+  return proto;
+}
+
 }  // namespace function
 }  // namespace netlist
 }  // namespace xls
@@ -15,6 +15,7 @@
 #ifndef XLS_NETLIST_FUNCTION_EXTRACTOR_H_
 #define XLS_NETLIST_FUNCTION_EXTRACTOR_H_
 
+#include <filesystem>  // NOLINT
 
 #include "absl/status/statusor.h"
 #include "xls/netlist/lib_parser.h"
@@ -30,6 +31,18 @@ namespace function {
 // logical operation of the cell or pin (in the case of multiple output pins).
 absl::StatusOr<CellLibraryProto> ExtractFunctions(cell_lib::CharStream* stream);
 
+// As above, for the Liberty file at `path`.
+absl::StatusOr<CellLibraryProto> ExtractFunctionsFromFile(
+    const std::filesystem::path& path);
+
+// As above, but keeps a binary cache of the result at `cache_path`. If the
+// cache was written for the current version of the Liberty file (judged by
+// its size and modification time) it is returned without parsing the file;
+// otherwise the functions are extracted and the cache is rewritten. Failing to
+// write the cache is not an error.
+absl::StatusOr<CellLibraryProto> ExtractFunctionsCached(
+    const std::filesystem::path& path, const std::filesystem::path& cache_path);
+
 }  // namespace function
 }  // namespace netlist
 }  // namespace xls
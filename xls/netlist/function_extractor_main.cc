@@ -27,7 +27,6 @@
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/netlist/function_extractor.h"
-#include "xls/netlist/lib_parser.h"
 #include "xls/netlist/netlist.pb.h"
 
 ABSL_FLAG(std::string, cell_library, "", "Cell library to preprocess.");
@@ -41,13 +40,9 @@ namespace xls::netlist::function {
 static absl::Status RealMain(const std::string& cell_library_path,
                              const std::string& output_path,
                              bool output_textproto) {
-  XLS_ASSIGN_OR_RETURN(std::string cell_library_text,
-                       GetFileContents(cell_library_path));
   XLS_ASSIGN_OR_RETURN(
-      auto char_stream,
-      netlist::cell_lib::CharStream::FromText(cell_library_text));
-  XLS_ASSIGN_OR_RETURN(netlist::CellLibraryProto lib_proto,
-                       netlist::function::ExtractFunctions(&char_stream));
+      netlist::CellLibraryProto lib_proto,
+      netlist::function::ExtractFunctionsFromFile(cell_library_path));
 
   if (output_textproto) {
     std::string output;
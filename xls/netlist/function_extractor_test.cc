@@ -14,10 +14,15 @@
 
 #include "xls/netlist/function_extractor.h"
 
+#include <filesystem>  // NOLINT
 #include <string>
+#include <string_view>
 
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_replace.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
 #include "xls/common/status/matchers.h"
 #include "xls/netlist/lib_parser.h"
 #include "xls/netlist/netlist.pb.h"
@@ -217,6 +222,55 @@ library (simple_statetable_cells) {
   EXPECT_EQ(row.next_internal_signals().at("X"), STATE_TABLE_SIGNAL_HIGH);
 }
 
+TEST(FunctionExtractorTest, CachedExtraction) {
+  constexpr std::string_view kLib = R"(
+library (blah) {
+  cell (cell_1) {
+    pin (i0) {
+      direction: input;
+    }
+    pin (o) {
+      direction: output;
+      function: "!i0";
+    }
+  }
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path lib_path = temp_dir.path() / "blah.lib";
+  std::filesystem::path cache_path = temp_dir.path() / "blah.lib.cache";
+  XLS_ASSERT_OK(SetFileContents(lib_path, kLib));
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryProto extracted,
+                           ExtractFunctionsFromFile(lib_path));
+  ASSERT_EQ(extracted.entries_size(), 1);
+  EXPECT_EQ(extracted.entries(0).output_pin_list().pins(0).function(), "!i0");
+
+  // The first cached extraction writes the cache.
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryProto proto,
+                           ExtractFunctionsCached(lib_path, cache_path));
+  EXPECT_EQ(proto.SerializeAsString(), extracted.SerializeAsString());
+  CellLibraryCacheProto cache;
+  XLS_ASSERT_OK(ParseProtobinFile(cache_path, &cache));
+  EXPECT_EQ(cache.library().SerializeAsString(), extracted.SerializeAsString());
+
+  // While the library is unchanged the cache is used as is, which is observable
+  // by tampering with it.
+  cache.mutable_library()->mutable_entries(0)->set_name("cached_cell");
+  XLS_ASSERT_OK(SetProtobinFile(cache_path, cache));
+  XLS_ASSERT_OK_AND_ASSIGN(proto, ExtractFunctionsCached(lib_path, cache_path));
+  EXPECT_EQ(proto.entries(0).name(), "cached_cell");
+
+  // Changing the library invalidates the cache. The size changes too, since
+  // the modification time may not change within the filesystem's resolution.
+  XLS_ASSERT_OK(SetFileContents(
+      lib_path, absl::StrReplaceAll(kLib, {{"cell_1", "renamed_cell"}})));
+  XLS_ASSERT_OK_AND_ASSIGN(proto, ExtractFunctionsCached(lib_path, cache_path));
+  EXPECT_EQ(proto.entries(0).name(), "renamed_cell");
+  XLS_ASSERT_OK(ParseProtobinFile(cache_path, &cache));
+  EXPECT_EQ(cache.library().entries(0).name(), "renamed_cell");
+}
+
 }  // namespace
 }  // namespace function
 }  // namespace netlist
@@ -258,18 +258,18 @@ AbstractInterpreter<EvalT>::InterpretModule(
                                                  dump_cells.end());
 
   // First, populate the unsatisfied cell list.
-  for (const auto& cell : module->cells()) {
+  for (rtl::AbstractCell<EvalT>* cell : module->cells()) {
     // if a cell has no inputs, it's active, so process it now.
     auto pcs = std::make_unique<ProcessedCellState>();
     if (cell->inputs().empty()) {
       XLS_ASSIGN_OR_RETURN(AbstractNetRef2Value<EvalT> results,
-                           InterpretCell(cell.get(), {}));
-      processed_cells[cell.get()] = std::move(pcs);
+                           InterpretCell(cell, {}));
+      processed_cells[cell] = std::move(pcs);
       UpdateProcessedState(processed_cells, active_wires, outputs, module,
-                           dump_cell_set, cell.get(), results);
+                           dump_cell_set, cell, results);
     } else {
       pcs->missing_wires = cell->inputs().size();
-      processed_cells[cell.get()] = std::move(pcs);
+      processed_cells[cell] = std::move(pcs);
     }
   }
 
@@ -355,8 +355,8 @@ AbstractInterpreter<EvalT>::InterpretModule(
 
   // Soundness check that we've processed all cells (i.e., that there aren't
   // unsatisfiable cells).
-  for (const auto& cell : module->cells()) {
-    if (processed_cells[cell.get()]->missing_wires > 0) {
+  for (rtl::AbstractCell<EvalT>* cell : module->cells()) {
+    if (processed_cells[cell]->missing_wires > 0) {
       return absl::InvalidArgumentError(absl::StrFormat(
           "Netlist contains unconnected subgraphs and cannot be translated. "
           "Example: cell %s",
@@ -14,9 +14,9 @@
 
 #include "xls/netlist/lib_parser.h"
 
-#include <cctype>
+#include <algorithm>
 #include <cstdint>
-#include <fstream>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <string>
@@ -29,10 +29,12 @@
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/variant.h"
+#include "xls/common/file/mapped_file.h"
 #include "xls/common/status/status_macros.h"
 
 namespace xls {
@@ -41,16 +43,50 @@ namespace cell_lib {
 
 /* static */ absl::StatusOr<CharStream> CharStream::FromPath(
     std::string_view path) {
-  std::ifstream file_stream{std::string(path)};
-  if (file_stream.is_open()) {
-    return CharStream(std::move(file_stream));
+  absl::StatusOr<MappedFile> file = MappedFile::Open(path);
+  if (!file.ok()) {
+    return absl::NotFoundError(absl::StrCat(
+        "Could not open file at path: ", path, ": ", file.status().message()));
   }
-  return absl::NotFoundError(
-      absl::StrCat("Could not open file at path: ", path));
+  return CharStream(std::move(file).value(), /*text=*/"");
 }
 
 /* static */ absl::StatusOr<CharStream> CharStream::FromText(std::string text) {
-  return CharStream(std::move(text));
+  return CharStream(/*file=*/std::nullopt, std::move(text));
+}
+
+CharStream::CharStream(CharStream&& other)
+    : pos_(other.pos_),
+      file_(std::move(other.file_)),
+      text_(std::move(other.text_)),
+      cursor_(other.cursor_) {
+  // Moving a short string moves its characters, so the view is re-pointed.
+  contents_ = file_.has_value() ? file_->contents() : text_;
+}
+
+std::string_view CharStream::PopChars(int64_t count) {
+  DCHECK_LE(cursor_ + count, contents_.size());
+  std::string_view popped = contents_.substr(cursor_, count);
+  cursor_ += count;
+  size_t last_newline = popped.rfind('\n');
+  if (last_newline == std::string_view::npos) {
+    pos_.colno += count;
+  } else {
+    pos_.lineno += std::count(popped.begin(), popped.end(), '\n');
+    pos_.colno = popped.size() - last_newline - 1;
+  }
+  return popped;
+}
+
+bool CharStream::DropThrough(std::string_view terminator) {
+  std::string_view remaining = Remaining();
+  size_t found = remaining.find(terminator);
+  if (found == std::string_view::npos) {
+    PopChars(remaining.size());
+    return false;
+  }
+  PopChars(found + terminator.size());
+  return true;
 }
 
 std::string TokenKindToString(TokenKind kind) {
@@ -82,52 +118,42 @@ std::string TokenKindToString(TokenKind kind) {
 absl::StatusOr<Token> Scanner::ScanIdentifier() {
   const Pos start_pos = cs_->GetPos();
   CHECK(IsIdentifierStart(cs_->PeekCharOrDie()));
-  absl::InlinedVector<char, 16> chars;
-  while (!cs_->AtEof() && IsIdentifierRest(cs_->PeekCharOrDie())) {
-    chars.push_back(cs_->PopCharOrDie());
+  std::string_view remaining = cs_->Remaining();
+  int64_t length = 1;
+  while (length < remaining.size() && IsIdentifierRest(remaining[length])) {
+    ++length;
   }
-  return Token::Identifier(
-      start_pos, std::string(std::string_view(chars.data(), chars.size())));
+  return Token::Identifier(start_pos, std::string(cs_->PopChars(length)));
 }
 
 // Scans a number token.
 absl::StatusOr<Token> Scanner::ScanNumber() {
   const Pos start_pos = cs_->GetPos();
-  CHECK_NE(std::isdigit(cs_->PeekCharOrDie()), 0);
-  absl::InlinedVector<char, 16> chars;
-  while (!cs_->AtEof()) {
-    if (IsNumberRest(cs_->PeekCharOrDie())) {
-      chars.push_back(cs_->PopCharOrDie());
-    } else if (cs_->TryDropChars('e', '-')) {
-      chars.push_back('e');
-      chars.push_back('-');
-    } else {
-      break;
-    }
+  CHECK(absl::ascii_isdigit(cs_->PeekCharOrDie()));
+  std::string_view remaining = cs_->Remaining();
+  int64_t length = 1;
+  while (length < remaining.size() && IsNumberRest(remaining[length])) {
+    ++length;
   }
-  return Token::Number(
-      start_pos, std::string(std::string_view(chars.data(), chars.size())));
+  return Token::Number(start_pos, std::string(cs_->PopChars(length)));
 }
 
 // Scans a string token.
 absl::StatusOr<Token> Scanner::ScanQuotedString() {
   const Pos start_pos = cs_->GetPos();
   CHECK(cs_->TryDropChar('"'));
-  absl::InlinedVector<char, 16> chars;
-  while (true) {
-    if (cs_->AtEof()) {
-      return absl::InvalidArgumentError(
-          "Unexpected end-of-file in string token starting @ " +
-          start_pos.ToHumanString());
-    }
-    char c = cs_->PopCharOrDie();
-    if (c == '"') {
-      break;
-    }
-    chars.push_back(c);
+  std::string_view remaining = cs_->Remaining();
+  const void* close_quote =
+      std::memchr(remaining.data(), '"', remaining.size());
+  if (close_quote == nullptr) {
+    return absl::InvalidArgumentError(
+        "Unexpected end-of-file in string token starting @ " +
+        start_pos.ToHumanString());
   }
-  return Token::QuotedString(
-      start_pos, std::string(std::string_view(chars.data(), chars.size())));
+  int64_t length = static_cast<const char*>(close_quote) - remaining.data();
+  std::string value(cs_->PopChars(length));
+  cs_->DropCharOrDie();
+  return Token::QuotedString(start_pos, std::move(value));
 }
 
 absl::Status Scanner::PeekInternal() {
@@ -138,7 +164,7 @@ absl::Status Scanner::PeekInternal() {
     DropWhitespaceAndComments();
     return absl::OkStatus();
   }
-  if (isdigit(cs_->PeekCharOrDie())) {
+  if (absl::ascii_isdigit(cs_->PeekCharOrDie())) {
     XLS_ASSIGN_OR_RETURN(lookahead_, ScanNumber());
     DropWhitespaceAndComments();
     return absl::OkStatus();
@@ -321,7 +347,10 @@ absl::StatusOr<std::vector<BlockEntry>> Parser::ParseEntries() {
         XLS_ASSIGN_OR_RETURN(std::string sub_value, PopValueOrError());
         absl::StrAppend(&value, ":", sub_value);
       }
-      result.push_back(KVEntry{identifier, value});
+      if (!attribute_allowlist_.has_value() ||
+          attribute_allowlist_->contains(identifier)) {
+        result.push_back(KVEntry{std::move(identifier), std::move(value)});
+      }
       XLS_ASSIGN_OR_RETURN(bool dropped_semi, TryDropToken(TokenKind::kSemi));
       if (!dropped_semi) {
         if (scanner_->GetPos().lineno == last_pos.lineno) {
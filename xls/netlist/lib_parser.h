@@ -20,9 +20,7 @@
 #ifndef XLS_NETLIST_LIB_PARSER_H_
 #define XLS_NETLIST_LIB_PARSER_H_
 
-#include <cctype>
 #include <cstdint>
-#include <fstream>
 #include <memory>
 #include <optional>
 #include <string>
@@ -36,7 +34,9 @@
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_format.h"
+#include "xls/common/file/mapped_file.h"
 #include "xls/common/status/status_macros.h"
 
 namespace xls {
@@ -54,34 +54,21 @@ struct Pos {
 };
 
 // Wraps a file as a character stream with a 1- or 2-character lookahead
-// interface.
+// interface. Files are memory mapped rather than read, and the contents are
+// contiguous so the scanner can consume whole runs of characters (identifiers,
+// strings, comments) at once.
 class CharStream {
  public:
   static absl::StatusOr<CharStream> FromPath(std::string_view path);
   static absl::StatusOr<CharStream> FromText(std::string text);
 
-  ~CharStream() {
-    if (if_.has_value()) {
-      if_->close();
-    }
-  }
-
-  CharStream(CharStream&& other) = default;
+  CharStream(CharStream&& other);
 
   Pos GetPos() const { return pos_; }
-  bool AtEof() const {
-    if (if_.has_value()) {
-      return if_->eof();
-    }
-    return cursor_ >= text_.size();
-  }
-  char PeekCharOrDie() {
-    if (if_.has_value()) {
-      DCHECK(!if_->eof());
-      return if_->peek();
-    }
-    DCHECK_LT(cursor_, text_.size());
-    return text_[cursor_];
+  bool AtEof() const { return cursor_ >= contents_.size(); }
+  char PeekCharOrDie() const {
+    DCHECK_LT(cursor_, contents_.size());
+    return contents_[cursor_];
   }
   char PopCharOrDie() {
     char c = PeekCharOrDie();
@@ -102,41 +89,39 @@ class CharStream {
 
   // Attempts to pop c0 followed by c1 in an atomic fashion.
   bool TryDropChars(char c0, char c1) {
-    if (AtEof()) {
-      return false;
-    }
-    if (TryDropChar(c0)) {
-      if (AtEof() || PeekCharOrDie() != c1) {
-        Unget(c0);
-        return false;
+    if (cursor_ + 1 < contents_.size() && contents_[cursor_] == c0 &&
+        contents_[cursor_ + 1] == c1) {
+      cursor_ += 2;
+      pos_.colno += 2;
+      if (c1 == '\n') {
+        pos_.lineno++;
+        pos_.colno = 0;
       }
-      DropCharOrDie();
       return true;
     }
     return false;
   }
 
- private:
-  explicit CharStream(std::ifstream file_stream)
-      : if_(std::move(file_stream)) {}
-  explicit CharStream(std::string text) : text_(std::move(text)) {}
+  // Returns the characters which have not been popped yet.
+  std::string_view Remaining() const { return contents_.substr(cursor_); }
 
-  void Unget(char c) {
-    cursor_--;
-    if (c == '\n') {
-      pos_.lineno--;
-      pos_.colno = last_colno_;
-    } else {
-      pos_.colno--;
-    }
-    if (if_.has_value()) {
-      if_->unget();
-    }
+  // Pops the next `count` characters and returns them as a view into the
+  // stream contents.
+  std::string_view PopChars(int64_t count);
+
+  // Drops characters up to and including the next occurrence of `terminator`
+  // and returns true, or drops the rest of the stream and returns false if
+  // there is no such occurrence.
+  bool DropThrough(std::string_view terminator);
+
+ private:
+  CharStream(std::optional<MappedFile> file, std::string text)
+      : file_(std::move(file)), text_(std::move(text)) {
+    contents_ = file_.has_value() ? file_->contents() : text_;
   }
 
   void BumpPos(char c) {
     cursor_++;
-    last_colno_ = pos_.colno;
     if (c == '\n') {
       pos_.lineno++;
       pos_.colno = 0;
@@ -147,15 +132,12 @@ class CharStream {
 
   Pos pos_ = {0, 0};
 
-  // We have both ifstream mode and text mode data, we store both inline.
-
-  // ifstream mode
-  std::optional<std::ifstream> if_;
-
-  // text mode
+  // The stream either maps a file or owns its text; `contents_` views
+  // whichever one it is.
+  std::optional<MappedFile> file_;
   std::string text_;
+  std::string_view contents_;
   int64_t cursor_ = 0;
-  int64_t last_colno_ = 0;
 };
 
 enum class TokenKind {
@@ -233,13 +215,15 @@ class Scanner {
   }
 
  private:
-  static bool IsIdentifierStart(char c) { return std::isalpha(c); }
+  static bool IsIdentifierStart(char c) { return absl::ascii_isalpha(c); }
   static bool IsIdentifierRest(char c) {
-    return std::isalpha(c) != 0 || std::isdigit(c) != 0 || c == '_';
+    return absl::ascii_isalnum(c) || c == '_';
+  }
+  static bool IsWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
   }
-  static bool IsWhitespace(char c) { return c == ' ' || c == '\n'; }
   static bool IsNumberRest(char c) {
-    return std::isdigit(c) != 0 || c == '.' || c == 'e' || c == '-';
+    return absl::ascii_isdigit(c) || c == '.' || c == 'e' || c == '-';
   }
 
   // Scans an identifier token.
@@ -259,15 +243,11 @@ class Scanner {
       cs_->DropCharOrDie();
     }
     if (cs_->TryDropChars('/', '*')) {
-      while (!cs_->AtEof() && !cs_->TryDropChars('*', '/')) {
-        cs_->DropCharOrDie();
-      }
+      cs_->DropThrough("*/");
       goto restart;
     }
     if (cs_->TryDropChars('/', '/')) {
-      while (!cs_->AtEof() && !cs_->TryDropChar('\n')) {
-        cs_->DropCharOrDie();
-      }
+      cs_->DropThrough("\n");
       goto restart;
     }
     if (cs_->TryDropChars('\\', '\n')) {
@@ -356,11 +336,16 @@ struct Block {
 
 class Parser {
  public:
-  // See comment on kind_allowlist_ member below for details.
+  // See comments on the kind_allowlist_ and attribute_allowlist_ members below
+  // for details.
   explicit Parser(Scanner* scanner,
                   std::optional<absl::flat_hash_set<std::string>>
-                      kind_allowlist = std::nullopt)
-      : scanner_(scanner), kind_allowlist_(std::move(kind_allowlist)) {}
+                      kind_allowlist = std::nullopt,
+                  std::optional<absl::flat_hash_set<std::string>>
+                      attribute_allowlist = std::nullopt)
+      : scanner_(scanner),
+        kind_allowlist_(std::move(kind_allowlist)),
+        attribute_allowlist_(std::move(attribute_allowlist)) {}
 
   absl::StatusOr<std::unique_ptr<Block>> ParseLibrary() {
     XLS_RETURN_IF_ERROR(DropIdentifierOrError("library"));
@@ -406,6 +391,11 @@ class Parser {
   // This is very useful for minimizing memory usage when we're interested in
   // just a subset of particular fields, e.g. as part of a query.
   std::optional<absl::flat_hash_set<std::string>> kind_allowlist_;
+
+  // Optional allowlist of key/value entry keys to keep. Other key/value
+  // entries are parsed but dropped, which avoids holding e.g. the timing and
+  // power tables of a large library in memory.
+  std::optional<absl::flat_hash_set<std::string>> attribute_allowlist_;
 };
 
 }  // namespace cell_lib
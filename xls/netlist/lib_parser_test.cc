@@ -14,14 +14,20 @@
 
 #include "xls/netlist/lib_parser.h"
 
+#include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
 #include <string>
 #include <utility>
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
 #include "xls/common/status/matchers.h"
 #include "xls/common/status/status_macros.h"
 
@@ -30,6 +36,8 @@ namespace netlist {
 namespace cell_lib {
 namespace {
 
+using ::absl_testing::StatusIs;
+
 TEST(LibParserTest, ScanSimple) {
   std::string text = "{}()";
   XLS_ASSERT_OK_AND_ASSIGN(auto cs, CharStream::FromText(text));
@@ -45,14 +53,31 @@ TEST(LibParserTest, ScanSimple) {
   EXPECT_TRUE(scanner.AtEof());
 }
 
+TEST(LibParserTest, ScanPositionsAfterComments) {
+  std::string text = "// line comment\n/* block\ncomment */\t{\r\n  foo";
+  XLS_ASSERT_OK_AND_ASSIGN(auto cs, CharStream::FromText(text));
+  Scanner scanner(&cs);
+  XLS_ASSERT_OK_AND_ASSIGN(Token curl, scanner.Pop());
+  EXPECT_EQ(curl.kind(), TokenKind::kOpenCurl);
+  EXPECT_EQ(curl.pos().ToHumanString(), "3:12");
+  XLS_ASSERT_OK_AND_ASSIGN(Token foo, scanner.Pop());
+  EXPECT_EQ(foo.kind(), TokenKind::kIdentifier);
+  EXPECT_EQ(foo.payload(), "foo");
+  EXPECT_EQ(foo.pos().ToHumanString(), "4:3");
+  EXPECT_TRUE(scanner.AtEof());
+}
+
 // Helper that parses the given text as a library block and returns the
 // block structure.
 absl::StatusOr<std::unique_ptr<Block>> Parse(
     std::string text,
-    std::optional<absl::flat_hash_set<std::string>> allowlist = std::nullopt) {
+    std::optional<absl::flat_hash_set<std::string>> allowlist = std::nullopt,
+    std::optional<absl::flat_hash_set<std::string>> attribute_allowlist =
+        std::nullopt) {
   XLS_ASSIGN_OR_RETURN(auto cs, CharStream::FromText(text));
   Scanner scanner(&cs);
-  Parser parser(&scanner, std::move(allowlist));
+  Parser parser(&scanner, std::move(allowlist),
+                std::move(attribute_allowlist));
   return parser.ParseLibrary();
 }
 
@@ -137,6 +162,31 @@ library (foo) {
   EXPECT_EQ(2, Parse(text).value()->GetSubBlocks("my_block").size());
 }
 
+TEST(LibParserTest, ParseFromPath) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path path = temp_dir.path() / "foo.lib";
+  XLS_ASSERT_OK(SetFileContents(path, R"(
+library (foo) {
+  cell (AND2) {
+    pin (o) {
+      function: "a&b";
+    }
+  }
+}
+)"));
+  XLS_ASSERT_OK_AND_ASSIGN(auto cs, CharStream::FromPath(path.string()));
+  Scanner scanner(&cs);
+  Parser parser(&scanner);
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Block> library,
+                           parser.ParseLibrary());
+  EXPECT_EQ(library->ToString(),
+            "(block library (foo) ((block cell (AND2) "
+            "((block pin (o) ((function \"a&b\")))))))");
+
+  EXPECT_THAT(CharStream::FromPath((temp_dir.path() / "bar.lib").string()),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
 TEST(LibParserTest, AllowlistKind) {
   std::string text = R"(
 library (foo) {
@@ -162,6 +212,26 @@ library (foo) {
             "))");
 }
 
+TEST(LibParserTest, AllowlistAttribute) {
+  std::string text = R"(
+library (foo) {
+  foo_key: foo_value;
+  bar () {
+    bar_key: bar_value;
+    baz_key: "baz_value";
+  }
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Block> library,
+      Parse(text, /*allowlist=*/std::nullopt,
+            absl::flat_hash_set<std::string>{"bar_key"}));
+  EXPECT_EQ(library->ToString(),
+            "(block library (foo) ("
+            "(block bar () ((bar_key \"bar_value\")))"
+            "))");
+}
+
 }  // namespace
 }  // namespace cell_lib
 }  // namespace netlist
@@ -26,9 +26,12 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -39,6 +42,7 @@
 #include "absl/strings/str_split.h"
 #include "absl/strings/strip.h"
 #include "absl/strings/substitute.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/common/bits_util.h"
 #include "xls/common/status/status_macros.h"
@@ -48,6 +52,40 @@ namespace xls {
 namespace netlist {
 namespace rtl {
 
+// Owns objects allocated in geometrically growing chunks rather than
+// individually, so that large netlists are stored (mostly) contiguously.
+// Objects never move once added.
+template <typename T>
+class ChunkedStorage {
+ public:
+  ChunkedStorage() = default;
+  ChunkedStorage(const ChunkedStorage&) = delete;
+  ChunkedStorage& operator=(const ChunkedStorage&) = delete;
+  ChunkedStorage(ChunkedStorage&&) = default;
+  ChunkedStorage& operator=(ChunkedStorage&&) = default;
+
+  template <typename... Args>
+  T* Emplace(Args&&... args) {
+    if (chunks_.empty() ||
+        chunks_.back().size() == chunks_.back().capacity()) {
+      size_t capacity =
+          chunks_.empty()
+              ? kMinChunkSize
+              : std::min(2 * chunks_.back().capacity(), kMaxChunkSize);
+      chunks_.emplace_back().reserve(capacity);
+    }
+    return &chunks_.back().emplace_back(std::forward<Args>(args)...);
+  }
+
+ private:
+  static constexpr size_t kMinChunkSize = 16;
+  static constexpr size_t kMaxChunkSize = 4096;
+
+  // Chunks are never grown past their reserved capacity, so their elements
+  // are never reallocated.
+  std::vector<std::vector<T>> chunks_;
+};
+
 // Forward declaration for use in AbstractNetRef.
 template <typename EvalT = bool>
 class AbstractNetDef;
@@ -271,12 +309,8 @@ class AbstractModule {
 
   absl::StatusOr<AbstractCell<EvalT>*> ResolveCell(std::string_view name) const;
 
-  absl::Span<const std::unique_ptr<AbstractNetDef<EvalT>>> nets() const {
-    return nets_;
-  }
-  absl::Span<const std::unique_ptr<AbstractCell<EvalT>>> cells() const {
-    return cells_;
-  }
+  absl::Span<const AbstractNetRef<EvalT>> nets() const { return nets_; }
+  absl::Span<AbstractCell<EvalT>* const> cells() const { return cells_; }
 
   const std::vector<AbstractNetRef<EvalT>>& inputs() const {
     return input_nets_;
@@ -427,7 +461,7 @@ class AbstractModule {
   // than are actually instantiated--this latter flexibility allows for checking
   // of correctness against the cell-library definitions, among other things.
   absl::Status AddCellEvaluationFns(const CellToOutputEvalFns<EvalT>& fns) {
-    for (auto& cell : cells_) {
+    for (AbstractCell<EvalT>* cell : cells_) {
       for (auto const& cell_name_to_rest : fns) {
         if (cell->cell_library_entry()->name() == cell_name_to_rest.first) {
           for (auto const& pin_name_to_fn : cell_name_to_rest.second) {
@@ -473,10 +507,14 @@ class AbstractModule {
   std::vector<AbstractNetRef<EvalT>> wire_nets_;
   absl::flat_hash_map<AbstractNetRef<EvalT>, AbstractNetRef<EvalT>>
       assign_nets_;
-  std::vector<std::unique_ptr<AbstractNetDef<EvalT>>> nets_;
-  absl::flat_hash_map<std::string, AbstractNetRef<EvalT>> name_to_netref_;
-  std::vector<std::unique_ptr<AbstractCell<EvalT>>> cells_;
-  absl::flat_hash_map<std::string, AbstractCell<EvalT>*> name_to_cell_;
+  // Nets and cells in order of declaration. The name maps are keyed by views
+  // of the names held by the (never moving) nets and cells themselves.
+  ChunkedStorage<AbstractNetDef<EvalT>> net_storage_;
+  std::vector<AbstractNetRef<EvalT>> nets_;
+  absl::flat_hash_map<std::string_view, AbstractNetRef<EvalT>> name_to_netref_;
+  ChunkedStorage<AbstractCell<EvalT>> cell_storage_;
+  std::vector<AbstractCell<EvalT>*> cells_;
+  absl::flat_hash_map<std::string_view, AbstractCell<EvalT>*> name_to_cell_;
   AbstractNetRef<EvalT> zero_;
   AbstractNetRef<EvalT> one_;
   AbstractNetRef<EvalT> dummy_;
@@ -499,7 +537,7 @@ class AbstractNetlist {
   // Useful when looking for a module expects to get false results most of the
   // time.
   std::optional<const AbstractModule<EvalT>*> MaybeGetModule(
-      const std::string& module_name) const;
+      std::string_view module_name) const;
   absl::Span<const std::unique_ptr<AbstractModule<EvalT>>> modules() {
     return modules_;
   }
@@ -515,9 +553,13 @@ class AbstractNetlist {
  private:
   // The AbstractNetlist itself manages the CellLibraryEntries corresponding to
   // the LUT4 cells that are used, which are identified by their LUT mask (i.e.
-  // the 16 bit LUT_INIT parameter).
-  absl::flat_hash_map<uint16_t, AbstractCellLibraryEntry<EvalT>> lut_cells_;
+  // the 16 bit LUT_INIT parameter). Entries may be created by concurrently
+  // parsed modules, and must not move once created.
+  absl::Mutex lut_cells_mutex_;
+  absl::node_hash_map<uint16_t, AbstractCellLibraryEntry<EvalT>> lut_cells_
+      ABSL_GUARDED_BY(lut_cells_mutex_);
   std::vector<std::unique_ptr<AbstractModule<EvalT>>> modules_;
+  absl::flat_hash_map<std::string_view, AbstractModule<EvalT>*> name_to_module_;
 };
 
 using Netlist = AbstractNetlist<>;
@@ -587,34 +629,33 @@ absl::StatusOr<AbstractCell<EvalT>*> AbstractModule<EvalT>::ResolveCell(
 template <typename EvalT>
 absl::StatusOr<AbstractCell<EvalT>*> AbstractModule<EvalT>::AddCell(
     AbstractCell<EvalT> cell) {
-  auto status_or_cell = ResolveCell(cell.name());
-  if (status_or_cell.status().ok()) {
+  if (name_to_cell_.contains(cell.name())) {
     return absl::InvalidArgumentError(
         absl::StrCat("Module already has a cell with name: ", cell.name()));
   }
 
-  cells_.push_back(std::make_unique<AbstractCell<EvalT>>(cell));
-  auto cell_ptr = cells_.back().get();
-  name_to_cell_[cell.name()] = cell_ptr;
+  AbstractCell<EvalT>* cell_ptr = cell_storage_.Emplace(std::move(cell));
+  cells_.push_back(cell_ptr);
+  name_to_cell_[cell_ptr->name()] = cell_ptr;
   return cell_ptr;
 }
 
 template <typename EvalT>
 absl::Status AbstractModule<EvalT>::AddNetDecl(NetDeclKind kind,
                                                std::string_view name) {
-  auto status_or_net = ResolveNet(name);
-  if (status_or_net.status().ok()) {
+  auto it = name_to_netref_.find(name);
+  if (it != name_to_netref_.end()) {
     // A wire being declared for an already-declared port is not an error.
-    if (status_or_net.value()->kind() == NetDeclKind::kWire) {
+    if (it->second->kind() == NetDeclKind::kWire) {
       return absl::InvalidArgumentError(
           absl::StrCat("Module already has a net/wire decl with name: ", name));
     }
     return absl::OkStatus();
   }
 
-  nets_.emplace_back(std::make_unique<AbstractNetDef<EvalT>>(name, kind));
-  AbstractNetRef<EvalT> ref = nets_.back().get();
-  name_to_netref_[name] = ref;
+  AbstractNetRef<EvalT> ref = net_storage_.Emplace(name, kind);
+  nets_.push_back(ref);
+  name_to_netref_[ref->name()] = ref;
   switch (kind) {
     case NetDeclKind::kInput:
       input_nets_.push_back(ref);
@@ -820,18 +861,19 @@ template <typename EvalT>
 template <typename EvalT>
 void AbstractNetlist<EvalT>::AddModule(
     std::unique_ptr<AbstractModule<EvalT>> module) {
+  // Lookups by name find the first module added with that name.
+  name_to_module_.emplace(module->name(), module.get());
   modules_.emplace_back(std::move(module));
 }
 
 template <typename EvalT>
 std::optional<const AbstractModule<EvalT>*>
-AbstractNetlist<EvalT>::MaybeGetModule(const std::string& module_name) const {
-  for (const auto& module : modules_) {
-    if (module->name() == module_name) {
-      return module.get();
-    }
+AbstractNetlist<EvalT>::MaybeGetModule(std::string_view module_name) const {
+  auto it = name_to_module_.find(module_name);
+  if (it == name_to_module_.end()) {
+    return std::nullopt;
   }
-  return std::nullopt;
+  return it->second;
 }
 
 template <typename EvalT>
@@ -853,6 +895,7 @@ AbstractNetlist<EvalT>::GetOrCreateLut4CellEntry(int64_t lut_mask, EvalT zero,
     return absl::InvalidArgumentError("Mask for LUT4 must be 16 bits");
   }
   uint16_t mask = static_cast<uint16_t>(lut_mask);
+  absl::MutexLock lock(&lut_cells_mutex_);
   auto it = lut_cells_.find(mask);
   if (it == lut_cells_.end()) {
     AbstractCellLibraryEntry<EvalT> entry(
@@ -0,0 +1,239 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "include/benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/get_runfile_path.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/netlist/bit_parallel_interpreter.h"
+#include "xls/netlist/cell_library.h"
+#include "xls/netlist/function_extractor.h"
+#include "xls/netlist/interpreter.h"
+#include "xls/netlist/lib_parser.h"
+#include "xls/netlist/netlist.h"
+#include "xls/netlist/netlist.pb.h"
+#include "xls/netlist/netlist_parser.h"
+
+namespace xls::netlist {
+namespace {
+
+// Compares `Interpreter::InterpretModule` with `BitParallelInterpreter` on the
+// testdata netlists and on generated netlists of configurable width. Unless
+// noted otherwise, every iteration evaluates 64 input vectors, i.e., one word
+// for the bit-parallel interpreter.
+constexpr const char* kTestdataModules[] = {"isqrt", "ifte"};
+constexpr int64_t kTestdataModuleCount = 2;
+
+// Depth of the generated netlists.
+constexpr int64_t kGeneratedLayerCount = 16;
+
+struct LoadedNetlist {
+  std::unique_ptr<CellLibrary> cell_library;
+  std::unique_ptr<rtl::Netlist> netlist;
+  const rtl::Module* module;
+};
+
+absl::StatusOr<LoadedNetlist> LoadNetlist(const std::string& text,
+                                          const std::string& module_name) {
+  XLS_ASSIGN_OR_RETURN(
+      std::filesystem::path lib_path,
+      GetXlsRunfilePath("xls/netlist/testdata/simple_cell.lib"));
+  XLS_ASSIGN_OR_RETURN(std::string lib_text, GetFileContents(lib_path));
+  XLS_ASSIGN_OR_RETURN(cell_lib::CharStream char_stream,
+                       cell_lib::CharStream::FromText(lib_text));
+  XLS_ASSIGN_OR_RETURN(CellLibraryProto lib_proto,
+                       function::ExtractFunctions(&char_stream));
+  LoadedNetlist loaded;
+  XLS_ASSIGN_OR_RETURN(CellLibrary cell_library,
+                       CellLibrary::FromProto(lib_proto));
+  loaded.cell_library = std::make_unique<CellLibrary>(std::move(cell_library));
+  rtl::Scanner scanner(text);
+  XLS_ASSIGN_OR_RETURN(
+      loaded.netlist,
+      rtl::Parser::ParseNetlist(loaded.cell_library.get(), &scanner));
+  XLS_ASSIGN_OR_RETURN(loaded.module, loaded.netlist->GetModule(module_name));
+  return loaded;
+}
+
+absl::StatusOr<LoadedNetlist> LoadTestdataNetlist(int64_t index) {
+  std::string module_name = kTestdataModules[index];
+  XLS_ASSIGN_OR_RETURN(std::filesystem::path path,
+                       GetXlsRunfilePath(absl::StrCat(
+                           "xls/netlist/testdata/", module_name, ".v")));
+  XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(path));
+  return LoadNetlist(text, module_name);
+}
+
+// Generates `kGeneratedLayerCount` layers of `width` two-input cells, each
+// reading two pseudo-randomly chosen nets of the previous layer (or inputs).
+// The last layer drives the module outputs.
+absl::StatusOr<LoadedNetlist> LoadGeneratedNetlist(int64_t width) {
+  std::mt19937_64 rng(0);
+  std::vector<std::string> inputs;
+  std::vector<std::string> outputs;
+  for (int64_t i = 0; i < width; ++i) {
+    inputs.push_back(absl::StrCat("i", i));
+    outputs.push_back(absl::StrCat("o", i));
+  }
+  std::vector<std::string> previous = inputs;
+  std::vector<std::string> wires;
+  std::string cells;
+  for (int64_t layer = 0; layer < kGeneratedLayerCount; ++layer) {
+    bool last = layer == kGeneratedLayerCount - 1;
+    std::vector<std::string> current;
+    for (int64_t i = 0; i < width; ++i) {
+      std::string net = last ? outputs[i] : absl::StrCat("n", layer, "_", i);
+      const std::string& a = previous[rng() % previous.size()];
+      const std::string& b = previous[rng() % previous.size()];
+      absl::StrAppend(&cells, "  ", i % 2 == 0 ? "xor2" : "nand2", " c",
+                      layer, "_", i, " ( .A(", a, "), .B(", b, "), .Y(", net,
+                      ") );\n");
+      current.push_back(net);
+    }
+    if (!last) {
+      wires.insert(wires.end(), current.begin(), current.end());
+    }
+    previous = std::move(current);
+  }
+  std::string text = absl::StrCat(
+      "module generated (", absl::StrJoin(inputs, ", "), ", ",
+      absl::StrJoin(outputs, ", "), ");\n", "  input ",
+      absl::StrJoin(inputs, ", "), ";\n", "  output ",
+      absl::StrJoin(outputs, ", "), ";\n", "  wire ",
+      absl::StrJoin(wires, ", "), ";\n", cells, "endmodule\n");
+  return LoadNetlist(text, "generated");
+}
+
+std::vector<NetRef2Value> RandomVectors(
+    const rtl::Module* module,
+    int64_t count = BitParallelInterpreter::kVectorsPerWord) {
+  std::mt19937_64 rng(42);
+  std::vector<NetRef2Value> vectors(count);
+  for (NetRef2Value& vector : vectors) {
+    for (rtl::NetRef input : module->inputs()) {
+      vector[input] = (rng() & 1) == 1;
+    }
+  }
+  return vectors;
+}
+
+void RunInterpretModule(benchmark::State& state, const LoadedNetlist& loaded) {
+  std::vector<NetRef2Value> vectors = RandomVectors(loaded.module);
+  Interpreter interpreter(loaded.netlist.get());
+  for (auto _ : state) {
+    for (const NetRef2Value& vector : vectors) {
+      absl::StatusOr<NetRef2Value> outputs =
+          interpreter.InterpretModule(loaded.module, vector);
+      CHECK_OK(outputs.status());
+      benchmark::DoNotOptimize(outputs);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * vectors.size());
+}
+
+void RunBitParallel(benchmark::State& state, const LoadedNetlist& loaded) {
+  BitParallelInterpreter interpreter =
+      BitParallelInterpreter::Create(loaded.netlist.get(), loaded.module)
+          .value();
+  std::mt19937_64 rng(42);
+  std::vector<BitParallelInterpreter::Word> inputs(
+      loaded.module->inputs().size());
+  for (BitParallelInterpreter::Word& input : inputs) {
+    input = rng();
+  }
+  for (auto _ : state) {
+    absl::StatusOr<std::vector<BitParallelInterpreter::Word>> outputs =
+        interpreter.Run(inputs);
+    CHECK_OK(outputs.status());
+    benchmark::DoNotOptimize(outputs);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          BitParallelInterpreter::kVectorsPerWord);
+  state.counters["instructions"] = interpreter.instruction_count();
+}
+
+static void BM_InterpretModuleTestdata(benchmark::State& state) {
+  LoadedNetlist loaded = LoadTestdataNetlist(state.range(0)).value();
+  state.SetLabel(kTestdataModules[state.range(0)]);
+  RunInterpretModule(state, loaded);
+}
+
+static void BM_BitParallelTestdata(benchmark::State& state) {
+  LoadedNetlist loaded = LoadTestdataNetlist(state.range(0)).value();
+  state.SetLabel(kTestdataModules[state.range(0)]);
+  RunBitParallel(state, loaded);
+}
+
+// Evaluates many words of vectors per iteration through `InterpretVectors`;
+// the second argument is the number of threads the words are spread across.
+static void BM_BitParallelVectorsTestdata(benchmark::State& state) {
+  constexpr int64_t kWordCount = 256;
+  LoadedNetlist loaded = LoadTestdataNetlist(state.range(0)).value();
+  state.SetLabel(kTestdataModules[state.range(0)]);
+  BitParallelInterpreter interpreter =
+      BitParallelInterpreter::Create(loaded.netlist.get(), loaded.module)
+          .value();
+  std::vector<NetRef2Value> vectors = RandomVectors(
+      loaded.module, kWordCount * BitParallelInterpreter::kVectorsPerWord);
+  for (auto _ : state) {
+    absl::StatusOr<std::vector<NetRef2Value>> outputs =
+        interpreter.InterpretVectors(vectors, state.range(1));
+    CHECK_OK(outputs.status());
+    benchmark::DoNotOptimize(outputs);
+  }
+  state.SetItemsProcessed(state.iterations() * vectors.size());
+}
+
+static void BM_InterpretModuleGenerated(benchmark::State& state) {
+  LoadedNetlist loaded = LoadGeneratedNetlist(state.range(0)).value();
+  RunInterpretModule(state, loaded);
+}
+
+static void BM_BitParallelGenerated(benchmark::State& state) {
+  LoadedNetlist loaded = LoadGeneratedNetlist(state.range(0)).value();
+  RunBitParallel(state, loaded);
+}
+
+BENCHMARK(BM_InterpretModuleTestdata)
+    ->DenseRange(0, kTestdataModuleCount - 1);
+BENCHMARK(BM_BitParallelTestdata)->DenseRange(0, kTestdataModuleCount - 1);
+BENCHMARK(BM_BitParallelVectorsTestdata)
+    ->ArgsProduct({benchmark::CreateDenseRange(0, kTestdataModuleCount - 1,
+                                               /*step=*/1),
+                   {1, 2, 4, 8}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_InterpretModuleGenerated)
+    ->Range(256, 16384)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BitParallelGenerated)
+    ->RangeMultiplier(8)
+    ->Range(256, 262144)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace xls::netlist
+
+BENCHMARK_MAIN();
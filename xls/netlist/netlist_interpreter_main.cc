@@ -41,7 +41,6 @@
 #include "xls/netlist/cell_library.h"
 #include "xls/netlist/function_extractor.h"
 #include "xls/netlist/interpreter.h"
-#include "xls/netlist/lib_parser.h"
 #include "xls/netlist/netlist.h"
 #include "xls/netlist/netlist.pb.h"
 #include "xls/netlist/netlist_parser.h"
@@ -50,6 +49,10 @@ ABSL_FLAG(std::string, cell_library, "",
           "Cell library to use for interpretation.");
 ABSL_FLAG(std::string, cell_library_proto, "",
           "Preprocessed cell library proto to use for interpretation.");
+ABSL_FLAG(std::string, cell_library_cache, "",
+          "If set along with --cell_library, path of a binary cache of the "
+          "preprocessed cell library. The cache is used if it is up to date "
+          "with the cell library and (re)written otherwise.");
 // TODO(rspringer): Eliminate the need for this flag.
 // This one is a hidden temporary flag until we can properly handle cells
 // with state_function attributes (e.g., some latches).
@@ -70,7 +73,8 @@ namespace xls {
 
 static absl::StatusOr<netlist::CellLibrary> GetCellLibrary(
     const std::string& cell_library_path,
-    const std::string& cell_library_proto_path) {
+    const std::string& cell_library_proto_path,
+    const std::string& cell_library_cache_path) {
   if (!cell_library_proto_path.empty()) {
     XLS_ASSIGN_OR_RETURN(std::string proto_text,
                          GetFileContents(cell_library_proto_path));
@@ -78,26 +82,30 @@ static absl::StatusOr<netlist::CellLibrary> GetCellLibrary(
     XLS_RET_CHECK(lib_proto.ParseFromString(proto_text));
     return netlist::CellLibrary::FromProto(lib_proto);
   }
-  XLS_ASSIGN_OR_RETURN(std::string cell_library_text,
-                       GetFileContents(cell_library_path));
+  if (!cell_library_cache_path.empty()) {
+    XLS_ASSIGN_OR_RETURN(netlist::CellLibraryProto lib_proto,
+                         netlist::function::ExtractFunctionsCached(
+                             cell_library_path, cell_library_cache_path));
+    return netlist::CellLibrary::FromProto(lib_proto);
+  }
   XLS_ASSIGN_OR_RETURN(
-      auto char_stream,
-      netlist::cell_lib::CharStream::FromText(cell_library_text));
-  XLS_ASSIGN_OR_RETURN(netlist::CellLibraryProto lib_proto,
-                       netlist::function::ExtractFunctions(&char_stream));
+      netlist::CellLibraryProto lib_proto,
+      netlist::function::ExtractFunctionsFromFile(cell_library_path));
   return netlist::CellLibrary::FromProto(lib_proto);
 }
 
 static absl::Status RealMain(const std::string& netlist_path,
                              const std::string& cell_library_path,
                              const std::string& cell_library_proto_path,
+                             const std::string& cell_library_cache_path,
                              const std::string& module_name,
                              absl::Span<const std::string> inputs,
                              const std::string& output_type_string,
                              absl::Span<const std::string> dump_cells) {
   XLS_ASSIGN_OR_RETURN(
       netlist::CellLibrary cell_library,
-      GetCellLibrary(cell_library_path, cell_library_proto_path));
+      GetCellLibrary(cell_library_path, cell_library_proto_path,
+                     cell_library_cache_path));
 
   XLS_ASSIGN_OR_RETURN(std::string netlist_text, GetFileContents(netlist_path));
   netlist::rtl::Scanner scanner(netlist_text);
@@ -188,6 +196,8 @@ int main(int argc, char* argv[]) {
   std::string output_type = absl::GetFlag(FLAGS_output_type);
 
   return xls::ExitStatus(xls::RealMain(netlist_path, cell_library_path,
-                                       cell_library_proto_path, module_name,
+                                       cell_library_proto_path,
+                                       absl::GetFlag(FLAGS_cell_library_cache),
+                                       module_name,
                                        inputs, output_type, dump_cells));
 }
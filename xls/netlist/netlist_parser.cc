@@ -15,7 +15,13 @@
 #include "xls/netlist/netlist_parser.h"
 
 #include <cctype>
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
@@ -24,6 +30,7 @@
 #include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "xls/common/file/mapped_file.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 
@@ -80,6 +87,14 @@ std::string Token::ToString() const {
                          pos.ToHumanString());
 }
 
+/* static */ absl::StatusOr<Scanner> Scanner::FromFile(
+    const std::filesystem::path& path) {
+  XLS_ASSIGN_OR_RETURN(MappedFile file, MappedFile::Open(path));
+  Scanner scanner(file.contents());
+  scanner.file_.emplace(std::move(file));
+  return scanner;
+}
+
 char Scanner::PeekCharOrDie() const {
   CHECK(!AtEofInternal());
   return text_[index_];
@@ -171,6 +186,8 @@ absl::StatusOr<Token> Scanner::Peek() {
   if (lookahead_.has_value()) {
     return lookahead_.value();
   }
+  DropIgnoredChars();
+  lookahead_offset_ = index_;
   XLS_ASSIGN_OR_RETURN(Token token, PeekInternal());
   lookahead_.emplace(token);
   return lookahead_.value();
@@ -184,8 +201,8 @@ absl::StatusOr<Token> Scanner::Pop() {
 }
 
 absl::StatusOr<Token> Scanner::ScanNumber(char startc, Pos pos) {
-  std::string chars;
-  chars.push_back(startc);
+  // `startc` has already been popped.
+  int64_t start = index_ - 1;
   bool seen_separator = false;
   auto is_hex_char = [](char c) {
     return absl::ascii_isxdigit(absl::ascii_toupper(c));
@@ -200,20 +217,19 @@ absl::StatusOr<Token> Scanner::ScanNumber(char startc, Pos pos) {
   while (!AtEofInternal()) {
     char c = PeekCharOrDie();
     if (is_hex_char(c)) {
-      chars.push_back(PopCharOrDie());
+      DropCharOrDie();
     } else if (c == '\'' && !seen_separator) {
       // If we see a base separator, pop it, then the optional signedness
       // indicator (s|S), then the base indicator (d|b|o|h|D|B|O|H).
-      chars.push_back(PopCharOrDie());
+      DropCharOrDie();
       XLS_RET_CHECK(!AtEofInternal()) << "Saw EOF while scanning number base!";
-      chars.push_back(PopCharOrDie());
-      if (chars.back() == 's' || chars.back() == 'S') {
+      c = PopCharOrDie();
+      if (c == 's' || c == 'S') {
         XLS_RET_CHECK(!AtEofInternal())
             << "Saw EOF while scanning number base (post-signedness)!";
-        chars.push_back(PopCharOrDie());
+        c = PopCharOrDie();
       }
 
-      c = chars.back();
       XLS_RET_CHECK(c == 'd' || c == 'b' || c == 'o' || c == 'h' || c == 'D' ||
                     c == 'B' || c == 'O' || c == 'H')
           << "Expected [dbohDBOH], saw '" << c << "'";
@@ -224,23 +240,23 @@ absl::StatusOr<Token> Scanner::ScanNumber(char startc, Pos pos) {
     }
   }
 
-  return Token{TokenKind::kNumber, pos, chars};
+  return Token{TokenKind::kNumber, pos, text_.substr(start, index_ - start)};
 }
 
 absl::StatusOr<Token> Scanner::ScanName(char startc, Pos pos, bool is_escaped) {
-  std::string chars;
-  chars.push_back(startc);
+  // `startc` has already been popped.
+  int64_t start = index_ - 1;
   while (!AtEofInternal()) {
     char c = PeekCharOrDie();
     bool is_whitespace = c == ' ' || c == '\t' || c == '\n';
     if ((is_escaped && !is_whitespace) || isalpha(c) || isdigit(c) ||
         c == '_') {
-      chars.push_back(PopCharOrDie());
+      DropCharOrDie();
     } else {
       break;
     }
   }
-  return Token{TokenKind::kName, pos, chars};
+  return Token{TokenKind::kName, pos, text_.substr(start, index_ - start)};
 }
 
 absl::StatusOr<Token> Scanner::PeekInternal() {
@@ -293,6 +309,118 @@ absl::StatusOr<Token> Scanner::PeekInternal() {
   }
 }
 
+absl::StatusOr<std::vector<ModuleText>> SplitModules(std::string_view text,
+                                                     Pos pos) {
+  int64_t index = 0;
+  auto at_eof = [&] { return index >= text.size(); };
+  auto peek_char2 = [&]() -> char {
+    return index + 1 < text.size() ? text[index + 1] : '\0';
+  };
+  auto drop_char = [&] {
+    if (text[index++] == '\n') {
+      ++pos.lineno;
+      pos.colno = 0;
+    } else {
+      ++pos.colno;
+    }
+  };
+  // Drops characters up to and including `end`, or to the end of the text.
+  auto drop_through = [&](std::string_view end) {
+    while (!at_eof() && text.substr(index, end.size()) != end) {
+      drop_char();
+    }
+    for (int64_t i = 0; i < end.size() && !at_eof(); ++i) {
+      drop_char();
+    }
+  };
+  auto is_whitespace = [](char c) {
+    return c == ' ' || c == '\t' || c == '\n';
+  };
+  // Mirrors Scanner::DropIgnoredChars.
+  auto drop_ignored_chars = [&] {
+    while (!at_eof()) {
+      char c = text[index];
+      if (is_whitespace(c)) {
+        drop_char();
+      } else if (c == '/' && peek_char2() == '/') {
+        drop_through("\n");
+      } else if (c == '/' && peek_char2() == '*') {
+        drop_char();
+        drop_char();
+        drop_through("*/");
+      } else if (c == '(' && peek_char2() == '*') {
+        drop_char();
+        drop_char();
+        drop_through("*)");
+      } else {
+        return;
+      }
+    }
+  };
+  // Pops a name (escaped or not) if one is next, otherwise pops nothing and
+  // returns an empty view.
+  auto pop_name = [&]() -> std::string_view {
+    int64_t start = index;
+    char c = text[index];
+    if (c == '\\') {
+      while (!at_eof() && !is_whitespace(text[index])) {
+        drop_char();
+      }
+    } else if (absl::ascii_isalpha(c) || c == '_') {
+      while (!at_eof() && (absl::ascii_isalnum(text[index]) ||
+                           text[index] == '_')) {
+        drop_char();
+      }
+    }
+    return text.substr(start, index - start);
+  };
+
+  std::vector<ModuleText> modules;
+  std::optional<ModuleText> current;
+  int64_t current_start = 0;
+  for (drop_ignored_chars(); !at_eof(); drop_ignored_chars()) {
+    Pos word_pos = pos;
+    int64_t word_start = index;
+    if (absl::ascii_isdigit(text[index])) {
+      // A number, which may contain letters (e.g. 4'hbeef).
+      while (!at_eof() && (absl::ascii_isalnum(text[index]) ||
+                           text[index] == '\'' || text[index] == '_')) {
+        drop_char();
+      }
+      continue;
+    }
+    std::string_view word = pop_name();
+    if (!current.has_value()) {
+      if (word != "module") {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Expected keyword 'module' @ %s", word_pos.ToHumanString()));
+      }
+      drop_ignored_chars();
+      current.emplace();
+      current->pos = word_pos;
+      current->name = at_eof() ? std::string_view() : pop_name();
+      if (current->name.empty()) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Expected module name @ %s", pos.ToHumanString()));
+      }
+      current_start = word_start;
+    } else if (word == "endmodule") {
+      current->text = text.substr(current_start, index - current_start);
+      modules.push_back(*std::move(current));
+      current.reset();
+    } else if (word.empty()) {
+      // Punctuation.
+      drop_char();
+    }
+  }
+  if (current.has_value()) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Module '%s' @ %s has no endmodule", current->name,
+                        current->pos.ToHumanString()));
+  }
+  return modules;
+}
+
 }  // namespace rtl
 }  // namespace netlist
 }  // namespace xls
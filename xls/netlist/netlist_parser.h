@@ -18,11 +18,13 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -36,6 +38,9 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/substitute.h"
+#include "absl/synchronization/notification.h"
+#include "xls/common/file/mapped_file.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/string_to_int.h"
@@ -80,18 +85,28 @@ struct Pos {
 };
 
 // Represents a scanned token (that comes from scanning a character stream).
+// For names and numbers, `value` is a view of the scanned text, which must
+// outlive the token.
 struct Token {
   TokenKind kind;
   Pos pos;
-  std::string value;
+  std::string_view value;
 
   std::string ToString() const;
 };
 
-// Token scanner for netlist files.
+// Token scanner for netlist files. Tokens refer to the scanned text rather
+// than copying it.
 class Scanner {
  public:
-  explicit Scanner(std::string_view text) : text_(text) {}
+  // Scans `text`, which must outlive the scanner and its tokens. Positions are
+  // reported relative to `start`, the position of `text` within its file.
+  explicit Scanner(std::string_view text, Pos start = Pos{0, 0})
+      : text_(text), lineno_(start.lineno), colno_(start.colno) {}
+
+  // Scans the contents of the file at `path`, which is memory mapped (rather
+  // than read) for the lifetime of the scanner.
+  static absl::StatusOr<Scanner> FromFile(const std::filesystem::path& path);
 
   absl::StatusOr<Token> Peek();
 
@@ -102,6 +117,12 @@ class Scanner {
     return index_ >= text_.size();
   }
 
+  // Returns the offset within the text of the next token to be popped.
+  int64_t offset() const {
+    return lookahead_.has_value() ? lookahead_offset_ : index_;
+  }
+  std::string_view text() const { return text_; }
+
  private:
   absl::StatusOr<Token> ScanName(char startc, Pos pos, bool is_escaped);
   absl::StatusOr<Token> ScanNumber(char startc, Pos pos);
@@ -126,28 +147,75 @@ class Scanner {
   // whether the character stream index has reached the end of the text.
   bool AtEofInternal() const { return index_ >= text_.size(); }
 
+  std::optional<MappedFile> file_;
   std::string_view text_;
   int64_t index_ = 0;
   int64_t lineno_ = 0;
   int64_t colno_ = 0;
   std::optional<Token> lookahead_;
+  int64_t lookahead_offset_ = 0;
+};
+
+// The text of one module definition, from its `module` keyword up to and
+// including its `endmodule` keyword.
+struct ModuleText {
+  std::string_view name;
+  std::string_view text;
+  // Position of the `module` keyword.
+  Pos pos;
 };
 
+// Delimits the module definitions in `text`, which starts at `pos` within its
+// file, by scanning its raw bytes instead of tokenizing it, so that the text of
+// each module can then be tokenized on its own. Comments, attributes, escaped
+// identifiers and numbers are skipped so that nothing within them is taken for
+// a keyword. Returns an error if `text` is not a sequence of module
+// definitions; parsing the text reports a more precise one.
+absl::StatusOr<std::vector<ModuleText>> SplitModules(std::string_view text,
+                                                     Pos pos);
+
 template <typename EvalT = bool>
 class AbstractParser {
  public:
   // Parses a netlist with the given cell library and token scanner.
   // Returns a status on parse error.
+  //
+  // If `threads` is greater than one, the text of each module is first
+  // delimited (see `SplitModules`) and the modules are then tokenized and
+  // parsed concurrently. As modules may only instantiate modules defined before
+  // them, a module instantiating another waits until that one has been parsed.
   static absl::StatusOr<std::unique_ptr<AbstractNetlist<EvalT>>> ParseNetlist(
       AbstractCellLibrary<EvalT>* cell_library, Scanner* scanner, EvalT zero,
-      EvalT one);
+      EvalT one, int64_t threads = 1);
   template <typename = std::is_constructible<EvalT, bool>>
   static absl::StatusOr<std::unique_ptr<AbstractNetlist<EvalT>>> ParseNetlist(
-      AbstractCellLibrary<EvalT>* cell_library, Scanner* scanner) {
-    return ParseNetlist(cell_library, scanner, EvalT{false}, EvalT{true});
+      AbstractCellLibrary<EvalT>* cell_library, Scanner* scanner,
+      int64_t threads = 1) {
+    return ParseNetlist(cell_library, scanner, EvalT{false}, EvalT{true},
+                        threads);
   }
 
  private:
+  // A module whose text has been delimited but which is parsed concurrently
+  // with the other modules of the netlist.
+  struct PendingModule {
+    std::string_view name;
+    std::string_view text;
+    Pos pos;
+    absl::StatusOr<std::unique_ptr<AbstractModule<EvalT>>> module;
+    absl::Notification parsed;
+  };
+  struct PendingModules {
+    std::vector<std::unique_ptr<PendingModule>> modules;
+    // Index of the first module of each name.
+    absl::flat_hash_map<std::string_view, int64_t> name_to_index;
+  };
+
+  static absl::StatusOr<std::unique_ptr<AbstractNetlist<EvalT>>>
+  ParseNetlistInParallel(AbstractCellLibrary<EvalT>* cell_library,
+                         Scanner* scanner, EvalT zero, EvalT one,
+                         int64_t threads);
+
   explicit AbstractParser(AbstractCellLibrary<EvalT>* cell_library,
                           Scanner* scanner, EvalT zero, EvalT one)
       : cell_library_(cell_library),
@@ -164,6 +232,11 @@ class AbstractParser {
   absl::StatusOr<const AbstractCellLibraryEntry<EvalT>*> ParseCellModule(
       AbstractNetlist<EvalT>& netlist);
 
+  // Returns the module named `name` defined before the module being parsed,
+  // if any, waiting for it to be parsed when parsing in parallel.
+  absl::StatusOr<std::optional<const AbstractModule<EvalT>*>>
+  FindPreviousModule(std::string_view name, AbstractNetlist<EvalT>& netlist);
+
   // Parses a wire declaration at the module scope.
   absl::Status ParseNetDecl(AbstractModule<EvalT>* module, NetDeclKind kind);
 
@@ -247,7 +320,7 @@ class AbstractParser {
 
   // Pops a name token and returns its contents or gives an error status if a
   // name token is not immediately present in the stream.
-  absl::StatusOr<std::string> PopNameOrError();
+  absl::StatusOr<std::string_view> PopNameOrError();
 
   // Pops a name token and returns its value or gives an error status if a
   // number token is not immediately present in the stream.  The overload
@@ -259,9 +332,10 @@ class AbstractParser {
   // Pops either a name or number token or returns an error.  The overload
   // accepting a width parameter sets that parameter to the bit width of the
   // parsed number, if a number was parsed; otherwise, width is not modified.
-  absl::StatusOr<std::variant<std::string, int64_t>> PopNameOrNumberOrError();
-  absl::StatusOr<std::variant<std::string, int64_t>> PopNameOrNumberOrError(
-      size_t& width);
+  absl::StatusOr<std::variant<std::string_view, int64_t>>
+  PopNameOrNumberOrError();
+  absl::StatusOr<std::variant<std::string_view, int64_t>>
+  PopNameOrNumberOrError(size_t& width);
 
   // Drops a token of kind target from the head of the stream or gives an error
   // status.
@@ -295,18 +369,23 @@ class AbstractParser {
   // Values representing zero/false and one/true in the EvalT type.
   EvalT zero_;
   EvalT one_;
+
+  // When parsing in parallel, all modules of the netlist and the index of the
+  // one being parsed.
+  PendingModules* pending_modules_ = nullptr;
+  int64_t module_index_ = 0;
 };
 
 using Parser = AbstractParser<>;
 
 template <typename EvalT>
-absl::StatusOr<std::string> AbstractParser<EvalT>::PopNameOrError() {
+absl::StatusOr<std::string_view> AbstractParser<EvalT>::PopNameOrError() {
   XLS_ASSIGN_OR_RETURN(Token token, scanner_->Pop());
   if (token.kind == TokenKind::kName) {
     return token.value;
   }
-  return absl::InvalidArgumentError("Expected name token; got: " +
-                                    token.ToString());
+  return absl::InvalidArgumentError(
+      absl::StrCat("Expected name token; got: ", token.ToString()));
 }
 
 template <typename EvalT>
@@ -350,16 +429,16 @@ absl::StatusOr<int64_t> AbstractParser<EvalT>::PopNumberOrError(size_t& width) {
 
     int64_t result;
     if (!absl::SimpleAtoi(token.value, &result)) {
-      return absl::InternalError(
-          "Number token's value cannot be parsed as an int64_t: " +
-          token.value);
+      return absl::InternalError(absl::StrCat(
+          "Number token's value cannot be parsed as an int64_t: ",
+          token.value));
     }
     // Size field defaults to 32 when not explicitly specified.
     width = 32;
     return result;
   }
-  return absl::InvalidArgumentError("Expected number token; got: " +
-                                    token.ToString());
+  return absl::InvalidArgumentError(
+      absl::StrCat("Expected number token; got: ", token.ToString()));
 }
 
 template <typename EvalT>
@@ -369,7 +448,7 @@ absl::StatusOr<int64_t> AbstractParser<EvalT>::PopNumberOrError() {
 }
 
 template <typename EvalT>
-absl::StatusOr<std::variant<std::string, int64_t>>
+absl::StatusOr<std::variant<std::string_view, int64_t>>
 AbstractParser<EvalT>::PopNameOrNumberOrError(size_t& width) {
   const TokenKind kind = scanner_->Peek()->kind;
   switch (kind) {
@@ -386,7 +465,7 @@ AbstractParser<EvalT>::PopNameOrNumberOrError(size_t& width) {
 }
 
 template <typename EvalT>
-absl::StatusOr<std::variant<std::string, int64_t>>
+absl::StatusOr<std::variant<std::string_view, int64_t>>
 AbstractParser<EvalT>::PopNameOrNumberOrError() {
   size_t width;
   return PopNameOrNumberOrError(width);
@@ -416,8 +495,8 @@ AbstractParser<EvalT>::PopParenNameList() {
       XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kCloseParen));
       break;
     }
-    XLS_ASSIGN_OR_RETURN(std::string name, PopNameOrError());
-    results.push_back(name);
+    XLS_ASSIGN_OR_RETURN(std::string_view name, PopNameOrError());
+    results.push_back(std::string(name));
     must_end = !TryDropToken(TokenKind::kComma);
   }
   return results;
@@ -437,18 +516,19 @@ absl::Status AbstractParser<EvalT>::DropKeywordOrError(
 template <typename EvalT>
 absl::StatusOr<const AbstractCellLibraryEntry<EvalT>*>
 AbstractParser<EvalT>::ParseCellModule(AbstractNetlist<EvalT>& netlist) {
-  XLS_ASSIGN_OR_RETURN(std::string name, PopNameOrError());
-  auto maybe_module = netlist.MaybeGetModule(name);
+  XLS_ASSIGN_OR_RETURN(std::string_view name, PopNameOrError());
+  XLS_ASSIGN_OR_RETURN(std::optional<const AbstractModule<EvalT>*> maybe_module,
+                       FindPreviousModule(name, netlist));
   if (maybe_module.has_value()) {
     return maybe_module.value()->AsCellLibraryEntry();
   }
   if (name == "SB_LUT4") {
     XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kStartParams));
     XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kDot));
-    XLS_ASSIGN_OR_RETURN(std::string param_name, PopNameOrError());
+    XLS_ASSIGN_OR_RETURN(std::string_view param_name, PopNameOrError());
     if (param_name != "LUT_INIT") {
-      return absl::InvalidArgumentError(
-          "Expected a single .LUT_INIT named parameter, got: " + param_name);
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Expected a single .LUT_INIT named parameter, got: ", param_name));
     }
     XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kOpenParen));
     XLS_ASSIGN_OR_RETURN(int64_t lut_mask, PopNumberOrError());
@@ -459,21 +539,42 @@ AbstractParser<EvalT>::ParseCellModule(AbstractNetlist<EvalT>& netlist) {
   return cell_library_->GetEntry(name);
 }
 
+template <typename EvalT>
+absl::StatusOr<std::optional<const AbstractModule<EvalT>*>>
+AbstractParser<EvalT>::FindPreviousModule(std::string_view name,
+                                          AbstractNetlist<EvalT>& netlist) {
+  if (pending_modules_ == nullptr) {
+    return netlist.MaybeGetModule(name);
+  }
+  auto it = pending_modules_->name_to_index.find(name);
+  if (it == pending_modules_->name_to_index.end() ||
+      it->second >= module_index_) {
+    return std::nullopt;
+  }
+  PendingModule& pending = *pending_modules_->modules[it->second];
+  pending.parsed.WaitForNotification();
+  if (!pending.module.ok()) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "Instantiated module %s could not be parsed.", name));
+  }
+  return pending.module->get();
+}
+
 template <typename EvalT>
 absl::StatusOr<AbstractNetRef<EvalT>> AbstractParser<EvalT>::ParseNetRef(
     AbstractModule<EvalT>* module) {
-  using TokenT = std::variant<std::string, int64_t>;
+  using TokenT = std::variant<std::string_view, int64_t>;
   XLS_ASSIGN_OR_RETURN(TokenT token, PopNameOrNumberOrError());
   if (std::holds_alternative<int64_t>(token)) {
     int64_t value = std::get<int64_t>(token);
     return module->AddOrResolveNumber(value);
   }
 
-  std::string name = std::get<std::string>(token);
+  std::string_view name = std::get<std::string_view>(token);
   if (TryDropToken(TokenKind::kOpenBracket)) {
     XLS_ASSIGN_OR_RETURN(int64_t index, PopNumberOrError());
     XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kCloseBracket));
-    absl::StrAppend(&name, "[", index, "]");
+    return module->ResolveNet(absl::StrCat(name, "[", index, "]"));
   }
   return module->ResolveNet(name);
 }
@@ -486,21 +587,23 @@ absl::Status AbstractParser<EvalT>::ParseInstance(
 
   XLS_ASSIGN_OR_RETURN(const AbstractCellLibraryEntry<EvalT>* cle,
                        ParseCellModule(netlist));
-  XLS_ASSIGN_OR_RETURN(std::string name, PopNameOrError());
+  XLS_ASSIGN_OR_RETURN(std::string_view name, PopNameOrError());
   XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kOpenParen));
   // LRM 23.3.2 Calls these "named parameter assignments".
   absl::flat_hash_map<std::string, AbstractNetRef<EvalT>>
       named_parameter_assignments;
   while (true) {
     XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kDot));
-    XLS_ASSIGN_OR_RETURN(std::string pin_name, PopNameOrError());
+    XLS_ASSIGN_OR_RETURN(std::string_view pin_name, PopNameOrError());
     XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kOpenParen));
     XLS_ASSIGN_OR_RETURN(AbstractNetRef<EvalT> net, ParseNetRef(module));
     XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kCloseParen));
     VLOG(3) << "Adding named parameter assignment: " << pin_name;
-    bool is_new = named_parameter_assignments.insert({pin_name, net}).second;
+    bool is_new =
+        named_parameter_assignments.emplace(std::string(pin_name), net).second;
     if (!is_new) {
-      return absl::InvalidArgumentError("Duplicate port seen: " + pin_name);
+      return absl::InvalidArgumentError(
+          absl::StrCat("Duplicate port seen: ", pin_name));
     }
     if (!TryDropToken(TokenKind::kComma)) {
       break;
@@ -591,9 +694,9 @@ template <typename EvalT>
 absl::Status AbstractParser<EvalT>::ParseNetDecl(AbstractModule<EvalT>* module,
                                                  NetDeclKind kind) {
   XLS_ASSIGN_OR_RETURN(auto range, ParseOptionalRange());
-  std::vector<std::string> names;
+  std::vector<std::string_view> names;
   do {
-    XLS_ASSIGN_OR_RETURN(std::string name, PopNameOrError());
+    XLS_ASSIGN_OR_RETURN(std::string_view name, PopNameOrError());
     names.push_back(name);
   } while (TryDropToken(TokenKind::kComma));
 
@@ -606,7 +709,7 @@ absl::Status AbstractParser<EvalT>::ParseNetDecl(AbstractModule<EvalT>* module,
         "Multiple declarations for a ranged net is not yet supported.");
   }
 
-  for (const std::string& name : names) {
+  for (std::string_view name : names) {
     switch (kind) {
       case NetDeclKind::kInput:
       case NetDeclKind::kOutput:
@@ -634,12 +737,12 @@ absl::Status AbstractParser<EvalT>::ParseOneEntryOfAssignDecl(
     AbstractModule<EvalT>* module, std::vector<std::string>& side,
     bool is_lhs) {
   size_t number_bit_width;
-  using TokenT = std::variant<std::string, int64_t>;
+  using TokenT = std::variant<std::string_view, int64_t>;
   XLS_ASSIGN_OR_RETURN(TokenT token, PopNameOrNumberOrError(number_bit_width));
-  std::string name;
+  std::string_view name;
   std::optional<Range> range = std::nullopt;
-  if (std::holds_alternative<std::string>(token)) {
-    name = std::get<std::string>(token);
+  if (std::holds_alternative<std::string_view>(token)) {
+    name = std::get<std::string_view>(token);
     XLS_ASSIGN_OR_RETURN(range, ParseOptionalRange(false));
   } else {
     // If we parsed a number, but we're expecting an lvalue, throw an error.
@@ -688,7 +791,7 @@ absl::Status AbstractParser<EvalT>::ParseOneEntryOfAssignDecl(
         high--;
       }
     } else {
-      side.push_back(name);
+      side.push_back(std::string(name));
     }
   }
   return absl::OkStatus();
@@ -766,7 +869,7 @@ template <typename EvalT>
 absl::StatusOr<std::unique_ptr<AbstractModule<EvalT>>>
 AbstractParser<EvalT>::ParseModule(AbstractNetlist<EvalT>& netlist) {
   XLS_RETURN_IF_ERROR(DropKeywordOrError("module"));
-  XLS_ASSIGN_OR_RETURN(std::string module_name, PopNameOrError());
+  XLS_ASSIGN_OR_RETURN(std::string_view module_name, PopNameOrError());
   XLS_ASSIGN_OR_RETURN(std::vector<std::string> module_ports,
                        PopParenNameList());
   XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kSemicolon));
@@ -786,7 +889,11 @@ AbstractParser<EvalT>::ParseModule(AbstractNetlist<EvalT>& netlist) {
 template <typename EvalT>
 absl::StatusOr<std::unique_ptr<AbstractNetlist<EvalT>>>
 AbstractParser<EvalT>::ParseNetlist(AbstractCellLibrary<EvalT>* cell_library,
-                                    Scanner* scanner, EvalT zero, EvalT one) {
+                                    Scanner* scanner, EvalT zero, EvalT one,
+                                    int64_t threads) {
+  if (threads > 1) {
+    return ParseNetlistInParallel(cell_library, scanner, zero, one, threads);
+  }
   auto netlist = std::make_unique<AbstractNetlist<EvalT>>();
   AbstractParser<EvalT> p(cell_library, scanner, zero, one);
   while (!scanner->AtEof()) {
@@ -797,6 +904,56 @@ AbstractParser<EvalT>::ParseNetlist(AbstractCellLibrary<EvalT>* cell_library,
   return std::move(netlist);
 }
 
+template <typename EvalT>
+absl::StatusOr<std::unique_ptr<AbstractNetlist<EvalT>>>
+AbstractParser<EvalT>::ParseNetlistInParallel(
+    AbstractCellLibrary<EvalT>* cell_library, Scanner* scanner, EvalT zero,
+    EvalT one, int64_t threads) {
+  auto netlist = std::make_unique<AbstractNetlist<EvalT>>();
+  if (scanner->AtEof()) {
+    return std::move(netlist);
+  }
+  XLS_ASSIGN_OR_RETURN(Token start, scanner->Peek());
+  absl::StatusOr<std::vector<ModuleText>> module_texts = SplitModules(
+      scanner->text().substr(scanner->offset()), start.pos);
+  if (!module_texts.ok()) {
+    // Let the serial parser report where the text goes wrong.
+    return ParseNetlist(cell_library, scanner, zero, one, /*threads=*/1);
+  }
+  PendingModules pending_modules;
+  for (const ModuleText& module_text : *module_texts) {
+    auto pending = std::make_unique<PendingModule>();
+    pending->name = module_text.name;
+    pending->text = module_text.text;
+    pending->pos = module_text.pos;
+    pending_modules.name_to_index.emplace(pending->name,
+                                          pending_modules.modules.size());
+    pending_modules.modules.push_back(std::move(pending));
+  }
+
+  // Modules are claimed in order, so a module only ever waits for modules
+  // which are already being parsed.
+  ParallelFor(pending_modules.modules.size(), threads, [&](int64_t i) {
+    PendingModule& pending = *pending_modules.modules[i];
+    Scanner module_scanner(pending.text, pending.pos);
+    AbstractParser<EvalT> p(cell_library, &module_scanner, zero, one);
+    p.pending_modules_ = &pending_modules;
+    p.module_index_ = i;
+    pending.module = p.ParseModule(*netlist);
+    if (pending.module.ok()) {
+      // Computed lazily otherwise; do it before other threads may read it.
+      (*pending.module)->AsCellLibraryEntry();
+    }
+    pending.parsed.Notify();
+  });
+
+  for (std::unique_ptr<PendingModule>& pending : pending_modules.modules) {
+    XLS_RETURN_IF_ERROR(pending->module.status());
+    netlist->AddModule(std::move(pending->module).value());
+  }
+  return std::move(netlist);
+}
+
 }  // namespace rtl
 }  // namespace netlist
 }  // namespace xls
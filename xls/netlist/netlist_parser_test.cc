@@ -16,8 +16,10 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <filesystem>  // NOLINT
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -27,7 +29,10 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/substitute.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
 #include "xls/common/status/matchers.h"
 #include "xls/netlist/cell_library.h"
 #include "xls/netlist/fake_cell_library.h"
@@ -39,7 +44,10 @@ namespace rtl {
 namespace {
 
 using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::EndsWith;
 using ::testing::HasSubstr;
+using ::testing::StartsWith;
 
 TEST(NetlistParserTest, EmptyModule) {
   std::string netlist = R"(module main(); endmodule)";
@@ -448,6 +456,177 @@ endmodule)";
   TestAssignHelper(m);
 }
 
+constexpr char kHierarchicalNetlist[] = R"(
+module inverter(a, y);
+  input a;
+  output y;
+  INV inv0 ( .A(a), .ZN(y) );
+endmodule
+
+module and_inverted(a, b, y);
+  input a, b;
+  output y;
+  wire ab;
+  AND and0 ( .A(a), .B(b), .Z(ab) );
+  inverter inv0 ( .a(ab), .y(y) );
+endmodule
+
+module other(a, y);
+  input a;
+  output y;
+  INV inv0 ( .A(a), .ZN(y) );
+endmodule
+
+module main(a, b, c, y);
+  input a, b, c;
+  output y;
+  wire x;
+  and_inverted ai0 ( .a(a), .b(b), .y(x) );
+  and_inverted ai1 ( .a(x), .b(c), .y(y) );
+endmodule)";
+
+TEST(NetlistParserTest, ParallelParseMatchesSerialParse) {
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  Scanner serial_scanner(kHierarchicalNetlist);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Netlist> serial,
+      Parser::ParseNetlist(&cell_library, &serial_scanner));
+  Scanner parallel_scanner(kHierarchicalNetlist);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Netlist> parallel,
+      Parser::ParseNetlist(&cell_library, &parallel_scanner, /*threads=*/4));
+
+  auto module_names = [](Netlist& netlist) {
+    std::vector<std::string> names;
+    for (const auto& module : netlist.modules()) {
+      names.push_back(module->name());
+    }
+    return names;
+  };
+  EXPECT_THAT(module_names(*parallel),
+              ElementsAre("inverter", "and_inverted", "other", "main"));
+  EXPECT_EQ(module_names(*parallel), module_names(*serial));
+  for (int64_t i = 0; i < serial->modules().size(); ++i) {
+    const Module* expected = serial->modules()[i].get();
+    const Module* actual = parallel->modules()[i].get();
+    EXPECT_EQ(actual->nets().size(), expected->nets().size());
+    ASSERT_EQ(actual->cells().size(), expected->cells().size());
+    for (int64_t j = 0; j < expected->cells().size(); ++j) {
+      EXPECT_EQ(actual->cells()[j]->name(), expected->cells()[j]->name());
+      EXPECT_EQ(actual->cells()[j]->cell_library_entry()->name(),
+                expected->cells()[j]->cell_library_entry()->name());
+    }
+  }
+
+  // Instantiated modules resolve to the modules of the same netlist.
+  XLS_ASSERT_OK_AND_ASSIGN(const Module* and_inverted,
+                           parallel->GetModule("and_inverted"));
+  XLS_ASSERT_OK_AND_ASSIGN(const Module* main, parallel->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(Cell * ai1, main->ResolveCell("ai1"));
+  EXPECT_EQ(ai1->cell_library_entry(), and_inverted->AsCellLibraryEntry());
+}
+
+TEST(NetlistParserTest, ParallelParseReportsSameErrors) {
+  // The cell in the third module is missing its B input.
+  std::string netlist = R"(module first(a, y);
+  input a;
+  output y;
+  INV inv0 ( .A(a), .ZN(y) );
+endmodule
+module second(a, y);
+  input a;
+  output y;
+  first f0 ( .a(a), .y(y) );
+endmodule
+module third(a, y);
+  input a;
+  output y;
+  AND and0 ( .A(a), .Z(y) );
+endmodule
+module fourth(a, y);
+  input a;
+  output y;
+  second s0 ( .a(a), .y(y) );
+endmodule)";
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  Scanner serial_scanner(netlist);
+  absl::StatusOr<std::unique_ptr<Netlist>> serial =
+      Parser::ParseNetlist(&cell_library, &serial_scanner);
+  EXPECT_THAT(serial, StatusIs(absl::StatusCode::kInvalidArgument,
+                               HasSubstr("@ 14:3")));
+  Scanner parallel_scanner(netlist);
+  absl::StatusOr<std::unique_ptr<Netlist>> parallel =
+      Parser::ParseNetlist(&cell_library, &parallel_scanner, /*threads=*/3);
+  EXPECT_EQ(parallel.status(), serial.status());
+}
+
+TEST(NetlistParserTest, SplitModules) {
+  // Nothing inside comments, attributes, escaped names or numbers is taken for
+  // a keyword.
+  constexpr std::string_view kText = R"(// module not_a_module
+module a(x); /* endmodule */
+  input x;
+  (* keep = "endmodule" *)
+  wire \endmodule ;
+  assign \endmodule = 4'hbeef;
+endmodule
+  module \b$c (y);
+  output y;
+endmodule
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<ModuleText> modules,
+                           SplitModules(kText, Pos{10, 0}));
+  ASSERT_EQ(modules.size(), 2);
+  EXPECT_EQ(modules[0].name, "a");
+  EXPECT_EQ(modules[0].pos.ToHumanString(), "12:1");
+  EXPECT_THAT(modules[0].text, StartsWith("module a(x);"));
+  EXPECT_THAT(modules[0].text, EndsWith("= 4'hbeef;\nendmodule"));
+  EXPECT_EQ(modules[1].name, "\\b$c");
+  EXPECT_EQ(modules[1].pos.ToHumanString(), "18:3");
+  EXPECT_EQ(modules[1].text, "module \\b$c (y);\n  output y;\nendmodule");
+
+  EXPECT_THAT(SplitModules("module a(x); input x;", Pos{0, 0}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("has no endmodule")));
+  EXPECT_THAT(SplitModules("wire x;", Pos{0, 0}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Expected keyword 'module' @ 1:1")));
+}
+
+TEST(NetlistParserTest, ParallelParseReportsSameErrorsForUnsplittableText) {
+  // The modules cannot be delimited, so the text is parsed serially.
+  constexpr std::string_view kNetlist = R"(module first(a, y);
+  input a;
+  output y;
+  INV inv0 ( .A(a), .ZN(y) );
+endmodule
+module second(a, y);
+  input a;
+  output y;
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  Scanner serial_scanner(kNetlist);
+  absl::StatusOr<std::unique_ptr<Netlist>> serial =
+      Parser::ParseNetlist(&cell_library, &serial_scanner);
+  EXPECT_FALSE(serial.ok());
+  Scanner parallel_scanner(kNetlist);
+  absl::StatusOr<std::unique_ptr<Netlist>> parallel =
+      Parser::ParseNetlist(&cell_library, &parallel_scanner, /*threads=*/2);
+  EXPECT_EQ(parallel.status(), serial.status());
+}
+
+TEST(NetlistParserTest, ScanFile) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path path = temp_dir.path() / "netlist.v";
+  XLS_ASSERT_OK(SetFileContents(path, kHierarchicalNetlist));
+  XLS_ASSERT_OK_AND_ASSIGN(Scanner scanner, Scanner::FromFile(path));
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Netlist> n,
+                           Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const Module* m, n->GetModule("main"));
+  EXPECT_EQ(m->cells().size(), 2);
+}
+
 }  // namespace
 }  // namespace rtl
 }  // namespace netlist
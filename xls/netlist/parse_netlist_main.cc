@@ -36,6 +36,8 @@
 #include "xls/netlist/netlist_parser.h"
 
 ABSL_FLAG(bool, show_clusters, false, "Show the logic clusters found.");
+ABSL_FLAG(int64_t, parse_threads, 1,
+          "Number of threads used to parse the modules of the netlist.");
 
 namespace xls {
 namespace {
@@ -51,17 +53,18 @@ absl::Status RealMain(std::string_view netlist_path,
                          netlist::CellLibrary::FromProto(cell_library_proto));
   }
 
-  XLS_ASSIGN_OR_RETURN(std::string netlist_text, GetFileContents(netlist_path));
-  netlist::rtl::Scanner scanner(netlist_text);
+  XLS_ASSIGN_OR_RETURN(netlist::rtl::Scanner scanner,
+                       netlist::rtl::Scanner::FromFile(netlist_path));
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<netlist::rtl::Netlist> netlist,
-      netlist::rtl::Parser::ParseNetlist(&cell_library, &scanner));
+      netlist::rtl::Parser::ParseNetlist(&cell_library, &scanner,
+                                         absl::GetFlag(FLAGS_parse_threads)));
   netlist::rtl::Module* module = netlist->modules()[0].get();
   std::cout << "nets:  " << module->nets().size() << '\n';
   std::cout << "cells: " << module->cells().size() << '\n';
   absl::flat_hash_map<netlist::CellKind, int64_t> cell_kind_to_count;
-  for (const auto& name_and_cell : module->cells()) {
-    cell_kind_to_count[name_and_cell->kind()]++;
+  for (const netlist::rtl::Cell* cell : module->cells()) {
+    cell_kind_to_count[cell->kind()]++;
   }
   std::cout << "cell-kind breakdown:" << '\n';
   for (int64_t i = static_cast<int64_t>(netlist::CellKind::kFlop);
@@ -0,0 +1,333 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/simulation/block_module_simulator.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/types/span.h"
+#include "xls/codegen/flattening.h"
+#include "xls/codegen/module_signature.h"
+#include "xls/codegen/module_signature.pb.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/interpreter/block_evaluator.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/block.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/value.h"
+#include "xls/ir/value_utils.h"
+
+namespace xls {
+namespace verilog {
+namespace {
+
+// Number of cycles the reset signal is asserted before driving inputs. Matches
+// the Verilog testbench built by ModuleTestbench.
+constexpr int64_t kResetCycles = 5;
+
+std::optional<PipelineControl> GetPipelineControl(
+    const ModuleSignature& signature) {
+  if (signature.proto().has_pipeline() &&
+      signature.proto().pipeline().has_pipeline_control()) {
+    return signature.proto().pipeline().pipeline_control();
+  }
+  return std::nullopt;
+}
+
+// Checks that the ports of `block` match those described by `signature`.
+absl::Status CheckPortCorrespondence(const ModuleSignature& signature,
+                                     Block* block) {
+  if (block->name() != signature.module_name()) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Block `%s` does not match module `%s`", block->name(),
+                        signature.module_name()));
+  }
+  if (signature.proto().has_clock_name() &&
+      (!block->GetClockPort().has_value() ||
+       block->GetClockPort()->name != signature.proto().clock_name())) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Block `%s` has no clock port named `%s`",
+                        block->name(), signature.proto().clock_name()));
+  }
+
+  // Input ports of the block which are not data inputs.
+  absl::flat_hash_set<std::string> control_inputs;
+  if (signature.proto().has_reset()) {
+    // Blocks parsed from IR text do not record their reset port so only check
+    // for an input port of the right name and width.
+    const std::string& reset_name = signature.proto().reset().name();
+    absl::StatusOr<InputPort*> reset_port = block->GetInputPort(reset_name);
+    if (!reset_port.ok() ||
+        (*reset_port)->GetType()->GetFlatBitCount() != 1) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Block `%s` has no single-bit reset port named `%s`",
+                          block->name(), reset_name));
+    }
+    control_inputs.insert(reset_name);
+  }
+  std::optional<PipelineControl> pipeline_control =
+      GetPipelineControl(signature);
+  if (pipeline_control.has_value() && pipeline_control->has_valid()) {
+    control_inputs.insert(pipeline_control->valid().input_name());
+  }
+  if (pipeline_control.has_value() && pipeline_control->has_manual()) {
+    control_inputs.insert(pipeline_control->manual().input_name());
+  }
+
+  absl::flat_hash_set<std::string> data_inputs;
+  for (const PortProto& input : signature.data_inputs()) {
+    absl::StatusOr<InputPort*> port = block->GetInputPort(input.name());
+    if (!port.ok()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Block `%s` has no input port named `%s`",
+                          block->name(), input.name()));
+    }
+    if ((*port)->GetType()->GetFlatBitCount() != input.width()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Input port `%s` of block `%s` has width %d, expected %d",
+          input.name(), block->name(), (*port)->GetType()->GetFlatBitCount(),
+          input.width()));
+    }
+    data_inputs.insert(input.name());
+  }
+  for (const PortProto& output : signature.data_outputs()) {
+    absl::StatusOr<OutputPort*> port = block->GetOutputPort(output.name());
+    if (!port.ok()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Block `%s` has no output port named `%s`",
+                          block->name(), output.name()));
+    }
+    int64_t width = (*port)->operand(0)->GetType()->GetFlatBitCount();
+    if (width != output.width()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Output port `%s` of block `%s` has width %d, expected %d",
+          output.name(), block->name(), width, output.width()));
+    }
+  }
+  for (InputPort* port : block->GetInputPorts()) {
+    if (!data_inputs.contains(port->GetName()) &&
+        !control_inputs.contains(port->GetName())) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Input port `%s` of block `%s` is not described by the module "
+          "signature",
+          port->GetName(), block->name()));
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<BlockModuleSimulator>>
+BlockModuleSimulator::Create(const ModuleSignature& signature, Block* block,
+                             const BlockEvaluator& evaluator) {
+  const ModuleSignatureProto& proto = signature.proto();
+  if (!proto.has_combinational() && !proto.has_fixed_latency() &&
+      !proto.has_pipeline()) {
+    return absl::UnimplementedError(absl::StrCat(
+        "Unsupported interface: ", proto.interface_oneof_case()));
+  }
+  XLS_RETURN_IF_ERROR(CheckPortCorrespondence(signature, block));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<BlockContinuation> continuation,
+                       evaluator.NewContinuation(block));
+  return absl::WrapUnique(
+      new BlockModuleSimulator(signature, block, std::move(continuation)));
+}
+
+BlockModuleSimulator::BlockModuleSimulator(
+    const ModuleSignature& signature, Block* block,
+    std::unique_ptr<BlockContinuation> continuation)
+    : signature_(signature),
+      block_(block),
+      continuation_(std::move(continuation)),
+      initial_registers_(continuation_->registers()) {}
+
+absl::Status BlockModuleSimulator::SetDataInputs(const BitsMap* inputs) {
+  for (const PortProto& input : signature_.data_inputs()) {
+    XLS_ASSIGN_OR_RETURN(InputPort * port, block_->GetInputPort(input.name()));
+    if (inputs == nullptr) {
+      input_port_values_[input.name()] = ZeroOfType(port->GetType());
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(
+        input_port_values_[input.name()],
+        UnflattenBitsToValue(inputs->at(input.name()), port->GetType()));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BlockModuleSimulator::RunCycle(bool in_reset) {
+  XLS_RETURN_IF_ERROR(continuation_->RunOneCycle(input_port_values_));
+  if (!in_reset && !continuation_->events().assert_msgs.empty()) {
+    return absl::AbortedError(
+        absl::StrFormat("Assertion failed in block `%s`: %s", block_->name(),
+                        absl::StrJoin(continuation_->events().assert_msgs,
+                                      "; ")));
+  }
+  return absl::OkStatus();
+}
+
+BlockModuleSimulator::BitsMap BlockModuleSimulator::GetDataOutputs() {
+  BitsMap outputs;
+  for (const PortProto& output : signature_.data_outputs()) {
+    outputs[output.name()] =
+        FlattenValueToBits(continuation_->output_ports().at(output.name()));
+  }
+  return outputs;
+}
+
+absl::StatusOr<BlockModuleSimulator::BitsMap> BlockModuleSimulator::RunFunction(
+    const BitsMap& inputs) {
+  XLS_ASSIGN_OR_RETURN(std::vector<BitsMap> outputs, RunBatched({inputs}));
+  XLS_RET_CHECK_EQ(outputs.size(), 1);
+  return outputs[0];
+}
+
+absl::StatusOr<std::vector<BlockModuleSimulator::BitsMap>>
+BlockModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) {
+  for (const BitsMap& input : inputs) {
+    XLS_RETURN_IF_ERROR(signature_.ValidateInputs(input));
+  }
+  if (inputs.empty()) {
+    return std::vector<BitsMap>();
+  }
+
+  XLS_RETURN_IF_ERROR(continuation_->SetRegisters(initial_registers_));
+  input_port_values_.clear();
+  for (InputPort* port : block_->GetInputPorts()) {
+    input_port_values_[port->GetName()] = ZeroOfType(port->GetType());
+  }
+  std::optional<PipelineControl> pipeline_control =
+      GetPipelineControl(signature_);
+  const bool has_valid =
+      pipeline_control.has_value() && pipeline_control->has_valid();
+  auto set_valid = [&](bool value) {
+    if (has_valid) {
+      input_port_values_[pipeline_control->valid().input_name()] =
+          Value(UBits(value ? 1 : 0, 1));
+    }
+  };
+  if (pipeline_control.has_value() && pipeline_control->has_manual()) {
+    const std::string& name = pipeline_control->manual().input_name();
+    XLS_ASSIGN_OR_RETURN(InputPort * port, block_->GetInputPort(name));
+    input_port_values_[name] =
+        Value(Bits::AllOnes(port->GetType()->GetFlatBitCount()));
+  }
+
+  if (signature_.proto().has_reset()) {
+    const ResetProto& reset = signature_.proto().reset();
+    input_port_values_[reset.name()] =
+        Value(UBits(reset.active_low() ? 0 : 1, 1));
+    for (int64_t i = 0; i < kResetCycles; ++i) {
+      XLS_RETURN_IF_ERROR(RunCycle(/*in_reset=*/true));
+    }
+    input_port_values_[reset.name()] =
+        Value(UBits(reset.active_low() ? 1 : 0, 1));
+  }
+
+  std::vector<BitsMap> outputs;
+  outputs.reserve(inputs.size());
+  if (signature_.proto().has_combinational()) {
+    for (const BitsMap& input : inputs) {
+      XLS_RETURN_IF_ERROR(SetDataInputs(&input));
+      XLS_RETURN_IF_ERROR(RunCycle());
+      outputs.push_back(GetDataOutputs());
+    }
+  } else if (signature_.proto().has_fixed_latency()) {
+    const int64_t latency = signature_.proto().fixed_latency().latency();
+    for (const BitsMap& input : inputs) {
+      // Hold the inputs until the output is captured at the end of cycle
+      // `latency`, then for one more cycle as the Verilog testbench does.
+      XLS_RETURN_IF_ERROR(SetDataInputs(&input));
+      for (int64_t i = 0; i <= latency; ++i) {
+        XLS_RETURN_IF_ERROR(RunCycle());
+      }
+      outputs.push_back(GetDataOutputs());
+      XLS_RETURN_IF_ERROR(RunCycle());
+    }
+  } else {
+    XLS_RET_CHECK(signature_.proto().has_pipeline());
+    // Issue a new input every cycle and capture the output for input `i` at
+    // the end of cycle `i + latency`.
+    const int64_t latency = signature_.proto().pipeline().latency();
+    for (int64_t cycle = 0; cycle < inputs.size() + latency; ++cycle) {
+      const bool issue = cycle < inputs.size();
+      XLS_RETURN_IF_ERROR(SetDataInputs(issue ? &inputs[cycle] : nullptr));
+      set_valid(issue);
+      XLS_RETURN_IF_ERROR(RunCycle());
+      if (cycle < latency) {
+        continue;
+      }
+      if (has_valid && pipeline_control->valid().has_output_name()) {
+        const Value& output_valid = continuation_->output_ports().at(
+            pipeline_control->valid().output_name());
+        if (output_valid != Value(UBits(1, 1))) {
+          return absl::InternalError(absl::StrFormat(
+              "Expected output valid `%s` to be asserted in cycle %d",
+              pipeline_control->valid().output_name(), cycle));
+        }
+      }
+      outputs.push_back(GetDataOutputs());
+    }
+  }
+  return outputs;
+}
+
+absl::StatusOr<Value> BlockModuleSimulator::RunFunction(
+    const absl::flat_hash_map<std::string, Value>& inputs) {
+  XLS_ASSIGN_OR_RETURN(std::vector<Value> outputs, RunBatched({inputs}));
+  XLS_RET_CHECK_EQ(outputs.size(), 1);
+  return outputs[0];
+}
+
+absl::StatusOr<std::vector<Value>> BlockModuleSimulator::RunBatched(
+    absl::Span<const absl::flat_hash_map<std::string, Value>> inputs) {
+  XLS_RET_CHECK_EQ(signature_.data_outputs().size(), 1);
+  std::vector<BitsMap> bits_inputs;
+  for (const auto& input : inputs) {
+    XLS_RETURN_IF_ERROR(signature_.ValidateInputs(input));
+    BitsMap& bits_input = bits_inputs.emplace_back();
+    for (const auto& [name, value] : input) {
+      bits_input[name] = FlattenValueToBits(value);
+    }
+  }
+  XLS_ASSIGN_OR_RETURN(std::vector<BitsMap> bits_outputs,
+                       RunBatched(bits_inputs));
+  const PortProto& output_port = signature_.data_outputs().front();
+  std::vector<Value> outputs;
+  for (const BitsMap& bits_output : bits_outputs) {
+    XLS_ASSIGN_OR_RETURN(
+        Value output, UnflattenBitsToValue(bits_output.at(output_port.name()),
+                                           output_port.type()));
+    outputs.push_back(std::move(output));
+  }
+  return outputs;
+}
+
+}  // namespace verilog
+}  // namespace xls
@@ -0,0 +1,105 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_SIMULATION_BLOCK_MODULE_SIMULATOR_H_
+#define XLS_SIMULATION_BLOCK_MODULE_SIMULATOR_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/codegen/module_signature.h"
+#include "xls/interpreter/block_evaluator.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/block.h"
+#include "xls/ir/value.h"
+#include "xls/jit/block_jit.h"
+
+namespace xls {
+namespace verilog {
+
+// Simulates a module generated by XLS by evaluating the block IR the Verilog
+// was generated from instead of running the Verilog text through an external
+// simulator. The block is compiled once (with the block JIT by default) and is
+// then stepped cycle by cycle with the same input schedule as the testbench
+// built by ModuleSimulator, which is much faster for regressions. Because the
+// block rather than the emitted Verilog is simulated, an external Verilog
+// simulator should still be used for sign-off.
+//
+// Tools select this simulator with the name kBlockJitSimulatorName. Only
+// function-style interfaces (combinational, fixed latency and pipelined) are
+// supported. The methods mirror those of ModuleSimulator. Data inputs are
+// driven with zeros where the Verilog testbench would drive X.
+class BlockModuleSimulator {
+ public:
+  // Type alias for passing named Bits value to and from module simulation.
+  using BitsMap = absl::flat_hash_map<std::string, Bits>;
+
+  // Creates a simulator of `block` which must be the top block that the module
+  // described by `signature` was generated from. Returns an error if the ports
+  // of the block do not correspond to the signature.
+  static absl::StatusOr<std::unique_ptr<BlockModuleSimulator>> Create(
+      const ModuleSignature& signature, Block* block,
+      const BlockEvaluator& evaluator = kJitBlockEvaluator);
+
+  // Simulates the module with the given inputs as Bits types. Returns a
+  // map containing the outputs by port name.
+  absl::StatusOr<BitsMap> RunFunction(const BitsMap& inputs);
+
+  // Runs the given batch of argument values through the module. The block
+  // state is reset before each batch.
+  absl::StatusOr<std::vector<BitsMap>> RunBatched(
+      absl::Span<const BitsMap> inputs);
+
+  // Overloads which accept Values rather than Bits. The module must have a
+  // single data output.
+  absl::StatusOr<Value> RunFunction(
+      const absl::flat_hash_map<std::string, Value>& inputs);
+  absl::StatusOr<std::vector<Value>> RunBatched(
+      absl::Span<const absl::flat_hash_map<std::string, Value>> inputs);
+
+ private:
+  BlockModuleSimulator(const ModuleSignature& signature, Block* block,
+                       std::unique_ptr<BlockContinuation> continuation);
+
+  // Sets the data input ports to the given values, or to zero if `inputs` is
+  // null.
+  absl::Status SetDataInputs(const BitsMap* inputs);
+
+  // Runs a single cycle with the current input port values. Returns an error
+  // if an assertion fires unless `in_reset` is true.
+  absl::Status RunCycle(bool in_reset = false);
+
+  // Returns the current values of the data output ports.
+  BitsMap GetDataOutputs();
+
+  ModuleSignature signature_;
+  Block* block_;
+  std::unique_ptr<BlockContinuation> continuation_;
+  // Register values of a newly created continuation, restored before each
+  // batch.
+  absl::flat_hash_map<std::string, Value> initial_registers_;
+  // Values driven on every input port of the block in the next cycle.
+  absl::flat_hash_map<std::string, Value> input_port_values_;
+};
+
+}  // namespace verilog
+}  // namespace xls
+
+#endif  // XLS_SIMULATION_BLOCK_MODULE_SIMULATOR_H_
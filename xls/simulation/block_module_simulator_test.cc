@@ -0,0 +1,232 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/simulation/block_module_simulator.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "xls/codegen/module_signature.h"
+#include "xls/codegen/module_signature.pb.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/block.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace verilog {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::Pair;
+
+using BitsMap = BlockModuleSimulator::BitsMap;
+
+constexpr char kCombinationalIr[] = R"(
+package test
+
+block comb_diff(x: bits[8], y: bits[8], out: bits[8]) {
+  x: bits[8] = input_port(name=x, id=1)
+  y: bits[8] = input_port(name=y, id=2)
+  sub.3: bits[8] = sub(x, y, id=3)
+  out: () = output_port(sub.3, name=out, id=4)
+}
+)";
+
+// Output is the sum of the current input and the input three cycles earlier.
+constexpr char kFixedLatencyIr[] = R"(
+package test
+
+block fixed_latency_3(clk: clock, x: bits[8], out: bits[8]) {
+  reg x_0(bits[8])
+  reg x_1(bits[8])
+  reg x_2(bits[8])
+  x: bits[8] = input_port(name=x, id=1)
+  x_0_q: bits[8] = register_read(register=x_0, id=2)
+  x_1_q: bits[8] = register_read(register=x_1, id=3)
+  x_2_q: bits[8] = register_read(register=x_2, id=4)
+  x_0_d: () = register_write(x, register=x_0, id=5)
+  x_1_d: () = register_write(x_0_q, register=x_1, id=6)
+  x_2_d: () = register_write(x_1_q, register=x_2, id=7)
+  add.8: bits[8] = add(x_2_q, x, id=8)
+  out: () = output_port(add.8, name=out, id=9)
+}
+)";
+
+// Single-stage pipeline computing `x + 1` with a reset valid signal.
+constexpr char kPipelineIr[] = R"(
+package test
+
+block inc_pipe(clk: clock, rst: bits[1], x: bits[8], in_vld: bits[1],
+               out: bits[8], out_vld: bits[1]) {
+  reg p0_x(bits[8])
+  reg p0_valid(bits[1], reset_value=0, asynchronous=false, active_low=false)
+  rst: bits[1] = input_port(name=rst, id=1)
+  x: bits[8] = input_port(name=x, id=2)
+  in_vld: bits[1] = input_port(name=in_vld, id=3)
+  p0_x_d: () = register_write(x, register=p0_x, id=4)
+  p0_valid_d: () = register_write(in_vld, register=p0_valid, reset=rst, id=5)
+  p0_x_q: bits[8] = register_read(register=p0_x, id=6)
+  p0_valid_q: bits[1] = register_read(register=p0_valid, id=7)
+  one: bits[8] = literal(value=1, id=8)
+  add.9: bits[8] = add(p0_x_q, one, id=9)
+  out: () = output_port(add.9, name=out, id=10)
+  out_vld: () = output_port(p0_valid_q, name=out_vld, id=11)
+}
+)";
+
+class BlockModuleSimulatorTest : public ::testing::Test {
+ protected:
+  absl::StatusOr<Block*> ParseBlock(std::string_view ir_text,
+                                    std::string_view name) {
+    XLS_ASSIGN_OR_RETURN(package_, Parser::ParsePackage(ir_text));
+    return package_->GetBlock(name);
+  }
+
+  std::unique_ptr<Package> package_;
+};
+
+TEST_F(BlockModuleSimulatorTest, CombinationalBatched) {
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block,
+                           ParseBlock(kCombinationalIr, "comb_diff"));
+  ModuleSignatureBuilder b("comb_diff");
+  b.WithCombinationalInterface();
+  b.AddDataInputAsBits("x", 8);
+  b.AddDataInputAsBits("y", 8);
+  b.AddDataOutputAsBits("out", 8);
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, b.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BlockModuleSimulator> simulator,
+                           BlockModuleSimulator::Create(signature, block));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<BitsMap> outputs,
+      simulator->RunBatched(
+          {BitsMap{{"x", UBits(99, 8)}, {"y", UBits(12, 8)}},
+           BitsMap{{"x", UBits(100, 8)}, {"y", UBits(25, 8)}},
+           BitsMap{{"x", UBits(255, 8)}, {"y", UBits(155, 8)}}}));
+  EXPECT_THAT(outputs, ElementsAre(ElementsAre(Pair("out", UBits(87, 8))),
+                                   ElementsAre(Pair("out", UBits(75, 8))),
+                                   ElementsAre(Pair("out", UBits(100, 8)))));
+}
+
+TEST_F(BlockModuleSimulatorTest, FixedLatency) {
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block,
+                           ParseBlock(kFixedLatencyIr, "fixed_latency_3"));
+  ModuleSignatureBuilder b("fixed_latency_3");
+  b.WithClock("clk").WithFixedLatencyInterface(3);
+  b.AddDataInputAsBits("x", 8);
+  b.AddDataOutputAsBits("out", 8);
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, b.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BlockModuleSimulator> simulator,
+                           BlockModuleSimulator::Create(signature, block));
+
+  // Inputs are held for the latency of the module so the output is twice the
+  // input, as with the equivalent ModuleSimulator test.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<BitsMap> outputs,
+      simulator->RunBatched({BitsMap{{"x", UBits(44, 8)}},
+                             BitsMap{{"x", UBits(123, 8)}},
+                             BitsMap{{"x", UBits(7, 8)}}}));
+  EXPECT_THAT(outputs, ElementsAre(ElementsAre(Pair("out", UBits(88, 8))),
+                                   ElementsAre(Pair("out", UBits(246, 8))),
+                                   ElementsAre(Pair("out", UBits(14, 8)))));
+
+  EXPECT_THAT(simulator->RunFunction(absl::flat_hash_map<std::string, Value>{
+                  {"x", Value(UBits(42, 8))}}),
+              IsOkAndHolds(Value(UBits(84, 8))));
+}
+
+TEST_F(BlockModuleSimulatorTest, PipelineWithResetAndValid) {
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, ParseBlock(kPipelineIr, "inc_pipe"));
+  PipelineControl pipeline_control;
+  pipeline_control.mutable_valid()->set_input_name("in_vld");
+  pipeline_control.mutable_valid()->set_output_name("out_vld");
+  ModuleSignatureBuilder b("inc_pipe");
+  b.WithClock("clk");
+  b.WithReset("rst", /*asynchronous=*/false, /*active_low=*/false);
+  b.WithPipelineInterface(/*latency=*/1, /*initiation_interval=*/1,
+                          pipeline_control);
+  b.AddDataInputAsBits("x", 8);
+  b.AddDataOutputAsBits("out", 8);
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, b.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BlockModuleSimulator> simulator,
+                           BlockModuleSimulator::Create(signature, block));
+
+  std::vector<BitsMap> inputs;
+  for (int64_t i = 0; i < 10; ++i) {
+    inputs.push_back(BitsMap{{"x", UBits(10 * i, 8)}});
+  }
+  // Run twice to check that the state is reset between batches.
+  for (int64_t run = 0; run < 2; ++run) {
+    XLS_ASSERT_OK_AND_ASSIGN(std::vector<BitsMap> outputs,
+                             simulator->RunBatched(inputs));
+    ASSERT_EQ(outputs.size(), inputs.size());
+    for (int64_t i = 0; i < inputs.size(); ++i) {
+      EXPECT_THAT(outputs[i], ElementsAre(Pair("out", UBits(10 * i + 1, 8))));
+    }
+  }
+}
+
+TEST_F(BlockModuleSimulatorTest, PortMismatch) {
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block,
+                           ParseBlock(kCombinationalIr, "comb_diff"));
+  {
+    ModuleSignatureBuilder b("comb_diff");
+    b.WithCombinationalInterface();
+    b.AddDataInputAsBits("x", 8);
+    b.AddDataInputAsBits("y", 16);
+    b.AddDataOutputAsBits("out", 8);
+    XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, b.Build());
+    EXPECT_THAT(BlockModuleSimulator::Create(signature, block),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("has width 8, expected 16")));
+  }
+  {
+    ModuleSignatureBuilder b("comb_diff");
+    b.WithCombinationalInterface();
+    b.AddDataInputAsBits("x", 8);
+    b.AddDataOutputAsBits("out", 8);
+    XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, b.Build());
+    EXPECT_THAT(BlockModuleSimulator::Create(signature, block),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("`y` of block `comb_diff` is not described "
+                                   "by the module signature")));
+  }
+  {
+    ModuleSignatureBuilder b("other");
+    b.WithCombinationalInterface();
+    XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, b.Build());
+    EXPECT_THAT(BlockModuleSimulator::Create(signature, block),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("does not match module `other`")));
+  }
+}
+
+}  // namespace
+}  // namespace verilog
+}  // namespace xls
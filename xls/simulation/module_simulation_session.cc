@@ -0,0 +1,318 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/simulation/module_simulation_session.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xls/codegen/flattening.h"
+#include "xls/codegen/module_signature.h"
+#include "xls/codegen/module_signature.pb.h"
+#include "xls/codegen/vast/vast.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/value.h"
+#include "xls/simulation/module_testbench.h"
+#include "xls/simulation/module_testbench_thread.h"
+#include "xls/simulation/testbench_signal_capture.h"
+#include "xls/simulation/testbench_stream.h"
+#include "xls/simulation/verilog_include.h"
+#include "xls/simulation/verilog_simulator.h"
+
+namespace xls {
+namespace verilog {
+
+/* static */ absl::StatusOr<std::unique_ptr<ModuleSimulationSession>>
+ModuleSimulationSession::Create(const ModuleSignature& signature,
+                                std::string_view verilog_text,
+                                FileType file_type,
+                                const VerilogSimulator* simulator,
+                                absl::Span<const VerilogInclude> includes) {
+  VLOG(1) << "Starting simulation session for Verilog module with signature:\n"
+          << signature.ToString();
+  const ModuleSignatureProto& proto = signature.proto();
+  int64_t latency;
+  if (proto.has_combinational()) {
+    latency = 0;
+  } else if (proto.has_fixed_latency()) {
+    latency = proto.fixed_latency().latency();
+  } else if (proto.has_pipeline()) {
+    latency = proto.pipeline().latency();
+  } else {
+    return absl::UnimplementedError(absl::StrCat(
+        "Unsupported interface: ", proto.interface_oneof_case()));
+  }
+  if (!proto.has_clock_name() && !proto.has_combinational()) {
+    return absl::InvalidArgumentError("Expected clock in signature");
+  }
+  if (signature.data_inputs().empty()) {
+    // The simulation ends when its input streams are closed.
+    return absl::InvalidArgumentError(
+        "A simulation session requires at least one data input");
+  }
+  for (absl::Span<const PortProto> ports :
+       {signature.data_inputs(), signature.data_outputs()}) {
+    for (const PortProto& port : ports) {
+      if (port.width() == 0) {
+        return absl::UnimplementedError(absl::StrFormat(
+            "Zero-width port `%s` is not supported in a simulation session",
+            port.name()));
+      }
+    }
+  }
+
+  auto session = absl::WrapUnique(new ModuleSimulationSession(signature));
+  XLS_ASSIGN_OR_RETURN(
+      session->testbench_,
+      ModuleTestbench::CreateFromVerilogText(
+          verilog_text, file_type, signature, simulator, /*reset_dut=*/true,
+          includes, /*simulation_cycle_limit=*/std::nullopt));
+  ModuleTestbench& tb = *session->testbench_;
+
+  std::optional<PipelineControl> pipeline_control;
+  if (proto.has_pipeline() && proto.pipeline().has_pipeline_control()) {
+    pipeline_control = proto.pipeline().pipeline_control();
+  }
+  std::vector<DutInput> dut_inputs;
+  if (pipeline_control.has_value() && pipeline_control->has_valid()) {
+    dut_inputs.push_back(
+        DutInput{.port_name = pipeline_control->valid().input_name(),
+                 .initial_value = UBits(0, 1)});
+  }
+  for (const PortProto& input : signature.data_inputs()) {
+    dut_inputs.push_back(DutInput{input.name(), IsX()});
+  }
+  XLS_ASSIGN_OR_RETURN(ModuleTestbenchThread * tbt,
+                       tb.CreateThread("input driver", dut_inputs));
+  SequentialBlock& seq = tbt->MainBlock();
+
+  // Vectors are issued one at a time so the pipeline controls may be held
+  // asserted for the whole simulation.
+  if (pipeline_control.has_value() && pipeline_control->has_manual()) {
+    seq.Set(pipeline_control->manual().input_name(), Bits::AllOnes(latency));
+  }
+  if (pipeline_control.has_value() && pipeline_control->has_valid()) {
+    seq.Set(pipeline_control->valid().input_name(), 1);
+  }
+
+  // Streams are named after the port they drive or capture.
+  std::vector<VerilogSimulator::MacroDefinition> macro_definitions;
+  SequentialBlock& loop = seq.RepeatForever();
+  for (const PortProto& input : signature.data_inputs()) {
+    XLS_ASSIGN_OR_RETURN(const TestbenchStream* stream,
+                         tb.CreateInputStream(input.name(), input.width()));
+    loop.ReadFromStreamAndSet(input.name(), stream);
+    macro_definitions.push_back({stream->path_macro_name, "\"/dev/null\""});
+  }
+  if (latency > 0) {
+    loop.AdvanceNCycles(latency);
+  }
+  EndOfCycleEvent& event = loop.AtEndOfCycle();
+  for (const PortProto& output : signature.data_outputs()) {
+    XLS_ASSIGN_OR_RETURN(const TestbenchStream* stream,
+                         tb.CreateOutputStream(output.name(), output.width()));
+    event.CaptureAndWriteToStream(output.name(), stream);
+    macro_definitions.push_back({stream->path_macro_name, "\"/dev/null\""});
+  }
+  if (proto.has_fixed_latency()) {
+    // As in ModuleSimulator::RunBatched, hold the input data for one more
+    // cycle while the output is read.
+    loop.NextCycle();
+  }
+
+  // The stream pipes are opened by both the simulation and RunWithStreamingIo
+  // and opening one end blocks until the other end is opened, so make sure the
+  // testbench compiles before starting the simulation.
+  XLS_RETURN_IF_ERROR(simulator->RunSyntaxChecking(
+      tb.GenerateVerilog(), file_type, macro_definitions, includes));
+
+  session->simulation_thread_ = std::make_unique<Thread>(
+      [session = session.get()]() { session->RunSimulation(); });
+  return session;
+}
+
+ModuleSimulationSession::ModuleSimulationSession(
+    const ModuleSignature& signature)
+    : signature_(signature) {
+  for (const PortProto& input : signature_.data_inputs()) {
+    pending_inputs_[input.name()];
+  }
+  for (const PortProto& output : signature_.data_outputs()) {
+    outputs_[output.name()];
+  }
+}
+
+ModuleSimulationSession::~ModuleSimulationSession() {
+  absl::Status status = Close();
+  if (!status.ok()) {
+    VLOG(1) << "Simulation session ended with error: " << status;
+  }
+}
+
+void ModuleSimulationSession::RunSimulation() {
+  // The producers and consumers passed to RunWithStreamingIo are FunctionRefs
+  // so the functions themselves must outlive the call.
+  std::vector<std::function<std::optional<Bits>()>> producer_fns;
+  producer_fns.reserve(signature_.data_inputs().size());
+  absl::flat_hash_map<std::string, TestbenchStreamThread::Producer> producers;
+  for (const PortProto& input : signature_.data_inputs()) {
+    producer_fns.push_back(
+        [this, name = input.name()]() { return NextInput(name); });
+    producers.emplace(input.name(), producer_fns.back());
+  }
+  std::vector<std::function<absl::Status(const Bits&)>> consumer_fns;
+  consumer_fns.reserve(signature_.data_outputs().size());
+  absl::flat_hash_map<std::string, TestbenchStreamThread::Consumer> consumers;
+  for (const PortProto& output : signature_.data_outputs()) {
+    consumer_fns.push_back([this, name = output.name()](const Bits& value) {
+      return PushOutput(name, value);
+    });
+    consumers.emplace(output.name(), consumer_fns.back());
+  }
+
+  absl::Status status = testbench_->RunWithStreamingIo(producers, consumers);
+  VLOG(1) << "Simulation session ended: " << status;
+  absl::MutexLock lock(&mutex_);
+  simulation_status_ = status;
+}
+
+std::optional<Bits> ModuleSimulationSession::NextInput(
+    std::string_view port_name) {
+  absl::MutexLock lock(&mutex_);
+  std::deque<Bits>& queue = pending_inputs_.at(port_name);
+  auto ready = [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return closing_ || !queue.empty();
+  };
+  mutex_.Await(absl::Condition(&ready));
+  if (queue.empty()) {
+    return std::nullopt;
+  }
+  Bits value = std::move(queue.front());
+  queue.pop_front();
+  return value;
+}
+
+absl::Status ModuleSimulationSession::PushOutput(std::string_view port_name,
+                                                 const Bits& value) {
+  absl::MutexLock lock(&mutex_);
+  outputs_.at(port_name).push_back(value);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<ModuleSimulationSession::BitsMap>>
+ModuleSimulationSession::RunBatched(absl::Span<const BitsMap> inputs) {
+  for (const BitsMap& input : inputs) {
+    XLS_RETURN_IF_ERROR(signature_.ValidateInputs(input));
+  }
+  if (inputs.empty()) {
+    return std::vector<BitsMap>();
+  }
+
+  absl::MutexLock lock(&mutex_);
+  if (closing_ || simulation_status_.has_value()) {
+    return absl::FailedPreconditionError("Simulation session is closed");
+  }
+  for (const BitsMap& input : inputs) {
+    for (auto& [name, queue] : pending_inputs_) {
+      queue.push_back(input.at(name));
+    }
+  }
+  auto done = [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (simulation_status_.has_value()) {
+      return true;
+    }
+    for (const auto& [_, queue] : outputs_) {
+      if (queue.size() < inputs.size()) {
+        return false;
+      }
+    }
+    return true;
+  };
+  mutex_.Await(absl::Condition(&done));
+
+  std::vector<BitsMap> outputs(inputs.size());
+  for (auto& [name, queue] : outputs_) {
+    if (queue.size() < inputs.size()) {
+      XLS_RETURN_IF_ERROR(*simulation_status_);
+      return absl::InternalError(absl::StrFormat(
+          "Simulation ended before producing all values of output `%s`",
+          name));
+    }
+    for (BitsMap& output : outputs) {
+      output[name] = std::move(queue.front());
+      queue.pop_front();
+    }
+  }
+  return outputs;
+}
+
+absl::StatusOr<std::vector<Value>> ModuleSimulationSession::RunBatched(
+    absl::Span<const absl::flat_hash_map<std::string, Value>> inputs) {
+  XLS_RET_CHECK_EQ(signature_.data_outputs().size(), 1);
+  std::vector<BitsMap> bits_inputs;
+  for (const auto& input : inputs) {
+    XLS_RETURN_IF_ERROR(signature_.ValidateInputs(input));
+    BitsMap& bits_input = bits_inputs.emplace_back();
+    for (const auto& [name, value] : input) {
+      bits_input[name] = FlattenValueToBits(value);
+    }
+  }
+  XLS_ASSIGN_OR_RETURN(std::vector<BitsMap> bits_outputs,
+                       RunBatched(bits_inputs));
+  const PortProto& output_port = *signature_.data_outputs().begin();
+  std::vector<Value> outputs;
+  for (const BitsMap& bits_output : bits_outputs) {
+    XLS_ASSIGN_OR_RETURN(
+        Value output,
+        UnflattenBitsToValue(bits_output.at(output_port.name()),
+                             output_port.type()));
+    outputs.push_back(std::move(output));
+  }
+  return outputs;
+}
+
+absl::Status ModuleSimulationSession::Close() {
+  {
+    absl::MutexLock lock(&mutex_);
+    closing_ = true;
+  }
+  if (simulation_thread_ != nullptr) {
+    simulation_thread_->Join();
+    simulation_thread_.reset();
+  }
+  absl::MutexLock lock(&mutex_);
+  return simulation_status_.value_or(absl::OkStatus());
+}
+
+}  // namespace verilog
+}  // namespace xls
@@ -0,0 +1,119 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_SIMULATION_MODULE_SIMULATION_SESSION_H_
+#define XLS_SIMULATION_MODULE_SIMULATION_SESSION_H_
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xls/codegen/module_signature.h"
+#include "xls/codegen/vast/vast.h"
+#include "xls/common/thread.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/value.h"
+#include "xls/simulation/module_testbench.h"
+#include "xls/simulation/verilog_include.h"
+#include "xls/simulation/verilog_simulator.h"
+
+namespace xls {
+namespace verilog {
+
+// A long-lived simulation of a module with a function-style (combinational,
+// fixed latency or pipelined) interface. The Verilog simulator is launched once
+// when the session is created: the DUT and a testbench are compiled a single
+// time and the testbench then loops forever, reading one input vector per
+// iteration from named pipes and writing the corresponding outputs back. Each
+// call to RunBatched streams its vectors to the running simulation, so unlike
+// ModuleSimulator::RunBatched the cost of compiling and launching the simulator
+// is paid once per session rather than once per batch.
+//
+// A session is thread-compatible. Each session runs its own simulator process
+// so separate sessions may be used concurrently from different threads.
+//
+// Pipelined modules are driven one vector at a time: each input is held until
+// its output has been captured. Outputs must not be X and the DUT must not end
+// the simulation itself; either stalls the session.
+class ModuleSimulationSession {
+ public:
+  using BitsMap = absl::flat_hash_map<std::string, Bits>;
+
+  // Builds the testbench and starts the simulation. Arguments are as for the
+  // ModuleSimulator constructor.
+  static absl::StatusOr<std::unique_ptr<ModuleSimulationSession>> Create(
+      const ModuleSignature& signature, std::string_view verilog_text,
+      FileType file_type, const VerilogSimulator* simulator,
+      absl::Span<const VerilogInclude> includes = {});
+
+  // Ends the simulation (see Close) ignoring its status.
+  ~ModuleSimulationSession();
+
+  // Runs the given batch of argument values through the running simulation
+  // and returns the outputs by port name, one map per input vector.
+  absl::StatusOr<std::vector<BitsMap>> RunBatched(
+      absl::Span<const BitsMap> inputs);
+
+  // Overload which accepts Values rather than Bits. The module must have a
+  // single data output.
+  absl::StatusOr<std::vector<Value>> RunBatched(
+      absl::Span<const absl::flat_hash_map<std::string, Value>> inputs);
+
+  // Ends the simulation by closing the input streams and waits for the
+  // simulator to exit. Returns the status of the simulation run. RunBatched
+  // returns an error after the session is closed.
+  absl::Status Close();
+
+ private:
+  explicit ModuleSimulationSession(const ModuleSignature& signature);
+
+  // Producer and consumer of the testbench streams for the given data port.
+  // NextInput blocks until a value is available and returns std::nullopt once
+  // the session is closing.
+  std::optional<Bits> NextInput(std::string_view port_name);
+  absl::Status PushOutput(std::string_view port_name, const Bits& value);
+
+  // Body of `simulation_thread_`: runs the testbench until the input streams
+  // are closed.
+  void RunSimulation();
+
+  ModuleSignature signature_;
+  std::unique_ptr<ModuleTestbench> testbench_;
+  std::unique_ptr<Thread> simulation_thread_;
+
+  absl::Mutex mutex_;
+  // Values not yet consumed by the simulation, indexed by input port name.
+  absl::flat_hash_map<std::string, std::deque<Bits>> pending_inputs_
+      ABSL_GUARDED_BY(mutex_);
+  // Values produced by the simulation, indexed by output port name.
+  absl::flat_hash_map<std::string, std::deque<Bits>> outputs_
+      ABSL_GUARDED_BY(mutex_);
+  bool closing_ ABSL_GUARDED_BY(mutex_) = false;
+  // Set when the simulator exits.
+  std::optional<absl::Status> simulation_status_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace verilog
+}  // namespace xls
+
+#endif  // XLS_SIMULATION_MODULE_SIMULATION_SESSION_H_
@@ -15,6 +15,7 @@
 #include "xls/simulation/module_simulator.h"
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -28,17 +29,20 @@
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
 #include "xls/codegen/module_signature.h"
+#include "xls/codegen/module_signature.pb.h"
 #include "xls/codegen/verilog_line_map.pb.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/get_runfile_path.h"
 #include "xls/common/status/matchers.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/channel.pb.h"
 #include "xls/ir/channel_ops.h"
 #include "xls/ir/package.h"
 #include "xls/ir/value.h"
+#include "xls/simulation/module_simulation_session.h"
 #include "xls/simulation/testbench_signal_capture.h"
 #include "xls/simulation/verilog_test_base.h"
 
@@ -330,6 +334,64 @@ endmodule
     return std::make_pair(text, signature);
   }
 
+  // Returns a Verilog module with a two-stage pipeline interface and valid
+  // pipeline control as a pair of Verilog text and Module signature. Output is
+  // the sum of the two inputs.
+  absl::StatusOr<std::pair<std::string_view, ModuleSignature>>
+  MakePipelinedModule() const {
+    constexpr std::string_view text = R"(
+module pipelined_sum(
+  input wire clk,
+  input wire rst,
+  input wire in_vld,
+  input wire [7:0] x,
+  input wire [7:0] y,
+  output wire [7:0] out,
+  output wire out_vld
+);
+
+  reg [7:0] p0_x;
+  reg [7:0] p0_y;
+  reg p0_vld;
+  reg [7:0] p1_sum;
+  reg p1_vld;
+  assign out = p1_sum;
+  assign out_vld = p1_vld;
+
+  always @ (posedge clk) begin
+    p0_x <= x;
+    p0_y <= y;
+    p1_sum <= p0_x + p0_y;
+  end
+
+  always @ (posedge clk) begin
+    if (rst) begin
+      p0_vld <= 1'h0;
+      p1_vld <= 1'h0;
+    end else begin
+      p0_vld <= in_vld;
+      p1_vld <= p0_vld;
+    end
+  end
+
+endmodule
+)";
+
+    PipelineControl pipeline_control;
+    pipeline_control.mutable_valid()->set_input_name("in_vld");
+    pipeline_control.mutable_valid()->set_output_name("out_vld");
+    ModuleSignatureBuilder b("pipelined_sum");
+    b.WithClock("clk");
+    b.WithReset("rst", /*asynchronous=*/false, /*active_low=*/false);
+    b.WithPipelineInterface(/*latency=*/2, /*initiation_interval=*/1,
+                            pipeline_control);
+    b.AddDataInputAsBits("x", 8);
+    b.AddDataInputAsBits("y", 8);
+    b.AddDataOutputAsBits("out", 8);
+    XLS_ASSIGN_OR_RETURN(ModuleSignature signature, b.Build());
+    return std::make_pair(text, signature);
+  }
+
   // Returns a Verilog module with a ready-valid interface as a pair of Verilog
   // text and Module signature. Output is the difference between the two inputs.
   absl::StatusOr<std::pair<std::string_view, ModuleSignature>>
@@ -410,6 +472,120 @@ TEST_P(ModuleSimulatorTest, CombinationalBatched) {
   EXPECT_THAT(outputs[2], ElementsAre(Pair("out", UBits(100, 8))));
 }
 
+TEST_P(ModuleSimulatorTest, SessionFixedLatencyBatches) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakeFixedLatencyModule());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ModuleSimulationSession> session,
+      ModuleSimulationSession::Create(verilog_signature.second,
+                                      verilog_signature.first, GetFileType(),
+                                      GetSimulator()));
+
+  // Each batch is streamed to the same running simulation.
+  using BitsMap = ModuleSimulationSession::BitsMap;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<BitsMap> outputs,
+      session->RunBatched(
+          {BitsMap{{"x", UBits(44, 8)}}, BitsMap{{"x", UBits(123, 8)}}}));
+  EXPECT_THAT(outputs, ElementsAre(ElementsAre(Pair("out", UBits(88, 8))),
+                                   ElementsAre(Pair("out", UBits(246, 8)))));
+
+  XLS_ASSERT_OK_AND_ASSIGN(outputs,
+                           session->RunBatched({BitsMap{{"x", UBits(7, 8)}}}));
+  EXPECT_THAT(outputs, ElementsAre(ElementsAre(Pair("out", UBits(14, 8)))));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<Value> values,
+      session->RunBatched({absl::flat_hash_map<std::string, Value>{
+          {"x", Value(UBits(3, 8))}}}));
+  EXPECT_THAT(values, ElementsAre(Value(UBits(6, 8))));
+
+  XLS_EXPECT_OK(session->Close());
+  EXPECT_THAT(session->RunBatched({BitsMap{{"x", UBits(1, 8)}}}),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_P(ModuleSimulatorTest, SessionPipelined) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakePipelinedModule());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ModuleSimulationSession> session,
+      ModuleSimulationSession::Create(verilog_signature.second,
+                                      verilog_signature.first, GetFileType(),
+                                      GetSimulator()));
+
+  // The valid input is held asserted and vectors are issued one at a time, so
+  // each output is captured before the next vector enters the pipeline.
+  using BitsMap = ModuleSimulationSession::BitsMap;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<BitsMap> outputs,
+      session->RunBatched(
+          {BitsMap{{"x", UBits(1, 8)}, {"y", UBits(2, 8)}},
+           BitsMap{{"x", UBits(100, 8)}, {"y", UBits(55, 8)}},
+           BitsMap{{"x", UBits(200, 8)}, {"y", UBits(100, 8)}}}));
+  EXPECT_THAT(outputs, ElementsAre(ElementsAre(Pair("out", UBits(3, 8))),
+                                   ElementsAre(Pair("out", UBits(155, 8))),
+                                   ElementsAre(Pair("out", UBits(44, 8)))));
+
+  // A later batch continues in the same simulation and agrees with a fresh
+  // ModuleSimulator run.
+  std::vector<BitsMap> inputs = {
+      BitsMap{{"x", UBits(17, 8)}, {"y", UBits(25, 8)}},
+      BitsMap{{"x", UBits(255, 8)}, {"y", UBits(1, 8)}}};
+  XLS_ASSERT_OK_AND_ASSIGN(outputs, session->RunBatched(inputs));
+  EXPECT_THAT(outputs, ElementsAre(ElementsAre(Pair("out", UBits(42, 8))),
+                                   ElementsAre(Pair("out", UBits(0, 8)))));
+  ModuleSimulator simulator =
+      NewModuleSimulator(verilog_signature.first, verilog_signature.second);
+  EXPECT_THAT(simulator.RunBatched(inputs), IsOkAndHolds(outputs));
+
+  XLS_EXPECT_OK(session->Close());
+}
+
+TEST_P(ModuleSimulatorTest, ConcurrentCombinationalSessions) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakeCombinationalModule());
+  constexpr int64_t kSessionCount = 3;
+  constexpr int64_t kBatchCount = 4;
+  const VerilogSimulator* simulator = GetSimulator();
+  FileType file_type = GetFileType();
+  std::vector<absl::Status> statuses(kSessionCount);
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t i = 0; i < kSessionCount; ++i) {
+    threads.push_back(std::make_unique<Thread>([&, i]() {
+      absl::Status& status = statuses[i];
+      absl::StatusOr<std::unique_ptr<ModuleSimulationSession>> session =
+          ModuleSimulationSession::Create(verilog_signature.second,
+                                          verilog_signature.first, file_type,
+                                          simulator);
+      if (!session.ok()) {
+        status = session.status();
+        return;
+      }
+      using BitsMap = ModuleSimulationSession::BitsMap;
+      for (int64_t batch = 0; batch < kBatchCount && status.ok(); ++batch) {
+        uint64_t x = 10 * i + batch + 20;
+        absl::StatusOr<std::vector<BitsMap>> outputs = (*session)->RunBatched(
+            {BitsMap{{"x", UBits(x, 8)}, {"y", UBits(i, 8)}},
+             BitsMap{{"x", UBits(x, 8)}, {"y", UBits(batch, 8)}}});
+        if (!outputs.ok()) {
+          status = outputs.status();
+        } else if (outputs->size() != 2 ||
+                   (*outputs)[0].at("out") != UBits(x - i, 8) ||
+                   (*outputs)[1].at("out") != UBits(x - batch, 8)) {
+          status = absl::InternalError("Unexpected session outputs");
+        }
+      }
+      if (status.ok()) {
+        status = (*session)->Close();
+      }
+    }));
+  }
+  for (std::unique_ptr<Thread>& thread : threads) {
+    thread->Join();
+  }
+  for (const absl::Status& status : statuses) {
+    XLS_EXPECT_OK(status);
+  }
+}
+
 TEST_P(ModuleSimulatorTest, ReadyValidBatched) {
   XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakeReadyValidModule());
   ModuleSimulator simulator =
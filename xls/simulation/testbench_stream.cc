@@ -106,7 +106,12 @@ void VastStreamEmitter::EmitRead(StatementBlock* block, LogicRef* lhs) const {
   //   if (cnt == 0) begin
   //     $display("FAILED: ...");
   //     $finish;
+  //   end else if (cnt < 0) begin
+  //     $finish;
   //   end
+  //
+  // A negative count means the writer closed the stream (EOF) which ends the
+  // simulation.
   SystemFunctionCall* call = block->file()->Make<SystemFunctionCall>(
       SourceInfo(), "fscanf",
       std::vector<Expression*>{
@@ -124,6 +129,10 @@ void VastStreamEmitter::EmitRead(StatementBlock* block, LogicRef* lhs) const {
           absl::StrFormat("FAILED: $fscanf of file for stream `%s` failed.",
                           stream_.name))});
   conditional->consequent()->Add<Finish>(SourceInfo());
+  conditional
+      ->AddAlternate(block->file()->LessThan(
+          count_, block->file()->PlainLiteral(0, SourceInfo()), SourceInfo()))
+      ->Add<Finish>(SourceInfo());
 }
 
 void VastStreamEmitter::EmitWrite(StatementBlock* block,
@@ -132,6 +141,9 @@ void VastStreamEmitter::EmitWrite(StatementBlock* block,
   //
   //   $fwriteh(fd, <value>);
   //   $fwrite(fd, "\n");
+  //   $fflush(fd);
+  //
+  // The flush lets a reader see each value as soon as it is written.
   block->Add<SystemTaskCall>(SourceInfo(), "fwriteh",
                              std::vector<Expression*>{file_descriptor_, value});
   block->Add<SystemTaskCall>(
@@ -139,6 +151,8 @@ void VastStreamEmitter::EmitWrite(StatementBlock* block,
       std::vector<Expression*>{
           file_descriptor_,
           block->file()->Make<QuotedString>(SourceInfo(), R"(\n)")});
+  block->Add<SystemTaskCall>(SourceInfo(), "fflush",
+                             std::vector<Expression*>{file_descriptor_});
 }
 
 void VastStreamEmitter::EmitClose(StatementBlock* block) const {
@@ -179,8 +193,13 @@ void TestbenchStreamThread::RunInputStream(
                                  stream_.name,
                                  BitsToString(*bits, FormatPreference::kHex));
       CHECK_EQ(bits->bit_count(), stream_.width);
+      // Flush each value so that a simulation blocked reading the stream sees
+      // it immediately rather than when the buffer fills or the pipe closes.
       absl::Status write_status =
           writer->WriteLine(BitsToString(*bits, FormatPreference::kPlainHex));
+      if (write_status.ok()) {
+        write_status = writer->Flush();
+      }
       if (!write_status.ok()) {
         VLOG(1) << absl::StrFormat("Writing value to stream `%s` failed: %s",
                                    stream_.name, write_status.message());
@@ -16,13 +16,21 @@
 
 #include <string_view>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "xls/simulation/verilog_simulator.h"
 
 namespace xls {
 namespace verilog {
 
 absl::StatusOr<VerilogSimulator*> GetVerilogSimulator(std::string_view name) {
+  if (name == kBlockJitSimulatorName) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Simulator `%s` simulates block IR rather than Verilog text and "
+        "requires the block IR of the module",
+        name));
+  }
   return GetVerilogSimulatorManagerSingleton().GetVerilogSimulator(name);
 }
 
@@ -23,6 +23,13 @@
 namespace xls {
 namespace verilog {
 
+// Name of the built-in simulator which evaluates the block IR that a module was
+// generated from with the block JIT (see BlockModuleSimulator) instead of
+// simulating the Verilog text. It is not a VerilogSimulator as it cannot run
+// arbitrary testbenches, so it is only accepted by tools which are also given
+// the block IR.
+inline constexpr std::string_view kBlockJitSimulatorName = "block_jit";
+
 // Returns the registered Verilog simulator with the given name.
 absl::StatusOr<VerilogSimulator*> GetVerilogSimulator(std::string_view name);
 
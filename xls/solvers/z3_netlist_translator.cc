@@ -134,7 +134,7 @@ absl::Status NetlistTranslator::Translate() {
   // outputs every time it's examined.
   absl::flat_hash_map<Cell*, absl::flat_hash_set<NetRef>> cell_inputs;
   std::deque<NetRef> active_wires;
-  for (const auto& cell : module_->cells()) {
+  for (Cell* cell : module_->cells()) {
     // If any cells have _no_ inputs, then their outputs should be made
     // immediately available.
     if (cell->inputs().empty()) {
@@ -147,7 +147,7 @@ absl::Status NetlistTranslator::Translate() {
       for (const auto& input : cell->inputs()) {
         inputs.insert(input.netref);
       }
-      cell_inputs[cell.get()] = std::move(inputs);
+      cell_inputs[cell] = std::move(inputs);
     }
   }
 
@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <optional>
+#include <ostream>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -147,15 +148,18 @@ absl::StatusOr<PipelineScheduleOrGroup> ScheduleFromMetadata(
 
 absl::StatusOr<CodegenResult> CodegenFromMetadata(
     Package* p, GeneratorKind generator_kind, const CodegenMetadata& metadata,
-    const PipelineScheduleOrGroup* schedules, absl::Duration* codegen_time) {
+    const PipelineScheduleOrGroup* schedules, absl::Duration* codegen_time,
+    std::ostream* verilog_output) {
   if (generator_kind == GENERATOR_KIND_COMBINATIONAL) {
     return CodegenCombinational(p, metadata.codegen_options,
-                                metadata.delay_estimator, codegen_time);
+                                metadata.delay_estimator, codegen_time,
+                                verilog_output);
   }
   XLS_RET_CHECK_EQ(generator_kind, GENERATOR_KIND_PIPELINE);
   XLS_RET_CHECK(schedules != nullptr);
   return CodegenPipeline(p, *schedules, metadata.codegen_options,
-                         metadata.delay_estimator, codegen_time);
+                         metadata.delay_estimator, codegen_time,
+                         verilog_output);
 }
 
 verilog::CodegenOptions::IOKind ToIOKind(IOKindProto p) {
@@ -359,7 +363,8 @@ absl::StatusOr<PipelineScheduleOrGroup> Schedule(
 absl::StatusOr<CodegenResult> CodegenPipeline(
     Package* p, PipelineScheduleOrGroup schedules,
     const verilog::CodegenOptions& codegen_options,
-    const DelayEstimator* delay_estimator, absl::Duration* codegen_time) {
+    const DelayEstimator* delay_estimator, absl::Duration* codegen_time,
+    std::ostream* verilog_output) {
   XLS_RETURN_IF_ERROR(VerifyPackage(p, /*codegen=*/true));
 
   std::optional<Stopwatch> stopwatch;
@@ -374,16 +379,18 @@ absl::StatusOr<CodegenResult> CodegenPipeline(
     package_pipeline_schedules_proto.mutable_schedules()->insert(
         {schedule.function_base()->name(), schedule.ToProto(*delay_estimator)});
     XLS_ASSIGN_OR_RETURN(
-        result, verilog::ToPipelineModuleText(
-                    schedule, *p->GetTop(), codegen_options, delay_estimator));
+        result, verilog::ToPipelineModuleText(schedule, *p->GetTop(),
+                                              codegen_options, delay_estimator,
+                                              verilog_output));
   } else if (std::holds_alternative<PackagePipelineSchedules>(schedules)) {
     const PackagePipelineSchedules& schedule_group =
         std::get<PackagePipelineSchedules>(schedules);
     package_pipeline_schedules_proto =
         PackagePipelineSchedulesToProto(schedule_group, *delay_estimator);
     XLS_ASSIGN_OR_RETURN(
-        result, verilog::ToPipelineModuleText(
-                    schedule_group, p, codegen_options, delay_estimator));
+        result, verilog::ToPipelineModuleText(schedule_group, p,
+                                              codegen_options, delay_estimator,
+                                              verilog_output));
   } else {
     LOG(FATAL) << absl::StreamFormat("Unknown schedules type (%d).",
                                      schedules.index());
@@ -401,14 +408,16 @@ absl::StatusOr<CodegenResult> CodegenPipeline(
 
 absl::StatusOr<CodegenResult> CodegenCombinational(
     Package* p, const verilog::CodegenOptions& codegen_options,
-    const DelayEstimator* delay_estimator, absl::Duration* codegen_time) {
+    const DelayEstimator* delay_estimator, absl::Duration* codegen_time,
+    std::ostream* verilog_output) {
   std::optional<Stopwatch> stopwatch;
   if (codegen_time != nullptr) {
     stopwatch.emplace();
   }
-  XLS_ASSIGN_OR_RETURN(verilog::ModuleGeneratorResult result,
-                       verilog::GenerateCombinationalModule(
-                           *p->GetTop(), codegen_options, delay_estimator));
+  XLS_ASSIGN_OR_RETURN(
+      verilog::ModuleGeneratorResult result,
+      verilog::GenerateCombinationalModule(*p->GetTop(), codegen_options,
+                                           delay_estimator, verilog_output));
   if (codegen_time != nullptr) {
     *codegen_time = stopwatch->GetElapsedTime();
   }
@@ -432,21 +441,22 @@ absl::StatusOr<CodegenResult> Codegen(
     Package* p,
     const SchedulingOptionsFlagsProto& scheduling_options_flags_proto,
     const CodegenFlagsProto& codegen_flags_proto, bool with_delay_model,
-    const PipelineScheduleOrGroup* schedules, absl::Duration* codegen_time) {
+    const PipelineScheduleOrGroup* schedules, absl::Duration* codegen_time,
+    std::ostream* verilog_output) {
   XLS_RETURN_IF_ERROR(MaybeSetTop(p, codegen_flags_proto));
   XLS_ASSIGN_OR_RETURN(
       CodegenMetadata metadata,
       CodegenMetadata::Create(p, scheduling_options_flags_proto,
                               codegen_flags_proto, with_delay_model));
   return CodegenFromMetadata(p, codegen_flags_proto.generator(), metadata,
-                             schedules, codegen_time);
+                             schedules, codegen_time, verilog_output);
 }
 
 absl::StatusOr<CodegenResult> ScheduleAndCodegen(
     Package* p,
     const SchedulingOptionsFlagsProto& scheduling_options_flags_proto,
     const CodegenFlagsProto& codegen_flags_proto, bool with_delay_model,
-    TimingReport* timing_report) {
+    TimingReport* timing_report, std::ostream* verilog_output) {
   XLS_RETURN_IF_ERROR(MaybeSetTop(p, codegen_flags_proto));
   XLS_ASSIGN_OR_RETURN(
       CodegenMetadata metadata,
@@ -467,7 +477,7 @@ absl::StatusOr<CodegenResult> ScheduleAndCodegen(
   }
   return CodegenFromMetadata(
       p, codegen_flags_proto.generator(), metadata, schedules_ptr,
-      timing_report ? &timing_report->codegen_time : nullptr);
+      timing_report ? &timing_report->codegen_time : nullptr, verilog_output);
 }
 
 }  // namespace xls
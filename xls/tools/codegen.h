@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <optional>
+#include <ostream>
 #include <variant>
 
 #include "absl/status/statusor.h"
@@ -40,6 +41,9 @@ absl::StatusOr<PipelineScheduleOrGroup> Schedule(
     const DelayEstimator* delay_estimator,
     absl::Duration* scheduling_time = nullptr);
 
+// For the codegen entry points below which take a `verilog_output` stream, if
+// the stream is non-null the Verilog text is written to it as it is emitted
+// rather than returned in `module_generator_result.verilog_text`.
 struct CodegenResult {
   verilog::ModuleGeneratorResult module_generator_result;
   std::optional<PackagePipelineSchedulesProto>
@@ -50,12 +54,14 @@ absl::StatusOr<CodegenResult> CodegenPipeline(
     Package* p, PipelineScheduleOrGroup schedules,
     const verilog::CodegenOptions& codegen_options,
     const DelayEstimator* delay_estimator,
-    absl::Duration* codegen_time = nullptr);
+    absl::Duration* codegen_time = nullptr,
+    std::ostream* verilog_output = nullptr);
 
 absl::StatusOr<CodegenResult> CodegenCombinational(
     Package* p, const verilog::CodegenOptions& codegen_options,
     const DelayEstimator* delay_estimator,
-    absl::Duration* codegen_time = nullptr);
+    absl::Duration* codegen_time = nullptr,
+    std::ostream* verilog_output = nullptr);
 
 absl::StatusOr<verilog::CodegenOptions> CodegenOptionsFromProto(
     const CodegenFlagsProto& p);
@@ -75,12 +81,14 @@ absl::StatusOr<CodegenResult> Codegen(
     Package* p,
     const SchedulingOptionsFlagsProto& scheduling_options_flags_proto,
     const CodegenFlagsProto& codegen_flags_proto, bool with_delay_model,
-    const PipelineScheduleOrGroup* schedules, absl::Duration* codegen_time);
+    const PipelineScheduleOrGroup* schedules, absl::Duration* codegen_time,
+    std::ostream* verilog_output = nullptr);
 absl::StatusOr<CodegenResult> ScheduleAndCodegen(
     Package* p,
     const SchedulingOptionsFlagsProto& scheduling_options_flags_proto,
     const CodegenFlagsProto& codegen_flags_proto, bool with_delay_model,
-    TimingReport* timing_report = nullptr);
+    TimingReport* timing_report = nullptr,
+    std::ostream* verilog_output = nullptr);
 
 }  // namespace xls
 
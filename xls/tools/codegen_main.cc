@@ -13,13 +13,17 @@
 // limitations under the License.
 #include <cstdint>
 #include <filesystem>  // NOLINT
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <ostream>
 #include <string>
 #include <string_view>
+#include <system_error>  // NOLINT
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"
 #include "absl/flags/flag.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
@@ -86,10 +90,43 @@ absl::Status RealMain(std::string_view ir_path) {
   XLS_ASSIGN_OR_RETURN(
       bool delay_model_flag_passed,
       IsDelayModelSpecifiedViaFlag(scheduling_options_flags_proto));
+
+  // When writing to a file the Verilog is streamed as it is emitted into a
+  // temporary file next to the destination, which replaces the destination
+  // only once every output has been produced. On failure the destination is
+  // left untouched. Output to stdout is written only after success.
+  const std::string& verilog_path = absl::GetFlag(FLAGS_output_verilog_path);
+  std::optional<std::filesystem::path> verilog_temp_path;
+  std::optional<std::ofstream> verilog_file;
+  if (!verilog_path.empty()) {
+    verilog_temp_path = std::filesystem::path(verilog_path).concat(".tmp");
+    verilog_file.emplace(*verilog_temp_path);
+    if (!verilog_file->is_open()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Unable to open Verilog output file `%s`",
+          verilog_temp_path->string()));
+    }
+  }
+  absl::Cleanup remove_verilog_temp = [&verilog_temp_path] {
+    if (verilog_temp_path.has_value()) {
+      std::error_code ec;
+      std::filesystem::remove(*verilog_temp_path, ec);
+    }
+  };
   XLS_ASSIGN_OR_RETURN(
       CodegenResult r,
-      ScheduleAndCodegen(p.get(), scheduling_options_flags_proto,
-                         codegen_flags_proto, delay_model_flag_passed));
+      ScheduleAndCodegen(
+          p.get(), scheduling_options_flags_proto, codegen_flags_proto,
+          delay_model_flag_passed, /*timing_report=*/nullptr,
+          verilog_file.has_value() ? &verilog_file.value() : nullptr));
+  if (verilog_file.has_value()) {
+    verilog_file->close();
+    if (verilog_file->fail()) {
+      return absl::InternalError(absl::StrFormat(
+          "Failed to write Verilog output file `%s`",
+          verilog_temp_path->string()));
+    }
+  }
   verilog::ModuleGeneratorResult result = r.module_generator_result;
   std::optional<PackagePipelineSchedulesProto> schedule =
       r.package_pipeline_schedules_proto;
@@ -123,7 +160,6 @@ absl::Status RealMain(std::string_view ir_path) {
         absl::GetFlag(FLAGS_output_signature_path), result.signature.proto()));
   }
 
-  const std::string& verilog_path = absl::GetFlag(FLAGS_output_verilog_path);
   if (!verilog_path.empty()) {
     for (int64_t i = 0; i < result.verilog_line_map.mapping_size(); ++i) {
       result.verilog_line_map.mutable_mapping(i)->set_verilog_file(
@@ -138,10 +174,17 @@ absl::Status RealMain(std::string_view ir_path) {
         SetTextProtoFile(verilog_line_map_path, result.verilog_line_map));
   }
 
-  if (verilog_path.empty()) {
-    std::cout << result.verilog_text;
+  if (verilog_temp_path.has_value()) {
+    std::error_code ec;
+    std::filesystem::rename(*verilog_temp_path, verilog_path, ec);
+    if (ec) {
+      return absl::InternalError(absl::StrFormat(
+          "Failed to move `%s` to Verilog output file `%s`: %s",
+          verilog_temp_path->string(), verilog_path, ec.message()));
+    }
+    verilog_temp_path.reset();
   } else {
-    XLS_RETURN_IF_ERROR(SetFileContents(verilog_path, result.verilog_text));
+    std::cout << result.verilog_text;
   }
   return absl::OkStatus();
 }
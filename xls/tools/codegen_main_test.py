@@ -262,6 +262,44 @@ class CodeGenMainTest(parameterized.TestCase):
         SHA256_IR_PATH,
     ])
 
+  def test_failed_codegen_keeps_previous_verilog(self):
+    verilog_file = self.create_tempfile(content='// previous output\n')
+    # No single stage can fit in a 1ps clock period.
+    result = subprocess.run(
+        [
+            CODEGEN_MAIN_PATH,
+            '--generator=pipeline',
+            '--delay_model=unit',
+            '--pipeline_stages=1',
+            '--clock_period_ps=1',
+            '--output_verilog_path=' + verilog_file.full_path,
+            SHA256_IR_PATH,
+        ],
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        check=False,
+    )
+    self.assertNotEqual(result.returncode, 0)
+    self.assertEqual(verilog_file.read_text(), '// previous output\n')
+    self.assertFalse(os.path.exists(verilog_file.full_path + '.tmp'))
+
+  def test_failed_codegen_writes_nothing_to_stdout(self):
+    result = subprocess.run(
+        [
+            CODEGEN_MAIN_PATH,
+            '--generator=pipeline',
+            '--delay_model=unit',
+            '--pipeline_stages=1',
+            '--clock_period_ps=1',
+            SHA256_IR_PATH,
+        ],
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        check=False,
+    )
+    self.assertNotEqual(result.returncode, 0)
+    self.assertEqual(result.stdout, b'')
+
   def test_custom_module_name(self):
     ir_file = self.create_tempfile(content=NOT_ADD_IR)
     verilog = subprocess.check_output([
@@ -46,7 +46,6 @@
 #include "xls/ir/type.h"
 #include "xls/netlist/cell_library.h"
 #include "xls/netlist/function_extractor.h"
-#include "xls/netlist/lib_parser.h"
 #include "xls/netlist/netlist.h"
 #include "xls/netlist/netlist.pb.h"
 #include "xls/netlist/netlist_parser.h"
@@ -118,11 +117,9 @@ absl::StatusOr<netlist::CellLibrary> GetCellLibrary(
     XLS_RET_CHECK(cell_proto.ParseFromString(cell_proto_text));
     return netlist::CellLibrary::FromProto(cell_proto);
   }
-  XLS_ASSIGN_OR_RETURN(std::string lib_text, GetFileContents(cell_lib_path));
-  XLS_ASSIGN_OR_RETURN(auto stream,
-                       netlist::cell_lib::CharStream::FromText(lib_text));
   XLS_ASSIGN_OR_RETURN(netlist::CellLibraryProto proto,
-                       netlist::function::ExtractFunctions(&stream));
+                       netlist::function::ExtractFunctionsFromFile(
+                           std::filesystem::path(cell_lib_path)));
   return netlist::CellLibrary::FromProto(proto);
 }
 
@@ -43,7 +43,8 @@
 
 namespace xls::tools {
 
-absl::Status OptimizeIrForTop(Package* package, const OptOptions& options) {
+absl::Status OptimizeIrForTop(Package* package, const OptOptions& options,
+                              PassResults* results) {
   if (!options.top.empty()) {
     VLOG(3) << "OptimizeIrForEntry; top: '" << options.top
             << "'; opt_level: " << options.opt_level;
@@ -84,8 +85,11 @@ absl::Status OptimizeIrForTop(Package* package, const OptOptions& options) {
   pass_options.use_context_narrowing_analysis =
       options.use_context_narrowing_analysis;
   pass_options.bisect_limit = options.bisect_limit;
-  PassResults results;
-  XLS_RETURN_IF_ERROR(pipeline->Run(package, pass_options, &results).status());
+  PassResults local_results;
+  if (results == nullptr) {
+    results = &local_results;
+  }
+  XLS_RETURN_IF_ERROR(pipeline->Run(package, pass_options, results).status());
   return absl::OkStatus();
 }
 
@@ -30,6 +30,7 @@
 #include "absl/types/span.h"
 #include "xls/ir/package.h"
 #include "xls/passes/optimization_pass.h"
+#include "xls/passes/pass_base.h"
 
 namespace xls::tools {
 
@@ -52,8 +53,10 @@ struct OptOptions {
 
 // Helper used in the opt_main tool, optimizes the given IR for a particular
 // top-level entity (e.g., function, proc, etc) at the given opt level and
-// modifies the package in place.
-absl::Status OptimizeIrForTop(Package* package, const OptOptions& options);
+// modifies the package in place. If `results` is non-null it receives the
+// record of the pass invocations.
+absl::Status OptimizeIrForTop(Package* package, const OptOptions& options,
+                              PassResults* results = nullptr);
 
 // Helper used in the opt_main tool, optimizes the given IR for a particular
 // top-level entity (e.g., function, proc, etc) at the given opt level and
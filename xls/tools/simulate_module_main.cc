@@ -17,6 +17,7 @@
 #include <filesystem>  // NOLINT
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -41,9 +42,12 @@
 #include "xls/common/file/filesystem.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/ir/block.h"
 #include "xls/ir/format_preference.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
 #include "xls/ir/value.h"
+#include "xls/simulation/block_module_simulator.h"
 #include "xls/simulation/module_simulator.h"
 #include "xls/simulation/verilog_simulator.h"
 #include "xls/simulation/verilog_simulators.h"
@@ -63,6 +67,11 @@ Simulate a module with a batch of arguments, one argument set per line in
 ARGS_FILE:
   simulate_module_main  --signature_file=SIG_FILE \
       --args_file=ARGS_FILE VERILOG_FILE
+
+Simulate the block IR the module was generated from with the block JIT rather
+than running the Verilog through a simulator (function interfaces only):
+  simulate_module_main --signature_file=SIG_FILE --verilog_simulator=block_jit \
+      --block_ir_path=BLOCK_IR_FILE --args_file=ARGS_FILE VERILOG_FILE
 )";
 
 ABSL_FLAG(
@@ -105,6 +114,10 @@ ABSL_FLAG(std::vector<std::string>, output_channel_counts, {},
 ABSL_FLAG(std::string, verilog_simulator, "iverilog",
           "The Verilog simulator to use. If not specified, the default "
           "simulator is used.");
+ABSL_FLAG(std::string, block_ir_path, "",
+          "Path to the block IR the Verilog was generated from. Required with "
+          "--verilog_simulator=block_jit which simulates the block IR in "
+          "place of the Verilog text.");
 ABSL_FLAG(std::string, file_type, "",
           "The type of input file, may be either 'verilog' or "
           "'system_verilog'. If not specified the file type is determined by "
@@ -161,7 +174,8 @@ absl::Status RunProc(const verilog::ModuleSimulator& simulator,
   return absl::OkStatus();
 }
 
-absl::Status RunFunction(const verilog::ModuleSimulator& simulator,
+template <typename SimulatorT>
+absl::Status RunFunction(SimulatorT& simulator,
                          const verilog::ModuleSignature& signature,
                          const FunctionInput& function_input) {
   std::vector<absl::flat_hash_map<std::string, Value>> args_sets;
@@ -185,6 +199,26 @@ absl::Status RunFunction(const verilog::ModuleSimulator& simulator,
   return absl::OkStatus();
 }
 
+// Simulates the block IR in `block_ir_path` in place of the Verilog.
+absl::Status RealMainBlockJit(std::string_view block_ir_path,
+                              const verilog::ModuleSignature& signature,
+                              InputType inputs) {
+  if (!std::holds_alternative<FunctionInput>(inputs)) {
+    return absl::UnimplementedError(
+        absl::StrFormat("Simulator `%s` does not support proc inputs",
+                        verilog::kBlockJitSimulatorName));
+  }
+  XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(block_ir_path));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(ir_text, block_ir_path));
+  XLS_ASSIGN_OR_RETURN(Block * block,
+                       package->GetBlock(signature.module_name()));
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<verilog::BlockModuleSimulator> simulator,
+      verilog::BlockModuleSimulator::Create(signature, block));
+  return RunFunction(*simulator, signature, std::get<FunctionInput>(inputs));
+}
+
 absl::Status RealMain(std::string_view verilog_text,
                       verilog::FileType file_type,
                       const verilog::ModuleSignature& signature,
@@ -206,11 +240,19 @@ int main(int argc, char** argv) {
   std::vector<std::string_view> positional_arguments =
       xls::InitXls(kUsage, argc, argv);
 
-  using xls::verilog::GetVerilogSimulator;
-  auto simulator = GetVerilogSimulator(absl::GetFlag(FLAGS_verilog_simulator));
-  QCHECK_OK(simulator) << "Unknown simulator --verilog_simulator";
-
-  const xls::verilog::VerilogSimulator* verilog_simulator = simulator.value();
+  const bool use_block_jit = absl::GetFlag(FLAGS_verilog_simulator) ==
+                             xls::verilog::kBlockJitSimulatorName;
+  const xls::verilog::VerilogSimulator* verilog_simulator = nullptr;
+  if (use_block_jit) {
+    QCHECK(!absl::GetFlag(FLAGS_block_ir_path).empty())
+        << "--verilog_simulator=block_jit requires --block_ir_path";
+  } else {
+    using xls::verilog::GetVerilogSimulator;
+    auto simulator =
+        GetVerilogSimulator(absl::GetFlag(FLAGS_verilog_simulator));
+    QCHECK_OK(simulator) << "Unknown simulator --verilog_simulator";
+    verilog_simulator = simulator.value();
+  }
 
   QCHECK_EQ(positional_arguments.size(), 1)
       << "Expected single Verilog file argument.";
@@ -314,6 +356,10 @@ int main(int argc, char** argv) {
       xls::verilog::ModuleSignature::FromProto(signature_proto);
   QCHECK_OK(signature_status.status());
 
+  if (use_block_jit) {
+    return xls::ExitStatus(xls::RealMainBlockJit(
+        absl::GetFlag(FLAGS_block_ir_path), signature_status.value(), input));
+  }
   return xls::ExitStatus(xls::RealMain(verilog_text.value(), file_type,
                                        signature_status.value(), input,
                                        verilog_simulator));